@@ -6,21 +6,164 @@
  *************************************************************************************************************/
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include <util/atomic.h>
+#include <util/delay.h>
 #include "Common_Macros.h"
+#include "Isr_Sync.h"
 #include "ADC.h"
 
 /***************************************************************************************
  *                                      Global Variables                               *
  ***************************************************************************************/
 
- volatile uint16 g_ADC_Value = 0;
+ISR_SYNC_SNAPSHOT_DEFINE(ADC_ValueSnapshot, uint16)
+
+/* Last conversion result of the ADC interrupt */
+static ADC_ValueSnapshot_Type g_lastValue;
+
+/* State of each slot of the hardware triggered sampling */
+typedef struct
+{
+	uint8 Channel;
+	uint8 Samples_Per_Result;
+	uint8 Sample_Count;
+	uint16 Sample_Sum;
+	uint16 Sample;
+	uint16 Result;
+	boolean Result_Ready;
+	boolean Has_Result;
+	uint16 Limit_Code;
+	uint8 Limit_Samples;
+	uint8 Limit_Count;
+	uint8 Interval;
+	uint8 Countdown;
+	void (*CallBack_Ptr)(void);
+	void (*Limit_CallBack_Ptr)(void);
+}ADC_SlotStateType;
+
+/* The limits are disabled with the highest code + 1, every slot is converted in every round */
+static volatile ADC_SlotStateType g_slots[ADC_MAX_SLOTS] =
+{
+	{0, 1, 0, 0, 0, 0, FALSE, FALSE, ADC_MAX_VALUE + 1, 1, 0, 1, 0, NULL_PTR, NULL_PTR},
+	{0, 1, 0, 0, 0, 0, FALSE, FALSE, ADC_MAX_VALUE + 1, 1, 0, 1, 0, NULL_PTR, NULL_PTR},
+	{0, 1, 0, 0, 0, 0, FALSE, FALSE, ADC_MAX_VALUE + 1, 1, 0, 1, 0, NULL_PTR, NULL_PTR},
+	{0, 1, 0, 0, 0, 0, FALSE, FALSE, ADC_MAX_VALUE + 1, 1, 0, 1, 0, NULL_PTR, NULL_PTR}
+};
+
+static volatile uint8 g_numOfSlots = 1;
+
+/* Slot of the turn in progress (the conversion in progress, or an idle turn) */
+static volatile uint8 g_currentSlot = 0;
+
+/* TRUE during an idle turn: the auto trigger is disabled, ADC_Tick moves to the next turn */
+static volatile boolean g_idleTurn = FALSE;
+
+/* TRUE while ADC_ReadChannel polls a conversion: ADC_Tick must not touch ADMUX and the auto trigger */
+static volatile boolean g_pollActive = FALSE;
+
+/****************************************************************************************
+ *                                   Private Functions Definitions                      *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Prepare the turn of the slot for the next trigger event: the slot is converted once every Interval
+ * of its turns, the other turns are idle (no conversion, no ADC interrupt).
+ */
+static void ADC_PrepareTurn(uint8 Slot)
+{
+	volatile ADC_SlotStateType *Slot_Ptr = &g_slots[Slot];
+
+	g_currentSlot = Slot;
+
+	if (Slot_Ptr -> Countdown == 0)
+	{
+		Slot_Ptr -> Countdown = Slot_Ptr -> Interval - 1;
+		ADMUX = (ADMUX & 0xE0) | (Slot_Ptr -> Channel);
+		g_idleTurn = FALSE;
+		SET_BIT(ADCSRA, ADATE);
+	}
+	else
+	{
+		Slot_Ptr -> Countdown--;
+		g_idleTurn = TRUE;
+		CLEAR_BIT(ADCSRA, ADATE);
+	}
+}
 
 /***************************************************************************************
  *                                  Interrupt Service Routines                         *
  ***************************************************************************************/
  ISR(ADC_vect)
  {
-	 g_ADC_Value = ADC;
+	uint8 Trigger_Source;
+	uint8 Next_Slot;
+	uint16 Value = ADC;
+	volatile ADC_SlotStateType *Slot_Ptr = &g_slots[g_currentSlot];
+
+	/* Safety fast path first: no loop, no division before the limit call back */
+	if (Value >= Slot_Ptr -> Limit_Code)
+	{
+		if (Slot_Ptr -> Limit_Count < Slot_Ptr -> Limit_Samples)
+		{
+			Slot_Ptr -> Limit_Count++;
+		}
+		if ((Slot_Ptr -> Limit_Count >= Slot_Ptr -> Limit_Samples) && (Slot_Ptr -> Limit_CallBack_Ptr != NULL_PTR))
+		{
+			(*Slot_Ptr -> Limit_CallBack_Ptr)();
+		}
+	}
+	else
+	{
+		Slot_Ptr -> Limit_Count = 0;
+	}
+
+	ADC_ValueSnapshot_Store(&g_lastValue, Value);
+	Slot_Ptr -> Sample = Value;
+
+	/* The new channel is used by the conversion of the next trigger event */
+	Next_Slot = g_currentSlot + 1;
+	if (Next_Slot >= g_numOfSlots)
+	{
+		Next_Slot = 0;
+	}
+	if ((Next_Slot != g_currentSlot) || (g_slots[Next_Slot].Interval > 1))
+	{
+		ADC_PrepareTurn(Next_Slot);
+	}
+
+	/*
+	 * A Timer0 trigger is the rising edge of its interrupt flag, the flag must be cleared for the
+	 * next event to start a conversion. It is cleared by hardware only when its interrupt is enabled.
+	 */
+	Trigger_Source = SFIOR >> 5;
+	if ((Trigger_Source == TIMER0_OVF) && BIT_IS_CLEAR(TIMSK, TOIE0))
+	{
+		TIFR = (1 << TOV0);
+	}
+	else if ((Trigger_Source == TIMER0_COMP) && BIT_IS_CLEAR(TIMSK, OCIE0))
+	{
+		TIFR = (1 << OCF0);
+	}
+
+	Slot_Ptr -> Sample_Sum += Value;
+	Slot_Ptr -> Sample_Count++;
+
+	if (Slot_Ptr -> Sample_Count >= Slot_Ptr -> Samples_Per_Result)
+	{
+		Slot_Ptr -> Result = Slot_Ptr -> Sample_Sum / Slot_Ptr -> Sample_Count;
+		Slot_Ptr -> Sample_Sum = 0;
+		Slot_Ptr -> Sample_Count = 0;
+		Slot_Ptr -> Result_Ready = TRUE;
+		Slot_Ptr -> Has_Result = TRUE;
+
+		if (Slot_Ptr -> CallBack_Ptr != NULL_PTR)
+		{
+			(*Slot_Ptr -> CallBack_Ptr)();
+		}
+	}
+
+	g_currentSlot = Next_Slot;
  }
 
 /****************************************************************************************
@@ -56,19 +199,348 @@ void ADC_Init(const ADC_ConfigType *Config_Ptr)
  * 4. You can clear the flag by writing "One" or automatically by Hardware.
  * 5. return the ADC value.
  * 6. Polling Technique Activated!
+ * 7. When switching to a gain channel the first conversion is dropped (offset cancellation settling).
+ * The result of a differential channel is converted with ADC_ToSigned.
  */
 uint16 ADC_ReadChannel(InputChannel_Select Channel_Select)
 {
-	/* ADMUX & 1110 0000 (MUX4:0) | (0:7) */
+	uint16 Digital_Value;
+	uint8 Old_Mux;
+	uint8 Old_Control;
+
+	/*
+	 * Mask the ADC interrupt while polling, otherwise once the global interrupts are enabled
+	 * the ISR clears ADIF by hardware and the polling loop below may never see it.
+	 * The auto trigger is paused as well so a triggered conversion cannot change the channel.
+	 * The ADC interrupt and ADC_Tick (from the trigger source interrupt) prepare the turns, so the state is saved
+	 * and paused with the interrupts disabled, then ADC_Tick is held off until it is restored.
+	 */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		Old_Mux = ADMUX;
+		Old_Control = ADCSRA & ((1 << ADIE) | (1 << ADATE));
+		ADCSRA &= ~((1 << ADIE) | (1 << ADATE));
+		g_pollActive = TRUE;
+	}
+
+	/* Let a triggered conversion which is already running finish, its result is dropped */
+	while(BIT_IS_SET(ADCSRA,ADSC));
+
+	/* ADMUX & 1110 0000 (MUX4:0) | (0:31) */
 	ADMUX = (ADMUX & 0xE0) | (Channel_Select);
+
+	/* The first conversion after switching to a gain channel has a poor accuracy, it is dropped */
+	if (ADC_IS_GAIN_CHANNEL(Channel_Select) && ((Old_Mux & 0x1F) != Channel_Select))
+	{
+		SET_BIT(ADCSRA,ADSC);
+		while(BIT_IS_SET(ADCSRA,ADSC));
+	}
+
 	SET_BIT(ADCSRA,ADSC);
 
-	/* Wait for conversion to complete, ADIF becomes '1' */
-	while(BIT_IS_CLEAR(ADCSRA,ADIF));
+	/* Wait for conversion to complete (ADSC becomes '0'), the ADIF flag may already be set by a triggered conversion */
+	while(BIT_IS_SET(ADCSRA,ADSC));
+
+	/* Read the digital value from the data register */
+	Digital_Value = ADC;
+
+	/* Clear ADIF by write '1' to it, then restore the channel, the auto trigger and the ADC interrupt */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		SET_BIT(ADCSRA,ADIF);
+		ADMUX = Old_Mux;
+		ADCSRA |= Old_Control;
+		g_pollActive = FALSE;
+	}
+
+	return Digital_Value;
+}
+
+/*
+ * Description:
+ * Convert the result of a differential channel (10-bit two's complement) to a signed value
+ * from ADC_DIFF_MIN_VALUE to ADC_DIFF_MAX_VALUE.
+ */
+sint16 ADC_ToSigned(uint16 Digital_Value)
+{
+	if (Digital_Value > ADC_DIFF_MAX_VALUE)
+	{
+		return (sint16)Digital_Value - (ADC_MAX_VALUE + 1);
+	}
+
+	return (sint16)Digital_Value;
+}
+
+/*
+ * Description:
+ * Change the voltage reference (bits 6 & 7 in ADMUX Register) and wait ADC_REFERENCE_SETTLING_MS if it changed.
+ * The reference is shared by all the channels: the results of the hardware triggered sampling are
+ * scaled with the new reference too.
+ */
+void ADC_SetReference(VoltageReference_Select Voltage_Ref)
+{
+	if (ADC_GetReference() == Voltage_Ref)
+	{
+		return;
+	}
+
+	/* Read-modify-write of ADMUX, the ADC interrupt writes the channel bits */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		ADMUX = (ADMUX & 0x3F) | (Voltage_Ref << 6);
+	}
+
+	_delay_ms(ADC_REFERENCE_SETTLING_MS);
+}
+
+/*
+ * Description:
+ * Return the voltage reference in use.
+ */
+VoltageReference_Select ADC_GetReference(void)
+{
+	return (VoltageReference_Select)(ADMUX >> 6);
+}
+
+/*
+ * Description:
+ * Start the hardware triggered sampling of a schedule of channels with the Auto Trigger Source of ADC_Init.
+ * 1. Every trigger event starts a conversion without any CPU work, the sample and hold takes place
+ *    2 ADC clock cycles after the trigger so the samples are always taken at the same phase.
+ * 2. With TIMER0_OVF the samples are taken at the beginning of every Timer0 PWM period (the rising edge
+ *    in Fast PWM mode, the middle of the low time in Phase Correct PWM mode), with TIMER0_COMP at the
+ *    falling edge of OC0.
+ * 3. The slots are converted in turn, one per trigger event: the ADC interrupt selects the channel of the
+ *    next slot for the next event. Each slot averages its Num_Of_Samples conversions into one result.
+ * 4. With Free_Running the first conversion is started here and the conversions follow each other,
+ *    only one slot can be used then (the next conversion starts before the channel can be changed).
+ */
+void ADC_StartScheduled(const ADC_SlotConfigType *Slots_Ptr, uint8 Num_Of_Slots)
+{
+	uint8 Slot;
+
+	ADC_StopTriggered();
+
+	if (Num_Of_Slots == 0)
+	{
+		return;
+	}
+	else if (Num_Of_Slots > ADC_MAX_SLOTS)
+	{
+		Num_Of_Slots = ADC_MAX_SLOTS;
+	}
+
+	for (Slot = 0; Slot < Num_Of_Slots; Slot++)
+	{
+		g_slots[Slot].Channel = Slots_Ptr[Slot].Channel;
+		g_slots[Slot].Samples_Per_Result = Slots_Ptr[Slot].Num_Of_Samples;
 
-	/* Clear ADIF by write '1' to it */
+		if (g_slots[Slot].Samples_Per_Result == 0)
+		{
+			g_slots[Slot].Samples_Per_Result = 1;
+		}
+		else if (g_slots[Slot].Samples_Per_Result > ADC_MAX_SAMPLES_PER_RESULT)
+		{
+			g_slots[Slot].Samples_Per_Result = ADC_MAX_SAMPLES_PER_RESULT;
+		}
+
+		g_slots[Slot].Sample_Count = 0;
+		g_slots[Slot].Sample_Sum = 0;
+		g_slots[Slot].Limit_Count = 0;
+		g_slots[Slot].Countdown = 0;
+		g_slots[Slot].Result_Ready = FALSE;
+		g_slots[Slot].Has_Result = FALSE;
+	}
+
+	g_numOfSlots = Num_Of_Slots;
+
+	/* Clear the old flags so the first conversion starts with the next trigger event */
 	SET_BIT(ADCSRA,ADIF);
+	if ((SFIOR >> 5) == TIMER0_OVF)
+	{
+		TIFR = (1 << TOV0);
+	}
+	else if ((SFIOR >> 5) == TIMER0_COMP)
+	{
+		TIFR = (1 << OCF0);
+	}
 
-	/* Read the digital value from the data register */
-	return ADC;
+	/* The first slot is always converted at the first trigger event */
+	SET_BIT(ADCSRA,ADIE);
+	ADC_PrepareTurn(0);
+
+	if ((SFIOR >> 5) == Free_Running)
+	{
+		SET_BIT(ADCSRA,ADSC);
+	}
+}
+
+/*
+ * Description:
+ * Start the hardware triggered sampling of one channel in slot 0 (a schedule of one slot).
+ */
+void ADC_StartTriggered(InputChannel_Select Channel_Select, uint8 Num_Of_Samples)
+{
+	ADC_SlotConfigType Slot_Config;
+
+	Slot_Config.Channel = Channel_Select;
+	Slot_Config.Num_Of_Samples = Num_Of_Samples;
+
+	ADC_StartScheduled(&Slot_Config, 1);
+}
+
+/*
+ * Description:
+ * Stop the hardware triggered sampling, the conversion in progress (if any) is completed.
+ */
+void ADC_StopTriggered(void)
+{
+	g_idleTurn = FALSE;
+	ADCSRA &= ~((1 << ADIE) | (1 << ADATE));
+	while(BIT_IS_SET(ADCSRA,ADSC));
+	SET_BIT(ADCSRA,ADIF);
+}
+
+/*
+ * Description:
+ * Return TRUE if a new result of the slot is ready since the last call of ADC_GetResult.
+ */
+boolean ADC_IsResultReady(uint8 Slot)
+{
+	return g_slots[Slot].Result_Ready;
+}
+
+/*
+ * Description:
+ * Return the latest averaged result of the slot.
+ * Wait only for the first result after the sampling is started, then never wait.
+ */
+uint16 ADC_GetResult(uint8 Slot)
+{
+	uint16 Result;
+
+	while (!g_slots[Slot].Has_Result);
+
+	/* The 16-bit result is written by the interrupt, read it atomically */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		Result = g_slots[Slot].Result;
+		g_slots[Slot].Result_Ready = FALSE;
+	}
+
+	return Result;
+}
+
+/*
+ * Description:
+ * Return the latest single conversion of the slot (not averaged), can be called from a call back.
+ */
+uint16 ADC_GetSample(uint8 Slot)
+{
+	uint16 Sample;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		Sample = g_slots[Slot].Sample;
+	}
+
+	return Sample;
+}
+
+/*
+ * Description:
+ * Return the last conversion of the ADC interrupt, whatever its slot (sequence snapshot, the interrupts are
+ * not disabled).
+ */
+uint16 ADC_GetLastValue(void)
+{
+	return ADC_ValueSnapshot_Load(&g_lastValue);
+}
+
+/*
+ * Description:
+ * Function to set the Call Back function address of a slot, it is called from the ADC interrupt each time
+ * a new result of the slot is ready.
+ */
+void ADC_SetCallBack(uint8 Slot, void(*a_ptr)(void))
+{
+	/* The 16-bit address is read by the interrupt */
+	uint8 Sreg = IsrSync_EnterCritical();
+
+	g_slots[Slot].CallBack_Ptr = a_ptr;
+	IsrSync_ExitCritical(Sreg);
+}
+
+/*
+ * Description:
+ * Set a limit checked on every single conversion of the slot at the beginning of the ADC interrupt, before
+ * the averaging: the call back is called when Num_Of_Samples consecutive conversions are >= Limit_Code,
+ * then once for each new conversion while the limit is still exceeded.
+ * It is the fast path of the safety functions, the call back must be short and constant time.
+ */
+void ADC_SetLimit(uint8 Slot, uint16 Limit_Code, uint8 Num_Of_Samples, void(*a_ptr)(void))
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_slots[Slot].Limit_Code = Limit_Code;
+		g_slots[Slot].Limit_Samples = (Num_Of_Samples == 0) ? 1 : Num_Of_Samples;
+		g_slots[Slot].Limit_Count = 0;
+		g_slots[Slot].Limit_CallBack_Ptr = a_ptr;
+	}
+}
+
+/*
+ * Description:
+ * Convert the slot only once every Interval of its turns in the schedule (1 = every turn, the default),
+ * the other turns of the slot are idle: the auto trigger is disabled for that trigger event, so there is
+ * no conversion and no ADC interrupt. The new interval is used from the next turn of the slot.
+ * The limit of the slot (ADC_SetLimit) is only checked on the conversions which are done.
+ * Only for a hardware trigger source (not Free_Running), ADC_Tick must be called from its interrupt.
+ */
+void ADC_SetInterval(uint8 Slot, uint8 Interval)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_slots[Slot].Interval = (Interval == 0) ? 1 : Interval;
+
+		if (g_slots[Slot].Countdown >= g_slots[Slot].Interval)
+		{
+			g_slots[Slot].Countdown = g_slots[Slot].Interval - 1;
+		}
+	}
+}
+
+/*
+ * Description:
+ * Return the interval of the slot set by ADC_SetInterval.
+ */
+uint8 ADC_GetInterval(uint8 Slot)
+{
+	return g_slots[Slot].Interval;
+}
+
+/*
+ * Description:
+ * Must be called from the interrupt of the trigger source (the Timer0 overflow interrupt for TIMER0_OVF)
+ * when a slot interval is more than 1: it ends an idle turn and prepares the turn of the next trigger event.
+ * The interrupt of the trigger source must be enabled so its flag is cleared by hardware, otherwise the
+ * re-enabled auto trigger never sees a rising edge of the flag. It does nothing during a conversion turn,
+ * and during an ADC_ReadChannel polling (the idle turn then lasts one more trigger event).
+ */
+void ADC_Tick(void)
+{
+	uint8 Next_Slot;
+
+	if (!g_idleTurn || g_pollActive)
+	{
+		return;
+	}
+
+	Next_Slot = g_currentSlot + 1;
+	if (Next_Slot >= g_numOfSlots)
+	{
+		Next_Slot = 0;
+	}
+
+	ADC_PrepareTurn(Next_Slot);
 }
@@ -15,12 +15,28 @@
 #define ADC_VOLTAGE_REF          2.56
 #define ADC_MAX_VALUE            1023
 
-/*******************************************************************************************
- *                                    External Variables                                   *
- *******************************************************************************************/
+/*
+ * Maximum number of hardware triggered samples averaged into one result by ADC_StartTriggered.
+ * The sum of the samples is kept in 16 bits: 64 * 1023 fits.
+ */
+#define ADC_MAX_SAMPLES_PER_RESULT   64
+
+/* Maximum number of channels converted in turn by the hardware triggered sampling */
+#define ADC_MAX_SLOTS                4
 
-/* Extern Public global variable to be used by other modules */
-extern volatile uint16 g_adcResult;
+/* Range of a differential conversion (10-bit two's complement result, see ADC_ToSigned) */
+#define ADC_DIFF_MIN_VALUE           (-512)
+#define ADC_DIFF_MAX_VALUE           511
+
+/*
+ * Settling time of the reference after ADC_SetReference: the internal 2.56V reference charges the
+ * AREF capacitor (100nF) through its ~32K output impedance, 5 time constants are 16ms.
+ */
+#define ADC_REFERENCE_SETTLING_MS    16
+
+/* Differential channels (positive input - negative input) and the channels of the gain stage */
+#define ADC_IS_DIFFERENTIAL(CHANNEL) (((CHANNEL) >= ADC0_ADC0_10X) && ((CHANNEL) <= ADC5_ADC2_1X))
+#define ADC_IS_GAIN_CHANNEL(CHANNEL) (((CHANNEL) >= ADC0_ADC0_10X) && ((CHANNEL) <= ADC3_ADC2_200X))
 
 /*******************************************************************************************
  *                                      Types Declaration                                  *
@@ -30,9 +46,20 @@ typedef enum
 	AREF, AVCC, Reversed, Internal_VREF
 }VoltageReference_Select;
 
+/*
+ * Values of MUX4:0 in ADMUX Register: the single ended channels, the differential channels named
+ * <positive input>_<negative input>_<gain>, the 1.22V bandgap and the ground.
+ * The differential channels are only guaranteed for the TQFP and MLF packages and need a
+ * reference between 2V and AVCC - 0.5V (the internal 2.56V one, not AVCC).
+ */
 typedef enum
 {
-	ADC0, ADC1, ADC2, ADC3, ADC4, ADC5, ADC6, ADC7
+	ADC0, ADC1, ADC2, ADC3, ADC4, ADC5, ADC6, ADC7,
+	ADC0_ADC0_10X, ADC1_ADC0_10X, ADC0_ADC0_200X, ADC1_ADC0_200X,
+	ADC2_ADC2_10X, ADC3_ADC2_10X, ADC2_ADC2_200X, ADC3_ADC2_200X,
+	ADC0_ADC1_1X, ADC1_ADC1_1X, ADC2_ADC1_1X, ADC3_ADC1_1X, ADC4_ADC1_1X, ADC5_ADC1_1X, ADC6_ADC1_1X, ADC7_ADC1_1X,
+	ADC0_ADC2_1X, ADC1_ADC2_1X, ADC2_ADC2_1X, ADC3_ADC2_1X, ADC4_ADC2_1X, ADC5_ADC2_1X,
+	ADC_VBG, ADC_GND
 }InputChannel_Select;
 
 typedef enum
@@ -52,6 +79,13 @@ typedef struct
 	ADC_AutoTriggerSource Trigger_Source;
 }ADC_ConfigType;
 
+/* One slot of the hardware triggered sampling schedule */
+typedef struct
+{
+	InputChannel_Select Channel;
+	uint8 Num_Of_Samples;
+}ADC_SlotConfigType;
+
 /****************************************************************************************
  *                                      Functions Prototypes                            *
  ****************************************************************************************/
@@ -75,8 +109,125 @@ void ADC_Init(const ADC_ConfigType *Config_Ptr);
  * 4. You can clear the flag by writing "One" or automatically by Hardware.
  * 5. return the ADC value.
  * 6. Polling Technique Activated!
+ * 7. When switching to a gain channel the first conversion is dropped (offset cancellation settling).
+ * The result of a differential channel is converted with ADC_ToSigned.
  */
 uint16 ADC_ReadChannel(InputChannel_Select Channel_Select);
 
+/*
+ * Description:
+ * Convert the result of a differential channel (10-bit two's complement) to a signed value
+ * from ADC_DIFF_MIN_VALUE to ADC_DIFF_MAX_VALUE.
+ */
+sint16 ADC_ToSigned(uint16 Digital_Value);
+
+/*
+ * Description:
+ * Change the voltage reference (bits 6 & 7 in ADMUX Register) and wait ADC_REFERENCE_SETTLING_MS if it changed.
+ * The reference is shared by all the channels: the results of the hardware triggered sampling are
+ * scaled with the new reference too.
+ */
+void ADC_SetReference(VoltageReference_Select Voltage_Ref);
+
+/*
+ * Description:
+ * Return the voltage reference in use.
+ */
+VoltageReference_Select ADC_GetReference(void);
+
+/*
+ * Description:
+ * Start the hardware triggered sampling of a schedule of channels with the Auto Trigger Source of ADC_Init.
+ * 1. Every trigger event starts a conversion without any CPU work, the sample and hold takes place
+ *    2 ADC clock cycles after the trigger so the samples are always taken at the same phase.
+ * 2. With TIMER0_OVF the samples are taken at the beginning of every Timer0 PWM period (the rising edge
+ *    in Fast PWM mode, the middle of the low time in Phase Correct PWM mode), with TIMER0_COMP at the
+ *    falling edge of OC0.
+ * 3. The slots are converted in turn, one per trigger event: the ADC interrupt selects the channel of the
+ *    next slot for the next event. Each slot averages its Num_Of_Samples conversions into one result.
+ * 4. With Free_Running the first conversion is started here and the conversions follow each other,
+ *    only one slot can be used then (the next conversion starts before the channel can be changed).
+ */
+void ADC_StartScheduled(const ADC_SlotConfigType *Slots_Ptr, uint8 Num_Of_Slots);
+
+/*
+ * Description:
+ * Start the hardware triggered sampling of one channel in slot 0 (a schedule of one slot).
+ */
+void ADC_StartTriggered(InputChannel_Select Channel_Select, uint8 Num_Of_Samples);
+
+/*
+ * Description:
+ * Stop the hardware triggered sampling, the conversion in progress (if any) is completed.
+ */
+void ADC_StopTriggered(void);
+
+/*
+ * Description:
+ * Return TRUE if a new result of the slot is ready since the last call of ADC_GetResult.
+ */
+boolean ADC_IsResultReady(uint8 Slot);
+
+/*
+ * Description:
+ * Return the latest averaged result of the slot.
+ * Wait only for the first result after the sampling is started, then never wait.
+ */
+uint16 ADC_GetResult(uint8 Slot);
+
+/*
+ * Description:
+ * Return the latest single conversion of the slot (not averaged), can be called from a call back.
+ */
+uint16 ADC_GetSample(uint8 Slot);
+
+/*
+ * Description:
+ * Return the last conversion of the ADC interrupt, whatever its slot (sequence snapshot, the interrupts are
+ * not disabled).
+ */
+uint16 ADC_GetLastValue(void);
+
+/*
+ * Description:
+ * Function to set the Call Back function address of a slot, it is called from the ADC interrupt each time
+ * a new result of the slot is ready.
+ */
+void ADC_SetCallBack(uint8 Slot, void(*a_ptr)(void));
+
+/*
+ * Description:
+ * Set a limit checked on every single conversion of the slot at the beginning of the ADC interrupt, before
+ * the averaging: the call back is called when Num_Of_Samples consecutive conversions are >= Limit_Code,
+ * then once for each new conversion while the limit is still exceeded.
+ * It is the fast path of the safety functions, the call back must be short and constant time.
+ */
+void ADC_SetLimit(uint8 Slot, uint16 Limit_Code, uint8 Num_Of_Samples, void(*a_ptr)(void));
+
+/*
+ * Description:
+ * Convert the slot only once every Interval of its turns in the schedule (1 = every turn, the default),
+ * the other turns of the slot are idle: the auto trigger is disabled for that trigger event, so there is
+ * no conversion and no ADC interrupt. The new interval is used from the next turn of the slot.
+ * The limit of the slot (ADC_SetLimit) is only checked on the conversions which are done.
+ * Only for a hardware trigger source (not Free_Running), ADC_Tick must be called from its interrupt.
+ */
+void ADC_SetInterval(uint8 Slot, uint8 Interval);
+
+/*
+ * Description:
+ * Return the interval of the slot set by ADC_SetInterval.
+ */
+uint8 ADC_GetInterval(uint8 Slot);
+
+/*
+ * Description:
+ * Must be called from the interrupt of the trigger source (the Timer0 overflow interrupt for TIMER0_OVF)
+ * when a slot interval is more than 1: it ends an idle turn and prepares the turn of the next trigger event.
+ * The interrupt of the trigger source must be enabled so its flag is cleared by hardware, otherwise the
+ * re-enabled auto trigger never sees a rising edge of the flag. It does nothing during a conversion turn,
+ * and during an ADC_ReadChannel polling (the idle turn then lasts one more trigger event).
+ */
+void ADC_Tick(void);
 
 #endif /* ADC_H_ */
@@ -0,0 +1,148 @@
+/*******************************************************************************************************************
+ * File Name: Auto_Range.c
+ * Date: 19/10/2026
+ * Driver: ADC Auto Ranging (Reference and Gain Selection) Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Auto_Range.h"
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+static const AutoRange_RangeConfigType *g_ranges = NULL_PTR;
+static uint8 g_numOfRanges = 0;
+
+/* Range in use and its offset in codes */
+static uint8 g_range = 0;
+static sint16 g_offset = 0;
+
+/****************************************************************************************
+ *                                   Private Functions Definitions                      *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Convert a channel, the differential results are sign extended.
+ */
+static sint16 AutoRange_Convert(InputChannel_Select Channel)
+{
+	uint16 Digital_Value = ADC_ReadChannel(Channel);
+
+	if (ADC_IS_DIFFERENTIAL(Channel))
+	{
+		return ADC_ToSigned(Digital_Value);
+	}
+
+	return (sint16)Digital_Value;
+}
+
+/*
+ * Description:
+ * Select a range: the reference first (waiting its settling), then the offset of the range.
+ */
+static void AutoRange_Select(uint8 Range)
+{
+	const AutoRange_RangeConfigType *Range_Ptr = &g_ranges[Range];
+
+	g_range = Range;
+	ADC_SetReference(Range_Ptr -> Voltage_Ref);
+	g_offset = AutoRange_Convert(Range_Ptr -> Offset_Channel);
+}
+
+/*
+ * Description:
+ * Scale a code of a range (offset removed) to 1/16 of a single ended 2.56V step.
+ */
+static sint32 AutoRange_Scale(const AutoRange_RangeConfigType *Range_Ptr, sint16 Code)
+{
+	return ((sint32)Code * ((sint32)Range_Ptr -> Scale_Numerator << AUTO_RANGE_FRACTION_BITS)) / Range_Ptr -> Scale_Denominator;
+}
+
+/*
+ * Description:
+ * Return TRUE if the reading gives a code of the range far enough from its limits.
+ */
+static boolean AutoRange_Fits(const AutoRange_RangeConfigType *Range_Ptr, sint32 Reading)
+{
+	sint32 Code = (Reading * Range_Ptr -> Scale_Denominator) / ((sint32)Range_Ptr -> Scale_Numerator << AUTO_RANGE_FRACTION_BITS);
+
+	return ((Code >= (sint32)Range_Ptr -> Min_Code + AUTO_RANGE_HYSTERESIS_CODES) &&
+			(Code <= (sint32)Range_Ptr -> Max_Code - AUTO_RANGE_HYSTERESIS_CODES)) ? TRUE : FALSE;
+}
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Set the table of ranges, ordered from the finest to the coarsest, the coarsest one is selected first.
+ * The table must stay valid (a const table).
+ */
+void AutoRange_Init(const AutoRange_RangeConfigType *Ranges_Ptr, uint8 Num_Of_Ranges)
+{
+	g_ranges = Ranges_Ptr;
+	g_numOfRanges = Num_Of_Ranges;
+
+	if (Num_Of_Ranges != 0)
+	{
+		AutoRange_Select(Num_Of_Ranges - 1);
+	}
+}
+
+/*
+ * Description:
+ * Read the input (polling, ADC_ReadChannel) and return it in 1/16 of a single ended 2.56V step.
+ * 1. A saturated conversion selects the next coarser range and converts again.
+ * 2. When the reading fits in the next finer range with AUTO_RANGE_HYSTERESIS_CODES of margin, the finer
+ *    range is selected and converts again, but never back and forth in the same call.
+ * 3. Entering a range waits the reference settling (ADC_SetReference) if the reference changes, then
+ *    measures the offset of the range once, subtracted from all its conversions.
+ * The settling is a busy wait of ADC_REFERENCE_SETTLING_MS: the ranges read from a loop with a time budget
+ * must all use the same reference.
+ */
+sint32 AutoRange_Read(void)
+{
+	const AutoRange_RangeConfigType *Range_Ptr;
+	boolean Moved_Coarser = FALSE;
+	boolean Saturated;
+	sint32 Reading;
+	sint16 Code;
+
+	if (g_numOfRanges == 0)
+	{
+		return 0;
+	}
+
+	while (1)
+	{
+		Range_Ptr = &g_ranges[g_range];
+		Code = AutoRange_Convert(Range_Ptr -> Channel);
+		Saturated = ((Code <= Range_Ptr -> Min_Code) || (Code >= Range_Ptr -> Max_Code)) ? TRUE : FALSE;
+		Reading = AutoRange_Scale(Range_Ptr, Code - g_offset);
+
+		if (Saturated && (g_range < g_numOfRanges - 1))
+		{
+			AutoRange_Select(g_range + 1);
+			Moved_Coarser = TRUE;
+		}
+		else if (!Saturated && !Moved_Coarser && (g_range > 0) && AutoRange_Fits(&g_ranges[g_range - 1], Reading))
+		{
+			AutoRange_Select(g_range - 1);
+		}
+		else
+		{
+			return Reading;
+		}
+	}
+}
+
+/*
+ * Description:
+ * Return the index of the range of the last reading in the table.
+ */
+uint8 AutoRange_GetRange(void)
+{
+	return g_range;
+}
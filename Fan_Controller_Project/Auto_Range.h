@@ -0,0 +1,78 @@
+/*******************************************************************************************************************
+ * File Name: Auto_Range.h
+ * Date: 19/10/2026
+ * Driver: ADC Auto Ranging (Reference and Gain Selection) Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+#include "ADC.h"
+
+#ifndef AUTO_RANGE_H_
+#define AUTO_RANGE_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/*
+ * The readings of all the ranges are given in the same unit: 1/16 of the step of a single ended
+ * conversion with the 2.56V reference (2.5mV / 16), so the caller never depends on the range in use.
+ */
+#define AUTO_RANGE_FRACTION_BITS                   4
+
+/* A finer range is only selected when the reading is this number of its codes away from its limits */
+#define AUTO_RANGE_HYSTERESIS_CODES                32
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+/*
+ * One range: the reference and the channel (single ended, or differential with or without gain),
+ * the channel which gives the offset of the range (the negative input shorted to itself, or ADC_GND),
+ * the codes from which the conversion is saturated, and the size of a step relative to the step of a
+ * single ended conversion with the 2.56V reference (Scale_Numerator / Scale_Denominator):
+ * single ended 2.56V: 1/1, AVCC (5V): 125/64, differential 1x: 2/1, 10x: 1/5, 200x: 1/100.
+ */
+typedef struct
+{
+	VoltageReference_Select Voltage_Ref;
+	InputChannel_Select Channel;
+	InputChannel_Select Offset_Channel;
+	sint16 Min_Code;
+	sint16 Max_Code;
+	uint8 Scale_Numerator;
+	uint8 Scale_Denominator;
+}AutoRange_RangeConfigType;
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Set the table of ranges, ordered from the finest to the coarsest, the coarsest one is selected first.
+ * The table must stay valid (a const table).
+ */
+void AutoRange_Init(const AutoRange_RangeConfigType *Ranges_Ptr, uint8 Num_Of_Ranges);
+
+/*
+ * Description:
+ * Read the input (polling, ADC_ReadChannel) and return it in 1/16 of a single ended 2.56V step.
+ * 1. A saturated conversion selects the next coarser range and converts again.
+ * 2. When the reading fits in the next finer range with AUTO_RANGE_HYSTERESIS_CODES of margin, the finer
+ *    range is selected and converts again, but never back and forth in the same call.
+ * 3. Entering a range waits the reference settling (ADC_SetReference) if the reference changes, then
+ *    measures the offset of the range once, subtracted from all its conversions.
+ * The settling is a busy wait of ADC_REFERENCE_SETTLING_MS: the ranges read from a loop with a time budget
+ * must all use the same reference.
+ */
+sint32 AutoRange_Read(void);
+
+/*
+ * Description:
+ * Return the index of the range of the last reading in the table.
+ */
+uint8 AutoRange_GetRange(void);
+
+#endif /* AUTO_RANGE_H_ */
@@ -0,0 +1,69 @@
+/*******************************************************************************************************************
+ * File Name: CRC.h
+ * Date: 19/10/2026
+ * Driver: Cyclic Redundancy Check (CRC) Utility Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+
+#ifndef CRC_H_
+#define CRC_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/* CRC-16/CCITT-FALSE: Polynomial x^16 + x^12 + x^5 + 1, Initial value 0xFFFF */
+#define CRC16_CCITT_POLYNOMIAL                     0x1021
+#define CRC16_CCITT_INITIAL_VALUE                  0xFFFF
+
+/* CRC-16/MODBUS: Polynomial x^16 + x^15 + x^2 + 1 (reflected 0xA001), Initial value 0xFFFF */
+#define CRC16_MODBUS_REFLECTED_POLYNOMIAL          0xA001
+#define CRC16_MODBUS_INITIAL_VALUE                 0xFFFF
+
+/* CRC-8/MAXIM (Dallas 1-Wire): Polynomial x^8 + x^5 + x^4 + 1 (reflected 0x8C), Initial value 0x00 */
+#define CRC8_MAXIM_REFLECTED_POLYNOMIAL            0x8C
+#define CRC8_MAXIM_INITIAL_VALUE                   0x00
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Update the CRC-16/CCITT value with one more byte.
+ */
+uint16 CRC16_CCITT_Update(uint16 Crc, uint8 Data);
+
+/*
+ * Description:
+ * Calculate the CRC-16/CCITT of a block of bytes.
+ */
+uint16 CRC16_CCITT_Calculate(const uint8 *Data_Ptr, uint16 Length);
+
+/*
+ * Description:
+ * Update the CRC-16/MODBUS value with one more byte (table driven).
+ */
+uint16 CRC16_MODBUS_Update(uint16 Crc, uint8 Data);
+
+/*
+ * Description:
+ * Calculate the CRC-16/MODBUS of a block of bytes, it is sent low byte first after the frame.
+ * The CRC of a frame followed by its CRC is 0.
+ */
+uint16 CRC16_MODBUS_Calculate(const uint8 *Data_Ptr, uint16 Length);
+
+/*
+ * Description:
+ * Update the CRC-8/MAXIM value with one more byte.
+ */
+uint8 CRC8_MAXIM_Update(uint8 Crc, uint8 Data);
+
+/*
+ * Description:
+ * Calculate the CRC-8/MAXIM of a block of bytes.
+ */
+uint8 CRC8_MAXIM_Calculate(const uint8 *Data_Ptr, uint16 Length);
+
+#endif /* CRC_H_ */
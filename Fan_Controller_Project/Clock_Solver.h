@@ -0,0 +1,177 @@
+/*******************************************************************************************************************
+ * File Name: Clock_Solver.h
+ * Date: 19/10/2026
+ * Driver: Compile Time Clock and Prescaler Solver (ADC - Timer0 PWM) Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "ADC.h"
+#include "TIMER0.h"
+
+#ifndef CLOCK_SOLVER_H_
+#define CLOCK_SOLVER_H_
+
+/*
+ * The prescalers of the ADC and of the Timer0 PWM are derived from F_CPU and from the targets below
+ * by the preprocessor, so changing F_CPU (or a target) is enough to get the right register values.
+ * The build fails with #error if no prescaler meets the requirement at this clock frequency.
+ * Only integer arithmetic without casts is used so every macro can also be tested in #if.
+ */
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+#ifndef F_CPU
+#define F_CPU 1000000UL
+#endif
+
+/* The ADC needs an input clock between 50kHz and 200kHz to get the full 10-bit resolution */
+#define CLOCK_SOLVER_ADC_MIN_HZ                    50000UL
+#define CLOCK_SOLVER_ADC_MAX_HZ                    200000UL
+
+/* Required frequency of the Timer0 (OC0) motor PWM and the accepted error in percent */
+#define CLOCK_SOLVER_TIMER0_PWM_HZ                 500UL
+#define CLOCK_SOLVER_TIMER0_TOLERANCE_PERCENT      5UL
+
+/* Number of timer clocks in one PWM period: Fast PWM counts 0..255, Phase Correct PWM counts up then down */
+#define CLOCK_SOLVER_FAST_PWM_STEPS                256UL
+#define CLOCK_SOLVER_PHASE_CORRECT_PWM_STEPS       510UL
+
+#define CLOCK_SOLVER_ABS_DIFF(A, B)                (((A) > (B)) ? ((A) - (B)) : ((B) - (A)))
+
+/****************************************************************************************
+ *                                       ADC Clock                                      *
+ ****************************************************************************************/
+
+/* Division factor of an ADC_ClockSelect value (CLK_2A and CLK2B both divide by 2) */
+#define CLOCK_SOLVER_ADC_DIVISION_OF(Clock_Select) (((Clock_Select) == 0) ? 2UL : (1UL << (Clock_Select)))
+
+/* Smallest division (fastest ADC clock, shortest conversion) which does not exceed the maximum frequency */
+#if (F_CPU / 2UL) <= CLOCK_SOLVER_ADC_MAX_HZ
+#define CLOCK_SOLVER_ADC_DIVISION                  2UL
+#define CLOCK_SOLVER_ADC_PRESCALAR                 CLK2B
+#elif (F_CPU / 4UL) <= CLOCK_SOLVER_ADC_MAX_HZ
+#define CLOCK_SOLVER_ADC_DIVISION                  4UL
+#define CLOCK_SOLVER_ADC_PRESCALAR                 CLK_4
+#elif (F_CPU / 8UL) <= CLOCK_SOLVER_ADC_MAX_HZ
+#define CLOCK_SOLVER_ADC_DIVISION                  8UL
+#define CLOCK_SOLVER_ADC_PRESCALAR                 CLK_8
+#elif (F_CPU / 16UL) <= CLOCK_SOLVER_ADC_MAX_HZ
+#define CLOCK_SOLVER_ADC_DIVISION                  16UL
+#define CLOCK_SOLVER_ADC_PRESCALAR                 CLK_16
+#elif (F_CPU / 32UL) <= CLOCK_SOLVER_ADC_MAX_HZ
+#define CLOCK_SOLVER_ADC_DIVISION                  32UL
+#define CLOCK_SOLVER_ADC_PRESCALAR                 CLK_32
+#elif (F_CPU / 64UL) <= CLOCK_SOLVER_ADC_MAX_HZ
+#define CLOCK_SOLVER_ADC_DIVISION                  64UL
+#define CLOCK_SOLVER_ADC_PRESCALAR                 CLK_64
+#else
+#define CLOCK_SOLVER_ADC_DIVISION                  128UL
+#define CLOCK_SOLVER_ADC_PRESCALAR                 CLK_128
+#endif
+
+#define CLOCK_SOLVER_ADC_CLOCK_HZ                  (F_CPU / CLOCK_SOLVER_ADC_DIVISION)
+
+#if (CLOCK_SOLVER_ADC_CLOCK_HZ > CLOCK_SOLVER_ADC_MAX_HZ) || (CLOCK_SOLVER_ADC_CLOCK_HZ < CLOCK_SOLVER_ADC_MIN_HZ)
+#error "No ADC prescaler gives an ADC clock within CLOCK_SOLVER_ADC_MIN_HZ..CLOCK_SOLVER_ADC_MAX_HZ at this F_CPU"
+#endif
+
+/****************************************************************************************
+ *                                    Timer0 PWM Clock                                  *
+ ****************************************************************************************/
+
+#define CLOCK_SOLVER_TIMER0_FREQUENCY_OF(Division, Steps)  (F_CPU / ((Division) * (Steps)))
+#define CLOCK_SOLVER_TIMER0_ERROR_OF(Division, Steps)      \
+	CLOCK_SOLVER_ABS_DIFF(CLOCK_SOLVER_TIMER0_FREQUENCY_OF(Division, Steps), CLOCK_SOLVER_TIMER0_PWM_HZ)
+
+/*
+ * Try every prescaler in both PWM modes and keep the closest frequency.
+ * On a tie the Fast PWM mode and the smallest prescaler are kept (tried first).
+ */
+#define CLOCK_SOLVER_TIMER0_DIVISION               1UL
+#define CLOCK_SOLVER_TIMER0_STEPS                  CLOCK_SOLVER_FAST_PWM_STEPS
+
+#if CLOCK_SOLVER_TIMER0_ERROR_OF(8UL, CLOCK_SOLVER_FAST_PWM_STEPS) < \
+	CLOCK_SOLVER_TIMER0_ERROR_OF(CLOCK_SOLVER_TIMER0_DIVISION, CLOCK_SOLVER_TIMER0_STEPS)
+#undef CLOCK_SOLVER_TIMER0_DIVISION
+#define CLOCK_SOLVER_TIMER0_DIVISION               8UL
+#endif
+#if CLOCK_SOLVER_TIMER0_ERROR_OF(64UL, CLOCK_SOLVER_FAST_PWM_STEPS) < \
+	CLOCK_SOLVER_TIMER0_ERROR_OF(CLOCK_SOLVER_TIMER0_DIVISION, CLOCK_SOLVER_TIMER0_STEPS)
+#undef CLOCK_SOLVER_TIMER0_DIVISION
+#define CLOCK_SOLVER_TIMER0_DIVISION               64UL
+#endif
+#if CLOCK_SOLVER_TIMER0_ERROR_OF(256UL, CLOCK_SOLVER_FAST_PWM_STEPS) < \
+	CLOCK_SOLVER_TIMER0_ERROR_OF(CLOCK_SOLVER_TIMER0_DIVISION, CLOCK_SOLVER_TIMER0_STEPS)
+#undef CLOCK_SOLVER_TIMER0_DIVISION
+#define CLOCK_SOLVER_TIMER0_DIVISION               256UL
+#endif
+#if CLOCK_SOLVER_TIMER0_ERROR_OF(1024UL, CLOCK_SOLVER_FAST_PWM_STEPS) < \
+	CLOCK_SOLVER_TIMER0_ERROR_OF(CLOCK_SOLVER_TIMER0_DIVISION, CLOCK_SOLVER_TIMER0_STEPS)
+#undef CLOCK_SOLVER_TIMER0_DIVISION
+#define CLOCK_SOLVER_TIMER0_DIVISION               1024UL
+#endif
+#if CLOCK_SOLVER_TIMER0_ERROR_OF(1UL, CLOCK_SOLVER_PHASE_CORRECT_PWM_STEPS) < \
+	CLOCK_SOLVER_TIMER0_ERROR_OF(CLOCK_SOLVER_TIMER0_DIVISION, CLOCK_SOLVER_TIMER0_STEPS)
+#undef CLOCK_SOLVER_TIMER0_DIVISION
+#undef CLOCK_SOLVER_TIMER0_STEPS
+#define CLOCK_SOLVER_TIMER0_DIVISION               1UL
+#define CLOCK_SOLVER_TIMER0_STEPS                  CLOCK_SOLVER_PHASE_CORRECT_PWM_STEPS
+#endif
+#if CLOCK_SOLVER_TIMER0_ERROR_OF(8UL, CLOCK_SOLVER_PHASE_CORRECT_PWM_STEPS) < \
+	CLOCK_SOLVER_TIMER0_ERROR_OF(CLOCK_SOLVER_TIMER0_DIVISION, CLOCK_SOLVER_TIMER0_STEPS)
+#undef CLOCK_SOLVER_TIMER0_DIVISION
+#undef CLOCK_SOLVER_TIMER0_STEPS
+#define CLOCK_SOLVER_TIMER0_DIVISION               8UL
+#define CLOCK_SOLVER_TIMER0_STEPS                  CLOCK_SOLVER_PHASE_CORRECT_PWM_STEPS
+#endif
+#if CLOCK_SOLVER_TIMER0_ERROR_OF(64UL, CLOCK_SOLVER_PHASE_CORRECT_PWM_STEPS) < \
+	CLOCK_SOLVER_TIMER0_ERROR_OF(CLOCK_SOLVER_TIMER0_DIVISION, CLOCK_SOLVER_TIMER0_STEPS)
+#undef CLOCK_SOLVER_TIMER0_DIVISION
+#undef CLOCK_SOLVER_TIMER0_STEPS
+#define CLOCK_SOLVER_TIMER0_DIVISION               64UL
+#define CLOCK_SOLVER_TIMER0_STEPS                  CLOCK_SOLVER_PHASE_CORRECT_PWM_STEPS
+#endif
+#if CLOCK_SOLVER_TIMER0_ERROR_OF(256UL, CLOCK_SOLVER_PHASE_CORRECT_PWM_STEPS) < \
+	CLOCK_SOLVER_TIMER0_ERROR_OF(CLOCK_SOLVER_TIMER0_DIVISION, CLOCK_SOLVER_TIMER0_STEPS)
+#undef CLOCK_SOLVER_TIMER0_DIVISION
+#undef CLOCK_SOLVER_TIMER0_STEPS
+#define CLOCK_SOLVER_TIMER0_DIVISION               256UL
+#define CLOCK_SOLVER_TIMER0_STEPS                  CLOCK_SOLVER_PHASE_CORRECT_PWM_STEPS
+#endif
+#if CLOCK_SOLVER_TIMER0_ERROR_OF(1024UL, CLOCK_SOLVER_PHASE_CORRECT_PWM_STEPS) < \
+	CLOCK_SOLVER_TIMER0_ERROR_OF(CLOCK_SOLVER_TIMER0_DIVISION, CLOCK_SOLVER_TIMER0_STEPS)
+#undef CLOCK_SOLVER_TIMER0_DIVISION
+#undef CLOCK_SOLVER_TIMER0_STEPS
+#define CLOCK_SOLVER_TIMER0_DIVISION               1024UL
+#define CLOCK_SOLVER_TIMER0_STEPS                  CLOCK_SOLVER_PHASE_CORRECT_PWM_STEPS
+#endif
+
+#define CLOCK_SOLVER_TIMER0_PWM_ACTUAL_HZ          \
+	CLOCK_SOLVER_TIMER0_FREQUENCY_OF(CLOCK_SOLVER_TIMER0_DIVISION, CLOCK_SOLVER_TIMER0_STEPS)
+
+#if (CLOCK_SOLVER_TIMER0_ERROR_OF(CLOCK_SOLVER_TIMER0_DIVISION, CLOCK_SOLVER_TIMER0_STEPS) * 100UL) > \
+	(CLOCK_SOLVER_TIMER0_PWM_HZ * CLOCK_SOLVER_TIMER0_TOLERANCE_PERCENT)
+#error "No Timer0 prescaler/PWM mode gives CLOCK_SOLVER_TIMER0_PWM_HZ within CLOCK_SOLVER_TIMER0_TOLERANCE_PERCENT at this F_CPU"
+#endif
+
+/* The solved values as driver configuration enums */
+#if CLOCK_SOLVER_TIMER0_STEPS == CLOCK_SOLVER_FAST_PWM_STEPS
+#define CLOCK_SOLVER_TIMER0_MODE                   Fast_PWM_3
+#else
+#define CLOCK_SOLVER_TIMER0_MODE                   PhaseCorrect_PWM_1
+#endif
+
+#if CLOCK_SOLVER_TIMER0_DIVISION == 1UL
+#define CLOCK_SOLVER_TIMER0_PRESCALAR              Prescaler_1
+#elif CLOCK_SOLVER_TIMER0_DIVISION == 8UL
+#define CLOCK_SOLVER_TIMER0_PRESCALAR              Prescaler_8
+#elif CLOCK_SOLVER_TIMER0_DIVISION == 64UL
+#define CLOCK_SOLVER_TIMER0_PRESCALAR              Prescaler_64
+#elif CLOCK_SOLVER_TIMER0_DIVISION == 256UL
+#define CLOCK_SOLVER_TIMER0_PRESCALAR              Prescaler_256
+#else
+#define CLOCK_SOLVER_TIMER0_PRESCALAR              Prescaler_1024
+#endif
+
+#endif /* CLOCK_SOLVER_H_ */
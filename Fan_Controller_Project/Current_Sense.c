@@ -0,0 +1,224 @@
+/*******************************************************************************************************************
+ * File Name: Current_Sense.c
+ * Date: 19/10/2026
+ * Driver: Motor Current Sensing and Overcurrent Cutoff Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include <util/atomic.h>
+#include "DC_Motor.h"
+#include "Isr_Sync.h"
+#include "Clock_Solver.h"
+#include "Sys_Time.h"
+#include "Current_Sense.h"
+
+#if (DC_MOTOR_PWM_BACKEND != DC_MOTOR_PWM_TIMER0)
+
+#error "The current is sampled at the Timer0 overflow, it needs the Timer0 motor PWM back end"
+
+#endif
+
+#if (CLOCK_SOLVER_TIMER0_STEPS != CLOCK_SOLVER_FAST_PWM_STEPS)
+
+#error "The current is sampled right after the Timer0 overflow, the high time of the Fast PWM mode only"
+
+#endif
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/*
+ * The sample and hold takes place 2 ADC clocks after the trigger: with a shorter high time the sample is
+ * taken after the bridge is off and the current is unknown (it is small anyway).
+ */
+#define CURRENT_SENSE_MIN_HIGH_TICKS               (((2UL * CLOCK_SOLVER_ADC_DIVISION) / CLOCK_SOLVER_TIMER0_DIVISION) + 1)
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+static uint16 g_averageLimitCode;
+
+ISR_SYNC_SNAPSHOT_DEFINE(CurrentSense_CodeSnapshot, uint16)
+
+/* Last samples: the current while the motor is driven and the average over the period (ADC codes) */
+static CurrentSense_CodeSnapshot_Type g_peakCode;
+static CurrentSense_CodeSnapshot_Type g_averageCode;
+static volatile uint8 g_averageCount = 0;
+
+static volatile CurrentSense_TripType g_lastTrip = CURRENT_SENSE_NO_TRIP;
+static volatile uint8 g_tripCount = 0;
+static volatile boolean g_tripPending = FALSE;
+
+/* Retry back off, handled by CurrentSense_Task */
+static uint32 g_backoff_ms = CURRENT_SENSE_RETRY_MIN_MS;
+static uint32 g_tripTime_ms = 0;
+static uint32 g_releaseTime_ms = 0;
+
+/****************************************************************************************
+ *                                      Interrupt Call Backs                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Cut the motor off first, then record the trip for CurrentSense_Task.
+ */
+static void CurrentSense_Trip(CurrentSense_TripType Trip)
+{
+	DcMotor_Cutoff();
+
+	g_lastTrip = Trip;
+	g_tripPending = TRUE;
+	g_averageCount = 0;
+	if (g_tripCount < 0xFF)
+	{
+		g_tripCount++;
+	}
+}
+
+/*
+ * Description:
+ * ADC limit call back of the shunt slot: peak current.
+ */
+static void CurrentSense_PeakTrip(void)
+{
+	if (!DcMotor_IsCutOff())
+	{
+		CurrentSense_Trip(CURRENT_SENSE_PEAK_TRIP);
+	}
+}
+
+/*
+ * Description:
+ * ADC result call back of the shunt slot: average current over the PWM period.
+ * The high time is (compare + 1) of the 256 Timer0 steps, the multiplications avoid any division here.
+ */
+static void CurrentSense_SampleReady(void)
+{
+	uint16 Code = ADC_GetSample(CURRENT_SENSE_ADC_SLOT);
+	uint16 High_Ticks = DcMotor_GetOutputCompare() + 1;
+
+	if (DcMotor_IsCutOff() || (High_Ticks < CURRENT_SENSE_MIN_HIGH_TICKS))
+	{
+		CurrentSense_CodeSnapshot_Store(&g_peakCode, 0);
+		CurrentSense_CodeSnapshot_Store(&g_averageCode, 0);
+		g_averageCount = 0;
+		return;
+	}
+
+	CurrentSense_CodeSnapshot_Store(&g_peakCode, Code);
+	CurrentSense_CodeSnapshot_Store(&g_averageCode, (uint16)(((uint32)Code * High_Ticks) >> 8));
+
+	if (g_averageCode.Value >= g_averageLimitCode)
+	{
+		g_averageCount++;
+		if (g_averageCount >= CURRENT_SENSE_AVERAGE_CONFIRM_SAMPLES)
+		{
+			CurrentSense_Trip(CURRENT_SENSE_AVERAGE_TRIP);
+		}
+	}
+	else
+	{
+		g_averageCount = 0;
+	}
+}
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the current sensing (after DcMotor_Init, ADC_StartScheduled with the shunt channel
+ * in CURRENT_SENSE_ADC_SLOT and SysTime_Init).
+ * 1. Set the peak limit of the slot, checked on every conversion before any other processing.
+ * 2. Register the slot call back which checks the average current.
+ */
+void CurrentSense_Init(void)
+{
+	g_averageLimitCode = CURRENT_SENSE_MA_TO_CODE(CURRENT_SENSE_AVERAGE_LIMIT_MA);
+	g_backoff_ms = CURRENT_SENSE_RETRY_MIN_MS;
+
+	ADC_SetLimit(CURRENT_SENSE_ADC_SLOT, CURRENT_SENSE_MA_TO_CODE(CURRENT_SENSE_PEAK_LIMIT_MA), 1, CurrentSense_PeakTrip);
+	ADC_SetCallBack(CURRENT_SENSE_ADC_SLOT, CurrentSense_SampleReady);
+}
+
+/*
+ * Description:
+ * Periodic task called from the main loop: release the cutoff when the back off time is elapsed.
+ */
+void CurrentSense_Task(void)
+{
+	uint32 Now_ms = SysTime_GetMilliseconds();
+	boolean Trip_Pending;
+	boolean Cut_Off;
+
+	/* A trip after this block is seen by the next call, it cannot be released by this one */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		Trip_Pending = g_tripPending;
+		g_tripPending = FALSE;
+		Cut_Off = DcMotor_IsCutOff();
+	}
+
+	if (Trip_Pending)
+	{
+		g_tripTime_ms = Now_ms;
+	}
+
+	if (Cut_Off)
+	{
+		if ((Now_ms - g_tripTime_ms) >= g_backoff_ms)
+		{
+			/* Retry, the next trip waits twice as long */
+			g_backoff_ms = (g_backoff_ms * 2 > CURRENT_SENSE_RETRY_MAX_MS) ? CURRENT_SENSE_RETRY_MAX_MS : (g_backoff_ms * 2);
+			g_releaseTime_ms = Now_ms;
+			DcMotor_ReleaseCutoff();
+		}
+	}
+	else if ((g_backoff_ms != CURRENT_SENSE_RETRY_MIN_MS) && ((Now_ms - g_releaseTime_ms) >= CURRENT_SENSE_RETRY_RESET_MS))
+	{
+		/* The motor runs normally again */
+		g_backoff_ms = CURRENT_SENSE_RETRY_MIN_MS;
+	}
+}
+
+/*
+ * Description:
+ * Return the current of the last sample while the bridge drives the motor, in mA.
+ */
+uint16 CurrentSense_GetPeak_mA(void)
+{
+	uint16 Code = CurrentSense_CodeSnapshot_Load(&g_peakCode);
+
+	return (uint16)(((uint32)Code * 1000UL * CURRENT_SENSE_VREF_MV) / (CURRENT_SENSE_MV_PER_AMP * ADC_MAX_VALUE));
+}
+
+/*
+ * Description:
+ * Return the average current over the PWM period of the last sample, in mA.
+ */
+uint16 CurrentSense_GetAverage_mA(void)
+{
+	uint16 Code = CurrentSense_CodeSnapshot_Load(&g_averageCode);
+
+	return (uint16)(((uint32)Code * 1000UL * CURRENT_SENSE_VREF_MV) / (CURRENT_SENSE_MV_PER_AMP * ADC_MAX_VALUE));
+}
+
+/*
+ * Description:
+ * Return the cause of the last trip (CURRENT_SENSE_NO_TRIP if the motor never tripped).
+ */
+CurrentSense_TripType CurrentSense_GetLastTrip(void)
+{
+	return g_lastTrip;
+}
+
+/*
+ * Description:
+ * Return the number of trips since startup (saturates at 255).
+ */
+uint8 CurrentSense_GetTripCount(void)
+{
+	return g_tripCount;
+}
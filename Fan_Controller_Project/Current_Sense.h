@@ -0,0 +1,126 @@
+/*******************************************************************************************************************
+ * File Name: Current_Sense.h
+ * Date: 19/10/2026
+ * Driver: Motor Current Sensing and Overcurrent Cutoff Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+#include "ADC.h"
+#include "GPIO.h"
+#include "LCD.h"
+
+#ifndef CURRENT_SENSE_H_
+#define CURRENT_SENSE_H_
+
+/*
+ * The voltage of a low side shunt (amplified) is converted in the ADC schedule right after every other
+ * Timer0 overflow, at the beginning of the high time of the Fast PWM: the sample is the current while
+ * the bridge drives the motor. The average current over the PWM period is this current times the duty cycle.
+ * Both checks run in the ADC interrupt and cut the motor off at once (DcMotor_Cutoff):
+ * 1. Peak: a single sample above CURRENT_SENSE_PEAK_LIMIT_MA (stalled rotor, short circuit).
+ * 2. Average: CURRENT_SENSE_AVERAGE_CONFIRM_SAMPLES consecutive averages above CURRENT_SENSE_AVERAGE_LIMIT_MA.
+ * CurrentSense_Task retries after a back off time which doubles after each trip (up to CURRENT_SENSE_RETRY_MAX_MS)
+ * and goes back to CURRENT_SENSE_RETRY_MIN_MS once the motor runs for CURRENT_SENSE_RETRY_RESET_MS.
+ */
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/*
+ * Spare PORTA pin of the shunt amplifier (its single ended ADC channel has the same number) and its slot in the
+ * ADC schedule (the LM35 is in slot 0). PA3..PA6 are the LCD data pins in LCD_BIT_MODE 4.
+ */
+#ifndef CURRENT_SENSE_PIN
+#define CURRENT_SENSE_PIN                          PIN7_ID
+#endif
+
+#define CURRENT_SENSE_CHANNEL                      ((InputChannel_Select)CURRENT_SENSE_PIN)
+#define CURRENT_SENSE_ADC_SLOT                     1
+
+#if ((LCD_BIT_MODE == 4) && (LCD_DATA_PORT == PORTA_ID) && \
+		((CURRENT_SENSE_PIN == LCD_DB4_PIN_ID) || (CURRENT_SENSE_PIN == LCD_DB5_PIN_ID) || \
+		 (CURRENT_SENSE_PIN == LCD_DB6_PIN_ID) || (CURRENT_SENSE_PIN == LCD_DB7_PIN_ID)))
+
+#error "CURRENT_SENSE_PIN is an LCD data pin in LCD_BIT_MODE 4, move the shunt to a free ADC pin"
+
+#endif
+
+/* Shunt resistance times amplifier gain: 0.1 ohm x 10 = 1000mV per Ampere */
+#define CURRENT_SENSE_MV_PER_AMP                   1000UL
+
+/* The ADC reference voltage in millivolts (ADC_VOLTAGE_REF) */
+#define CURRENT_SENSE_VREF_MV                      2560UL
+
+/* Limits of the motor current */
+#define CURRENT_SENSE_PEAK_LIMIT_MA                2000UL
+#define CURRENT_SENSE_AVERAGE_LIMIT_MA             1200UL
+#define CURRENT_SENSE_AVERAGE_CONFIRM_SAMPLES      4
+
+/* Retry back off after a trip */
+#define CURRENT_SENSE_RETRY_MIN_MS                 500UL
+#define CURRENT_SENSE_RETRY_MAX_MS                 16000UL
+#define CURRENT_SENSE_RETRY_RESET_MS               10000UL
+
+#define CURRENT_SENSE_MA_TO_CODE(Current_mA)       \
+	(((Current_mA) * CURRENT_SENSE_MV_PER_AMP * ADC_MAX_VALUE) / (1000UL * CURRENT_SENSE_VREF_MV))
+
+#if (CURRENT_SENSE_MA_TO_CODE(CURRENT_SENSE_PEAK_LIMIT_MA) > ADC_MAX_VALUE)
+
+#error "CURRENT_SENSE_PEAK_LIMIT_MA is above the range of the shunt amplifier, decrease CURRENT_SENSE_MV_PER_AMP"
+
+#endif
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+typedef enum
+{
+	CURRENT_SENSE_NO_TRIP, CURRENT_SENSE_PEAK_TRIP, CURRENT_SENSE_AVERAGE_TRIP
+}CurrentSense_TripType;
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the current sensing (after DcMotor_Init, ADC_StartScheduled with the shunt channel
+ * in CURRENT_SENSE_ADC_SLOT and SysTime_Init).
+ * 1. Set the peak limit of the slot, checked on every conversion before any other processing.
+ * 2. Register the slot call back which checks the average current.
+ */
+void CurrentSense_Init(void);
+
+/*
+ * Description:
+ * Periodic task called from the main loop: release the cutoff when the back off time is elapsed.
+ */
+void CurrentSense_Task(void);
+
+/*
+ * Description:
+ * Return the current of the last sample while the bridge drives the motor, in mA.
+ */
+uint16 CurrentSense_GetPeak_mA(void);
+
+/*
+ * Description:
+ * Return the average current over the PWM period of the last sample, in mA.
+ */
+uint16 CurrentSense_GetAverage_mA(void);
+
+/*
+ * Description:
+ * Return the cause of the last trip (CURRENT_SENSE_NO_TRIP if the motor never tripped).
+ */
+CurrentSense_TripType CurrentSense_GetLastTrip(void);
+
+/*
+ * Description:
+ * Return the number of trips since startup (saturates at 255).
+ */
+uint8 CurrentSense_GetTripCount(void);
+
+#endif /* CURRENT_SENSE_H_ */
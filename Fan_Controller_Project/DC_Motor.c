@@ -4,17 +4,215 @@
  * Driver: DC Motor Driver Source File
  * Author: Youssef Zaki
  ****************************************************************************************************************/
+#include <avr/io.h>
+#include <util/atomic.h>
+#include "Common_Macros.h"
 #include "GPIO.h"
 #include "DC_Motor.h"
 #include "TIMER0.h"
+#include "TIMER1.h"
+#include "Profiler.h"
+
+#if ((DC_MOTOR_PWM_BACKEND == DC_MOTOR_PWM_TIMER1) && (PROFILER_ENABLED == 1))
+
+#error "Timer1 cannot be the motor PWM back end and the profiler timestamp counter at the same time"
+
+#endif
+
+#if ((DC_MOTOR_PWM_BACKEND == DC_MOTOR_PWM_TIMER1) && (DC_MOTOR_TIMER1_TOP < DC_MOTOR_TIMER1_MIN_TOP))
+
+#error "DC_MOTOR_TIMER1_PWM_FREQUENCY is too high for F_CPU, decrease it or increase F_CPU"
+
+#endif
+
+/*******************************************************************************
+ *                                Definitions                                  *
+ *******************************************************************************/
+
+/* Compare value of the full speed */
+#if (DC_MOTOR_PWM_BACKEND == DC_MOTOR_PWM_TIMER0)
+#define DC_MOTOR_COMPARE_TOP                       255
+#else
+#define DC_MOTOR_COMPARE_TOP                       DC_MOTOR_TIMER1_TOP
+#endif
+
+/* Bridge pins (PB0 = A, PB1 = B) of each state for one port write */
+#define DC_MOTOR_PINS_MASK                         ((1 << PIN0_ID) | (1 << PIN1_ID))
+#define DC_MOTOR_PINS_CW                           (1 << PIN1_ID)
+#define DC_MOTOR_PINS_A_CW                         (1 << PIN0_ID)
+#define DC_MOTOR_PINS_BRAKE                        ((1 << PIN0_ID) | (1 << PIN1_ID))
+
+/*******************************************************************************
+ *                                Global Variables                             *
+ *******************************************************************************/
+
+/* TRUE while the motor is held at full speed by DcMotor_EmergencyFullSpeed */
+static volatile boolean g_emergency = FALSE;
+
+/* TRUE while the motor is cut off by DcMotor_Cutoff, it has priority over the emergency full speed */
+static volatile boolean g_cutoff = FALSE;
+
+/* Last request of DcMotor_Rotate/DcMotor_RotateFine, applied again when the motor is given back */
+static volatile DcMotor_State g_lastState = STOP;
+static volatile uint16 g_lastCompare = 0;
+
+/* Deceleration profile: remaining PWM periods and the accumulator which spreads the brake periods */
+static volatile uint16 g_brakePeriods = 0;
+static volatile uint8 g_brakeAccumulator = 0;
+static volatile uint8 g_brakeRatio = DC_MOTOR_BRAKE_RATIO_PERCENT;
+
+/*******************************************************************************
+ *                              Functions Definitions                          *
+ *******************************************************************************/
+
+/*
+ * DESCRIPTION:
+ * Write the two motor pins according to the state.
+ */
+static void DcMotor_SetDirection(DcMotor_State state)
+{
+	if (state == STOP)
+	{
+		/* STOP MODE: A = LOW, B = LOW */
+		GPIO_WritePin(PORTB_ID,PIN0_ID,LOGIC_LOW);
+		GPIO_WritePin(PORTB_ID,PIN1_ID,LOGIC_LOW);
+	}
+	else if (state == CW)
+	{
+		/* CLOCk WISE MODE: A = LOW, B = HIGH */
+		GPIO_WritePin(PORTB_ID,PIN0_ID,LOGIC_LOW);
+		GPIO_WritePin(PORTB_ID,PIN1_ID,LOGIC_HIGH);
+	}
+	else if (state == A_CW)
+	{
+		/* Anti-CLOCk WISE MODE: A = HIGH, B = LOW */
+		GPIO_WritePin(PORTB_ID,PIN0_ID,LOGIC_HIGH);
+		GPIO_WritePin(PORTB_ID,PIN1_ID,LOGIC_LOW);
+	}
+	else if (state == BRAKE)
+	{
+		/* BRAKE MODE: A = HIGH, B = HIGH, the motor windings are shorted through the bridge */
+		GPIO_WritePin(PORTB_ID,PIN0_ID,LOGIC_HIGH);
+		GPIO_WritePin(PORTB_ID,PIN1_ID,LOGIC_HIGH);
+	}
+}
+
+/*
+ * DESCRIPTION:
+ * Write the last requested direction and compare value.
+ */
+static void DcMotor_ApplyRequest(void)
+{
+	DcMotor_SetDirection(g_lastState);
+
+#if (DC_MOTOR_PWM_BACKEND == DC_MOTOR_PWM_TIMER0)
+	Timer0_PWM_SetCompare((uint8)g_lastCompare);
+#else
+	Timer1_PWM_SetCompare(DC_MOTOR_TIMER1_CHANNEL, g_lastCompare);
+#endif
+}
+
+/*
+ * DESCRIPTION:
+ * Disconnect the PWM pin from its timer and drive it as a normal output pin (constant time).
+ * The compare registers are only updated at the end of the period in the PWM modes, the pin is not.
+ */
+static void DcMotor_ForcePwmPin(uint8 Level)
+{
+#if (DC_MOTOR_PWM_BACKEND == DC_MOTOR_PWM_TIMER0)
+	/* OC0 (PB3) */
+	TCCR0 &= ~((1 << COM01) | (1 << COM00));
+	if (Level == LOGIC_HIGH)
+	{
+		SET_BIT(PORTB, PIN3_ID);
+	}
+	else
+	{
+		CLEAR_BIT(PORTB, PIN3_ID);
+	}
+#else
+	/* OC1A (PD5) or OC1B (PD4) */
+	if (DC_MOTOR_TIMER1_CHANNEL == TIMER1_OC1A)
+	{
+		TCCR1A &= ~((1 << COM1A1) | (1 << COM1A0));
+		if (Level == LOGIC_HIGH)
+		{
+			SET_BIT(PORTD, PIN5_ID);
+		}
+		else
+		{
+			CLEAR_BIT(PORTD, PIN5_ID);
+		}
+	}
+	else
+	{
+		TCCR1A &= ~((1 << COM1B1) | (1 << COM1B0));
+		if (Level == LOGIC_HIGH)
+		{
+			SET_BIT(PORTD, PIN4_ID);
+		}
+		else
+		{
+			CLEAR_BIT(PORTD, PIN4_ID);
+		}
+	}
+#endif
+}
+
+/*
+ * DESCRIPTION:
+ * Give the PWM pin back to its timer (Non-Inverting) with the last requested compare value (constant time),
+ * the pin level of the port is cleared.
+ */
+static void DcMotor_ConnectPwmPin(void)
+{
+#if (DC_MOTOR_PWM_BACKEND == DC_MOTOR_PWM_TIMER0)
+	OCR0 = (uint8)g_lastCompare;
+	CLEAR_BIT(PORTB, PIN3_ID);
+	TCCR0 |= (1 << COM01);
+#else
+	if (DC_MOTOR_TIMER1_CHANNEL == TIMER1_OC1A)
+	{
+		CLEAR_BIT(PORTD, PIN5_ID);
+	}
+	else
+	{
+		CLEAR_BIT(PORTD, PIN4_ID);
+	}
+
+	/* Timer1_PWM_SetCompare connects the channel again when the compare value is not zero */
+	Timer1_PWM_SetCompare(DC_MOTOR_TIMER1_CHANNEL, g_lastCompare);
+#endif
+}
+
+/*
+ * DESCRIPTION:
+ * Emergency full speed: CW and the PWM pin driven high (constant time).
+ */
+static void DcMotor_ForceFullSpeed(void)
+{
+	/* CLOCK WISE: PB0 = LOW, PB1 = HIGH in one write, the pins are already outputs (DcMotor_Init) */
+	PORTB = (PORTB & ~DC_MOTOR_PINS_MASK) | DC_MOTOR_PINS_CW;
+	DcMotor_ForcePwmPin(LOGIC_HIGH);
+}
 
 /*
  * DESCRIPTION:
  * The Function responsible for setup the direction for the two motor pins through the GPIO driver.
  * Stop at the DC-Motor at the beginning through the GPIO driver.
+ * With the Timer1 back end, initialize Timer1 in the Fast PWM Mode with TOP = DC_MOTOR_TIMER1_TOP.
  */
 void DcMotor_Init(void)
 {
+#if (DC_MOTOR_PWM_BACKEND == DC_MOTOR_PWM_TIMER1)
+	TIMER1_PWM_ConfigType Timer1_Config =
+	{
+		DC_MOTOR_TIMER1_TOP,
+		DC_MOTOR_TIMER1_PRESCALER,
+		(DC_MOTOR_TIMER1_CHANNEL == TIMER1_OC1A) ? TIMER1_Channel_A : TIMER1_Channel_B
+	};
+#endif
+
 	/* let the first 2 pins as output pins at PORTB */
 	GPIO_SetupPinDirection(PORTB_ID,PIN0_ID,OUTPUT_PIN);
 	GPIO_SetupPinDirection(PORTB_ID,PIN1_ID,OUTPUT_PIN);
@@ -22,36 +220,238 @@ void DcMotor_Init(void)
 	 /* Stop the Motor at the beginning */
 	GPIO_WritePin(PORTB_ID,PIN0_ID,LOGIC_LOW);
 	GPIO_WritePin(PORTB_ID,PIN1_ID,LOGIC_LOW);
+
+#if (DC_MOTOR_PWM_BACKEND == DC_MOTOR_PWM_TIMER1)
+	Timer1_PWM_Init(&Timer1_Config);
+#endif
 }
 
 /*
  * DESCRIPTION:
  * The function responsible for rotate the DC Motor CW/ or A-CW or stop the motor based on the state
- * input state value.
+ * input state value. BRAKE shorts the motor (both pins high), the speed is then the braking strength.
+ * A lower speed than the previous one starts the deceleration profile (DC_MOTOR_DECEL_MODE).
  * Send the required duty cycle to the PWM driver based on the required speed value.
  */
 void DcMotor_Rotate(DcMotor_State state, uint8 speed)
 {
-	if (state == STOP)
+	/* Same compare value as TIMER0_PWM_Start with the Timer0 back end: (speed * 255) / 100 */
+	DcMotor_RotateFine(state, (uint16)speed * (DC_MOTOR_DUTY_FULL_SCALE / 100));
+}
+
+/*
+ * DESCRIPTION:
+ * Same as DcMotor_Rotate but the duty cycle is given in per mille (0 to DC_MOTOR_DUTY_FULL_SCALE),
+ * the Timer1 back end keeps the full resolution of its TOP value.
+ */
+void DcMotor_RotateFine(DcMotor_State state, uint16 duty)
+{
+	uint16 Compare_Value;
+#if (DC_MOTOR_DECEL_MODE == DC_MOTOR_DECEL_BRAKE)
+	uint16 Periods;
+#endif
+
+	if (duty > DC_MOTOR_DUTY_FULL_SCALE)
 	{
-		/* STOP MODE: A = LOW, B = LOW */
-		GPIO_WritePin(PORTB_ID,PIN0_ID,LOGIC_LOW);
-		GPIO_WritePin(PORTB_ID,PIN1_ID,LOGIC_LOW);
+		duty = DC_MOTOR_DUTY_FULL_SCALE;
 	}
-	else if (state == CW)
+
+#if (DC_MOTOR_PWM_BACKEND == DC_MOTOR_PWM_TIMER0)
+	Compare_Value = (uint8)(((uint32)duty * 255) / DC_MOTOR_DUTY_FULL_SCALE);
+#else
+	Compare_Value = (uint16)(((uint32)duty * DC_MOTOR_TIMER1_TOP) / DC_MOTOR_DUTY_FULL_SCALE);
+#endif
+
+	/* DcMotor_EmergencyFullSpeed and DcMotor_Cutoff may run from an interrupt, they must not be overwritten half way */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
 	{
-		/* CLOCk WISE MODE: A = LOW, B = HIGH */
-		GPIO_WritePin(PORTB_ID,PIN0_ID,LOGIC_LOW);
-		GPIO_WritePin(PORTB_ID,PIN1_ID,LOGIC_HIGH);
+#if (DC_MOTOR_DECEL_MODE == DC_MOTOR_DECEL_BRAKE)
+		/* Slowing down in the same direction or stopping a running motor: brake for a time proportional to the drop */
+		if (((g_lastState == CW) || (g_lastState == A_CW)) && ((state == g_lastState) || (state == STOP)) &&
+			(Compare_Value < g_lastCompare))
+		{
+			if (state == STOP)
+			{
+				/* Nothing to drive at the end, every period of the profile is a brake period */
+				Periods = (uint16)(((uint32)g_lastCompare * DC_MOTOR_BRAKE_STOP_PERIODS_FULL_SCALE) / DC_MOTOR_COMPARE_TOP);
+				g_brakeRatio = 100;
+			}
+			else
+			{
+				Periods = (uint16)(((uint32)(g_lastCompare - Compare_Value) * DC_MOTOR_BRAKE_PERIODS_FULL_SCALE) / DC_MOTOR_COMPARE_TOP);
+				g_brakeRatio = DC_MOTOR_BRAKE_RATIO_PERCENT;
+			}
+
+			if (Periods > g_brakePeriods)
+			{
+				g_brakePeriods = Periods;
+			}
+		}
+		else if ((state != g_lastState) || (Compare_Value > g_lastCompare))
+		{
+			/* New direction or speeding up: the profile is cancelled (a repeated request keeps it running) */
+			g_brakePeriods = 0;
+		}
+#endif
+
+		g_lastState = state;
+		g_lastCompare = Compare_Value;
+
+		/* While a profile is running, DcMotor_Tick applies the request in the drive periods */
+		if (!g_emergency && !g_cutoff && (g_brakePeriods == 0))
+		{
+			/* The pin may still be held by a profile which was just cancelled */
+			DcMotor_ConnectPwmPin();
+			DcMotor_ApplyRequest();
+		}
 	}
-	else if (state == A_CW)
+}
+
+/*
+ * DESCRIPTION:
+ * Emergency full speed, safe to call from an interrupt (constant time, no GPIO driver calls).
+ * The direction pins are written CW in one port write and the PWM pin is disconnected from its timer
+ * and driven high, so the motor is at full speed at once instead of at the end of the PWM period.
+ * DcMotor_Rotate/DcMotor_RotateFine cannot change the direction nor the speed any more (latched till the next reset).
+ * While the motor is cut off (DcMotor_Cutoff) the full speed is only applied when the cutoff is released.
+ */
+void DcMotor_EmergencyFullSpeed(void)
+{
+	g_emergency = TRUE;
+
+	if (!g_cutoff)
 	{
-		/* Anti-CLOCk WISE MODE: A = HIGH, B = LOW */
-		GPIO_WritePin(PORTB_ID,PIN0_ID,LOGIC_HIGH);
-		GPIO_WritePin(PORTB_ID,PIN1_ID,LOGIC_LOW);
+		DcMotor_ForceFullSpeed();
 	}
+}
 
-	/* Pass the Speed of the Motor to PWM Function to calculate duty cycle and hence Timer0 Compare  Value */
-	TIMER0_PWM_Start(speed);
+/*
+ * DESCRIPTION:
+ * Cut the motor off, safe to call from an interrupt (constant time, no GPIO driver calls).
+ * Both direction pins are written low in one port write and the PWM pin is disconnected from its timer
+ * and driven low, so the bridge stops driving at once. It has priority over DcMotor_EmergencyFullSpeed.
+ */
+void DcMotor_Cutoff(void)
+{
+	g_cutoff = TRUE;
+
+	/* STOP: PB0 = LOW, PB1 = LOW in one write */
+	PORTB &= ~DC_MOTOR_PINS_MASK;
+	DcMotor_ForcePwmPin(LOGIC_LOW);
+}
 
+/*
+ * DESCRIPTION:
+ * Release the cutoff: the emergency full speed if it is still set, else the last requested direction and speed.
+ */
+void DcMotor_ReleaseCutoff(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		if (g_cutoff)
+		{
+			g_cutoff = FALSE;
+
+			if (g_emergency)
+			{
+				DcMotor_ForceFullSpeed();
+			}
+			else
+			{
+				DcMotor_ConnectPwmPin();
+				DcMotor_ApplyRequest();
+			}
+		}
+	}
+}
+
+/*
+ * DESCRIPTION:
+ * Return TRUE while the motor is cut off by DcMotor_Cutoff.
+ */
+boolean DcMotor_IsCutOff(void)
+{
+	return g_cutoff;
+}
+
+/*
+ * DESCRIPTION:
+ * Return the compare value which drives the motor now: the last requested one, the TOP value while
+ * the motor is held at full speed and 0 while it is cut off.
+ */
+uint16 DcMotor_GetOutputCompare(void)
+{
+	if (g_cutoff)
+	{
+		return 0;
+	}
+	else if (g_emergency)
+	{
+#if (DC_MOTOR_PWM_BACKEND == DC_MOTOR_PWM_TIMER0)
+		return 0xFF;
+#else
+		return DC_MOTOR_TIMER1_TOP;
+#endif
+	}
+
+	return g_lastCompare;
+}
+
+/*
+ * DESCRIPTION:
+ * Deceleration profile step, called from the Timer0 overflow interrupt once every PWM period
+ * (constant time, no GPIO driver calls). It does nothing when no profile is running.
+ */
+void DcMotor_Tick(void)
+{
+	uint8 Pins;
+
+	if (g_brakePeriods == 0)
+	{
+		return;
+	}
+
+	if (g_emergency || g_cutoff)
+	{
+		/* The safety functions own the bridge, the profile is dropped */
+		g_brakePeriods = 0;
+		return;
+	}
+
+	g_brakePeriods--;
+
+	/* g_brakeRatio percent of the periods are brake periods, evenly spread */
+	g_brakeAccumulator += g_brakeRatio;
+
+	if ((g_brakeAccumulator >= 100) && (g_brakePeriods != 0))
+	{
+		g_brakeAccumulator -= 100;
+
+		/* Brake period: short the windings with the PWM pin held high for the whole period */
+		PORTB = (PORTB & ~DC_MOTOR_PINS_MASK) | DC_MOTOR_PINS_BRAKE;
+		DcMotor_ForcePwmPin(LOGIC_HIGH);
+	}
+	else
+	{
+		/* Drive period (and the end of the profile): the requested direction and speed */
+		if (g_lastState == CW)
+		{
+			Pins = DC_MOTOR_PINS_CW;
+		}
+		else if (g_lastState == A_CW)
+		{
+			Pins = DC_MOTOR_PINS_A_CW;
+		}
+		else if (g_lastState == BRAKE)
+		{
+			Pins = DC_MOTOR_PINS_BRAKE;
+		}
+		else
+		{
+			Pins = 0;
+		}
+
+		PORTB = (PORTB & ~DC_MOTOR_PINS_MASK) | Pins;
+		DcMotor_ConnectPwmPin();
+	}
 }
@@ -13,8 +13,73 @@
  *                                Definitions                                  *
  *******************************************************************************/
 
+/*
+ * PWM back end of the motor speed:
+ * DC_MOTOR_PWM_TIMER0: OC0 (PB3), 8-bit Fast PWM configured by the application (F_CPU/8/256 = 488Hz at 1MHz).
+ * DC_MOTOR_PWM_TIMER1: OC1A (PD5) or OC1B (PD4), Fast PWM with TOP = ICR1, configured by DcMotor_Init.
+ */
+#define DC_MOTOR_PWM_TIMER0                        0
+#define DC_MOTOR_PWM_TIMER1                        1
+
+#define DC_MOTOR_PWM_BACKEND                       DC_MOTOR_PWM_TIMER0
+
+#if ((DC_MOTOR_PWM_BACKEND != DC_MOTOR_PWM_TIMER0) && (DC_MOTOR_PWM_BACKEND != DC_MOTOR_PWM_TIMER1))
+
+#error "DC_MOTOR_PWM_BACKEND should be DC_MOTOR_PWM_TIMER0 or DC_MOTOR_PWM_TIMER1"
+
+#endif
+
+/* Timer1 back end: output channel (TIMER1_OC1A or TIMER1_OC1B), pre-scalar and frequency */
+#define DC_MOTOR_TIMER1_CHANNEL                    TIMER1_OC1A
+#define DC_MOTOR_TIMER1_PRESCALER                  TIMER1_Prescaler_1
+#define DC_MOTOR_TIMER1_PRESCALER_DIVISION         1
+
+#if (F_CPU >= 8000000UL)
+/* The standard fan PWM frequency, above the audible range */
+#define DC_MOTOR_TIMER1_PWM_FREQUENCY              25000
+#else
+/* The clock is too slow for 25KHz with a useful resolution (TOP would be 39 at 1MHz) */
+#define DC_MOTOR_TIMER1_PWM_FREQUENCY              2000
+#endif
+
+#define DC_MOTOR_TIMER1_TOP                        TIMER1_PWM_TOP(DC_MOTOR_TIMER1_PWM_FREQUENCY, DC_MOTOR_TIMER1_PRESCALER_DIVISION)
+
+/* At least 1% steps are required from the Timer1 back end */
+#define DC_MOTOR_TIMER1_MIN_TOP                    99
+
+/* Full scale of the fine duty cycle used by DcMotor_RotateFine (per mille) */
+#define DC_MOTOR_DUTY_FULL_SCALE                   1000
+
+/*
+ * Deceleration when the speed is decreased (or the motor is stopped):
+ * DC_MOTOR_DECEL_COAST: the motor slows down by its own friction and fan load.
+ * DC_MOTOR_DECEL_BRAKE: during a number of PWM periods proportional to the speed drop, brake periods
+ * (both bridge pins high and the PWM pin high: the motor windings are shorted) alternate with drive periods
+ * at the new speed, a stop only uses brake periods. DcMotor_Tick must be called once every Timer0 PWM
+ * period (Timer0 overflow). The values below are tuned with Host_Tools/Motor_Decel.
+ */
+#define DC_MOTOR_DECEL_COAST                       0
+#define DC_MOTOR_DECEL_BRAKE                       1
+
+#define DC_MOTOR_DECEL_MODE                        DC_MOTOR_DECEL_BRAKE
+
+/* Number of PWM periods of the profile for a full scale speed drop to a running speed (32 periods = 66ms at 488Hz) */
+#define DC_MOTOR_BRAKE_PERIODS_FULL_SCALE          32
+
+/* Share of the brake periods in the profile to a running speed, in percent */
+#define DC_MOTOR_BRAKE_RATIO_PERCENT               50
+
+/* Number of PWM periods of the profile (brake periods only) to stop the motor from full speed (1s at 488Hz) */
+#define DC_MOTOR_BRAKE_STOP_PERIODS_FULL_SCALE     512
+
+#if ((DC_MOTOR_BRAKE_RATIO_PERCENT < 1) || (DC_MOTOR_BRAKE_RATIO_PERCENT > 100))
+
+#error "DC_MOTOR_BRAKE_RATIO_PERCENT should be from 1 to 100"
+
+#endif
+
 typedef enum {
-	STOP,CW,A_CW
+	STOP,CW,A_CW,BRAKE
 }DcMotor_State;
 
 /*******************************************************************************
@@ -25,15 +90,68 @@ typedef enum {
  * DESCRIPTION:
  * The Function responsible for setup the direction for the two motor pins through the GPIO driver.
  * Stop at the DC-Motor at the beginning through the GPIO driver.
+ * With the Timer1 back end, initialize Timer1 in the Fast PWM Mode with TOP = DC_MOTOR_TIMER1_TOP.
  */
 void DcMotor_Init(void);
 
 /*
  * DESCRIPTION:
  * The function responsible for rotate the DC Motor CW/ or A-CW or stop the motor based on the state input
- * state value.
+ * state value. BRAKE shorts the motor (both pins high), the speed is then the braking strength.
+ * A lower speed than the previous one starts the deceleration profile (DC_MOTOR_DECEL_MODE).
  * Send the required duty cycle to the PWM driver based on the required speed value.
  */
 void DcMotor_Rotate(DcMotor_State state, uint8 speed);
 
+/*
+ * DESCRIPTION:
+ * Same as DcMotor_Rotate but the duty cycle is given in per mille (0 to DC_MOTOR_DUTY_FULL_SCALE),
+ * the Timer1 back end keeps the full resolution of its TOP value.
+ */
+void DcMotor_RotateFine(DcMotor_State state, uint16 duty);
+
+/*
+ * DESCRIPTION:
+ * Emergency full speed, safe to call from an interrupt (constant time, no GPIO driver calls).
+ * The direction pins are written CW in one port write and the PWM pin is disconnected from its timer
+ * and driven high, so the motor is at full speed at once instead of at the end of the PWM period.
+ * DcMotor_Rotate/DcMotor_RotateFine cannot change the direction nor the speed any more (latched till the next reset).
+ * While the motor is cut off (DcMotor_Cutoff) the full speed is only applied when the cutoff is released.
+ */
+void DcMotor_EmergencyFullSpeed(void);
+
+/*
+ * DESCRIPTION:
+ * Cut the motor off, safe to call from an interrupt (constant time, no GPIO driver calls).
+ * Both direction pins are written low in one port write and the PWM pin is disconnected from its timer
+ * and driven low, so the bridge stops driving at once. It has priority over DcMotor_EmergencyFullSpeed.
+ */
+void DcMotor_Cutoff(void);
+
+/*
+ * DESCRIPTION:
+ * Release the cutoff: the emergency full speed if it is still set, else the last requested direction and speed.
+ */
+void DcMotor_ReleaseCutoff(void);
+
+/*
+ * DESCRIPTION:
+ * Return TRUE while the motor is cut off by DcMotor_Cutoff.
+ */
+boolean DcMotor_IsCutOff(void);
+
+/*
+ * DESCRIPTION:
+ * Deceleration profile step, called from the Timer0 overflow interrupt once every PWM period
+ * (constant time, no GPIO driver calls). It does nothing when no profile is running.
+ */
+void DcMotor_Tick(void);
+
+/*
+ * DESCRIPTION:
+ * Return the compare value which drives the motor now: the last requested one, the TOP value while
+ * the motor is held at full speed and 0 while it is cut off.
+ */
+uint16 DcMotor_GetOutputCompare(void);
+
 #endif /* DC_MOTOR_H_ */
@@ -0,0 +1,224 @@
+/*******************************************************************************************************************
+ * File Name: DS18B20.c
+ * Date: 19/10/2026
+ * Driver: DS18B20 Digital Temperature Sensor Driver (1-Wire, Non-Blocking) Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "CRC.h"
+#include "One_Wire.h"
+#include "Sys_Time.h"
+#include "DS18B20.h"
+
+/*******************************************************************************
+ *                              Macros Definitions                             *
+ *******************************************************************************/
+
+/* Configuration register: R1:R0 = resolution - 9, the other bits read 0 (bit 7) and 1 (bits 4:0) */
+#define DS18B20_CONFIG_VALUE                       ((uint8)(((DS18B20_RESOLUTION_BITS - 9) << 5) | 0x1F))
+#define DS18B20_CONFIG_INDEX                       4
+
+/* Alarm thresholds written with the configuration, the alarm search is not used */
+#define DS18B20_ALARM_HIGH                         0x7F
+#define DS18B20_ALARM_LOW                          0x80
+
+/* Low bits of the result which are undefined at the resolution */
+#define DS18B20_UNDEFINED_BITS_MASK                ((1 << (12 - DS18B20_RESOLUTION_BITS)) - 1)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef enum
+{
+	DS18B20_IDLE, DS18B20_CONFIGURE, DS18B20_CONVERT, DS18B20_WAIT, DS18B20_READ, DS18B20_READY, DS18B20_ERROR
+}DS18B20_StateType;
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+static const uint8 g_configureCommand[] =
+{
+	DS18B20_SKIP_ROM, DS18B20_WRITE_SCRATCHPAD, DS18B20_ALARM_HIGH, DS18B20_ALARM_LOW, DS18B20_CONFIG_VALUE
+};
+
+static const uint8 g_convertCommand[] = {DS18B20_SKIP_ROM, DS18B20_CONVERT_T};
+static const uint8 g_readCommand[] = {DS18B20_SKIP_ROM, DS18B20_READ_SCRATCHPAD};
+
+static uint8 g_scratchpad[DS18B20_SCRATCHPAD_SIZE];
+static DS18B20_StateType g_state = DS18B20_IDLE;
+static boolean g_configured = FALSE;
+static uint32 g_convertStart_ms = 0;
+static uint8 g_lateRetries = 0;
+
+/* The DS18B20 behind the sensor interface (Temp_Sensor.h) */
+const TempSensor_DriverType g_DS18B20Sensor =
+{
+	DS18B20_StartConversion, DS18B20_PollConversion, DS18B20_ReadConversion
+};
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Start the bus transfer of the current state again (the bus is free).
+ */
+static void DS18B20_RestartTransfer(void)
+{
+	switch (g_state)
+	{
+	case DS18B20_CONFIGURE:
+		OneWire_StartTransfer(g_configureCommand, sizeof(g_configureCommand), NULL_PTR, 0);
+		break;
+
+	case DS18B20_CONVERT:
+		OneWire_StartTransfer(g_convertCommand, sizeof(g_convertCommand), NULL_PTR, 0);
+		break;
+
+	default:
+		OneWire_StartTransfer(g_readCommand, sizeof(g_readCommand), g_scratchpad, DS18B20_SCRATCHPAD_SIZE);
+		break;
+	}
+}
+
+/*
+ * Description:
+ * Initialization of the DS18B20 driver and of the 1-Wire bus (OneWire_Init), the resolution is written by
+ * the first conversion.
+ */
+void DS18B20_Init(void)
+{
+	OneWire_Init();
+	g_state = DS18B20_IDLE;
+	g_configured = FALSE;
+}
+
+/*
+ * Description:
+ * Sensor interface: start a conversion (the resolution first if needed). Return FALSE if the bus is busy.
+ */
+boolean DS18B20_StartConversion(void)
+{
+	g_lateRetries = 0;
+
+	if (!g_configured)
+	{
+		if (!OneWire_StartTransfer(g_configureCommand, sizeof(g_configureCommand), NULL_PTR, 0))
+		{
+			return FALSE;
+		}
+		g_state = DS18B20_CONFIGURE;
+	}
+	else
+	{
+		if (!OneWire_StartTransfer(g_convertCommand, sizeof(g_convertCommand), NULL_PTR, 0))
+		{
+			return FALSE;
+		}
+		g_state = DS18B20_CONVERT;
+	}
+
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Sensor interface: move the conversion on (next bus transfer when the previous one is over, read of the
+ * scratchpad once the conversion time is elapsed) and return its state, never waits. A transfer aborted by a
+ * missed 1-Wire deadline (ONE_WIRE_LATE) is sent again, up to DS18B20_LATE_RETRIES times.
+ */
+TempSensor_StatusType DS18B20_PollConversion(void)
+{
+	OneWire_StatusType Bus = OneWire_GetStatus();
+
+	switch (g_state)
+	{
+	case DS18B20_CONFIGURE:
+	case DS18B20_CONVERT:
+	case DS18B20_READ:
+		if (Bus == ONE_WIRE_BUSY)
+		{
+			return TEMP_SENSOR_BUSY;
+		}
+		if ((Bus == ONE_WIRE_LATE) && (g_lateRetries < DS18B20_LATE_RETRIES))
+		{
+			/* A time slot was delayed by another interrupt, nothing is wrong with the sensor */
+			g_lateRetries++;
+			DS18B20_RestartTransfer();
+			return TEMP_SENSOR_BUSY;
+		}
+		if (Bus != ONE_WIRE_DONE)
+		{
+			g_state = DS18B20_ERROR;
+			return TEMP_SENSOR_ERROR;
+		}
+		break;
+
+	case DS18B20_WAIT:
+		break;
+
+	case DS18B20_READY:
+		return TEMP_SENSOR_READY;
+
+	default:
+		return TEMP_SENSOR_ERROR;
+	}
+
+	/* The transfer of the state is over (or the conversion time is running) */
+	switch (g_state)
+	{
+	case DS18B20_CONFIGURE:
+		/* The bus is free, the transfer cannot be refused */
+		g_configured = TRUE;
+		OneWire_StartTransfer(g_convertCommand, sizeof(g_convertCommand), NULL_PTR, 0);
+		g_state = DS18B20_CONVERT;
+		break;
+
+	case DS18B20_CONVERT:
+		g_convertStart_ms = SysTime_GetMilliseconds();
+		g_state = DS18B20_WAIT;
+		break;
+
+	case DS18B20_WAIT:
+		if ((uint32)(SysTime_GetMilliseconds() - g_convertStart_ms) >= DS18B20_CONVERSION_MS)
+		{
+			OneWire_StartTransfer(g_readCommand, sizeof(g_readCommand), g_scratchpad, DS18B20_SCRATCHPAD_SIZE);
+			g_state = DS18B20_READ;
+		}
+		break;
+
+	default:
+		/*
+		 * A missing sensor reads all ones (bad CRC), a shorted bus all zeros (good CRC, but bit 0 of the
+		 * configuration is 0). Another resolution means the sensor was reset, it is written again next time.
+		 */
+		if ((CRC8_MAXIM_Calculate(g_scratchpad, DS18B20_SCRATCHPAD_SIZE) != 0) ||
+				((g_scratchpad[DS18B20_CONFIG_INDEX] & 0x9F) != 0x1F))
+		{
+			g_state = DS18B20_ERROR;
+			return TEMP_SENSOR_ERROR;
+		}
+		if (g_scratchpad[DS18B20_CONFIG_INDEX] != DS18B20_CONFIG_VALUE)
+		{
+			g_configured = FALSE;
+		}
+		g_state = DS18B20_READY;
+		return TEMP_SENSOR_READY;
+	}
+
+	return TEMP_SENSOR_BUSY;
+}
+
+/*
+ * Description:
+ * Sensor interface: return the temperature of the finished conversion in 1/16 degree (the undefined low
+ * bits of the lower resolutions are cleared).
+ */
+sint16 DS18B20_ReadConversion(void)
+{
+	uint16 Raw = (uint16)(((uint16)g_scratchpad[1] << 8) | g_scratchpad[0]);
+
+	return (sint16)(Raw & ~DS18B20_UNDEFINED_BITS_MASK);
+}
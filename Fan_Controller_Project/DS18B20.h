@@ -0,0 +1,87 @@
+/*******************************************************************************************************************
+ * File Name: DS18B20.h
+ * Date: 19/10/2026
+ * Driver: DS18B20 Digital Temperature Sensor Driver (1-Wire, Non-Blocking) Header File
+ * Author: Youssef Zaki
+ *
+ * One DS18B20 alone on the 1-Wire bus (One_Wire.h), addressed with Skip ROM. A conversion is a state machine
+ * moved on by DS18B20_PollConversion from the main loop:
+ *     1. the resolution is written to the scratchpad (first conversion, or after the sensor lost it),
+ *     2. Convert T is sent, then the conversion time (DS18B20_CONVERSION_MS, 750ms at 12 bits) is waited with
+ *        the system time, the bus and the CPU are free meanwhile,
+ *     3. the 9 bytes of the scratchpad are read and checked with their CRC-8 (CRC8_MAXIM_Calculate) and with
+ *        the fixed bits of the configuration register, so a missing or shorted sensor is an error.
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+#include "Temp_Sensor.h"
+
+#ifndef DS18B20_H_
+#define DS18B20_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/* Resolution of the conversions, 9 (0.5C, 94ms) to 12 bits (0.0625C, 750ms) */
+#define DS18B20_RESOLUTION_BITS                    12
+
+/* Conversion time of the resolution (the datasheet maximum is 750ms / 2^(12 - bits)) */
+#define DS18B20_CONVERSION_MS                      ((750U >> (12 - DS18B20_RESOLUTION_BITS)) + 1)
+
+/* Commands */
+#define DS18B20_SKIP_ROM                           0xCC
+#define DS18B20_CONVERT_T                          0x44
+#define DS18B20_READ_SCRATCHPAD                    0xBE
+#define DS18B20_WRITE_SCRATCHPAD                   0x4E
+
+#define DS18B20_SCRATCHPAD_SIZE                    9
+
+/* Transfers aborted by a missed 1-Wire deadline (ONE_WIRE_LATE) are sent again, up to this number per conversion */
+#define DS18B20_LATE_RETRIES                       3
+
+#if ((DS18B20_RESOLUTION_BITS < 9) || (DS18B20_RESOLUTION_BITS > 12))
+
+#error "DS18B20_RESOLUTION_BITS should be from 9 to 12"
+
+#endif
+
+/******************************************************************************************
+ *                                    External Variables                                  *
+ ******************************************************************************************/
+
+/* The DS18B20 behind the sensor interface (Temp_Sensor.h) */
+extern const TempSensor_DriverType g_DS18B20Sensor;
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the DS18B20 driver and of the 1-Wire bus (OneWire_Init), the resolution is written by
+ * the first conversion.
+ */
+void DS18B20_Init(void);
+
+/*
+ * Description:
+ * Sensor interface: start a conversion (the resolution first if needed). Return FALSE if the bus is busy.
+ */
+boolean DS18B20_StartConversion(void);
+
+/*
+ * Description:
+ * Sensor interface: move the conversion on (next bus transfer when the previous one is over, read of the
+ * scratchpad once the conversion time is elapsed) and return its state, never waits. A transfer aborted by a
+ * missed 1-Wire deadline (ONE_WIRE_LATE) is sent again, up to DS18B20_LATE_RETRIES times.
+ */
+TempSensor_StatusType DS18B20_PollConversion(void);
+
+/*
+ * Description:
+ * Sensor interface: return the temperature of the finished conversion in 1/16 degree (the undefined low
+ * bits of the lower resolutions are cleared).
+ */
+sint16 DS18B20_ReadConversion(void);
+
+#endif /* DS18B20_H_ */
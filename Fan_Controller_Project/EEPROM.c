@@ -0,0 +1,171 @@
+/*******************************************************************************************************************
+ * File Name: EEPROM.c
+ * Date: 19/10/2026
+ * Driver: ATmega32 Internal EEPROM Driver Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "Common_Macros.h"
+#include "Isr_Sync.h"
+#include "EEPROM.h"
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+/* The block which is being programmed by the EEPROM Ready Interrupt */
+static volatile uint16 g_writeAddress = 0;
+static const uint8 * volatile g_writeDataPtr = NULL_PTR;
+static volatile uint16 g_writeRemaining = 0;
+
+/* Global variables to hold the address of the call back function in the application */
+static void (* volatile g_CallBackPtr)(void) = NULL_PTR;
+
+/***************************************************************************************
+ *                                  Interrupt Service Routines                         *
+ ***************************************************************************************/
+
+/*
+ * The EEPROM Ready Interrupt fires as long as EEWE is cleared, so each time it runs the previous
+ * byte is programmed and the next one can be started.
+ */
+ISR(EE_RDY_vect)
+{
+	uint8 Data;
+
+	while (g_writeRemaining != 0)
+	{
+		Data = *g_writeDataPtr;
+
+		/* Read the old value first, there is no need to program a byte which already has the value */
+		EEAR = g_writeAddress;
+		SET_BIT(EECR, EERE);
+
+		g_writeAddress++;
+		g_writeDataPtr++;
+		g_writeRemaining--;
+
+		if (EEDR != Data)
+		{
+			EEDR = Data;
+
+			/* EEWE must be written within four cycles after EEMWE, the interrupts are already disabled */
+			SET_BIT(EECR, EEMWE);
+			SET_BIT(EECR, EEWE);
+			return;
+		}
+	}
+
+	/* The whole block is programmed, disable the EEPROM Ready Interrupt */
+	CLEAR_BIT(EECR, EERIE);
+
+	if (g_CallBackPtr != NULL_PTR)
+	{
+		(*g_CallBackPtr)();
+	}
+}
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Read one byte from the EEPROM.
+ * 1. Wait until any byte being programmed by the interrupt driven writer is finished.
+ * 2. Load the address in EEAR Register and set EERE bit in EECR Register.
+ * 3. Return the data found in EEDR Register.
+ */
+uint8 EEPROM_ReadByte(uint16 Address)
+{
+	uint8 Data;
+	uint8 Sreg;
+
+	while (1)
+	{
+		/* Wait for the completion of the previous write with the interrupts still enabled */
+		while (BIT_IS_SET(EECR, EEWE));
+
+		/* The EEPROM Ready Interrupt must not start a new byte between checking EEWE and reading */
+		Sreg = IsrSync_EnterCritical();
+
+		if (BIT_IS_CLEAR(EECR, EEWE))
+		{
+			EEAR = Address;
+			SET_BIT(EECR, EERE);
+			Data = EEDR;
+			IsrSync_ExitCritical(Sreg);
+			return Data;
+		}
+
+		IsrSync_ExitCritical(Sreg);
+	}
+}
+
+/*
+ * Description:
+ * Read a block of bytes from the EEPROM starting from the required address.
+ */
+void EEPROM_ReadBlock(uint16 Address, uint8 *Data_Ptr, uint16 Length)
+{
+	while (Length != 0)
+	{
+		*Data_Ptr = EEPROM_ReadByte(Address);
+		Data_Ptr++;
+		Address++;
+		Length--;
+	}
+}
+
+/*
+ * Description:
+ * Start a non-blocking write of a block of bytes to the EEPROM.
+ * 1. The bytes are programmed one by one from the EEPROM Ready Interrupt, so the caller never waits
+ *    the ~8.5ms programming time of each byte.
+ * 2. Bytes which already hold the required value are skipped to save time and EEPROM endurance.
+ * 3. The buffer must stay valid until the write is completed (EEPROM_IsBusy returns FALSE).
+ * 4. Return FALSE if another write is still in progress or the block is out of the EEPROM range.
+ */
+boolean EEPROM_WriteBlock(uint16 Address, const uint8 *Data_Ptr, uint16 Length)
+{
+	if (EEPROM_IsBusy() || ((uint32)Address + Length > EEPROM_SIZE))
+	{
+		return FALSE;
+	}
+
+	if (Length != 0)
+	{
+		g_writeAddress = Address;
+		g_writeDataPtr = Data_Ptr;
+		g_writeRemaining = Length;
+
+		/* The interrupt fires immediately when EEWE is cleared and programs the first byte */
+		SET_BIT(EECR, EERIE);
+	}
+
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Return TRUE while a block write started by EEPROM_WriteBlock is still in progress.
+ */
+boolean EEPROM_IsBusy(void)
+{
+	return BIT_IS_SET(EECR, EERIE) ? TRUE : FALSE;
+}
+
+/*
+ * Description:
+ * Function to set the Call Back function address, it is called from the interrupt context when
+ * the block write is completed.
+ */
+void EEPROM_SetCallBack(void(*a_ptr)(void))
+{
+	/* The 16-bit address is read by the interrupt */
+	uint8 Sreg = IsrSync_EnterCritical();
+
+	g_CallBackPtr = a_ptr;
+	IsrSync_ExitCritical(Sreg);
+}
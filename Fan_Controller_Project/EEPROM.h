@@ -0,0 +1,65 @@
+/*******************************************************************************************************************
+ * File Name: EEPROM.h
+ * Date: 19/10/2026
+ * Driver: ATmega32 Internal EEPROM Driver Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+
+#ifndef EEPROM_H_
+#define EEPROM_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/* ATmega32 has 1024 bytes of internal EEPROM */
+#define EEPROM_SIZE                                1024
+
+/* Value of an erased EEPROM cell */
+#define EEPROM_ERASED_BYTE                         0xFF
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Read one byte from the EEPROM.
+ * 1. Wait until any byte being programmed by the interrupt driven writer is finished.
+ * 2. Load the address in EEAR Register and set EERE bit in EECR Register.
+ * 3. Return the data found in EEDR Register.
+ */
+uint8 EEPROM_ReadByte(uint16 Address);
+
+/*
+ * Description:
+ * Read a block of bytes from the EEPROM starting from the required address.
+ */
+void EEPROM_ReadBlock(uint16 Address, uint8 *Data_Ptr, uint16 Length);
+
+/*
+ * Description:
+ * Start a non-blocking write of a block of bytes to the EEPROM.
+ * 1. The bytes are programmed one by one from the EEPROM Ready Interrupt, so the caller never waits
+ *    the ~8.5ms programming time of each byte.
+ * 2. Bytes which already hold the required value are skipped to save time and EEPROM endurance.
+ * 3. The buffer must stay valid until the write is completed (EEPROM_IsBusy returns FALSE).
+ * 4. Return FALSE if another write is still in progress or the block is out of the EEPROM range.
+ */
+boolean EEPROM_WriteBlock(uint16 Address, const uint8 *Data_Ptr, uint16 Length);
+
+/*
+ * Description:
+ * Return TRUE while a block write started by EEPROM_WriteBlock is still in progress.
+ */
+boolean EEPROM_IsBusy(void);
+
+/*
+ * Description:
+ * Function to set the Call Back function address, it is called from the interrupt context when
+ * the block write is completed.
+ */
+void EEPROM_SetCallBack(void(*a_ptr)(void));
+
+#endif /* EEPROM_H_ */
@@ -2,11 +2,14 @@
  * [File]: FanControllerApplication.c
  * [Date]: 19/8/2023
  * [Objective]: Application for Control the fan speed based on the LM35 Temperature Sensor Reading.
- * [Drivers]: GPIO - Timer0 PWM Mode - ADC - DC_Motor - LM35 Temperature Sensor - LCD
+ * [Drivers]: GPIO - Timer0 PWM Mode - ADC - EEPROM - DC_Motor - LM35 Temperature Sensor (or DS18B20 / TMP102) - LCD
+ * [Services]: Configuration Store - System Time - Temperature History Log - Temperature Statistics - Temperature Monitor - Fan Safety - Current Sense - Profiler - Modbus RTU Slave
  * [Author]: Youssef Ahmed Zaki
  *************************************************************************************************************/
 #include <avr/io.h>
+#include <avr/interrupt.h>
 #include <util/delay.h>
+#include <avr/sleep.h>
 
 /* MCAL Layer */
 #include "GPIO.h"
@@ -16,91 +19,284 @@
 /* HAL Layer */
 #include "LCD.h"
 #include "LM35.h"
+#include "Temp_Sensor.h"
 #include "DC_Motor.h"
 
+/* Services */
+#include "Fan_Config.h"
+#include "Sys_Time.h"
+#include "Temp_History.h"
+#include "Temp_Stats.h"
+#include "Temp_Monitor.h"
+#include "Fan_Safety.h"
+#include "Current_Sense.h"
+#include "Profiler.h"
+#include "Modbus_Slave.h"
+
+/*
+ * Description:
+ * Timer0 overflow call back (once every PWM period): system time base, idle turns of the ADC schedule
+ * and motor deceleration profile.
+ */
+static void App_PwmPeriodTick(void)
+{
+	SysTime_Tick();
+	ADC_Tick();
+	DcMotor_Tick();
+}
+
+/*
+ * Description:
+ * Write the temperature after its label, with spaces after the number when it is shorter than three digits
+ * to clear the old digits.
+ */
+static void App_ShowTemperature(uint8 Temperature)
+{
+	PROFILE_BEGIN(PROFILE_LCD_UPDATE);
+	LCD_MoveCursor(1, 10);
+	LCD_IntegerToString(Temperature);
+
+	if (Temperature < 100)
+	{
+		LCD_DisplayCharacter(' ');
+	}
+	if (Temperature < 10)
+	{
+		LCD_DisplayCharacter(' ');
+	}
+	PROFILE_END(PROFILE_LCD_UPDATE);
+}
+
+/*
+ * Description:
+ * Write the fan state after its label: MAX when the motor is held at full speed, else ON or OFF.
+ */
+static void App_ShowFanState(uint8 Speed, boolean Faulted)
+{
+	PROFILE_BEGIN(PROFILE_LCD_UPDATE);
+	LCD_MoveCursor(0, 10);
+
+	if (Faulted)
+	{
+		LCD_DisplayString("MAX");
+	}
+	else if (Speed == 0)
+	{
+		LCD_DisplayString("OFF");
+	}
+	else
+	{
+		LCD_DisplayString("ON ");
+	}
+	PROFILE_END(PROFILE_LCD_UPDATE);
+}
+
 int main (void)
 {
-	uint8 Temperature;
+	uint8 Temperature = 0;
+	uint8 Speed = 0;
+	uint8 Events;
+	boolean Fault_Shown = FALSE;
+	boolean Lcd_Ready = FALSE;
+	boolean Temperature_Valid = FALSE;
+	uint32 Last_Second = 0;
+	TempStats_ResultType Window_Stats;
+
+	TIMER0_ConfigType Timer0_config;
+	ADC_ConfigType ADC_Config;
+	ADC_SlotConfigType Adc_Schedule[2];
 
 	/*
+	 * Load the configuration block from the EEPROM once at startup, the compiled defaults are used
+	 * if the block is erased or corrupted:
+	 *
 	 * Timer0 Driver Configuration:
 	 * 1. Let the Register TCNT0 = 0 as an initial value of the timer.
 	 * 2. The compare value is based on the required input duty cycle.
-	 * 3. Let the Timer0 work based on Fast PWM Mode.
-	 * 4. Pre_scaler = F_CPU/8 as mentioned in the requirements to generate 500Hz Signal to control DC Motor.
-	 */
-	TIMER0_ConfigType Timer0_config = {0, 0, Fast_PWM_3, Prescaler_8};
-
-	/*
+	 * 3. The PWM mode and the Pre_scaler are solved at compile time (Clock_Solver.h) for the closest
+	 *    frequency to 500Hz at F_CPU (Fast PWM, F_CPU/8 = 488Hz at 1MHz).
+	 *
 	 * ADC Driver Configuration:
 	 * 1. Let the voltage reference is the internal VREF reference = 2.56V
-	 * 2. Activate the ADC Channel two to connect it with the temperature sensor.
-	 * 3. Pre_scaler = F_CPU/8 as mentioned in the requirements.
-	 * 4. Let ADC in Free Running Mode.
-	 * 5. ADC is operating in polling technique as mentioned in the requirements.
+	 * 2. The Pre_scaler is solved at compile time for an ADC clock within 50kHz:200kHz (F_CPU/8 = 125kHz at 1MHz).
+	 * 3. Let the ADC conversions be triggered by the Timer0 overflow, so the sensor is always sampled at
+	 *    the same phase of the motor PWM period and the switching noise does not move the readings.
+	 * 4. The ADC interrupt averages LM35_SYNC_SAMPLES_PER_RESULT samples, the main loop only reads the result.
 	 */
-	ADC_ConfigType ADC_Config = {Internal_VREF, ADC2, CLK_8, Free_Running};
+	FanConfig_Load();
+	FanConfig_GetTimer0Config(&Timer0_config);
+	FanConfig_GetADCConfig(&ADC_Config);
+
+	/* The Timer0 overflow (once every PWM period) is the tick of the system time base and of the motor profile */
+	SysTime_Init(Timer0_GetOverflowPeriod_us(&Timer0_config));
+	Timer0_SetCallBack(App_PwmPeriodTick);
 
 	/* MCAL Drivers Initialization */
 	Timer0_PWM_Mode_Init(&Timer0_config);
 	ADC_Init(&ADC_Config);
 
-	/* HAL Drivers Initialization */
-	LCD_Init();
+	/*
+	 * HAL Drivers Initialization: the motor and the sensor first, the fan is controlled from the first valid
+	 * sample while the LCD is still in its power on delay (LCD_StartInit below)
+	 */
 	DcMotor_Init();
+	LM35_SetChannel(g_FanConfig.Sensor_Channel);
+
+	/* The sensor and the motor shunt are converted in turn at the Timer0 overflows (ADC slots 0 and 1) */
+	Adc_Schedule[LM35_ADC_SLOT].Channel = g_FanConfig.Sensor_Channel;
+	Adc_Schedule[LM35_ADC_SLOT].Num_Of_Samples = LM35_SYNC_SAMPLES_PER_RESULT;
+	Adc_Schedule[CURRENT_SENSE_ADC_SLOT].Channel = CURRENT_SENSE_CHANNEL;
+	Adc_Schedule[CURRENT_SENSE_ADC_SLOT].Num_Of_Samples = 1;
+	ADC_StartScheduled(Adc_Schedule, 2);
+
+	TempMonitor_Init(&g_FanConfig.Curve);
+
+	/* Over temperature fast path: the ADC interrupt itself forces the motor to full speed */
+	FanSafety_Init(FAN_SAFETY_CRITICAL_TEMPERATURE);
+
+	/* A digital sensor (TEMP_SENSOR_SOURCE) feeds the monitor from the main loop, compiled out for the LM35 */
+	TempSensor_Init(TempMonitor_PostTemperature);
+
+	/* Overcurrent cutoff from the ADC interrupt, the retries are handled by CurrentSense_Task */
+	CurrentSense_Init();
+
+	set_sleep_mode(SLEEP_MODE_IDLE);
+
+	/* Timer1 timestamps and USART dump of the profiling regions (compiled out when the profiler is disabled) */
+	Profiler_Init();
+
+	/* USART and Timer2 of the Modbus slave (compiled out when it is disabled) */
+	ModbusSlave_Init();
+
+	/* Services Initialization, the highest threshold of the fan curve is the over temperature limit */
+	TempHistory_Init(g_FanConfig.Curve.Thresholds[FAN_CURVE_NUM_OF_THRESHOLDS - 1]);
+	TempStats_Init();
+
+	/* The LCD power on delay and commands are sent from the main loop (LCD_InitTask), never waited for */
+	LCD_StartInit(SysTime_GetMilliseconds());
+
+	/* Enable the global interrupts, needed by the system time base and the interrupt driven EEPROM writes */
+	sei();
 
 	while (1)
 	{
-		Temperature = LM35_GetTemperature();
-		LCD_DisplayStringRowColumn(0,3,"Fan is ");
-		LCD_DisplayStringRowColumn(1,3,"Temp = ");
+		PROFILE_BEGIN(PROFILE_MAIN_LOOP);
 
-		/* Display the Temperature on the LCD Screen */
-		if (Temperature >= 100)
-		{
-			LCD_IntegerToString(Temperature);
-		}
-		else
+		/* One step of the LCD initialization per turn, then the labels and the values known so far */
+		if (!Lcd_Ready && LCD_InitTask(SysTime_GetMilliseconds()))
 		{
-			LCD_IntegerToString(Temperature);
+			Lcd_Ready = TRUE;
 
-			/* Put space in next place when the number is one, two or three digits to prevent noises on LCD */
-			LCD_DisplayCharacter(' ');
+			/* The labels never change, only the values are written again */
+			LCD_DisplayStringRowColumn(0,3,"Fan is ");
+			LCD_DisplayStringRowColumn(1,3,"Temp = ");
+
+			App_ShowFanState(Speed, Fault_Shown);
+			if (Temperature_Valid)
+			{
+				App_ShowTemperature(Temperature);
+			}
 		}
 
-		/* Move cursor to this location to write the fan state (ON or OFF)*/
-		LCD_MoveCursor(0, 10);
+		/* Start, poll and read the conversions of a digital sensor, never waits for them */
+		TempSensor_Task(SysTime_GetMilliseconds());
+
+		/* The ADC interrupt posts an event only when the displayed temperature or the fan curve level changes */
+		Events = TempMonitor_GetEvents();
 
-		/* Check the temperature */
-		if (Temperature < 30 )
+		if (Events & TEMP_MONITOR_EVENT_VALUE)
 		{
-			LCD_DisplayString("OFF");
-			LCD_DisplayCharacter(' ');
-			DcMotor_Rotate(STOP, 0);
+			PROFILE_BEGIN(PROFILE_LM35_GET_TEMPERATURE);
+			Temperature = TempMonitor_GetTemperature();
+			PROFILE_END(PROFILE_LM35_GET_TEMPERATURE);
+			Temperature_Valid = TRUE;
+
+			/* Display the Temperature on the LCD Screen */
+			if (Lcd_Ready)
+			{
+				App_ShowTemperature(Temperature);
+			}
 		}
-		else if (Temperature >= 30 && (Temperature < 60))
+
+		/* The motor is already at full speed, only the display is left to the main loop (latched till the next reset) */
+		if (FanSafety_IsFaulted() && !Fault_Shown)
 		{
-			LCD_DisplayString("ON");
-			LCD_DisplayCharacter(' ');
-			DcMotor_Rotate(CW, 25);
+			Fault_Shown = TRUE;
+			if (Lcd_Ready)
+			{
+				App_ShowFanState(Speed, Fault_Shown);
+			}
 		}
-		else if (Temperature >= 60 && Temperature < 90)
+
+		if ((Events & TEMP_MONITOR_EVENT_BAND) && !Fault_Shown)
 		{
-			LCD_DisplayString("ON");
-			LCD_DisplayCharacter(' ');
-			DcMotor_Rotate(CW, 50);
+			/* Find the speed of the new level in the fan curve */
+			Speed = g_FanConfig.Curve.Speeds[TempMonitor_GetLevel()];
+
+			/* The motor first, the display may still be in its initialization */
+			PROFILE_BEGIN(PROFILE_DC_MOTOR_ROTATE);
+			if (Speed == 0)
+			{
+				DcMotor_Rotate(STOP, 0);
+			}
+			else
+			{
+				DcMotor_Rotate(CW, Speed);
+			}
+			PROFILE_END(PROFILE_DC_MOTOR_ROTATE);
+
+			/* Write the fan state (ON or OFF) */
+			if (Lcd_Ready)
+			{
+				App_ShowFanState(Speed, FALSE);
+			}
 		}
-		else if (Temperature >= 90 && Temperature < 120)
+
+		/* The history summary and the sliding windows get one sample per second whatever the number of events */
+		if (SysTime_GetSeconds() != Last_Second)
 		{
-			LCD_DisplayString("ON");
-			LCD_DisplayCharacter(' ');
-			DcMotor_Rotate(CW, 75);
+			Last_Second = SysTime_GetSeconds();
+			TempHistory_AddSample(Temperature);
+
+			/* The peak of the window is written again once per bucket (10 seconds) */
+			if (TempStats_AddSample(Temperature) && TEMP_STATS_LCD_ENABLED && Lcd_Ready && TempStats_GetWindow(TEMP_STATS_LCD_WINDOW, &Window_Stats))
+			{
+				LCD_MoveCursor(0, 13);
+				LCD_IntegerToString(Window_Stats.Maximum);
+				if (Window_Stats.Maximum < 100)
+				{
+					LCD_DisplayCharacter(' ');
+				}
+				if (Window_Stats.Maximum < 10)
+				{
+					LCD_DisplayCharacter(' ');
+				}
+			}
 		}
-		else if (Temperature >= 120)
+		TempHistory_Task();
+		CurrentSense_Task();
+
+		/* Answer the Modbus request received by the interrupts, the response is sent by the interrupts too */
+		ModbusSlave_Task();
+
+		/* Execute the profiler commands received over the USART (compiled out when the profiler is disabled) */
+		Profiler_Task();
+
+		PROFILE_END(PROFILE_MAIN_LOOP);
+
+		/*
+		 * Nothing to do until the next interrupt: sleep in the Idle mode, the timers and the ADC keep running.
+		 * The interrupts are disabled while checking the events so an event cannot be posted between the
+		 * check and the sleep instruction (the instruction after sei is always executed first).
+		 */
+		cli();
+		if (!TempMonitor_HasEvents() && (FanSafety_IsFaulted() == Fault_Shown) && !ModbusSlave_HasRequest())
 		{
-			LCD_DisplayString("ON");
-			LCD_DisplayCharacter(' ');
-			DcMotor_Rotate(CW, 100);
+			sleep_enable();
+			sei();
+			sleep_cpu();
+			sleep_disable();
 		}
+		sei();
 	}
 }
@@ -0,0 +1,308 @@
+/*******************************************************************************************************************
+ * File Name: Fan_Array.c
+ * Date: 19/10/2026
+ * Driver: Multi-Fan Motor Array Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "GPIO.h"
+#include "Isr_Sync.h"
+#include "TIMER0.h"
+#include "TIMER1.h"
+#include "TIMER2.h"
+#include "LM35.h"
+#include "Fan_Array.h"
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+static const FanArray_FanConfigType *g_fanTable = NULL_PTR;
+static uint8 g_numOfFans = 0;
+
+/* Requested state and speed of every fan, and the bit mask of the fans which are not yet committed */
+static DcMotor_State g_fanStates[FAN_ARRAY_MAX_FANS];
+static uint8 g_fanSpeeds[FAN_ARRAY_MAX_FANS];
+static uint8 g_fanTemperatures[FAN_ARRAY_MAX_FANS];
+static uint8 g_changedFans = 0;
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Return the output latch of the port with the GPIO port ID.
+ */
+static volatile uint8 *FanArray_PortRegister(uint8 Port)
+{
+	switch (Port)
+	{
+	case PORTA_ID:
+		return &PORTA;
+	case PORTB_ID:
+		return &PORTB;
+	case PORTC_ID:
+		return &PORTC;
+	default:
+		return &PORTD;
+	}
+}
+
+/*
+ * Description:
+ * Write the compare register of the PWM channel of one fan.
+ */
+static void FanArray_WriteCompare(FanArray_PwmChannel Channel, uint8 Compare_Value)
+{
+	switch (Channel)
+	{
+	case FAN_ARRAY_OC0:
+		Timer0_PWM_SetCompare(Compare_Value);
+		break;
+#if FAN_ARRAY_TIMER1_ENABLED
+	case FAN_ARRAY_OC1A:
+		Timer1_PWM_SetCompare(TIMER1_OC1A, Compare_Value);
+		break;
+	case FAN_ARRAY_OC1B:
+		Timer1_PWM_SetCompare(TIMER1_OC1B, Compare_Value);
+		break;
+#endif
+#if FAN_ARRAY_TIMER2_ENABLED
+	case FAN_ARRAY_OC2:
+		Timer2_SetCompare(Compare_Value);
+		break;
+#endif
+	default:
+		/* Channel left out, the fan only follows its direction pins */
+		break;
+	}
+}
+
+/*
+ * Description:
+ * Initialization of the fan array.
+ * 1. Keep a reference to the fan table (it must stay valid, normally a const table).
+ * 2. Setup the direction pins of every fan as output pins and stop all the fans.
+ * 3. Initialize Timer1 and/or Timer2 PWM if any fan uses their channels (and they are enabled).
+ */
+void FanArray_Init(const FanArray_FanConfigType *Table_Ptr, uint8 Num_Of_Fans)
+{
+#if FAN_ARRAY_TIMER1_ENABLED
+	TIMER1_PWM_ConfigType Timer1_Config = {FAN_ARRAY_TIMER1_TOP, FAN_ARRAY_TIMER1_PRESCALER, 0};
+#endif
+#if FAN_ARRAY_TIMER2_ENABLED
+	TIMER2_ConfigType Timer2_Config = {0, 0, Fast_PWM_3, FAN_ARRAY_TIMER2_PRESCALER};
+	boolean Timer2_Used = FALSE;
+#endif
+	uint8 Fan;
+
+	if (Num_Of_Fans > FAN_ARRAY_MAX_FANS)
+	{
+		Num_Of_Fans = FAN_ARRAY_MAX_FANS;
+	}
+
+	g_fanTable = Table_Ptr;
+	g_numOfFans = Num_Of_Fans;
+	g_changedFans = 0;
+
+	for (Fan = 0; Fan < Num_Of_Fans; Fan++)
+	{
+		GPIO_SetupPinDirection(Table_Ptr[Fan].Direction_Port, Table_Ptr[Fan].Pin_A, OUTPUT_PIN);
+		GPIO_SetupPinDirection(Table_Ptr[Fan].Direction_Port, Table_Ptr[Fan].Pin_B, OUTPUT_PIN);
+		GPIO_WritePin(Table_Ptr[Fan].Direction_Port, Table_Ptr[Fan].Pin_A, LOGIC_LOW);
+		GPIO_WritePin(Table_Ptr[Fan].Direction_Port, Table_Ptr[Fan].Pin_B, LOGIC_LOW);
+
+		g_fanStates[Fan] = STOP;
+		g_fanSpeeds[Fan] = 0;
+		g_fanTemperatures[Fan] = 0;
+
+		switch (Table_Ptr[Fan].Pwm_Channel)
+		{
+		case FAN_ARRAY_OC0:
+			/* Timer0 is initialized by the application */
+			Timer0_PWM_SetCompare(0);
+			break;
+#if FAN_ARRAY_TIMER1_ENABLED
+		case FAN_ARRAY_OC1A:
+			Timer1_Config.Channels |= TIMER1_Channel_A;
+			break;
+		case FAN_ARRAY_OC1B:
+			Timer1_Config.Channels |= TIMER1_Channel_B;
+			break;
+#endif
+#if FAN_ARRAY_TIMER2_ENABLED
+		case FAN_ARRAY_OC2:
+			Timer2_Used = TRUE;
+			break;
+#endif
+		default:
+			/* Channel left out, its timer is not initialized */
+			break;
+		}
+	}
+
+#if FAN_ARRAY_TIMER1_ENABLED
+	if (Timer1_Config.Channels != 0)
+	{
+		Timer1_PWM_Init(&Timer1_Config);
+	}
+#endif
+
+#if FAN_ARRAY_TIMER2_ENABLED
+	if (Timer2_Used)
+	{
+		Timer2_PWM_Mode_Init(&Timer2_Config);
+	}
+#endif
+}
+
+/*
+ * Description:
+ * Request a new state and speed (percent) for one fan, nothing is written to the hardware until
+ * FanArray_UpdateAll is called. A request equal to the current output costs nothing.
+ */
+void FanArray_SetSpeed(uint8 Fan, DcMotor_State State, uint8 Speed)
+{
+	if (Fan >= g_numOfFans)
+	{
+		return;
+	}
+
+	if (Speed > 100)
+	{
+		Speed = 100;
+	}
+
+	if ((g_fanStates[Fan] != State) || (g_fanSpeeds[Fan] != Speed))
+	{
+		g_fanStates[Fan] = State;
+		g_fanSpeeds[Fan] = Speed;
+		g_changedFans |= (1 << Fan);
+	}
+}
+
+/*
+ * Description:
+ * Commit all the requested changes in one pass.
+ * 1. Return immediately if no fan has changed.
+ * 2. Write the direction pins of all the changed fans with one write per port.
+ * 3. Write the compare registers of the changed fans.
+ */
+void FanArray_UpdateAll(void)
+{
+	uint8 Set_Masks[NUM_OF_PORTS] = {0, 0, 0, 0};
+	uint8 Clear_Masks[NUM_OF_PORTS] = {0, 0, 0, 0};
+	uint8 Compare_Values[FAN_ARRAY_MAX_FANS];
+	const FanArray_FanConfigType *Fan_Ptr;
+	uint8 Fan;
+	uint8 Port;
+	uint8 Sreg;
+
+	if (g_changedFans == 0)
+	{
+		return;
+	}
+
+	/* Prepare everything first so the hardware is updated in one short pass */
+	for (Fan = 0; Fan < g_numOfFans; Fan++)
+	{
+		if (g_changedFans & (1 << Fan))
+		{
+			Fan_Ptr = &g_fanTable[Fan];
+
+			if (g_fanStates[Fan] == CW)
+			{
+				/* CLOCk WISE MODE: A = LOW, B = HIGH */
+				Clear_Masks[Fan_Ptr -> Direction_Port] |= (1 << Fan_Ptr -> Pin_A);
+				Set_Masks[Fan_Ptr -> Direction_Port] |= (1 << Fan_Ptr -> Pin_B);
+			}
+			else if (g_fanStates[Fan] == A_CW)
+			{
+				/* Anti-CLOCk WISE MODE: A = HIGH, B = LOW */
+				Set_Masks[Fan_Ptr -> Direction_Port] |= (1 << Fan_Ptr -> Pin_A);
+				Clear_Masks[Fan_Ptr -> Direction_Port] |= (1 << Fan_Ptr -> Pin_B);
+			}
+			else
+			{
+				/* STOP MODE: A = LOW, B = LOW */
+				Clear_Masks[Fan_Ptr -> Direction_Port] |= (1 << Fan_Ptr -> Pin_A) | (1 << Fan_Ptr -> Pin_B);
+			}
+
+			Compare_Values[Fan] = (g_fanStates[Fan] == STOP) ? 0 : (uint8)(((uint16)g_fanSpeeds[Fan] * 255) / 100);
+		}
+	}
+
+	Sreg = IsrSync_EnterCritical();
+
+	for (Port = 0; Port < NUM_OF_PORTS; Port++)
+	{
+		if ((Set_Masks[Port] | Clear_Masks[Port]) != 0)
+		{
+			*FanArray_PortRegister(Port) = (*FanArray_PortRegister(Port) & ~Clear_Masks[Port]) | Set_Masks[Port];
+		}
+	}
+
+	for (Fan = 0; Fan < g_numOfFans; Fan++)
+	{
+		if (g_changedFans & (1 << Fan))
+		{
+			FanArray_WriteCompare(g_fanTable[Fan].Pwm_Channel, Compare_Values[Fan]);
+		}
+	}
+
+	g_changedFans = 0;
+
+	IsrSync_ExitCritical(Sreg);
+}
+
+/*
+ * Description:
+ * Read the sensor of every fan (each ADC channel is read once per call even if it is shared),
+ * evaluate the curve of every fan, then commit the changes with FanArray_UpdateAll.
+ */
+void FanArray_Control(void)
+{
+	uint8 Temperatures[NUM_OF_PINS_PER_PORT];
+	uint8 Channels_Read = 0;
+	uint8 Channel;
+	uint8 Speed;
+	uint8 Fan;
+
+	for (Fan = 0; Fan < g_numOfFans; Fan++)
+	{
+		Channel = g_fanTable[Fan].Sensor_Channel & 0x07;
+
+		if (!(Channels_Read & (1 << Channel)))
+		{
+			Temperatures[Channel] = LM35_GetTemperatureFromChannel(Channel);
+			Channels_Read |= (1 << Channel);
+		}
+
+		g_fanTemperatures[Fan] = Temperatures[Channel];
+		Speed = FanCurve_GetSpeed(g_fanTable[Fan].Curve_Ptr, Temperatures[Channel]);
+
+		FanArray_SetSpeed(Fan, (Speed == 0) ? STOP : CW, Speed);
+	}
+
+	FanArray_UpdateAll();
+}
+
+/*
+ * Description:
+ * Return the last temperature read by FanArray_Control for the sensor of the required fan.
+ */
+uint8 FanArray_GetTemperature(uint8 Fan)
+{
+	return (Fan < g_numOfFans) ? g_fanTemperatures[Fan] : 0;
+}
+
+/*
+ * Description:
+ * Return the speed (percent) requested for the required fan.
+ */
+uint8 FanArray_GetSpeed(uint8 Fan)
+{
+	return (Fan < g_numOfFans) ? g_fanSpeeds[Fan] : 0;
+}
@@ -0,0 +1,134 @@
+/*******************************************************************************************************************
+ * File Name: Fan_Array.h
+ * Date: 19/10/2026
+ * Driver: Multi-Fan Motor Array Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+#include "DC_Motor.h"
+#include "Fan_Curve.h"
+#include "Temp_Sensor.h"
+
+#ifndef FAN_ARRAY_H_
+#define FAN_ARRAY_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/* One fan per hardware PWM output of the ATmega32 */
+#define FAN_ARRAY_MAX_FANS                         4
+
+/*
+ * All the channels run 8-bit Fast PWM at F_CPU/8/256 (488Hz at 1MHz) like Timer0 in the application,
+ * so one speed value means the same duty cycle on every channel.
+ * Timer0 (OC0) is not initialized here because the application owns it (it is also the system tick).
+ */
+#define FAN_ARRAY_TIMER1_PRESCALER                 TIMER1_Prescaler_8
+#define FAN_ARRAY_TIMER1_TOP                       255
+#define FAN_ARRAY_TIMER2_PRESCALER                 TIMER2_Prescaler_8
+
+/*
+ * The channels of Timer1 (OC1A, OC1B) and Timer2 (OC2) can be left out: the timer is not initialized and the
+ * fans of these channels only follow their direction pins (their PWM input tied high). The DS18B20 needs Timer1
+ * for the 1-Wire slots (One_Wire.h) and its bus is PD7, the OC2 pin, so both are left out with that sensor.
+ */
+#ifndef FAN_ARRAY_TIMER1_ENABLED
+#define FAN_ARRAY_TIMER1_ENABLED                   (TEMP_SENSOR_SOURCE != TEMP_SENSOR_SOURCE_DS18B20)
+#endif
+
+#ifndef FAN_ARRAY_TIMER2_ENABLED
+#define FAN_ARRAY_TIMER2_ENABLED                   (TEMP_SENSOR_SOURCE != TEMP_SENSOR_SOURCE_DS18B20)
+#endif
+
+#if ((TEMP_SENSOR_SOURCE == TEMP_SENSOR_SOURCE_DS18B20) && FAN_ARRAY_TIMER1_ENABLED)
+
+#error "Timer1 is the 1-Wire time base of the DS18B20, set FAN_ARRAY_TIMER1_ENABLED to 0"
+
+#endif
+
+#if ((TEMP_SENSOR_SOURCE == TEMP_SENSOR_SOURCE_DS18B20) && FAN_ARRAY_TIMER2_ENABLED)
+
+#error "OC2 (PD7) is the 1-Wire bus of the DS18B20, set FAN_ARRAY_TIMER2_ENABLED to 0"
+
+#endif
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+typedef enum
+{
+	FAN_ARRAY_OC0,     /* PB3, Timer0 */
+	FAN_ARRAY_OC1A,    /* PD5, Timer1 */
+	FAN_ARRAY_OC1B,    /* PD4, Timer1 */
+	FAN_ARRAY_OC2      /* PD7, Timer2 */
+}FanArray_PwmChannel;
+
+/*
+ * One row of the fan table, for example:
+ * static const FanArray_FanConfigType Fans[] =
+ * {
+ *     {PORTB_ID, PIN0_ID, PIN1_ID, FAN_ARRAY_OC0,  ADC2, &Curve_Intake},
+ *     {PORTB_ID, PIN4_ID, PIN5_ID, FAN_ARRAY_OC1A, ADC3, &Curve_Exhaust},
+ * };
+ */
+typedef struct
+{
+	uint8 Direction_Port;
+	uint8 Pin_A;
+	uint8 Pin_B;
+	FanArray_PwmChannel Pwm_Channel;
+	uint8 Sensor_Channel;
+	const FanCurve_Type *Curve_Ptr;
+}FanArray_FanConfigType;
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the fan array.
+ * 1. Keep a reference to the fan table (it must stay valid, normally a const table).
+ * 2. Setup the direction pins of every fan as output pins and stop all the fans.
+ * 3. Initialize Timer1 and/or Timer2 PWM if any fan uses their channels (and they are enabled).
+ */
+void FanArray_Init(const FanArray_FanConfigType *Table_Ptr, uint8 Num_Of_Fans);
+
+/*
+ * Description:
+ * Request a new state and speed (percent) for one fan, nothing is written to the hardware until
+ * FanArray_UpdateAll is called. A request equal to the current output costs nothing.
+ */
+void FanArray_SetSpeed(uint8 Fan, DcMotor_State State, uint8 Speed);
+
+/*
+ * Description:
+ * Commit all the requested changes in one pass.
+ * 1. Return immediately if no fan has changed.
+ * 2. Write the direction pins of all the changed fans with one write per port.
+ * 3. Write the compare registers of the changed fans.
+ */
+void FanArray_UpdateAll(void);
+
+/*
+ * Description:
+ * Read the sensor of every fan (each ADC channel is read once per call even if it is shared),
+ * evaluate the curve of every fan, then commit the changes with FanArray_UpdateAll.
+ */
+void FanArray_Control(void);
+
+/*
+ * Description:
+ * Return the last temperature read by FanArray_Control for the sensor of the required fan.
+ */
+uint8 FanArray_GetTemperature(uint8 Fan);
+
+/*
+ * Description:
+ * Return the speed (percent) requested for the required fan.
+ */
+uint8 FanArray_GetSpeed(uint8 Fan);
+
+#endif /* FAN_ARRAY_H_ */
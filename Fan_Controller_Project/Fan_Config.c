@@ -0,0 +1,150 @@
+/*******************************************************************************************************************
+ * File Name: Fan_Config.c
+ * Date: 19/10/2026
+ * Driver: Fan Controller Configuration Store (EEPROM) Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "CRC.h"
+#include "EEPROM.h"
+#include "Fan_Config.h"
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+FanConfig_Type g_FanConfig;
+
+/* Copy of the block which is being written by the EEPROM driver */
+static FanConfig_Type g_FanConfigShadow;
+
+static const FanConfig_Type g_FanConfigDefaults =
+{
+	FAN_CONFIG_MAGIC,
+	FAN_CONFIG_VERSION,
+	sizeof(FanConfig_Type),
+	FAN_CONFIG_DEFAULT_SENSOR_CHANNEL,
+	FAN_CONFIG_DEFAULT_ADC_VOLTAGE_REF,
+	FAN_CONFIG_DEFAULT_ADC_PRESCALAR,
+	FAN_CONFIG_DEFAULT_ADC_TRIGGER_SOURCE,
+	FAN_CONFIG_DEFAULT_TIMER0_MODE,
+	FAN_CONFIG_DEFAULT_TIMER0_PRESCALAR,
+	FAN_CONFIG_DEFAULT_CURVE,
+	0
+};
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * The CRC covers the whole block except the CRC field itself.
+ */
+static uint16 FanConfig_CalculateCrc(const FanConfig_Type *Config_Ptr)
+{
+	return CRC16_CCITT_Calculate((const uint8 *)Config_Ptr, sizeof(FanConfig_Type) - sizeof(uint16));
+}
+
+/*
+ * Description:
+ * The ADC clock must stay within the range required by the ADC and the Timer0 settings must be the
+ * ones solved for F_CPU, a block saved by a firmware built for another clock frequency is rejected.
+ */
+static boolean FanConfig_IsClockValid(const FanConfig_Type *Config_Ptr)
+{
+	uint32 Adc_Clock;
+
+	if (Config_Ptr -> Adc_Prescalar > CLK_128)
+	{
+		return FALSE;
+	}
+
+	Adc_Clock = F_CPU / CLOCK_SOLVER_ADC_DIVISION_OF(Config_Ptr -> Adc_Prescalar);
+
+	return ((Adc_Clock >= CLOCK_SOLVER_ADC_MIN_HZ) && (Adc_Clock <= CLOCK_SOLVER_ADC_MAX_HZ) &&
+			(Config_Ptr -> Timer0_Mode == CLOCK_SOLVER_TIMER0_MODE) &&
+			(Config_Ptr -> Timer0_Prescalar == CLOCK_SOLVER_TIMER0_PRESCALAR)) ? TRUE : FALSE;
+}
+
+/*
+ * Description:
+ * Load the configuration block from the EEPROM into g_FanConfig (called once at startup).
+ * 1. Check the magic number, the version, the length and the CRC of the stored block.
+ * 2. Check the stored clock settings still match F_CPU (the block may come from a build at another clock).
+ * 3. If any check fails, load the compiled default values instead.
+ * 4. Return TRUE if the EEPROM block is valid, FALSE if the defaults are used.
+ */
+boolean FanConfig_Load(void)
+{
+	EEPROM_ReadBlock(FAN_CONFIG_EEPROM_ADDRESS, (uint8 *)&g_FanConfig, sizeof(FanConfig_Type));
+
+	if ((g_FanConfig.Magic == FAN_CONFIG_MAGIC) &&
+		(g_FanConfig.Version == FAN_CONFIG_VERSION) &&
+		(g_FanConfig.Length == sizeof(FanConfig_Type)) &&
+		(g_FanConfig.Crc == FanConfig_CalculateCrc(&g_FanConfig)) &&
+		FanConfig_IsClockValid(&g_FanConfig))
+	{
+		return TRUE;
+	}
+
+	FanConfig_LoadDefaults();
+	return FALSE;
+}
+
+/*
+ * Description:
+ * Load the compiled default values into g_FanConfig.
+ */
+void FanConfig_LoadDefaults(void)
+{
+	g_FanConfig = g_FanConfigDefaults;
+	g_FanConfig.Crc = FanConfig_CalculateCrc(&g_FanConfig);
+}
+
+/*
+ * Description:
+ * Save g_FanConfig to the EEPROM without blocking.
+ * 1. Update the header and the CRC of g_FanConfig.
+ * 2. Take a copy of the block so g_FanConfig can be changed while the write is in progress.
+ * 3. Start the interrupt driven EEPROM write.
+ * 4. Return FALSE if a previous save is still in progress.
+ */
+boolean FanConfig_Save(void)
+{
+	if (EEPROM_IsBusy())
+	{
+		return FALSE;
+	}
+
+	g_FanConfig.Magic = FAN_CONFIG_MAGIC;
+	g_FanConfig.Version = FAN_CONFIG_VERSION;
+	g_FanConfig.Length = sizeof(FanConfig_Type);
+	g_FanConfig.Crc = FanConfig_CalculateCrc(&g_FanConfig);
+
+	g_FanConfigShadow = g_FanConfig;
+
+	return EEPROM_WriteBlock(FAN_CONFIG_EEPROM_ADDRESS, (const uint8 *)&g_FanConfigShadow, sizeof(FanConfig_Type));
+}
+
+/*
+ * Description:
+ * Fill the ADC driver configuration structure from g_FanConfig.
+ */
+void FanConfig_GetADCConfig(ADC_ConfigType *Config_Ptr)
+{
+	Config_Ptr -> Voltage_Ref = (VoltageReference_Select)g_FanConfig.Adc_VoltageRef;
+	Config_Ptr -> ADC_Prescalar = (ADC_ClockSelect)g_FanConfig.Adc_Prescalar;
+	Config_Ptr -> Trigger_Source = (ADC_AutoTriggerSource)g_FanConfig.Adc_TriggerSource;
+}
+
+/*
+ * Description:
+ * Fill the Timer0 driver configuration structure from g_FanConfig.
+ */
+void FanConfig_GetTimer0Config(TIMER0_ConfigType *Config_Ptr)
+{
+	Config_Ptr -> Initial_Value = 0;
+	Config_Ptr -> Compare_Value = 0;
+	Config_Ptr -> Timer_Mode = (WaveFormGenerationMode)g_FanConfig.Timer0_Mode;
+	Config_Ptr -> Prescalar = (TIMER0_Clock_Select)g_FanConfig.Timer0_Prescalar;
+}
@@ -0,0 +1,113 @@
+/*******************************************************************************************************************
+ * File Name: Fan_Config.h
+ * Date: 19/10/2026
+ * Driver: Fan Controller Configuration Store (EEPROM) Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+#include "ADC.h"
+#include "TIMER0.h"
+#include "LM35.h"
+#include "Fan_Curve.h"
+#include "Clock_Solver.h"
+
+#ifndef FAN_CONFIG_H_
+#define FAN_CONFIG_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/* Location and identification of the configuration block in the EEPROM */
+#define FAN_CONFIG_EEPROM_ADDRESS                  0x0000
+#define FAN_CONFIG_MAGIC                           0xFC
+
+/* Increment the version whenever the layout or the meaning of FanConfig_Type changes */
+#define FAN_CONFIG_VERSION                         1
+
+/* Compiled default values, used when the EEPROM block is erased, corrupted or from another version */
+#define FAN_CONFIG_DEFAULT_SENSOR_CHANNEL          LM35_SENSOR_READ_CHANNEL
+#define FAN_CONFIG_DEFAULT_ADC_VOLTAGE_REF         Internal_VREF
+#define FAN_CONFIG_DEFAULT_ADC_PRESCALAR           CLOCK_SOLVER_ADC_PRESCALAR
+#define FAN_CONFIG_DEFAULT_ADC_TRIGGER_SOURCE      TIMER0_OVF
+#define FAN_CONFIG_DEFAULT_TIMER0_MODE             CLOCK_SOLVER_TIMER0_MODE
+#define FAN_CONFIG_DEFAULT_TIMER0_PRESCALAR        CLOCK_SOLVER_TIMER0_PRESCALAR
+
+/* The curve can be given by the build instead, e.g. the header written by Host_Tools/Curve_Optimizer */
+#ifndef FAN_CONFIG_DEFAULT_CURVE
+#define FAN_CONFIG_DEFAULT_CURVE                   {{30, 60, 90, 120}, {0, 25, 50, 75, 100}}
+#endif
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+/*
+ * The configuration block exactly as it is stored in the EEPROM.
+ * Only uint8/uint16 members are used (no enums) so the layout does not depend on the compiler options.
+ */
+typedef struct
+{
+	uint8 Magic;
+	uint8 Version;
+	uint8 Length;
+	uint8 Sensor_Channel;
+	uint8 Adc_VoltageRef;
+	uint8 Adc_Prescalar;
+	uint8 Adc_TriggerSource;
+	uint8 Timer0_Mode;
+	uint8 Timer0_Prescalar;
+	FanCurve_Type Curve;
+	uint16 Crc;
+}FanConfig_Type;
+
+/*******************************************************************************************
+ *                                    External Variables                                   *
+ *******************************************************************************************/
+
+/* The RAM copy of the configuration, loaded once at startup by FanConfig_Load */
+extern FanConfig_Type g_FanConfig;
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Load the configuration block from the EEPROM into g_FanConfig (called once at startup).
+ * 1. Check the magic number, the version, the length and the CRC of the stored block.
+ * 2. Check the stored clock settings still match F_CPU (the block may come from a build at another clock).
+ * 3. If any check fails, load the compiled default values instead.
+ * 4. Return TRUE if the EEPROM block is valid, FALSE if the defaults are used.
+ */
+boolean FanConfig_Load(void);
+
+/*
+ * Description:
+ * Load the compiled default values into g_FanConfig.
+ */
+void FanConfig_LoadDefaults(void);
+
+/*
+ * Description:
+ * Save g_FanConfig to the EEPROM without blocking.
+ * 1. Update the header and the CRC of g_FanConfig.
+ * 2. Take a copy of the block so g_FanConfig can be changed while the write is in progress.
+ * 3. Start the interrupt driven EEPROM write.
+ * 4. Return FALSE if a previous save is still in progress.
+ */
+boolean FanConfig_Save(void);
+
+/*
+ * Description:
+ * Fill the ADC driver configuration structure from g_FanConfig.
+ */
+void FanConfig_GetADCConfig(ADC_ConfigType *Config_Ptr);
+
+/*
+ * Description:
+ * Fill the Timer0 driver configuration structure from g_FanConfig.
+ */
+void FanConfig_GetTimer0Config(TIMER0_ConfigType *Config_Ptr);
+
+#endif /* FAN_CONFIG_H_ */
@@ -0,0 +1,36 @@
+/*******************************************************************************************************************
+ * File Name: Fan_Curve.c
+ * Date: 19/10/2026
+ * Driver: Fan Curve (Temperature to Speed) Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Fan_Curve.h"
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Return the level of the temperature in the curve thresholds (0 to FAN_CURVE_NUM_OF_THRESHOLDS).
+ */
+uint8 FanCurve_GetLevel(const FanCurve_Type *Curve_Ptr, uint8 Temperature)
+{
+	uint8 Level = 0;
+
+	while ((Level < FAN_CURVE_NUM_OF_THRESHOLDS) && (Temperature >= Curve_Ptr -> Thresholds[Level]))
+	{
+		Level++;
+	}
+
+	return Level;
+}
+
+/*
+ * Description:
+ * Return the fan speed in percent for the temperature.
+ */
+uint8 FanCurve_GetSpeed(const FanCurve_Type *Curve_Ptr, uint8 Temperature)
+{
+	return Curve_Ptr -> Speeds[FanCurve_GetLevel(Curve_Ptr, Temperature)];
+}
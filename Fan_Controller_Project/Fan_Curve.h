@@ -0,0 +1,50 @@
+/*******************************************************************************************************************
+ * File Name: Fan_Curve.h
+ * Date: 19/10/2026
+ * Driver: Fan Curve (Temperature to Speed) Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+
+#ifndef FAN_CURVE_H_
+#define FAN_CURVE_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/* Number of temperature thresholds, the number of speed levels is one more */
+#define FAN_CURVE_NUM_OF_THRESHOLDS                4
+#define FAN_CURVE_NUM_OF_LEVELS                    (FAN_CURVE_NUM_OF_THRESHOLDS + 1)
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+/*
+ * Level 0 is below Thresholds[0], level n is from Thresholds[n-1] up to below Thresholds[n].
+ * The thresholds must be in ascending order, the speeds are in percent (0 stops the fan).
+ */
+typedef struct
+{
+	uint8 Thresholds[FAN_CURVE_NUM_OF_THRESHOLDS];
+	uint8 Speeds[FAN_CURVE_NUM_OF_LEVELS];
+}FanCurve_Type;
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Return the level of the temperature in the curve thresholds (0 to FAN_CURVE_NUM_OF_THRESHOLDS).
+ */
+uint8 FanCurve_GetLevel(const FanCurve_Type *Curve_Ptr, uint8 Temperature);
+
+/*
+ * Description:
+ * Return the fan speed in percent for the temperature.
+ */
+uint8 FanCurve_GetSpeed(const FanCurve_Type *Curve_Ptr, uint8 Temperature);
+
+#endif /* FAN_CURVE_H_ */
@@ -0,0 +1,135 @@
+/*******************************************************************************************************************
+ * File Name: Fan_Safety.c
+ * Date: 19/10/2026
+ * Driver: Emergency Over Temperature Fast Path (ADC Interrupt) Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <util/atomic.h>
+#include "ADC.h"
+#include "LM35.h"
+#include "DC_Motor.h"
+#include "Isr_Sync.h"
+#include "Clock_Solver.h"
+#include "Fan_Safety.h"
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+static uint16 g_criticalCode = ADC_MAX_VALUE + 1;
+static volatile boolean g_faulted = FALSE;
+static volatile uint8 g_reactionTicks = 0;
+
+/* Consecutive results of a digital sensor above the critical code (FanSafety_CheckCode) */
+static uint8 g_samplesAbove = 0;
+
+/* Global variables to hold the address of the call back function in the application */
+static void (* volatile g_CallBackPtr)(void) = NULL_PTR;
+
+/****************************************************************************************
+ *                                      Interrupt Call Backs                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * ADC limit call back: the critical temperature is confirmed, force the motor to full speed first.
+ */
+static void FanSafety_Trip(void)
+{
+	if (!g_faulted)
+	{
+		DcMotor_EmergencyFullSpeed();
+
+		/* The conversion was triggered when Timer0 overflowed (TCNT0 = 0) */
+		g_reactionTicks = TCNT0;
+		g_faulted = TRUE;
+
+		if (g_CallBackPtr != NULL_PTR)
+		{
+			(*g_CallBackPtr)();
+		}
+	}
+}
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the over temperature fast path (after DcMotor_Init and ADC_Init).
+ * 1. Convert the critical temperature to a raw ADC code once.
+ * 2. Set the limit of the ADC interrupt, every single conversion is checked before any other processing
+ *    (LM35 source only).
+ */
+void FanSafety_Init(uint8 Critical_Temperature)
+{
+	g_criticalCode = LM35_TemperatureToCode(Critical_Temperature);
+	g_faulted = FALSE;
+	g_reactionTicks = 0;
+	g_samplesAbove = 0;
+
+#if (TEMP_SENSOR_SOURCE == TEMP_SENSOR_SOURCE_LM35)
+	ADC_SetLimit(LM35_ADC_SLOT, g_criticalCode, FAN_SAFETY_CONFIRM_SAMPLES, FanSafety_Trip);
+#endif
+}
+
+/*
+ * Description:
+ * Check a result of a digital sensor, as a code of the LM35 scale, against the critical code: the fault
+ * is latched after FAN_SAFETY_CONFIRM_SAMPLES consecutive results above it, as for the ADC fast path.
+ */
+void FanSafety_CheckCode(uint16 Code)
+{
+	if (Code < g_criticalCode)
+	{
+		g_samplesAbove = 0;
+		return;
+	}
+
+	if (g_samplesAbove < FAN_SAFETY_CONFIRM_SAMPLES)
+	{
+		g_samplesAbove++;
+	}
+	if (g_samplesAbove >= FAN_SAFETY_CONFIRM_SAMPLES)
+	{
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			FanSafety_Trip();
+		}
+	}
+}
+
+/*
+ * Description:
+ * Return TRUE once the fault is latched (the motor is held at full speed till the next reset).
+ */
+boolean FanSafety_IsFaulted(void)
+{
+	return g_faulted;
+}
+
+/*
+ * Description:
+ * Return the latency of the last trip in CPU cycles, from the Timer0 overflow which triggered the
+ * critical conversion to the motor at full speed (valid with the TIMER0_OVF trigger source only).
+ */
+uint32 FanSafety_GetReactionCycles(void)
+{
+	return (uint32)g_reactionTicks * CLOCK_SOLVER_TIMER0_DIVISION;
+}
+
+/*
+ * Description:
+ * Function to set the Call Back function address, it is called from the ADC interrupt once when the
+ * fault is latched.
+ */
+void FanSafety_SetCallBack(void(*a_ptr)(void))
+{
+	/* The 16-bit address is read by the interrupt */
+	uint8 Sreg = IsrSync_EnterCritical();
+
+	g_CallBackPtr = a_ptr;
+	IsrSync_ExitCritical(Sreg);
+}
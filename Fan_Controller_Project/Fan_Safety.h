@@ -0,0 +1,104 @@
+/*******************************************************************************************************************
+ * File Name: Fan_Safety.h
+ * Date: 19/10/2026
+ * Driver: Emergency Over Temperature Fast Path (ADC Interrupt) Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+#include "Clock_Solver.h"
+#include "Temp_Sensor.h"
+
+#ifndef FAN_SAFETY_H_
+#define FAN_SAFETY_H_
+
+/*
+ * Reaction latency, from the Timer0 overflow which triggers the critical conversion to the motor at full speed,
+ * budget FAN_SAFETY_REACTION_BUDGET_CYCLES (1269 cycles at 1MHz):
+ *     conversion:  13.5 ADC clocks for an auto triggered conversion (108 cycles at 1MHz with F_CPU/8)
+ *   + blocking:    the longest section which delays the ADC interrupt, FAN_SAFETY_BLOCKING_CYCLES
+ *   + response:    up to 4 cycles to finish the current instruction, 4 cycles to push the PC, 3 cycles jump
+ *   + fast path:   FAN_SAFETY_FAST_PATH_CYCLES, ADC interrupt prologue, limit check and DcMotor_EmergencyFullSpeed,
+ *                  constant time (no loop, no division, no driver call)
+ * The AVR interrupts are not nested, the blocking sections of the application (estimated for avr-gcc -Os) are:
+ *     - the Timer0 overflow interrupt, entered at the same edge as the conversion: SysTime_Tick divides a 32-bit
+ *       count by 1000 (about 650 cycles in the library division) and the motor profile steps, about 800 cycles,
+ *     - DcMotor_Rotate computes the length of the brake profile with a 32-bit division inside its ATOMIC_BLOCK,
+ *       about 700 cycles,
+ *     - the EEPROM Ready interrupt and the USART and Timer2 interrupts of the Modbus slave, below 150 cycles.
+ * A module added to the application must keep its interrupts and critical sections under FAN_SAFETY_BLOCKING_CYCLES:
+ * Soft_PWM.c busy waits the edges closer than SOFT_PWM_EDGE_MARGIN_TICKS, up to 8 edges of 12 ticks in one
+ * interrupt (768 cycles), which fits. The 1-Wire interrupt of One_Wire.c busy waits the short pulses of a read
+ * slot and the windows closer than its own entry, ONE_WIRE_ISR_CYCLES (325 at 1MHz), and One_Wire.c checks it.
+ * The critical temperature must be seen on FAN_SAFETY_CONFIRM_SAMPLES consecutive conversions of the sensor slot,
+ * one per round of the ADC schedule (every other PWM period with the current sensing), or one every 16 rounds
+ * (65ms) at the slowest adaptive sampling rate of a stable temperature (Sample_Rate.h).
+ * The measured latency of the last trip is kept (FanSafety_GetReactionCycles); Host_Tools/Thermal_Sim trips the
+ * fault (--initial 150) and fails when it is above the budget.
+ * With a digital sensor (TEMP_SENSOR_SOURCE) there is no ADC fast path: its results, converted to codes of the
+ * LM35 scale by Temp_Monitor.c, are checked by FanSafety_CheckCode from the main loop.
+ * The fault is latched till the next reset: the motor stays at full speed and "MAX" stays on the LCD, also after
+ * TEMP_SENSOR_MAX_FAILURES failed reads of a digital sensor (a lost sensor is read as MAX_LM35_TEMPERATURE).
+ */
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/* Temperature which trips the fast path, above the highest threshold of the fan curve */
+#define FAN_SAFETY_CRITICAL_TEMPERATURE            140
+
+/* Consecutive conversions above the critical temperature before tripping (rejects a single noisy sample) */
+#define FAN_SAFETY_CONFIRM_SAMPLES                 2
+
+/* Terms of the reaction latency in CPU cycles, see above */
+#define FAN_SAFETY_CONVERSION_CYCLES               ((27UL * CLOCK_SOLVER_ADC_DIVISION) / 2UL)
+#define FAN_SAFETY_BLOCKING_CYCLES                 1000UL
+#define FAN_SAFETY_RESPONSE_CYCLES                 11UL
+
+/* Fast path by instruction count, from the ADC vector to the motor pins (about 40 cycles of prologue) */
+#define FAN_SAFETY_FAST_PATH_CYCLES                150UL
+
+#define FAN_SAFETY_REACTION_BUDGET_CYCLES          (FAN_SAFETY_CONVERSION_CYCLES + FAN_SAFETY_BLOCKING_CYCLES + \
+                                                    FAN_SAFETY_RESPONSE_CYCLES + FAN_SAFETY_FAST_PATH_CYCLES)
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the over temperature fast path (after DcMotor_Init and ADC_Init).
+ * 1. Convert the critical temperature to a raw ADC code once.
+ * 2. Set the limit of the ADC interrupt, every single conversion is checked before any other processing
+ *    (LM35 source only).
+ */
+void FanSafety_Init(uint8 Critical_Temperature);
+
+/*
+ * Description:
+ * Check a result of a digital sensor, as a code of the LM35 scale, against the critical code: the fault
+ * is latched after FAN_SAFETY_CONFIRM_SAMPLES consecutive results above it, as for the ADC fast path.
+ */
+void FanSafety_CheckCode(uint16 Code);
+
+/*
+ * Description:
+ * Return TRUE once the fault is latched (the motor is held at full speed till the next reset).
+ */
+boolean FanSafety_IsFaulted(void);
+
+/*
+ * Description:
+ * Return the latency of the last trip in CPU cycles, from the Timer0 overflow which triggered the
+ * critical conversion to the motor at full speed (valid with the TIMER0_OVF trigger source only).
+ */
+uint32 FanSafety_GetReactionCycles(void);
+
+/*
+ * Description:
+ * Function to set the Call Back function address, it is called from the ADC interrupt once when the
+ * fault is latched.
+ */
+void FanSafety_SetCallBack(void(*a_ptr)(void));
+
+#endif /* FAN_SAFETY_H_ */
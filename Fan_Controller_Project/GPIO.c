@@ -7,6 +7,7 @@
 #include <avr/io.h>
 #include "GPIO.h"
 #include "Common_Macros.h"
+#include "Isr_Sync.h"
 
 /****************************************************************************************
  *                                      Functions Definitions                           *
@@ -80,12 +81,18 @@ void GPIO_SetupPinDirection(uint8 Port_Num, uint8 Pin_Num, uint8 GPIO_PinDirecti
  * write the value LOGIC HIGH or LOGIC LOW on the required PIN in the required PORT
  * If the PORT or PIN numbers are not correct, the function will not handle the request
  * If the PIN is INPUT PIN, so the PIN will enable/disable the internal pull-up resistor
+ * The read-modify-write of the PORT register is done with the interrupts disabled, so a pin of the same PORT
+ * written by an interrupt (Soft_PWM.c) is never lost
  */
 void GPIO_WritePin(uint8 Port_Num, uint8 Pin_Num, uint8 value)
 {
+	uint8 Sreg;
+
 	/* CHECK IF THE CORRECT NUMBER OF PORT AND NUMBER OF PIN ARE ENTERED */
 	if ((Port_Num >= PORTA_ID && Port_Num <= PORTD_ID) && (Pin_Num >= PIN0_ID && Pin_Num <= PIN7_ID))
 	{
+		Sreg = IsrSync_EnterCritical();
+
 		switch(Port_Num)
 		{
 		case PORTA_ID:
@@ -132,6 +139,8 @@ void GPIO_WritePin(uint8 Port_Num, uint8 Pin_Num, uint8 value)
 			}
 			break;
 		}
+
+		IsrSync_ExitCritical(Sreg);
 	}
 	else
 	{
@@ -61,6 +61,8 @@ void GPIO_SetupPinDirection(uint8 Port_num, uint8 Pin_num, uint8 GPIO_PinDirecti
  * write the value LOGIC HIGH or LOGIC LOW on the required PIN in the required PORT
  * If the PORT or PIN numbers are not correct, the function will not handle the request
  * If the PIN is INPUT PIN, so the PIN will enable/disable the internal pull-up resistor
+ * The read-modify-write of the PORT register is done with the interrupts disabled, so a pin of the same PORT
+ * written by an interrupt (Soft_PWM.c) is never lost
  */
 void GPIO_WritePin(uint8 Port_num, uint8 Pin_num, uint8 value);
 
@@ -0,0 +1,175 @@
+/*******************************************************************************************************************
+ * File Name: Isr_Sync.h
+ * Date: 19/10/2026
+ * Driver: Data Shared with the Interrupts (Critical Sections, Sequence Snapshots and SPSC Queues) Header File
+ * Author: Youssef Zaki
+ *
+ * The AVR reads and writes one byte per instruction, so a multi-byte variable shared with an interrupt can
+ * be read torn (half old, half new value). Three ways to share it, from the most general to the cheapest:
+ * 1. Critical section: save SREG, disable the interrupts, restore SREG (the interrupts are enabled again
+ *    only if they were enabled before, so it can be used in an interrupt and nested).
+ *    For the read-modify-write of several variables. It delays every interrupt.
+ * 2. Sequence snapshot: the writer increments a sequence counter before and after the write, the reader
+ *    copies the value and tries again if the counter was odd or has changed. The interrupts are never
+ *    disabled, so the reaction time of the other interrupts (Fan_Safety.c) does not grow.
+ *    The writer must not be preempted by the reader: the writer is an interrupt and the reader the main
+ *    loop, or both are in the main loop, or the writer runs with the interrupts disabled.
+ * 3. Single producer single consumer queue: the producer only writes the head index and the consumer only
+ *    writes the tail index, both one byte, so no critical section at all (an interrupt and the main loop).
+ * The snapshots and the queues are generated per type by macros (static inline functions, no code is
+ * added for the functions which are not used).
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "Standard_Types.h"
+
+#ifndef ISR_SYNC_H_
+#define ISR_SYNC_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/* The compiler must not move the memory accesses across this point (no instruction is generated) */
+#define ISR_SYNC_BARRIER()                         __asm__ __volatile__ ("" ::: "memory")
+
+/****************************************************************************************
+ *                                   Critical Sections                                  *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Disable the interrupts and return the previous SREG to be given to IsrSync_ExitCritical.
+ */
+static inline uint8 IsrSync_EnterCritical(void)
+{
+	uint8 Sreg = SREG;
+
+	cli();
+	ISR_SYNC_BARRIER();
+	return Sreg;
+}
+
+/*
+ * Description:
+ * Restore the SREG saved by IsrSync_EnterCritical (the interrupts are enabled again only if they were).
+ */
+static inline void IsrSync_ExitCritical(uint8 Sreg)
+{
+	ISR_SYNC_BARRIER();
+	SREG = Sreg;
+}
+
+/****************************************************************************************
+ *                                  Sequence Snapshots                                  *
+ ****************************************************************************************/
+
+/*
+ * Generate the type Name_Type holding a value of Type with its sequence counter, and its functions:
+ *     void Name_Store(Name_Type *Snapshot_Ptr, Type Value)
+ *     Type Name_Load(const Name_Type *Snapshot_Ptr)
+ * The writer context can read Snapshot_Ptr -> Value directly. A zero initialized snapshot is valid.
+ */
+#define ISR_SYNC_SNAPSHOT_DEFINE(Name, Type)                                                     \
+                                                                                                 \
+typedef struct                                                                                   \
+{                                                                                                \
+	volatile uint8 Sequence;                                                                     \
+	Type Value;                                                                                  \
+}Name##_Type;                                                                                    \
+                                                                                                 \
+static inline void Name##_Store(Name##_Type *Snapshot_Ptr, Type Value)                           \
+{                                                                                                \
+	Snapshot_Ptr -> Sequence++;                                                                  \
+	ISR_SYNC_BARRIER();                                                                          \
+	Snapshot_Ptr -> Value = Value;                                                               \
+	ISR_SYNC_BARRIER();                                                                          \
+	Snapshot_Ptr -> Sequence++;                                                                  \
+}                                                                                                \
+                                                                                                 \
+static inline Type Name##_Load(const Name##_Type *Snapshot_Ptr)                                  \
+{                                                                                                \
+	Type Value;                                                                                  \
+	uint8 Sequence;                                                                              \
+                                                                                                 \
+	do                                                                                           \
+	{                                                                                            \
+		Sequence = Snapshot_Ptr -> Sequence;                                                     \
+		ISR_SYNC_BARRIER();                                                                      \
+		Value = Snapshot_Ptr -> Value;                                                           \
+		ISR_SYNC_BARRIER();                                                                      \
+	} while ((Sequence & 1) || (Sequence != Snapshot_Ptr -> Sequence));                          \
+                                                                                                 \
+	return Value;                                                                                \
+}
+
+/****************************************************************************************
+ *                          Single Producer Single Consumer Queues                      *
+ ****************************************************************************************/
+
+/*
+ * Generate the type Name_Type, a queue of Size items of Type (Size is a power of 2 from 2 to 128), and its
+ * functions:
+ *     void Name_Init(Name_Type *Queue_Ptr)
+ *     boolean Name_Push(Name_Type *Queue_Ptr, Type Item)      producer, FALSE if the queue is full
+ *     boolean Name_Pop(Name_Type *Queue_Ptr, Type *Item_Ptr)  consumer, FALSE if the queue is empty
+ *     uint8 Name_Count(const Name_Type *Queue_Ptr)             either side
+ * The indexes run freely over 0..255 and are masked on access, Head - Tail is the number of items.
+ * A zero initialized queue is empty.
+ */
+#define ISR_SYNC_QUEUE_DEFINE(Name, Type, Size)                                                  \
+                                                                                                 \
+typedef char Name##_SizeCheck[((((Size) & ((Size) - 1)) == 0) && ((Size) >= 2) && ((Size) <= 128)) ? 1 : -1]; \
+                                                                                                 \
+typedef struct                                                                                   \
+{                                                                                                \
+	volatile uint8 Head;                                                                         \
+	volatile uint8 Tail;                                                                         \
+	Type Items[Size];                                                                            \
+}Name##_Type;                                                                                    \
+                                                                                                 \
+static inline void Name##_Init(Name##_Type *Queue_Ptr)                                           \
+{                                                                                                \
+	Queue_Ptr -> Head = 0;                                                                       \
+	Queue_Ptr -> Tail = 0;                                                                       \
+}                                                                                                \
+                                                                                                 \
+static inline boolean Name##_Push(Name##_Type *Queue_Ptr, Type Item)                             \
+{                                                                                                \
+	uint8 Head = Queue_Ptr -> Head;                                                              \
+                                                                                                 \
+	if ((uint8)(Head - Queue_Ptr -> Tail) >= (Size))                                             \
+	{                                                                                            \
+		return FALSE;                                                                            \
+	}                                                                                            \
+                                                                                                 \
+	/* The item is complete before the consumer can see the new head */                         \
+	Queue_Ptr -> Items[Head & ((Size) - 1)] = Item;                                              \
+	ISR_SYNC_BARRIER();                                                                          \
+	Queue_Ptr -> Head = Head + 1;                                                                \
+	return TRUE;                                                                                 \
+}                                                                                                \
+                                                                                                 \
+static inline boolean Name##_Pop(Name##_Type *Queue_Ptr, Type *Item_Ptr)                         \
+{                                                                                                \
+	uint8 Tail = Queue_Ptr -> Tail;                                                              \
+                                                                                                 \
+	if (Queue_Ptr -> Head == Tail)                                                               \
+	{                                                                                            \
+		return FALSE;                                                                            \
+	}                                                                                            \
+                                                                                                 \
+	/* The item is copied before the producer can reuse its place */                             \
+	ISR_SYNC_BARRIER();                                                                          \
+	*Item_Ptr = Queue_Ptr -> Items[Tail & ((Size) - 1)];                                         \
+	ISR_SYNC_BARRIER();                                                                          \
+	Queue_Ptr -> Tail = Tail + 1;                                                                \
+	return TRUE;                                                                                 \
+}                                                                                                \
+                                                                                                 \
+static inline uint8 Name##_Count(const Name##_Type *Queue_Ptr)                                   \
+{                                                                                                \
+	return (uint8)(Queue_Ptr -> Head - Queue_Ptr -> Tail);                                       \
+}
+
+#endif /* ISR_SYNC_H_ */
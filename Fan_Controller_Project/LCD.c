@@ -10,32 +10,62 @@
 #include "Common_Macros.h"
 #include "GPIO.h"
 
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+/* A command of the background initialization and the time to wait before sending it */
+typedef struct
+{
+	uint8 Command;
+	uint8 Delay_ms;
+}LCD_InitStepType;
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+/* The same commands as LCD_Init, every command waits at least one time step after the previous one */
+static const LCD_InitStepType g_initSteps[] =
+{
+#if (LCD_BIT_MODE == 8)
+	{LCD_TWO_LINES_EIGHT_BIT_MODE, LCD_POWER_ON_DELAY_MS},
+#elif (LCD_BIT_MODE == 4)
+	{LCD_TWO_LINES_FOUR_BITS_MODE_INIT1, LCD_POWER_ON_DELAY_MS},
+	{LCD_TWO_LINES_FOUR_BITS_MODE_INIT2, 0},
+	{LCD_TWO_LINES_FOUR_BIT_MODE, 0},
+#endif
+	{CLEAR_DISPLAY_SCREEN, 0},
+	{DISPLAY_ON_CURSOR_OFF, LCD_CLEAR_DELAY_MS}
+};
+
+#define LCD_NUM_OF_INIT_STEPS                      (sizeof(g_initSteps) / sizeof(g_initSteps[0]))
+
+/* Index of the next step of the background initialization, LCD_NUM_OF_INIT_STEPS when the LCD is ready */
+static uint8 g_initStep = 0;
+
+/* Time of the previous step (of LCD_StartInit for the first one) */
+static uint32 g_initStepTime_ms = 0;
+
 /****************************************************************************************
  *                                     Functions Definitions                            *
  ****************************************************************************************/
 
 /*
  * Description:
- * 1. Setup the LCD pins directions by GPIO Driver
- * 2. Setup the LCD Data Mode 4-bits or 8-bits.
+ * Setup the directions of the control pins and the data pins by GPIO Driver.
  */
-void LCD_Init(void)
+static void LCD_SetupPins(void)
 {
 	/* Setup the RS and E pins as an Output pins to control the LCD */
 	GPIO_SetupPinDirection(LCD_RS_PORT, LCD_RS_PIN, OUTPUT_PIN);
 	GPIO_SetupPinDirection(LCD_E_PORT, LCD_E_PIN, OUTPUT_PIN);
 
-	/* LCD Power ON delay always > 15ms */
-	_delay_ms(20);
-
 #if (LCD_BIT_MODE == 8)
 
 	/* let all pins in LCD_DATA_PORT to be an output pins to connect with LCD Data pins  */
 	GPIO_SetupPortDirection(LCD_DATA_PORT, OUTPUT_PORT);
 
-	/* Send the command of the 8-bit mode to LCD */
-	LCD_SendCommand(LCD_TWO_LINES_EIGHT_BIT_MODE);
-
 #elif (LCD_BIT_MODE == 4)
 
 	/* make the 4 Pins in the LCD Data Port as output pins to connect with LCD */
@@ -44,6 +74,30 @@ void LCD_Init(void)
 	GPIO_SetupPinDirection(LCD_DATA_PORT, LCD_DB6_PIN_ID, OUTPUT_PIN);
 	GPIO_SetupPinDirection(LCD_DATA_PORT, LCD_DB7_PIN_ID, OUTPUT_PIN);
 
+#endif
+}
+
+/*
+ * Description:
+ * 1. Setup the LCD pins directions by GPIO Driver
+ * 2. Setup the LCD Data Mode 4-bits or 8-bits.
+ * The power on delay and the commands are busy waits (about 20ms), see LCD_StartInit for the background
+ * initialization.
+ */
+void LCD_Init(void)
+{
+	LCD_SetupPins();
+
+	/* LCD Power ON delay always > 15ms */
+	_delay_ms(LCD_POWER_ON_DELAY_MS);
+
+#if (LCD_BIT_MODE == 8)
+
+	/* Send the command of the 8-bit mode to LCD */
+	LCD_SendCommand(LCD_TWO_LINES_EIGHT_BIT_MODE);
+
+#elif (LCD_BIT_MODE == 4)
+
 	/* Send for 4-bit initialization of LCD  */
 	LCD_SendCommand(LCD_TWO_LINES_FOUR_BITS_MODE_INIT1);
 	LCD_SendCommand(LCD_TWO_LINES_FOUR_BITS_MODE_INIT2);
@@ -60,6 +114,57 @@ void LCD_Init(void)
 	 */
 	LCD_SendCommand(CLEAR_DISPLAY_SCREEN);
 	LCD_SendCommand(DISPLAY_ON_CURSOR_OFF);
+
+	g_initStep = LCD_NUM_OF_INIT_STEPS;
+}
+
+/*
+ * Description:
+ * Start the background initialization of the LCD: setup the pins and start the power on delay at the time
+ * Now_ms. The LCD is then initialized by the calls of LCD_InitTask, nothing is displayed before it is ready.
+ */
+void LCD_StartInit(uint32 Now_ms)
+{
+	LCD_SetupPins();
+
+	g_initStep = 0;
+	g_initStepTime_ms = Now_ms;
+}
+
+/*
+ * Description:
+ * Step of the background initialization started by LCD_StartInit, called from the main loop with the
+ * current time. It sends at most one command per call, when the delay of the command has passed:
+ * the power on delay before the first command, the execution time of the clear command before the next one.
+ * The time of the main loop has a resolution of LCD_INIT_TIME_RESOLUTION_MS, every delay is extended by it
+ * so the real delay is never shorter. Return TRUE when the LCD is ready.
+ */
+boolean LCD_InitTask(uint32 Now_ms)
+{
+	if (g_initStep >= LCD_NUM_OF_INIT_STEPS)
+	{
+		return TRUE;
+	}
+
+	if ((Now_ms - g_initStepTime_ms) < ((uint32)g_initSteps[g_initStep].Delay_ms + LCD_INIT_TIME_RESOLUTION_MS))
+	{
+		return FALSE;
+	}
+
+	LCD_SendCommand(g_initSteps[g_initStep].Command);
+	g_initStepTime_ms = Now_ms;
+	g_initStep++;
+
+	return (g_initStep >= LCD_NUM_OF_INIT_STEPS) ? TRUE : FALSE;
+}
+
+/*
+ * Description:
+ * Return TRUE if the LCD is ready (LCD_Init is done or LCD_InitTask has sent the last command).
+ */
+boolean LCD_IsReady(void)
+{
+	return (g_initStep >= LCD_NUM_OF_INIT_STEPS) ? TRUE : FALSE;
 }
 
 /*
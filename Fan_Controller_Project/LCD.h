@@ -9,7 +9,10 @@
 #ifndef LCD_H_
 #define LCD_H_
 
+/* Data bus width, 4 or 8 (the host tools build both) */
+#ifndef LCD_BIT_MODE
 #define LCD_BIT_MODE                               8
+#endif
 
 #if ((LCD_BIT_MODE != 4) && (LCD_BIT_MODE != 8))
 
@@ -21,6 +24,16 @@
  *                                    Macros Definitions                                  *
  ******************************************************************************************/
 
+/* Power on delay of the LCD (more than 15ms) and execution time of the clear and return home commands (1.52ms) */
+#define LCD_POWER_ON_DELAY_MS                      20
+#define LCD_CLEAR_DELAY_MS                         2
+
+/*
+ * Resolution of the time given to LCD_InitTask: one tick of the system time base (the Timer0 overflow period,
+ * 2.048ms at 1MHz) rounded up
+ */
+#define LCD_INIT_TIME_RESOLUTION_MS                3
+
 /* LCD Modes */
 #define LCD_ONE_LINE_FOUR_BIT_MODE                 0x20
 #define LCD_TWO_LINES_FOUR_BIT_MODE                0x28
@@ -49,9 +62,11 @@
 #define SET_CURSOR_POSITION                        0x80
 #define FORCE_CURSOR_BEGINNING_OF_SECOND_LINE      0xC0
 
-/* Control Pins Setup */
+/* Control Pins Setup, the build can move RS (PD0 is also the USART RXD, e.g. to PIN3_ID for Modbus_Slave.c) */
 #define LCD_RS_PORT                               PORTD_ID
+#ifndef LCD_RS_PIN
 #define LCD_RS_PIN                                PIN0_ID
+#endif
 
 #define LCD_E_PORT                                PORTD_ID
 #define LCD_E_PIN                                 PIN2_ID
@@ -83,6 +98,29 @@
  */
 void LCD_Init(void);
 
+/*
+ * Description:
+ * Start the background initialization of the LCD: setup the pins and start the power on delay at the time
+ * Now_ms. The LCD is then initialized by the calls of LCD_InitTask, nothing is displayed before it is ready.
+ */
+void LCD_StartInit(uint32 Now_ms);
+
+/*
+ * Description:
+ * Step of the background initialization started by LCD_StartInit, called from the main loop with the
+ * current time. It sends at most one command per call, when the delay of the command has passed:
+ * the power on delay before the first command, the execution time of the clear command before the next one.
+ * The time of the main loop has a resolution of LCD_INIT_TIME_RESOLUTION_MS, every delay is extended by it
+ * so the real delay is never shorter. Return TRUE when the LCD is ready.
+ */
+boolean LCD_InitTask(uint32 Now_ms);
+
+/*
+ * Description:
+ * Return TRUE if the LCD is ready (LCD_Init is done or LCD_InitTask has sent the last command).
+ */
+boolean LCD_IsReady(void);
+
 
 /*
  * Description:
@@ -6,24 +6,197 @@
  ****************************************************************************************************************/
 #include "LM35.h"
 #include "ADC.h"
+#include "Auto_Range.h"
+
+/***************************************************************************************
+ *                                      Global Variables                               *
+ ***************************************************************************************/
+
+static uint8 g_sensorChannel = LM35_SENSOR_READ_CHANNEL;
+
+/* TRUE when the sensor channel is sampled by the ADC auto trigger */
+static boolean g_synchronized = FALSE;
+
+/* Code of the last conversion started by LM35_StartConversion */
+static uint16 g_code = 0;
+
+/* The LM35 behind the sensor interface (Temp_Sensor.h) */
+const TempSensor_DriverType g_LM35Sensor =
+{
+	LM35_StartConversion, LM35_PollConversion, LM35_ReadConversion
+};
+
+/* Ranges of LM35_GetPreciseTemperature from the finest, filled by LM35_InitAutoRange for the sensor channel */
+static AutoRange_RangeConfigType g_preciseRanges[2];
 
 /****************************************************************************************
  *                                     Functions Definitions                            *
  ****************************************************************************************/
 
+/*
+ * Description:
+ * Select the ADC channel which the sensor is connected to (LM35_SENSOR_READ_CHANNEL by default).
+ */
+void LM35_SetChannel(uint8 Channel)
+{
+	g_sensorChannel = Channel;
+}
+
 /*
  * Description:
  * Calculation of the Temperature Sensor, then return the temperature.
+ * The conversion goes through the sensor interface (TempSensor_Measure of g_LM35Sensor).
  */
 uint8 LM35_GetTemperature(void)
 {
-	uint8 Temperature = 0;
+	return (uint8)(TempSensor_Measure(&g_LM35Sensor) >> TEMP_SENSOR_FRACTION_BITS);
+}
+
+/*
+ * Description:
+ * Sensor interface: start a conversion. The synchronized samples are converted by the ADC interrupt, there is
+ * nothing to start; otherwise the sensor channel is converted at once (ADC_ReadChannel, one ADC conversion).
+ */
+boolean LM35_StartConversion(void)
+{
+	if (!g_synchronized)
+	{
+		g_code = ADC_ReadChannel(g_sensorChannel);
+	}
 
-	uint16 Digital_Value = 0;
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Sensor interface: the result is always ready after LM35_StartConversion.
+ */
+TempSensor_StatusType LM35_PollConversion(void)
+{
+	return TEMP_SENSOR_READY;
+}
 
-	Digital_Value = ADC_ReadChannel(LM35_SENSOR_READ_CHANNEL);
+/*
+ * Description:
+ * Sensor interface: return the temperature of the last conversion (or of the latest synchronized result)
+ * in 1/16 degree, with the whole degree resolution of LM35_ConvertToTemperature.
+ */
+sint16 LM35_ReadConversion(void)
+{
+	uint16 Code = g_synchronized ? ADC_GetResult(LM35_ADC_SLOT) : g_code;
+
+	return (sint16)((uint16)LM35_ConvertToTemperature(Code) << TEMP_SENSOR_FRACTION_BITS);
+}
+
+/*
+ * Description:
+ * Start the hardware triggered sampling of the sensor channel alone (ADC_StartTriggered), then
+ * LM35_GetTemperature returns the latest synchronized result instead of polling a new conversion.
+ * When other channels are sampled too, ADC_StartScheduled is used with the sensor in LM35_ADC_SLOT.
+ */
+void LM35_StartSynchronizedSampling(uint8 Num_Of_Samples)
+{
+	ADC_StartTriggered(g_sensorChannel, Num_Of_Samples);
+	g_synchronized = TRUE;
+}
+
+/*
+ * Description:
+ * Calculation of the Temperature of a sensor connected to the required ADC channel, then return the temperature.
+ */
+uint8 LM35_GetTemperatureFromChannel(uint8 Channel)
+{
+	return LM35_ConvertToTemperature(ADC_ReadChannel(Channel));
+}
+
+/*
+ * Description:
+ * Convert an ADC result of the sensor channel to a temperature.
+ * The full scale code converts to 256C, the result is limited to 255 so it does not wrap to 0.
+ */
+uint8 LM35_ConvertToTemperature(uint16 Digital_Value)
+{
+	uint32 Temperature = 0;
 
 	Temperature = ( ((uint32)Digital_Value  * MAX_VOLTAGE_REFERENCE * MAX_LM35_TEMPERATURE) / ( MAX_VOLTAGE_SENSOR * ADC_MAX_DIGITAL_VALUE) );
 
+	return (Temperature > 0xFF) ? 0xFF : (uint8)Temperature;
+}
+
+/*
+ * Description:
+ * Return the first ADC code which LM35_ConvertToTemperature converts to the temperature or more
+ * (ADC_MAX_DIGITAL_VALUE + 1 if no code reaches it), used to compare raw samples against temperatures.
+ */
+uint16 LM35_TemperatureToCode(uint8 Temperature)
+{
+	uint16 Code;
+
+	Code = (uint16)(((uint32)Temperature * MAX_VOLTAGE_SENSOR * ADC_MAX_DIGITAL_VALUE) / (MAX_VOLTAGE_REFERENCE * MAX_LM35_TEMPERATURE));
+
+	/* The floating point rounding may give a code next to the right one, adjust it with the conversion itself */
+	while ((Code > 0) && (LM35_ConvertToTemperature(Code - 1) >= Temperature))
+	{
+		Code--;
+	}
+	while ((Code <= ADC_MAX_DIGITAL_VALUE) && (LM35_ConvertToTemperature(Code) < Temperature))
+	{
+		Code++;
+	}
+
+	return Code;
+}
+
+/*
+ * Description:
+ * Give the ranges of the sensor channel (LM35_SetChannel) to the auto ranging (AutoRange_Init), needed once
+ * before LM35_GetPreciseTemperature and again after a change of the channel.
+ * 1. Sensor on ADC1 (ground on ADC0) or on ADC3 (ground on ADC2): the 10x gain channel of the pair, then
+ *    the single ended channel. On any other channel the single ended channel only.
+ * 2. The ranges keep the reference in use (ADC_Init), so the reads never wait the reference settling and
+ *    never change the reference of the scheduled conversions.
+ */
+void LM35_InitAutoRange(void)
+{
+	VoltageReference_Select Voltage_Ref = ADC_GetReference();
+	AutoRange_RangeConfigType *Range_Ptr = g_preciseRanges;
+
+	if ((g_sensorChannel == ADC1) || (g_sensorChannel == ADC3))
+	{
+		Range_Ptr -> Voltage_Ref = Voltage_Ref;
+		Range_Ptr -> Channel = (g_sensorChannel == ADC1) ? ADC1_ADC0_10X : ADC3_ADC2_10X;
+		Range_Ptr -> Offset_Channel = (g_sensorChannel == ADC1) ? ADC0_ADC0_10X : ADC2_ADC2_10X;
+		Range_Ptr -> Min_Code = ADC_DIFF_MIN_VALUE;
+		Range_Ptr -> Max_Code = ADC_DIFF_MAX_VALUE;
+		Range_Ptr -> Scale_Numerator = 1;
+		Range_Ptr -> Scale_Denominator = 5;
+		Range_Ptr++;
+	}
+
+	Range_Ptr -> Voltage_Ref = Voltage_Ref;
+	Range_Ptr -> Channel = (InputChannel_Select)g_sensorChannel;
+	Range_Ptr -> Offset_Channel = ADC_GND;
+	Range_Ptr -> Min_Code = 0;
+	Range_Ptr -> Max_Code = ADC_MAX_VALUE;
+	Range_Ptr -> Scale_Numerator = 1;
+	Range_Ptr -> Scale_Denominator = 1;
+	Range_Ptr++;
+
+	AutoRange_Init(g_preciseRanges, (uint8)(Range_Ptr - g_preciseRanges));
+}
+
+/*
+ * Description:
+ * Read the sensor with the finest range of LM35_InitAutoRange which holds the temperature (polling) and
+ * return the temperature in 1/LM35_PRECISE_DEGREE_FRACTION of degree.
+ */
+sint16 LM35_GetPreciseTemperature(void)
+{
+	sint16 Temperature = 0;
+
+	/* Same formula as LM35_ConvertToTemperature on a single ended code with AUTO_RANGE_FRACTION_BITS fraction bits */
+	Temperature = ( ((sint32)AutoRange_Read() * MAX_VOLTAGE_REFERENCE * MAX_LM35_TEMPERATURE * LM35_PRECISE_DEGREE_FRACTION) /
+			( MAX_VOLTAGE_SENSOR * ADC_MAX_DIGITAL_VALUE * (1 << AUTO_RANGE_FRACTION_BITS)) );
+
 	return Temperature;
 }
@@ -5,6 +5,7 @@
  * Author: Youssef Zaki
  ****************************************************************************************************************/
 #include "Standard_Types.h"
+#include "Temp_Sensor.h"
 
 #ifndef LM35_H_
 #define LM35_H_
@@ -21,14 +22,111 @@
 
 #define LM35_SENSOR_READ_CHANNEL             2
 
+/* Slot of the sensor channel in the hardware triggered sampling schedule of the ADC */
+#define LM35_ADC_SLOT                        0
+
+/* Number of PWM synchronized samples averaged into one temperature (one new value every 8 PWM periods) */
+#define LM35_SYNC_SAMPLES_PER_RESULT         8
+
+/*
+ * LM35_GetPreciseTemperature reads the sensor channel (LM35_SetChannel, the Sensor_Channel of Fan_Config) with
+ * auto ranging. The 10x gain channels of the ATmega32 only exist for ADC1-ADC0 and ADC3-ADC2: with the sensor
+ * on ADC1 and its ground wired to ADC0 (or ADC3 and ADC2) the differential channel gives 0.05C steps from 0C
+ * to 25.5C, above it the single ended channel gives 0.25C steps. On the other channels (ADC2 by default) only
+ * the single ended range is used. The reference stays the one of ADC_Init (2.56V assumed as for
+ * LM35_ConvertToTemperature). It is a polled library, the application uses the scheduled samples.
+ * The result is in hundredths of degree.
+ */
+#define LM35_PRECISE_DEGREE_FRACTION         100
+
+/******************************************************************************************
+ *                                    External Variables                                  *
+ ******************************************************************************************/
+
+/* The LM35 behind the sensor interface (Temp_Sensor.h) */
+extern const TempSensor_DriverType g_LM35Sensor;
+
 /******************************************************************************************
  *                                    Functions Prototypes                                *
  ******************************************************************************************/
 
+/*
+ * Description:
+ * Select the ADC channel which the sensor is connected to (LM35_SENSOR_READ_CHANNEL by default).
+ */
+void LM35_SetChannel(uint8 Channel);
+
 /*
  * Description:
  * Calculation of the Temperature Sensor, then return the temperature.
+ * The conversion goes through the sensor interface (TempSensor_Measure of g_LM35Sensor).
  */
 uint8 LM35_GetTemperature(void);
 
+/*
+ * Description:
+ * Sensor interface: start a conversion. The synchronized samples are converted by the ADC interrupt, there is
+ * nothing to start; otherwise the sensor channel is converted at once (ADC_ReadChannel, one ADC conversion).
+ */
+boolean LM35_StartConversion(void);
+
+/*
+ * Description:
+ * Sensor interface: the result is always ready after LM35_StartConversion.
+ */
+TempSensor_StatusType LM35_PollConversion(void);
+
+/*
+ * Description:
+ * Sensor interface: return the temperature of the last conversion (or of the latest synchronized result)
+ * in 1/16 degree, with the whole degree resolution of LM35_ConvertToTemperature.
+ */
+sint16 LM35_ReadConversion(void);
+
+/*
+ * Description:
+ * Start the hardware triggered sampling of the sensor channel alone (ADC_StartTriggered), then
+ * LM35_GetTemperature returns the latest synchronized result instead of polling a new conversion.
+ * When other channels are sampled too, ADC_StartScheduled is used with the sensor in LM35_ADC_SLOT.
+ */
+void LM35_StartSynchronizedSampling(uint8 Num_Of_Samples);
+
+/*
+ * Description:
+ * Convert an ADC result of the sensor channel to a temperature.
+ * The full scale code converts to 256C, the result is limited to 255 so it does not wrap to 0.
+ */
+uint8 LM35_ConvertToTemperature(uint16 Digital_Value);
+
+/*
+ * Description:
+ * Return the first ADC code which LM35_ConvertToTemperature converts to the temperature or more
+ * (ADC_MAX_DIGITAL_VALUE + 1 if no code reaches it), used to compare raw samples against temperatures.
+ */
+uint16 LM35_TemperatureToCode(uint8 Temperature);
+
+/*
+ * Description:
+ * Calculation of the Temperature of a sensor connected to the required ADC channel, then return the temperature.
+ */
+uint8 LM35_GetTemperatureFromChannel(uint8 Channel);
+
+/*
+ * Description:
+ * Give the ranges of the sensor channel (LM35_SetChannel) to the auto ranging (AutoRange_Init), needed once
+ * before LM35_GetPreciseTemperature and again after a change of the channel.
+ * 1. Sensor on ADC1 (ground on ADC0) or on ADC3 (ground on ADC2): the 10x gain channel of the pair, then
+ *    the single ended channel. On any other channel the single ended channel only.
+ * 2. The ranges keep the reference in use (ADC_Init), so the reads never wait the reference settling and
+ *    never change the reference of the scheduled conversions.
+ */
+void LM35_InitAutoRange(void);
+
+/*
+ * Description:
+ * Read the sensor with the finest range of LM35_InitAutoRange which holds the temperature (polling) and
+ * return the temperature in 1/LM35_PRECISE_DEGREE_FRACTION of degree.
+ */
+sint16 LM35_GetPreciseTemperature(void);
+
 #endif /* LM35_H_ */
@@ -0,0 +1,518 @@
+/*******************************************************************************************************************
+ * File Name: Modbus_Slave.c
+ * Date: 19/10/2026
+ * Driver: Modbus RTU Slave (Remote Monitoring and Fan Curve Setpoints over the USART) Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Modbus_Slave.h"
+
+#if (MODBUS_SLAVE_ENABLED == 1)
+
+#include "CRC.h"
+#include "UART.h"
+#include "TIMER2.h"
+#include "DC_Motor.h"
+#include "Fan_Config.h"
+#include "Fan_Safety.h"
+#include "Current_Sense.h"
+#include "Temp_Monitor.h"
+#include "Temp_Stats.h"
+#include "Sys_Time.h"
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+#define MODBUS_BROADCAST_ADDRESS                   0
+
+#define MODBUS_READ_HOLDING_REGISTERS              0x03
+#define MODBUS_READ_INPUT_REGISTERS                0x04
+#define MODBUS_WRITE_SINGLE_REGISTER               0x06
+#define MODBUS_WRITE_MULTIPLE_REGISTERS            0x10
+
+#define MODBUS_EXCEPTION_ILLEGAL_FUNCTION          0x01
+#define MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS      0x02
+#define MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE        0x03
+#define MODBUS_EXCEPTION_SLAVE_DEVICE_BUSY         0x06
+
+/* No exception: the request is done */
+#define MODBUS_EXCEPTION_NONE                      0x00
+
+/* Value of the registers which have no value (no tachometer, statistics window without samples) */
+#define MODBUS_NOT_AVAILABLE                       0xFFFF
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+/*
+ * State of the frame buffer:
+ * IDLE:      waiting for the first byte of a frame (the line was silent for t3.5)
+ * RECEIVING: the interrupts fill the buffer, till t3.5 of silence
+ * DISCARD:   the frame is invalid (or the slave was just started), the bytes are dropped till t3.5 of silence
+ * READY:     a complete frame waits for ModbusSlave_Task, the received bytes are dropped
+ * REPLYING:  the USART interrupts send the response from the buffer
+ */
+typedef enum
+{
+	MODBUS_STATE_IDLE, MODBUS_STATE_RECEIVING, MODBUS_STATE_DISCARD, MODBUS_STATE_READY, MODBUS_STATE_REPLYING
+}ModbusSlave_StateType;
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+/* The request, then the response built in place, owned by the interrupts in the IDLE/RECEIVING/DISCARD states */
+static uint8 g_frame[MODBUS_MAX_FRAME_SIZE];
+static volatile uint8 g_frameLength = 0;
+
+static volatile uint8 g_state = MODBUS_STATE_DISCARD;
+
+/* Diagnostic counters (input registers), the errors are counted by the interrupts */
+static uint16 g_framesOk = 0;
+static volatile uint16 g_frameErrors = 0;
+
+/****************************************************************************************
+ *                                      Interrupt Call Backs                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Start Timer2 from 0, the compare match interrupt comes after t3.5 (a stale compare flag is cleared).
+ */
+static void ModbusSlave_StartTimer(void)
+{
+	TIMER2_ConfigType Timer2_Config = {0, MODBUS_T35_TICKS, CTC_2, MODBUS_TIMER2_PRESCALER};
+
+	Timer2_NonPWM_Mode_Init(&Timer2_Config);
+	Timer2_Restart();
+}
+
+/*
+ * Description:
+ * Called from the USART Receive Complete Interrupt with every received byte.
+ */
+static void ModbusSlave_ByteReceived(uint8 Data, boolean Error)
+{
+	switch (g_state)
+	{
+	case MODBUS_STATE_IDLE:
+		ModbusSlave_StartTimer();
+		g_frame[0] = Data;
+		g_frameLength = 1;
+		g_state = Error ? MODBUS_STATE_DISCARD : MODBUS_STATE_RECEIVING;
+		break;
+
+	case MODBUS_STATE_RECEIVING:
+		/* The count since the previous byte is checked before the restart */
+		if (Error || (Timer2_GetCount() > MODBUS_T15_TICKS) || (g_frameLength >= MODBUS_MAX_FRAME_SIZE))
+		{
+			g_state = MODBUS_STATE_DISCARD;
+			g_frameErrors++;
+		}
+		else
+		{
+			g_frame[g_frameLength] = Data;
+			g_frameLength++;
+		}
+		Timer2_Restart();
+		break;
+
+	case MODBUS_STATE_DISCARD:
+		Timer2_Restart();
+		break;
+
+	default:
+		/* READY or REPLYING: the master did not wait for the response, the byte is lost */
+		break;
+	}
+}
+
+/*
+ * Description:
+ * Called from the Timer2 compare match interrupt after t3.5 of silence.
+ */
+static void ModbusSlave_Silence(void)
+{
+	Timer2_DeInit();
+
+	g_state = (g_state == MODBUS_STATE_RECEIVING) ? MODBUS_STATE_READY : MODBUS_STATE_IDLE;
+}
+
+/*
+ * Description:
+ * Called from the USART Transmit Complete Interrupt after the last stop bit of the response.
+ */
+static void ModbusSlave_ResponseSent(void)
+{
+#if (MODBUS_RS485_DE_ENABLED == 1)
+	GPIO_WritePin(MODBUS_RS485_DE_PORT, MODBUS_RS485_DE_PIN, LOGIC_LOW);
+#endif
+
+	/* The end of the response is the end of a frame, the next byte starts the next request */
+	g_state = MODBUS_STATE_IDLE;
+}
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+static uint16 ModbusSlave_GetWord(uint8 Index)
+{
+	return ((uint16)g_frame[Index] << 8) | g_frame[Index + 1];
+}
+
+static void ModbusSlave_PutWord(uint8 Index, uint16 Value)
+{
+	g_frame[Index] = (uint8)(Value >> 8);
+	g_frame[Index + 1] = (uint8)Value;
+}
+
+/*
+ * Description:
+ * Return the value of an input register (MODBUS_INPUT_x, checked by the caller).
+ */
+static uint16 ModbusSlave_ReadInput(uint8 Register)
+{
+	TempStats_ResultType Window_Stats;
+	uint8 Flags = 0;
+	uint8 Window;
+
+	switch (Register)
+	{
+	case MODBUS_INPUT_TEMPERATURE:
+		return TempMonitor_GetLatestTemperature();
+
+	case MODBUS_INPUT_DUTY:
+#if (DC_MOTOR_PWM_BACKEND == DC_MOTOR_PWM_TIMER0)
+		return (uint16)(((uint32)DcMotor_GetOutputCompare() * DC_MOTOR_DUTY_FULL_SCALE) / 255);
+#else
+		return (uint16)(((uint32)DcMotor_GetOutputCompare() * DC_MOTOR_DUTY_FULL_SCALE) / DC_MOTOR_TIMER1_TOP);
+#endif
+
+	case MODBUS_INPUT_FAN_RPM:
+		return MODBUS_NOT_AVAILABLE;
+
+	case MODBUS_INPUT_FAULT_FLAGS:
+		if (FanSafety_IsFaulted())
+		{
+			Flags |= MODBUS_FAULT_OVER_TEMPERATURE;
+		}
+		if (DcMotor_IsCutOff())
+		{
+			Flags |= MODBUS_FAULT_CURRENT_CUTOFF;
+		}
+		return Flags;
+
+	case MODBUS_INPUT_CURVE_LEVEL:
+		return TempMonitor_GetLevel();
+
+	case MODBUS_INPUT_CURRENT_AVERAGE:
+		return CurrentSense_GetAverage_mA();
+
+	case MODBUS_INPUT_CURRENT_PEAK:
+		return CurrentSense_GetPeak_mA();
+
+	case MODBUS_INPUT_CURRENT_TRIPS:
+		return CurrentSense_GetTripCount();
+
+	case MODBUS_INPUT_UPTIME_HIGH:
+		return (uint16)(SysTime_GetSeconds() >> 16);
+
+	case MODBUS_INPUT_UPTIME_LOW:
+		return (uint16)SysTime_GetSeconds();
+
+	case MODBUS_INPUT_FRAMES_OK:
+		return g_framesOk;
+
+	case MODBUS_INPUT_FRAME_ERRORS:
+		return g_frameErrors;
+
+	default:
+		/* Three registers per window: minimum, maximum, mean */
+		Window = (Register - MODBUS_INPUT_STATS_FIRST) / 3;
+		if (!TempStats_GetWindow(Window, &Window_Stats))
+		{
+			return MODBUS_NOT_AVAILABLE;
+		}
+		switch ((Register - MODBUS_INPUT_STATS_FIRST) % 3)
+		{
+		case 0:
+			return Window_Stats.Minimum;
+		case 1:
+			return Window_Stats.Maximum;
+		default:
+			return Window_Stats.Mean;
+		}
+	}
+}
+
+/*
+ * Description:
+ * Return the value of a holding register (MODBUS_HOLDING_x, checked by the caller).
+ */
+static uint16 ModbusSlave_ReadHolding(uint8 Register)
+{
+	if (Register < MODBUS_HOLDING_SPEEDS_FIRST)
+	{
+		return g_FanConfig.Curve.Thresholds[Register - MODBUS_HOLDING_THRESHOLDS_FIRST];
+	}
+	else if (Register < MODBUS_HOLDING_SAVE)
+	{
+		return g_FanConfig.Curve.Speeds[Register - MODBUS_HOLDING_SPEEDS_FIRST];
+	}
+
+	return 0;
+}
+
+/*
+ * Description:
+ * Write Quantity holding registers from Start, the values are in the frame from the byte Index.
+ * The new curve is checked as a whole before it replaces the current one (thresholds in ascending order,
+ * speeds up to 100 percent), then the save register starts the EEPROM write.
+ * Return the exception code, MODBUS_EXCEPTION_NONE if the registers are written.
+ */
+static uint8 ModbusSlave_WriteHolding(uint8 Start, uint8 Quantity, uint8 Index)
+{
+	FanCurve_Type Curve = g_FanConfig.Curve;
+	boolean Save = FALSE;
+	uint16 Value;
+	uint8 Register;
+	uint8 Level;
+
+	for (Register = Start; Register < Start + Quantity; Register++)
+	{
+		Value = ModbusSlave_GetWord(Index);
+		Index += 2;
+
+		if (Register < MODBUS_HOLDING_SPEEDS_FIRST)
+		{
+			if (Value > 0xFF)
+			{
+				return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+			}
+			Curve.Thresholds[Register - MODBUS_HOLDING_THRESHOLDS_FIRST] = (uint8)Value;
+		}
+		else if (Register < MODBUS_HOLDING_SAVE)
+		{
+			if (Value > 100)
+			{
+				return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+			}
+			Curve.Speeds[Register - MODBUS_HOLDING_SPEEDS_FIRST] = (uint8)Value;
+		}
+		else
+		{
+			if (Value > 1)
+			{
+				return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+			}
+			Save = (Value == 1) ? TRUE : FALSE;
+		}
+	}
+
+	for (Level = 1; Level < FAN_CURVE_NUM_OF_THRESHOLDS; Level++)
+	{
+		if (Curve.Thresholds[Level] <= Curve.Thresholds[Level - 1])
+		{
+			return MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+		}
+	}
+
+	/* The speeds are applied by the main loop on the band event posted by TempMonitor_SetCurve */
+	if (Start < MODBUS_HOLDING_SAVE)
+	{
+		g_FanConfig.Curve = Curve;
+		TempMonitor_SetCurve(&g_FanConfig.Curve);
+	}
+
+	if (Save && !FanConfig_Save())
+	{
+		return MODBUS_EXCEPTION_SLAVE_DEVICE_BUSY;
+	}
+
+	return MODBUS_EXCEPTION_NONE;
+}
+
+/*
+ * Description:
+ * Execute the request in g_frame (address and CRC already checked, Length without the CRC) and build the
+ * response in place. Return the length of the response without its CRC.
+ */
+static uint8 ModbusSlave_Execute(uint8 Length)
+{
+	uint8 Function = g_frame[1];
+	uint16 Start = ModbusSlave_GetWord(2);
+	uint16 Quantity = ModbusSlave_GetWord(4);
+	uint16 Num_Of_Registers = (Function == MODBUS_READ_INPUT_REGISTERS) ? MODBUS_NUM_OF_INPUT_REGISTERS : MODBUS_NUM_OF_HOLDING_REGISTERS;
+	uint8 Exception = MODBUS_EXCEPTION_NONE;
+	uint8 Register;
+
+	switch (Function)
+	{
+	case MODBUS_READ_HOLDING_REGISTERS:
+	case MODBUS_READ_INPUT_REGISTERS:
+		if ((Length != 6) || (Quantity == 0) || (Quantity > MODBUS_MAX_REGISTERS))
+		{
+			Exception = MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+		}
+		else if ((Start >= Num_Of_Registers) || (Quantity > Num_Of_Registers - Start))
+		{
+			Exception = MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+		}
+		else
+		{
+			/* Address, function, byte count, the values */
+			g_frame[2] = (uint8)(Quantity * 2);
+			for (Register = 0; Register < Quantity; Register++)
+			{
+				ModbusSlave_PutWord(3 + (Register * 2), (Function == MODBUS_READ_INPUT_REGISTERS) ?
+						ModbusSlave_ReadInput((uint8)Start + Register) : ModbusSlave_ReadHolding((uint8)Start + Register));
+			}
+			return 3 + (uint8)(Quantity * 2);
+		}
+		break;
+
+	case MODBUS_WRITE_SINGLE_REGISTER:
+		if (Length != 6)
+		{
+			Exception = MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+		}
+		else if (Start >= MODBUS_NUM_OF_HOLDING_REGISTERS)
+		{
+			Exception = MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+		}
+		else
+		{
+			/* The value is at the place of the quantity, the response is the request */
+			Exception = ModbusSlave_WriteHolding((uint8)Start, 1, 4);
+			if (Exception == MODBUS_EXCEPTION_NONE)
+			{
+				return 6;
+			}
+		}
+		break;
+
+	case MODBUS_WRITE_MULTIPLE_REGISTERS:
+		if ((Length < 7) || (Quantity == 0) || (Quantity > MODBUS_MAX_REGISTERS) ||
+				(g_frame[6] != Quantity * 2) || (Length != 7 + g_frame[6]))
+		{
+			Exception = MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+		}
+		else if ((Start >= MODBUS_NUM_OF_HOLDING_REGISTERS) || (Quantity > MODBUS_NUM_OF_HOLDING_REGISTERS - Start))
+		{
+			Exception = MODBUS_EXCEPTION_ILLEGAL_DATA_ADDRESS;
+		}
+		else
+		{
+			/* The response is the address, function, start and quantity of the request */
+			Exception = ModbusSlave_WriteHolding((uint8)Start, (uint8)Quantity, 7);
+			if (Exception == MODBUS_EXCEPTION_NONE)
+			{
+				return 6;
+			}
+		}
+		break;
+
+	default:
+		Exception = MODBUS_EXCEPTION_ILLEGAL_FUNCTION;
+		break;
+	}
+
+	g_frame[1] = Function | 0x80;
+	g_frame[2] = Exception;
+	return 3;
+}
+
+/*
+ * Description:
+ * Initialization of the Modbus slave.
+ * 1. Initialize the USART with the Modbus line settings and register the receive and transmit call backs.
+ * 2. Setup the RS-485 driver enable pin (receive).
+ * 3. Start Timer2: the first frame is accepted after t3.5 of silence.
+ */
+void ModbusSlave_Init(void)
+{
+	UART_ConfigType UART_Config = {MODBUS_BAUD_RATE, MODBUS_PARITY, MODBUS_STOP_BITS};
+
+#if (MODBUS_RS485_DE_ENABLED == 1)
+	GPIO_SetupPinDirection(MODBUS_RS485_DE_PORT, MODBUS_RS485_DE_PIN, OUTPUT_PIN);
+	GPIO_WritePin(MODBUS_RS485_DE_PORT, MODBUS_RS485_DE_PIN, LOGIC_LOW);
+#endif
+
+	g_state = MODBUS_STATE_DISCARD;
+	g_frameLength = 0;
+
+	UART_SetReceiveCallBack(ModbusSlave_ByteReceived);
+	UART_SetTransmitCallBack(ModbusSlave_ResponseSent);
+	Timer2_SetCompareCallBack(ModbusSlave_Silence);
+
+	ModbusSlave_StartTimer();
+	UART_Init(&UART_Config);
+}
+
+/*
+ * Description:
+ * Periodic task called from the main loop: handle the received frame, if any, and start its response.
+ */
+void ModbusSlave_Task(void)
+{
+	uint8 Length;
+	uint8 Address;
+	uint16 Crc;
+
+	if (g_state != MODBUS_STATE_READY)
+	{
+		return;
+	}
+
+	/* The buffer is not written by the interrupts in the READY state */
+	Length = g_frameLength;
+	Address = g_frame[0];
+
+	if ((Address != MODBUS_SLAVE_ADDRESS) && (Address != MODBUS_BROADCAST_ADDRESS))
+	{
+		g_state = MODBUS_STATE_IDLE;
+		return;
+	}
+
+	if ((Length < 4) || (CRC16_MODBUS_Calculate(g_frame, Length) != 0))
+	{
+		g_frameErrors++;
+		g_state = MODBUS_STATE_IDLE;
+		return;
+	}
+	g_framesOk++;
+
+	Length = ModbusSlave_Execute(Length - 2);
+
+	/* No response to the broadcast requests */
+	if (Address == MODBUS_BROADCAST_ADDRESS)
+	{
+		g_state = MODBUS_STATE_IDLE;
+		return;
+	}
+
+	/* The CRC is sent low byte first */
+	Crc = CRC16_MODBUS_Calculate(g_frame, Length);
+	g_frame[Length] = (uint8)Crc;
+	g_frame[Length + 1] = (uint8)(Crc >> 8);
+
+#if (MODBUS_RS485_DE_ENABLED == 1)
+	GPIO_WritePin(MODBUS_RS485_DE_PORT, MODBUS_RS485_DE_PIN, LOGIC_HIGH);
+#endif
+
+	g_state = MODBUS_STATE_REPLYING;
+	UART_StartTransmit(g_frame, Length + 2);
+}
+
+/*
+ * Description:
+ * Return TRUE if a received frame waits for ModbusSlave_Task (can be called with the interrupts disabled).
+ */
+boolean ModbusSlave_HasRequest(void)
+{
+	return (g_state == MODBUS_STATE_READY) ? TRUE : FALSE;
+}
+
+#endif
@@ -0,0 +1,199 @@
+/*******************************************************************************************************************
+ * File Name: Modbus_Slave.h
+ * Date: 19/10/2026
+ * Driver: Modbus RTU Slave (Remote Monitoring and Fan Curve Setpoints over the USART) Header File
+ * Author: Youssef Zaki
+ *
+ * Frames are received by the USART Receive Complete Interrupt (UART_SetReceiveCallBack) and delimited by the
+ * silent intervals of the Modbus over serial line specification, timed by Timer2 in the CTC mode:
+ *     - every byte restarts Timer2, a frame ends when the line is silent for t3.5 (compare match interrupt),
+ *     - a gap of more than t1.5 between two bytes of a frame makes the frame invalid (the count of Timer2 when
+ *       the next byte arrives), as a parity, frame or overrun error or a frame longer than the buffer does.
+ * A complete frame is handled by ModbusSlave_Task in the main loop (woken up by the compare match interrupt):
+ * the address and the CRC (table driven CRC-16/MODBUS) are checked, the registers are read or written and the
+ * response is sent by the USART interrupts (UART_StartTransmit), so the main loop never waits for the line.
+ * Response latency: t3.5 after the last byte, plus the rest of the main loop turn in progress, plus the request
+ * itself (at most MODBUS_MAX_REGISTERS registers).
+ * Supported functions: 03 Read Holding Registers, 04 Read Input Registers, 06 Write Single Register and
+ * 16 Write Multiple Registers, the writes are accepted in broadcast (address 0) without response.
+ * The USART uses PD0 (RXD) and PD1 (TXD): the LCD RS pin must be moved from PD0 (LCD_RS_PIN) and the profiler,
+ * which uses the USART too, must be disabled. Timer2 must not be used by Fan_Array.c or Soft_PWM.c.
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+#include "Clock_Solver.h"
+#include "Fan_Curve.h"
+#include "GPIO.h"
+#include "LCD.h"
+#include "Profiler.h"
+
+#ifndef MODBUS_SLAVE_H_
+#define MODBUS_SLAVE_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/* 1 to compile the Modbus slave in, 0 to compile it out completely (the build can give it) */
+#ifndef MODBUS_SLAVE_ENABLED
+#define MODBUS_SLAVE_ENABLED                       0
+#endif
+
+/* Address of this controller on the bus, 1 to 247 (the build can give one per controller) */
+#ifndef MODBUS_SLAVE_ADDRESS
+#define MODBUS_SLAVE_ADDRESS                       1
+#endif
+
+/* Line settings, the Modbus default is 8 data bits with even parity (11 bits per character) */
+#define MODBUS_BAUD_RATE                           9600UL
+#define MODBUS_PARITY                              UART_Parity_Even
+#define MODBUS_STOP_BITS                           UART_One_Stop_Bit
+#define MODBUS_BITS_PER_CHARACTER                  11UL
+
+/* RS-485 transceiver: the driver enable pin is high during the response only (0 for a point to point line) */
+#define MODBUS_RS485_DE_ENABLED                    1
+#define MODBUS_RS485_DE_PORT                       PORTD_ID
+#define MODBUS_RS485_DE_PIN                        PIN6_ID
+
+/* Largest frame received or sent, and the number of registers of one request which fits in it */
+#define MODBUS_MAX_FRAME_SIZE                      64
+#define MODBUS_MAX_REGISTERS                       ((MODBUS_MAX_FRAME_SIZE - 9) / 2)
+
+/* Silent intervals in microseconds, fixed above 19200 baud */
+#define MODBUS_CHARACTER_US                        ((MODBUS_BITS_PER_CHARACTER * 1000000UL) / MODBUS_BAUD_RATE)
+
+#if (MODBUS_BAUD_RATE > 19200UL)
+#define MODBUS_T15_US                              750UL
+#define MODBUS_T35_US                              1750UL
+#else
+#define MODBUS_T15_US                              ((15UL * MODBUS_CHARACTER_US) / 10UL)
+#define MODBUS_T35_US                              ((35UL * MODBUS_CHARACTER_US) / 10UL)
+#endif
+
+/* Number of Timer2 ticks in a time, rounded up */
+#define MODBUS_TIMER2_TICKS(Time_us, Division)     \
+	(((Time_us) * (F_CPU / 1000UL) + ((Division) * 1000UL) - 1UL) / ((Division) * 1000UL))
+
+/* Smallest Timer2 division (finest tick) with t3.5 within the 8-bit counter */
+#if (MODBUS_TIMER2_TICKS(MODBUS_T35_US, 8UL) < 255UL)
+#define MODBUS_TIMER2_DIVISION                     8UL
+#define MODBUS_TIMER2_PRESCALER                    TIMER2_Prescaler_8
+#elif (MODBUS_TIMER2_TICKS(MODBUS_T35_US, 32UL) < 255UL)
+#define MODBUS_TIMER2_DIVISION                     32UL
+#define MODBUS_TIMER2_PRESCALER                    TIMER2_Prescaler_32
+#elif (MODBUS_TIMER2_TICKS(MODBUS_T35_US, 64UL) < 255UL)
+#define MODBUS_TIMER2_DIVISION                     64UL
+#define MODBUS_TIMER2_PRESCALER                    TIMER2_Prescaler_64
+#elif (MODBUS_TIMER2_TICKS(MODBUS_T35_US, 128UL) < 255UL)
+#define MODBUS_TIMER2_DIVISION                     128UL
+#define MODBUS_TIMER2_PRESCALER                    TIMER2_Prescaler_128
+#elif (MODBUS_TIMER2_TICKS(MODBUS_T35_US, 256UL) < 255UL)
+#define MODBUS_TIMER2_DIVISION                     256UL
+#define MODBUS_TIMER2_PRESCALER                    TIMER2_Prescaler_256
+#elif (MODBUS_TIMER2_TICKS(MODBUS_T35_US, 1024UL) < 255UL)
+#define MODBUS_TIMER2_DIVISION                     1024UL
+#define MODBUS_TIMER2_PRESCALER                    TIMER2_Prescaler_1024
+#else
+#error "t3.5 of MODBUS_BAUD_RATE does not fit in Timer2 at F_CPU"
+#endif
+
+/*
+ * Timer2 compare value of the end of frame, one tick more than t3.5 because the prescaler is not reset,
+ * and the longest count from a byte to the next one in a frame (a character plus t1.5)
+ */
+#define MODBUS_T35_TICKS                           (MODBUS_TIMER2_TICKS(MODBUS_T35_US, MODBUS_TIMER2_DIVISION) + 1UL)
+#define MODBUS_T15_TICKS                           MODBUS_TIMER2_TICKS(MODBUS_CHARACTER_US + MODBUS_T15_US, MODBUS_TIMER2_DIVISION)
+
+/* Input registers (function 04), read only */
+#define MODBUS_INPUT_TEMPERATURE                   0     /* C */
+#define MODBUS_INPUT_DUTY                          1     /* Drive duty cycle of the motor, per mille */
+#define MODBUS_INPUT_FAN_RPM                       2     /* 0xFFFF: no tachometer input on this board */
+#define MODBUS_INPUT_FAULT_FLAGS                   3     /* MODBUS_FAULT_x bits */
+#define MODBUS_INPUT_CURVE_LEVEL                   4     /* Level of the fan curve, 255 before the first sample */
+#define MODBUS_INPUT_CURRENT_AVERAGE               5     /* Motor current, mA */
+#define MODBUS_INPUT_CURRENT_PEAK                  6     /* mA */
+#define MODBUS_INPUT_CURRENT_TRIPS                 7     /* Overcurrent trips since startup */
+#define MODBUS_INPUT_UPTIME_HIGH                   8     /* Seconds since startup, high word first */
+#define MODBUS_INPUT_UPTIME_LOW                    9
+#define MODBUS_INPUT_STATS_FIRST                   10    /* Minimum, maximum, mean of the 1, 10 and 60 minutes */
+                                                         /* windows (Temp_Stats.c), 0xFFFF without samples */
+#define MODBUS_INPUT_FRAMES_OK                     19    /* Frames received for this address with a valid CRC */
+#define MODBUS_INPUT_FRAME_ERRORS                  20    /* Frames dropped: CRC, gap, parity, framing, length */
+#define MODBUS_NUM_OF_INPUT_REGISTERS              21
+
+#define MODBUS_FAULT_OVER_TEMPERATURE              0x0001    /* Held at full speed by Fan_Safety.c */
+#define MODBUS_FAULT_CURRENT_CUTOFF                0x0002    /* Cut off by Current_Sense.c */
+
+/* Holding registers (functions 03, 06 and 16) */
+#define MODBUS_HOLDING_THRESHOLDS_FIRST            0     /* FAN_CURVE_NUM_OF_THRESHOLDS thresholds, ascending, C */
+#define MODBUS_HOLDING_SPEEDS_FIRST                (MODBUS_HOLDING_THRESHOLDS_FIRST + FAN_CURVE_NUM_OF_THRESHOLDS)
+                                                         /* FAN_CURVE_NUM_OF_LEVELS speeds, 0 to 100 percent */
+#define MODBUS_HOLDING_SAVE                        (MODBUS_HOLDING_SPEEDS_FIRST + FAN_CURVE_NUM_OF_LEVELS)
+                                                         /* Write 1 to save the curve to the EEPROM, reads 0 */
+#define MODBUS_NUM_OF_HOLDING_REGISTERS            (MODBUS_HOLDING_SAVE + 1)
+
+#if ((MODBUS_SLAVE_ENABLED != 0) && (MODBUS_SLAVE_ENABLED != 1))
+
+#error "MODBUS_SLAVE_ENABLED should be 0 or 1"
+
+#endif
+
+#if ((MODBUS_SLAVE_ADDRESS < 1) || (MODBUS_SLAVE_ADDRESS > 247))
+
+#error "MODBUS_SLAVE_ADDRESS should be from 1 to 247"
+
+#endif
+
+#if ((MODBUS_MAX_FRAME_SIZE < 16) || (MODBUS_MAX_FRAME_SIZE > 255))
+
+#error "MODBUS_MAX_FRAME_SIZE should be from 16 to 255"
+
+#endif
+
+#if ((MODBUS_SLAVE_ENABLED == 1) && (PROFILER_ENABLED == 1))
+
+#error "The Modbus slave and the profiler both use the USART, enable only one of them"
+
+#endif
+
+#if ((MODBUS_SLAVE_ENABLED == 1) && (LCD_RS_PORT == PORTD_ID) && (LCD_RS_PIN <= PIN1_ID))
+
+#error "The USART uses PD0 and PD1, move the LCD RS pin (LCD_RS_PIN) for the Modbus slave"
+
+#endif
+
+#if (MODBUS_SLAVE_ENABLED == 1)
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the Modbus slave.
+ * 1. Initialize the USART with the Modbus line settings and register the receive and transmit call backs.
+ * 2. Setup the RS-485 driver enable pin (receive).
+ * 3. Start Timer2: the first frame is accepted after t3.5 of silence.
+ */
+void ModbusSlave_Init(void);
+
+/*
+ * Description:
+ * Periodic task called from the main loop: handle the received frame, if any, and start its response.
+ */
+void ModbusSlave_Task(void);
+
+/*
+ * Description:
+ * Return TRUE if a received frame waits for ModbusSlave_Task (can be called with the interrupts disabled).
+ */
+boolean ModbusSlave_HasRequest(void);
+
+#else
+
+#define ModbusSlave_Init()
+#define ModbusSlave_Task()
+#define ModbusSlave_HasRequest()                   FALSE
+
+#endif
+
+#endif /* MODBUS_SLAVE_H_ */
@@ -0,0 +1,287 @@
+/*******************************************************************************************************************
+ * File Name: One_Wire.c
+ * Date: 19/10/2026
+ * Driver: 1-Wire Bus Master (Bit Timing from the Timer1 Compare B Interrupt) Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <util/delay.h>
+#include "Common_Macros.h"
+#include "GPIO.h"
+#include "Isr_Sync.h"
+#include "TIMER1.h"
+#include "DC_Motor.h"
+#include "Fan_Safety.h"
+#include "One_Wire.h"
+
+#if (DC_MOTOR_PWM_BACKEND == DC_MOTOR_PWM_TIMER1)
+
+#error "The 1-Wire bus uses Timer1 as a free running counter, it cannot be the PWM back end of the motor"
+
+#endif
+
+#if (ONE_WIRE_ISR_CYCLES > FAN_SAFETY_BLOCKING_CYCLES)
+
+#error "The 1-Wire interrupt is longer than the blocking sections allowed by the over temperature fast path"
+
+#endif
+
+/*******************************************************************************
+ *                              Macros Definitions                             *
+ *******************************************************************************/
+
+/* Open drain: pull the bus low with the output at 0, release it with the input */
+#define ONE_WIRE_PULL_LOW()                        SET_BIT(ONE_WIRE_DDR, ONE_WIRE_BIT)
+#define ONE_WIRE_RELEASE()                         CLEAR_BIT(ONE_WIRE_DDR, ONE_WIRE_BIT)
+#define ONE_WIRE_IS_HIGH()                         BIT_IS_SET(ONE_WIRE_PIN, ONE_WIRE_BIT)
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+/* What the next compare B interrupt does */
+typedef enum
+{
+	ONE_WIRE_PHASE_RESET_RELEASE, ONE_WIRE_PHASE_PRESENCE, ONE_WIRE_PHASE_WRITE0_RELEASE, ONE_WIRE_PHASE_SLOT
+}OneWire_PhaseType;
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+static volatile OneWire_StatusType g_status = ONE_WIRE_IDLE;
+static volatile OneWire_PhaseType g_phase = ONE_WIRE_PHASE_SLOT;
+
+/* Transfer in progress, the bits are counted through the written bytes then the read bytes */
+static const uint8 *g_writePtr = NULL_PTR;
+static uint8 *g_readPtr = NULL_PTR;
+static uint16 g_writeBits = 0;
+static uint16 g_totalBits = 0;
+static uint16 g_bit = 0;
+static boolean g_present = FALSE;
+
+/* Timer1 count of the last bus edge with a deadline after it (reset release, low of a 0) */
+static uint16 g_edgeTime = 0;
+
+/****************************************************************************************
+ *                                      Interrupt Call Backs                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Abort the transfer after a missed deadline: release the bus and stop the time slots.
+ */
+static void OneWire_Abort(void)
+{
+	ONE_WIRE_RELEASE();
+	Timer1_StopCompareB();
+	g_status = ONE_WIRE_LATE;
+}
+
+/*
+ * Description:
+ * Wait for the opening of the window of a step with a deadline (Opening counts after the edge): the interrupt came
+ * early because the previous step was delayed by another interrupt. Return TRUE once the window is open, or FALSE
+ * after scheduling the interrupt again at the opening, less its entry (the step is done by that interrupt). Only
+ * a wait shorter than the interrupt entry is a busy wait.
+ */
+static boolean OneWire_WaitWindow(uint16 Opening)
+{
+	uint16 Remaining = Opening - (uint16)(TCNT1 - g_edgeTime);
+
+	if (Remaining > (ONE_WIRE_ISR_ENTRY_CYCLES + TIMER1_COMPARE_MIN_AHEAD))
+	{
+		Timer1_ScheduleCompareB((uint16)(Remaining - ONE_WIRE_ISR_ENTRY_CYCLES));
+		return FALSE;
+	}
+
+	while ((uint16)(TCNT1 - g_edgeTime) < Opening);
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Start the next time slot of the transfer, or end the transfer.
+ */
+static void OneWire_StartSlot(void)
+{
+	uint16 Index;
+	uint8 Mask;
+
+	if (!g_present || (g_bit >= g_totalBits))
+	{
+		Timer1_StopCompareB();
+		g_status = g_present ? ONE_WIRE_DONE : ONE_WIRE_NO_PRESENCE;
+		return;
+	}
+
+	if (g_bit < g_writeBits)
+	{
+		Index = g_bit;
+		Mask = (uint8)(1 << (Index & 0x07));
+		g_bit++;
+
+		ONE_WIRE_PULL_LOW();
+		if (g_writePtr[Index >> 3] & Mask)
+		{
+			/* Write 1: a short low pulse, then the bus stays released until the end of the slot */
+			_delay_us(ONE_WIRE_WRITE1_LOW_US);
+			ONE_WIRE_RELEASE();
+			Timer1_NextCompareB(ONE_WIRE_TICKS(ONE_WIRE_SLOT_US));
+		}
+		else
+		{
+			/* Write 0: the bus is released by the next interrupt */
+			g_edgeTime = TCNT1;
+			g_phase = ONE_WIRE_PHASE_WRITE0_RELEASE;
+			Timer1_NextCompareB(ONE_WIRE_TICKS(ONE_WIRE_WRITE0_LOW_US));
+		}
+	}
+	else
+	{
+		Index = g_bit - g_writeBits;
+		Mask = (uint8)(1 << (Index & 0x07));
+		g_bit++;
+
+		/* Read: a short low pulse, the device holds the bus low for a 0, sampled before 15us */
+		ONE_WIRE_PULL_LOW();
+		_delay_us(ONE_WIRE_READ_LOW_US);
+		ONE_WIRE_RELEASE();
+		_delay_us(ONE_WIRE_READ_SAMPLE_US);
+
+		if (ONE_WIRE_IS_HIGH())
+		{
+			g_readPtr[Index >> 3] |= Mask;
+		}
+		Timer1_NextCompareB(ONE_WIRE_TICKS(ONE_WIRE_SLOT_US));
+	}
+}
+
+/*
+ * Description:
+ * Timer1 compare B call back: the next step of the transfer.
+ */
+static void OneWire_TimerEvent(void)
+{
+	uint16 Elapsed;
+
+	switch (g_phase)
+	{
+	case ONE_WIRE_PHASE_RESET_RELEASE:
+		ONE_WIRE_RELEASE();
+		g_edgeTime = TCNT1;
+		g_phase = ONE_WIRE_PHASE_PRESENCE;
+		Timer1_NextCompareB(ONE_WIRE_TICKS(ONE_WIRE_PRESENCE_SAMPLE_US));
+		break;
+
+	case ONE_WIRE_PHASE_PRESENCE:
+		/* A device pulls the bus low for 60us to 240us, starting 15us to 60us after the reset release */
+		Elapsed = TCNT1 - g_edgeTime;
+		if (Elapsed > ONE_WIRE_TICKS(ONE_WIRE_PRESENCE_LATEST_US))
+		{
+			/* The shortest presence pulse may be over, an absent device cannot be told from a late sample */
+			OneWire_Abort();
+			break;
+		}
+		if ((Elapsed < ONE_WIRE_TICKS(ONE_WIRE_PRESENCE_EARLIEST_US)) &&
+				!OneWire_WaitWindow(ONE_WIRE_TICKS(ONE_WIRE_PRESENCE_EARLIEST_US)))
+		{
+			break;
+		}
+
+		g_present = ONE_WIRE_IS_HIGH() ? FALSE : TRUE;
+		g_phase = ONE_WIRE_PHASE_SLOT;
+		Timer1_NextCompareB(ONE_WIRE_TICKS(ONE_WIRE_RESET_END_US));
+		break;
+
+	case ONE_WIRE_PHASE_WRITE0_RELEASE:
+		/* The low time of a 0 is 60us to 120us, a longer one may be seen as a reset by the devices */
+		Elapsed = TCNT1 - g_edgeTime;
+		if (Elapsed > ONE_WIRE_TICKS(ONE_WIRE_WRITE0_MAX_LOW_US))
+		{
+			OneWire_Abort();
+			break;
+		}
+		if ((Elapsed < ONE_WIRE_TICKS(ONE_WIRE_WRITE0_LOW_US)) && !OneWire_WaitWindow(ONE_WIRE_TICKS(ONE_WIRE_WRITE0_LOW_US)))
+		{
+			break;
+		}
+
+		ONE_WIRE_RELEASE();
+		g_phase = ONE_WIRE_PHASE_SLOT;
+		Timer1_NextCompareB(ONE_WIRE_TICKS(ONE_WIRE_SLOT_US - ONE_WIRE_WRITE0_LOW_US));
+		break;
+
+	default:
+		OneWire_StartSlot();
+		break;
+	}
+}
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the 1-Wire bus master.
+ * 1. Release the bus (input pin, output latch at 0 for the pull down).
+ * 2. Start Timer1 as a free running counter at the CPU clock and register the compare B call back.
+ */
+void OneWire_Init(void)
+{
+	ONE_WIRE_RELEASE();
+	CLEAR_BIT(ONE_WIRE_PORT, ONE_WIRE_BIT);
+
+	g_status = ONE_WIRE_IDLE;
+	Timer1_FreeRunning_Init(TIMER1_Prescaler_1);
+	Timer1_SetCompareBCallBack(OneWire_TimerEvent);
+}
+
+/*
+ * Description:
+ * Start a transfer: reset and presence, then Write_Length bytes of Write_Ptr, then Read_Length bytes into
+ * Read_Ptr. The buffers are used by the interrupt until the end of the transfer. Return FALSE if a transfer
+ * is already in progress.
+ */
+boolean OneWire_StartTransfer(const uint8 *Write_Ptr, uint8 Write_Length, uint8 *Read_Ptr, uint8 Read_Length)
+{
+	uint8 Index;
+
+	if (g_status == ONE_WIRE_BUSY)
+	{
+		return FALSE;
+	}
+
+	/* The read slots only set the bits which are read as 1 */
+	for (Index = 0; Index < Read_Length; Index++)
+	{
+		Read_Ptr[Index] = 0;
+	}
+
+	g_writePtr = Write_Ptr;
+	g_readPtr = Read_Ptr;
+	g_writeBits = (uint16)Write_Length * 8;
+	g_totalBits = g_writeBits + (uint16)Read_Length * 8;
+	g_bit = 0;
+	g_present = FALSE;
+	g_status = ONE_WIRE_BUSY;
+
+	/* Reset pulse, released by the first interrupt */
+	g_phase = ONE_WIRE_PHASE_RESET_RELEASE;
+	ONE_WIRE_PULL_LOW();
+	Timer1_ScheduleCompareB(ONE_WIRE_TICKS(ONE_WIRE_RESET_LOW_US));
+
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Return the state of the last transfer: ONE_WIRE_BUSY while it runs, then ONE_WIRE_DONE,
+ * ONE_WIRE_NO_PRESENCE if no device answered the reset (the bytes are not sent), or ONE_WIRE_LATE if a
+ * deadline was missed (the transfer is aborted and can be started again).
+ */
+OneWire_StatusType OneWire_GetStatus(void)
+{
+	return g_status;
+}
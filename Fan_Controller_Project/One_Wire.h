@@ -0,0 +1,115 @@
+/*******************************************************************************************************************
+ * File Name: One_Wire.h
+ * Date: 19/10/2026
+ * Driver: 1-Wire Bus Master (Bit Timing from the Timer1 Compare B Interrupt) Header File
+ * Author: Youssef Zaki
+ *
+ * A transfer (reset, presence, bytes written, bytes read, least significant bit first) runs in the Timer1
+ * compare B interrupt: every step of a time slot schedules the interrupt of the next one (Timer1_NextCompareB),
+ * so the 480us reset, the 60us low time of a 0 and the end of the slots are timed by Timer1 while the main loop
+ * keeps running. Only the parts shorter than the interrupt latency stay in the interrupt: the low time of a 1
+ * and of a read slot, and the wait before sampling a read slot (ONE_WIRE_READ_SAMPLE_US), about 15us per slot.
+ * The presence sample and the end of the low time of a 0 have deadlines: they are timed from the bus edge which
+ * starts them, and when another interrupt delayed them past their window the transfer is aborted (ONE_WIRE_LATE)
+ * instead of sampling or releasing the bus late. When the previous step was delayed instead, the interrupt comes
+ * before the window: it is scheduled again at the opening of the window, less its entry (ONE_WIRE_ISR_ENTRY_CYCLES),
+ * and returns, only a shorter wait is a busy wait. The longest interrupt, ONE_WIRE_ISR_CYCLES, is one of the
+ * blocking sections of the over temperature fast path (FAN_SAFETY_BLOCKING_CYCLES, Fan_Safety.h).
+ * The bus is driven open drain: the pin is an output at 0 to pull the bus low and an input (without internal
+ * pull-up, an external 4.7k pull-up is needed) to release it. The sensors must be powered from VDD, the strong
+ * pull-up of the parasite power is not supported.
+ * Timer1 runs free at the CPU clock (as for the profiler timestamps, which can share it), so it cannot be the
+ * PWM back end of the motor (DC_MOTOR_PWM_BACKEND) or of Fan_Array.c at the same time.
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+#include "TIMER1.h"
+
+#ifndef ONE_WIRE_H_
+#define ONE_WIRE_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/* Bus pin (PD7, the OC2 pin is not used by the application) */
+#define ONE_WIRE_DDR                               DDRD
+#define ONE_WIRE_PORT                              PORTD
+#define ONE_WIRE_PIN                               PIND
+#define ONE_WIRE_BIT                               PIN7_ID
+
+/* Time slots in microseconds (standard speed) */
+#define ONE_WIRE_RESET_LOW_US                      480
+#define ONE_WIRE_PRESENCE_SAMPLE_US                70
+#define ONE_WIRE_RESET_END_US                      410
+#define ONE_WIRE_SLOT_US                           70
+#define ONE_WIRE_WRITE0_LOW_US                     60
+#define ONE_WIRE_WRITE1_LOW_US                     5
+#define ONE_WIRE_READ_LOW_US                       1
+#define ONE_WIRE_READ_SAMPLE_US                    8
+
+/*
+ * Windows of the steps with a deadline, from the bus edge which starts them: the presence pulse of a device
+ * starts at most 60us after the reset release and lasts 60us at least (low from 60us to 75us at worst), the
+ * low time of a 0 is 60us to 120us.
+ */
+#define ONE_WIRE_PRESENCE_EARLIEST_US              60
+#define ONE_WIRE_PRESENCE_LATEST_US                75
+#define ONE_WIRE_WRITE0_MAX_LOW_US                 120
+
+/* Timer1 counts of a time in microseconds (Timer1 runs at the CPU clock) */
+#define ONE_WIRE_TICKS(Time_us)                    ((uint16)((Time_us) * (F_CPU / 1000000UL)))
+
+/* CPU cycles from a compare match to the window check: response, vector, prologue and call back (avr-gcc -Os) */
+#define ONE_WIRE_ISR_ENTRY_CYCLES                  50U
+
+/*
+ * Longest interrupt in CPU cycles: the busy waits of a read slot (the low time of a 1 is shorter) and of a window
+ * closer than the interrupt entry, plus the bit handling and the compare scheduling (estimated for avr-gcc -Os)
+ */
+#define ONE_WIRE_ISR_CYCLES                        ((ONE_WIRE_READ_LOW_US + ONE_WIRE_READ_SAMPLE_US) * (F_CPU / 1000000UL) + \
+                                                    ONE_WIRE_ISR_ENTRY_CYCLES + TIMER1_COMPARE_MIN_AHEAD + 250UL)
+
+#if (F_CPU < 1000000UL)
+
+#error "The 1-Wire time slots need F_CPU of 1MHz at least"
+
+#endif
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+typedef enum
+{
+	ONE_WIRE_IDLE, ONE_WIRE_BUSY, ONE_WIRE_DONE, ONE_WIRE_NO_PRESENCE, ONE_WIRE_LATE
+}OneWire_StatusType;
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the 1-Wire bus master.
+ * 1. Release the bus (input pin, output latch at 0 for the pull down).
+ * 2. Start Timer1 as a free running counter at the CPU clock and register the compare B call back.
+ */
+void OneWire_Init(void);
+
+/*
+ * Description:
+ * Start a transfer: reset and presence, then Write_Length bytes of Write_Ptr, then Read_Length bytes into
+ * Read_Ptr. The buffers are used by the interrupt until the end of the transfer. Return FALSE if a transfer
+ * is already in progress.
+ */
+boolean OneWire_StartTransfer(const uint8 *Write_Ptr, uint8 Write_Length, uint8 *Read_Ptr, uint8 Read_Length);
+
+/*
+ * Description:
+ * Return the state of the last transfer: ONE_WIRE_BUSY while it runs, then ONE_WIRE_DONE,
+ * ONE_WIRE_NO_PRESENCE if no device answered the reset (the bytes are not sent), or ONE_WIRE_LATE if a
+ * deadline was missed (the transfer is aborted and can be started again).
+ */
+OneWire_StatusType OneWire_GetStatus(void);
+
+#endif /* ONE_WIRE_H_ */
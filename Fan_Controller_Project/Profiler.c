@@ -0,0 +1,263 @@
+/*******************************************************************************************************************
+ * File Name: Profiler.c
+ * Date: 19/10/2026
+ * Driver: Hot-Path Profiler (Timer1 Timestamps) Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "Isr_Sync.h"
+#include "UART.h"
+#include "Stack_Monitor.h"
+#include "Temp_Stats.h"
+#include "Profiler.h"
+
+#if (PROFILER_ENABLED == 1)
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+volatile Profiler_StatsType g_ProfilerStats[PROFILE_NUM_OF_REGIONS];
+
+static const char * const g_regionNames[PROFILE_NUM_OF_REGIONS] =
+{
+	"main_loop",
+	"LM35_GetTemperature",
+	"LCD_Update",
+	"DcMotor_Rotate"
+};
+
+static const char * const g_tempStatsWindowNames[TEMP_STATS_NUM_OF_WINDOWS] =
+{
+	"1min",
+	"10min",
+	"60min"
+};
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the profiler.
+ * 1. Start Timer1 as a free running timestamp counter.
+ * 2. Initialize the USART used to dump the statistics.
+ * 3. Reset the statistics of all the regions.
+ */
+void Profiler_Init(void)
+{
+	UART_ConfigType UART_Config = {PROFILER_UART_BAUD_RATE, UART_Parity_Disabled, UART_One_Stop_Bit};
+
+	Timer1_FreeRunning_Init(PROFILER_TIMER1_PRESCALER);
+	UART_Init(&UART_Config);
+	Profiler_Reset();
+}
+
+/*
+ * Description:
+ * Accumulate the count, minimum, maximum, total and latency histogram of a region which started at
+ * the Timer1 timestamp Start.
+ */
+void Profiler_Record(Profiler_RegionType Region, uint16 Start)
+{
+	uint16 Now = Timer1_GetCount();
+	uint16 Elapsed;
+	uint16 Value;
+	uint8 Bucket = 0;
+	uint8 Sreg;
+	volatile Profiler_StatsType *Stats_Ptr = &g_ProfilerStats[Region];
+
+	/* The counter wraps at TOP, not always at 0xFFFF */
+	if (Now >= Start)
+	{
+		Elapsed = Now - Start;
+	}
+	else
+	{
+		Elapsed = (uint16)(Now + (Timer1_GetTop() - Start) + 1);
+	}
+
+	/* Bucket = number of significant bits of the elapsed ticks */
+	Value = Elapsed;
+	while (Value != 0)
+	{
+		Bucket++;
+		Value >>= 1;
+	}
+
+	/* A region may also be recorded from an interrupt, update the statistics atomically */
+	Sreg = IsrSync_EnterCritical();
+
+	Stats_Ptr -> Count++;
+	Stats_Ptr -> Total += Elapsed;
+	if (Elapsed < Stats_Ptr -> Min)
+	{
+		Stats_Ptr -> Min = Elapsed;
+	}
+	if (Elapsed > Stats_Ptr -> Max)
+	{
+		Stats_Ptr -> Max = Elapsed;
+	}
+	if (Stats_Ptr -> Histogram[Bucket] != 0xFFFF)
+	{
+		Stats_Ptr -> Histogram[Bucket]++;
+	}
+
+	IsrSync_ExitCritical(Sreg);
+}
+
+/*
+ * Description:
+ * Reset the statistics of all the regions.
+ */
+void Profiler_Reset(void)
+{
+	uint8 Region;
+	uint8 Bucket;
+	uint8 Sreg = IsrSync_EnterCritical();
+
+	for (Region = 0; Region < PROFILE_NUM_OF_REGIONS; Region++)
+	{
+		g_ProfilerStats[Region].Count = 0;
+		g_ProfilerStats[Region].Total = 0;
+		g_ProfilerStats[Region].Min = 0xFFFF;
+		g_ProfilerStats[Region].Max = 0;
+
+		for (Bucket = 0; Bucket < PROFILER_NUM_OF_BUCKETS; Bucket++)
+		{
+			g_ProfilerStats[Region].Histogram[Bucket] = 0;
+		}
+	}
+
+	IsrSync_ExitCritical(Sreg);
+}
+
+/*
+ * Description:
+ * Send the statistics of all the regions over the USART, one line per region:
+ * region count min max total histogram(bucket:count ...)
+ * followed by the RAM usage reported by the stack monitor.
+ */
+void Profiler_Dump(void)
+{
+	Profiler_StatsType Stats;
+	StackMonitor_ReportType Ram_Report;
+	uint8 Region;
+	uint8 Bucket;
+	uint8 Sreg;
+
+	UART_SendString("region count min max total histogram\r\n");
+
+	for (Region = 0; Region < PROFILE_NUM_OF_REGIONS; Region++)
+	{
+		/* Take a consistent copy, the USART is slow and the statistics keep changing */
+		Sreg = IsrSync_EnterCritical();
+		Stats = *(const Profiler_StatsType *)&g_ProfilerStats[Region];
+		IsrSync_ExitCritical(Sreg);
+
+		UART_SendString(g_regionNames[Region]);
+		UART_SendByte(' ');
+		UART_SendUnsigned(Stats.Count);
+		UART_SendByte(' ');
+		UART_SendUnsigned((Stats.Count != 0) ? Stats.Min : 0);
+		UART_SendByte(' ');
+		UART_SendUnsigned(Stats.Max);
+		UART_SendByte(' ');
+		UART_SendUnsigned(Stats.Total);
+
+		for (Bucket = 0; Bucket < PROFILER_NUM_OF_BUCKETS; Bucket++)
+		{
+			if (Stats.Histogram[Bucket] != 0)
+			{
+				UART_SendByte(' ');
+				UART_SendUnsigned(Bucket);
+				UART_SendByte(':');
+				UART_SendUnsigned(Stats.Histogram[Bucket]);
+			}
+		}
+
+		UART_SendString("\r\n");
+	}
+
+	/* RAM usage line: static data, heap, deepest stack and worst case free RAM since reset */
+	StackMonitor_GetReport(&Ram_Report);
+
+	UART_SendString("ram size=");
+	UART_SendUnsigned(Ram_Report.Ram_Size);
+	UART_SendString(" data_bss=");
+	UART_SendUnsigned(Ram_Report.Data_Bss_Size);
+	UART_SendString(" heap=");
+	UART_SendUnsigned(Ram_Report.Heap_Size);
+	UART_SendString(" stack_max=");
+	UART_SendUnsigned(Ram_Report.Stack_High_Water);
+	UART_SendString(" free_min=");
+	UART_SendUnsigned(Ram_Report.Free_Ram_Min);
+	UART_SendString("\r\n");
+}
+
+/*
+ * Description:
+ * Send the temperature statistics over the USART, one line per window (Temp_Stats.c):
+ * window min max mean samples
+ */
+void Profiler_DumpTempStats(void)
+{
+	TempStats_ResultType Result;
+	uint8 Window;
+
+	UART_SendString("window min max mean samples\r\n");
+
+	for (Window = 0; Window < TEMP_STATS_NUM_OF_WINDOWS; Window++)
+	{
+		UART_SendString(g_tempStatsWindowNames[Window]);
+
+		if (TempStats_GetWindow(Window, &Result))
+		{
+			UART_SendByte(' ');
+			UART_SendUnsigned(Result.Minimum);
+			UART_SendByte(' ');
+			UART_SendUnsigned(Result.Maximum);
+			UART_SendByte(' ');
+			UART_SendUnsigned(Result.Mean);
+			UART_SendByte(' ');
+			UART_SendUnsigned(Result.Num_Of_Samples);
+		}
+		else
+		{
+			UART_SendString(" - - - 0");
+		}
+
+		UART_SendString("\r\n");
+	}
+}
+
+/*
+ * Description:
+ * Periodic task called from the main loop, it executes the dump/reset/statistics commands received over the USART.
+ */
+void Profiler_Task(void)
+{
+	uint8 Command;
+
+	if (UART_IsByteReceived())
+	{
+		Command = UART_ReceiveByte();
+
+		if (Command == PROFILER_COMMAND_DUMP)
+		{
+			Profiler_Dump();
+		}
+		else if (Command == PROFILER_COMMAND_RESET)
+		{
+			Profiler_Reset();
+		}
+		else if (Command == PROFILER_COMMAND_TEMP_STATS)
+		{
+			Profiler_DumpTempStats();
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,160 @@
+/*******************************************************************************************************************
+ * File Name: Profiler.h
+ * Date: 19/10/2026
+ * Driver: Hot-Path Profiler (Timer1 Timestamps) Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+#include "GPIO.h"
+#include "LCD.h"
+#include "TIMER1.h"
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/*
+ * 1 to compile the profiling regions in, 0 to compile them out completely (no code and no RAM).
+ * When enabled, Timer1 is used as a free running timestamp counter and the USART for the dump.
+ */
+#define PROFILER_ENABLED                           0
+
+#if ((PROFILER_ENABLED != 0) && (PROFILER_ENABLED != 1))
+
+#error "PROFILER_ENABLED should be 0 or 1"
+
+#endif
+
+#if ((PROFILER_ENABLED == 1) && (LCD_RS_PORT == PORTD_ID) && (LCD_RS_PIN <= PIN1_ID))
+
+#error "The USART uses PD0 and PD1, move the LCD RS pin (LCD_RS_PIN, e.g. -DLCD_RS_PIN=PIN3_ID) for the profiler"
+
+#endif
+
+/*
+ * Timer1 clock: with Prescaler_1 one tick is one CPU cycle, a region must be shorter than
+ * 65536 ticks (65.5ms at 1MHz) to be measured correctly.
+ */
+#define PROFILER_TIMER1_PRESCALER                  TIMER1_Prescaler_1
+
+#define PROFILER_UART_BAUD_RATE                    9600
+
+/* Latency histogram: bucket n counts the regions which took [2^(n-1), 2^n) ticks, bucket 0 counts 0 ticks */
+#define PROFILER_NUM_OF_BUCKETS                    17
+
+/* Commands received over the USART by Profiler_Task */
+#define PROFILER_COMMAND_DUMP                      'p'
+#define PROFILER_COMMAND_RESET                     'r'
+#define PROFILER_COMMAND_TEMP_STATS                'w'
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+typedef enum
+{
+	PROFILE_MAIN_LOOP,
+	PROFILE_LM35_GET_TEMPERATURE,
+	PROFILE_LCD_UPDATE,
+	PROFILE_DC_MOTOR_ROTATE,
+	PROFILE_NUM_OF_REGIONS
+}Profiler_RegionType;
+
+typedef struct
+{
+	uint32 Count;
+	uint32 Total;
+	uint16 Min;
+	uint16 Max;
+	uint16 Histogram[PROFILER_NUM_OF_BUCKETS];
+}Profiler_StatsType;
+
+/*******************************************************************************************
+ *                                    Profiling Macros                                     *
+ *******************************************************************************************/
+
+#if (PROFILER_ENABLED == 1)
+
+/* Take the entry timestamp of a region, PROFILE_END must follow in the same scope */
+#define PROFILE_BEGIN(Region)                      uint16 Profile_Start_##Region = Timer1_GetCount()
+
+/* Take the exit timestamp of a region and accumulate its statistics */
+#define PROFILE_END(Region)                        Profiler_Record((Region), Profile_Start_##Region)
+
+#else
+
+#define PROFILE_BEGIN(Region)
+#define PROFILE_END(Region)
+
+#endif
+
+#if (PROFILER_ENABLED == 1)
+
+/*******************************************************************************************
+ *                                    External Variables                                   *
+ *******************************************************************************************/
+
+/* The statistics of all the regions, can be read directly from the simulator (simavr) or the debugger */
+extern volatile Profiler_StatsType g_ProfilerStats[PROFILE_NUM_OF_REGIONS];
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the profiler.
+ * 1. Start Timer1 as a free running timestamp counter.
+ * 2. Initialize the USART used to dump the statistics.
+ * 3. Reset the statistics of all the regions.
+ */
+void Profiler_Init(void);
+
+/*
+ * Description:
+ * Accumulate the count, minimum, maximum, total and latency histogram of a region which started at
+ * the Timer1 timestamp Start.
+ */
+void Profiler_Record(Profiler_RegionType Region, uint16 Start);
+
+/*
+ * Description:
+ * Reset the statistics of all the regions.
+ */
+void Profiler_Reset(void);
+
+/*
+ * Description:
+ * Send the statistics of all the regions over the USART, one line per region:
+ * region count min max total histogram(bucket:count ...)
+ * followed by the RAM usage reported by the stack monitor.
+ */
+void Profiler_Dump(void);
+
+/*
+ * Description:
+ * Send the temperature statistics over the USART, one line per window (Temp_Stats.c):
+ * window min max mean samples
+ */
+void Profiler_DumpTempStats(void);
+
+/*
+ * Description:
+ * Periodic task called from the main loop, it executes the dump/reset/statistics commands received over the USART.
+ */
+void Profiler_Task(void);
+
+#else
+
+#define Profiler_Init()
+#define Profiler_Reset()
+#define Profiler_Dump()
+#define Profiler_DumpTempStats()
+#define Profiler_Task()
+
+#endif
+
+#endif /* PROFILER_H_ */
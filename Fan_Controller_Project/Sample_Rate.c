@@ -0,0 +1,146 @@
+/*******************************************************************************************************************
+ * File Name: Sample_Rate.c
+ * Date: 19/10/2026
+ * Driver: Adaptive Temperature Sampling Rate (Slope Estimation in the ADC Interrupt) Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include <util/atomic.h>
+#include "ADC.h"
+#include "LM35.h"
+#include "Sample_Rate.h"
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+/* The sensor slot is converted once every 2^g_intervalShift of its turns */
+static volatile uint8 g_intervalShift = 0;
+
+/* Filtered slope times 2^SAMPLE_RATE_FILTER_SHIFT (no rounding loss), previous result and number of stable results */
+static volatile sint16 g_slopeSum = 0;
+static volatile uint16 g_lastCode = 0;
+static volatile boolean g_hasLastCode = FALSE;
+static volatile uint8 g_stableCount = 0;
+
+/****************************************************************************************
+ *                                   Private Functions Definitions                      *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Select the interval of the sensor slot.
+ */
+static void SampleRate_SetShift(uint8 Shift)
+{
+	if (Shift != g_intervalShift)
+	{
+		g_intervalShift = Shift;
+		ADC_SetInterval(LM35_ADC_SLOT, (uint8)(1 << Shift));
+	}
+	g_stableCount = 0;
+}
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Start at the fastest rate with no slope, the next result is the reference of the slope.
+ */
+void SampleRate_Init(void)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_intervalShift = 0;
+		g_slopeSum = 0;
+		g_hasLastCode = FALSE;
+		g_stableCount = 0;
+		ADC_SetInterval(LM35_ADC_SLOT, 1);
+	}
+}
+
+/*
+ * Description:
+ * Called from the ADC interrupt with every new result of the sensor slot (constant time):
+ * 1. A jump of SAMPLE_RATE_JUMP_CODES or a slope above SAMPLE_RATE_FAST_SLOPE selects the fastest rate.
+ * 2. SAMPLE_RATE_STABLE_RESULTS consecutive results under SAMPLE_RATE_STABLE_SLOPE halve the rate,
+ *    down to the slowest one.
+ */
+void SampleRate_Update(uint16 Code)
+{
+	sint16 Delta;
+	sint16 Instant;
+	sint16 Slope;
+
+	if (!g_hasLastCode)
+	{
+		g_lastCode = Code;
+		g_hasLastCode = TRUE;
+		return;
+	}
+
+	Delta = (sint16)Code - (sint16)g_lastCode;
+	g_lastCode = Code;
+
+	if ((Delta >= SAMPLE_RATE_JUMP_CODES) || (Delta <= -SAMPLE_RATE_JUMP_CODES))
+	{
+		/* The slope of a jump is not averaged, one result is enough to go back to the fastest rate */
+		g_slopeSum = ((Delta > 0) ? SAMPLE_RATE_FAST_SLOPE : -SAMPLE_RATE_FAST_SLOPE) << SAMPLE_RATE_FILTER_SHIFT;
+		SampleRate_SetShift(0);
+		return;
+	}
+
+	/* Change per result at the fastest rate: the result period is 2^g_intervalShift times longer */
+	Instant = (sint16)(Delta << (SAMPLE_RATE_SLOPE_FRACTION_BITS - g_intervalShift));
+	g_slopeSum += Instant - (g_slopeSum >> SAMPLE_RATE_FILTER_SHIFT);
+
+	Slope = g_slopeSum >> SAMPLE_RATE_FILTER_SHIFT;
+	if (Slope < 0)
+	{
+		Slope = -Slope;
+	}
+
+	if (Slope >= SAMPLE_RATE_FAST_SLOPE)
+	{
+		SampleRate_SetShift(0);
+	}
+	else if (Slope < SAMPLE_RATE_STABLE_SLOPE)
+	{
+		g_stableCount++;
+
+		if (g_stableCount >= SAMPLE_RATE_STABLE_RESULTS)
+		{
+			SampleRate_SetShift((g_intervalShift < SAMPLE_RATE_MAX_INTERVAL_SHIFT) ? (g_intervalShift + 1) : g_intervalShift);
+		}
+	}
+	else
+	{
+		g_stableCount = 0;
+	}
+}
+
+/*
+ * Description:
+ * Return the interval of the sensor slot in use (1 to 2^SAMPLE_RATE_MAX_INTERVAL_SHIFT).
+ */
+uint8 SampleRate_GetInterval(void)
+{
+	return (uint8)(1 << g_intervalShift);
+}
+
+/*
+ * Description:
+ * Return the filtered slope in ADC codes per result at the fastest rate with SAMPLE_RATE_SLOPE_FRACTION_BITS.
+ */
+sint16 SampleRate_GetSlope(void)
+{
+	sint16 Slope;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		Slope = g_slopeSum >> SAMPLE_RATE_FILTER_SHIFT;
+	}
+
+	return Slope;
+}
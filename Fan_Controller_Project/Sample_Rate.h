@@ -0,0 +1,83 @@
+/*******************************************************************************************************************
+ * File Name: Sample_Rate.h
+ * Date: 19/10/2026
+ * Driver: Adaptive Temperature Sampling Rate (Slope Estimation in the ADC Interrupt) Header File
+ * Author: Youssef Zaki
+ *
+ * The sensor slot of the ADC schedule is converted once every 2^n of its turns (ADC_SetInterval), n from 0
+ * at a fast temperature change to SAMPLE_RATE_MAX_INTERVAL_SHIFT when the temperature is stable. The other
+ * turns are idle: no conversion and no ADC interrupt. The fan curve events, so the control of the motor and
+ * the display, follow the same rate.
+ * With 8 samples per result and the current sensing in the schedule, a result takes 32.8ms at the fastest
+ * rate and 524ms at the slowest one (Timer0 PWM at 488Hz).
+ * The slope is the change of the result per result at the fastest rate, filtered by an exponential average
+ * of every new result (no history buffer, no division).
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+
+#ifndef SAMPLE_RATE_H_
+#define SAMPLE_RATE_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/* Slowest rate: the sensor slot is converted once every 2^4 = 16 of its turns */
+#define SAMPLE_RATE_MAX_INTERVAL_SHIFT             4
+
+/* Fraction bits of the slope (ADC codes per result at the fastest rate) */
+#define SAMPLE_RATE_SLOPE_FRACTION_BITS            8
+
+/* Slope from which the fastest rate is used at once: 16/256 code per 32.8ms, about 0.5C/s */
+#define SAMPLE_RATE_FAST_SLOPE                     16
+
+/* Slope under which the temperature is stable: 4/256 code per 32.8ms, about 0.12C/s */
+#define SAMPLE_RATE_STABLE_SLOPE                   4
+
+/* A result this number of codes away from the previous one is a transient, the fastest rate is used at once */
+#define SAMPLE_RATE_JUMP_CODES                     2
+
+/* Number of consecutive stable results before halving the rate */
+#define SAMPLE_RATE_STABLE_RESULTS                 8
+
+/* Weight of a new result in the slope average: 1/2^3 */
+#define SAMPLE_RATE_FILTER_SHIFT                   3
+
+#if (SAMPLE_RATE_STABLE_SLOPE >= SAMPLE_RATE_FAST_SLOPE)
+
+#error "SAMPLE_RATE_STABLE_SLOPE should be lower than SAMPLE_RATE_FAST_SLOPE"
+
+#endif
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Start at the fastest rate with no slope, the next result is the reference of the slope.
+ */
+void SampleRate_Init(void);
+
+/*
+ * Description:
+ * Called from the ADC interrupt with every new result of the sensor slot (constant time):
+ * 1. A jump of SAMPLE_RATE_JUMP_CODES or a slope above SAMPLE_RATE_FAST_SLOPE selects the fastest rate.
+ * 2. SAMPLE_RATE_STABLE_RESULTS consecutive results under SAMPLE_RATE_STABLE_SLOPE halve the rate,
+ *    down to the slowest one.
+ */
+void SampleRate_Update(uint16 Code);
+
+/*
+ * Description:
+ * Return the interval of the sensor slot in use (1 to 2^SAMPLE_RATE_MAX_INTERVAL_SHIFT).
+ */
+uint8 SampleRate_GetInterval(void);
+
+/*
+ * Description:
+ * Return the filtered slope in ADC codes per result at the fastest rate with SAMPLE_RATE_SLOPE_FRACTION_BITS.
+ */
+sint16 SampleRate_GetSlope(void);
+
+#endif /* SAMPLE_RATE_H_ */
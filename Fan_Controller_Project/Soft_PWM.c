@@ -0,0 +1,330 @@
+/*******************************************************************************************************************
+ * File Name: Soft_PWM.c
+ * Date: 19/10/2026
+ * Driver: Software PWM Engine (Sorted Edge Scheduling on Timer2) Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "Common_Macros.h"
+#include "GPIO.h"
+#include "Isr_Sync.h"
+#include "TIMER2.h"
+#include "Soft_PWM.h"
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+/* At Time the pins in Clear_Mask of Port go low */
+typedef struct
+{
+	uint8 Time;
+	uint8 Port;
+	uint8 Clear_Mask;
+}SoftPWM_EdgeType;
+
+/* The pins in Set_Masks go high at the beginning of the period, then the edges clear them in order */
+typedef struct
+{
+	uint8 Set_Masks[NUM_OF_PORTS];
+	uint8 Num_Of_Edges;
+	SoftPWM_EdgeType Edges[SOFT_PWM_MAX_CHANNELS];
+}SoftPWM_ScheduleType;
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+static const SoftPWM_ChannelConfigType *g_channels = NULL_PTR;
+static uint8 g_numOfChannels = 0;
+static uint8 g_duties[SOFT_PWM_MAX_CHANNELS];
+
+/* Double buffered schedule: the interrupt reads g_schedules[g_activeSchedule], SoftPWM_Commit writes the other one */
+static SoftPWM_ScheduleType g_schedules[2];
+static volatile uint8 g_activeSchedule = 0;
+static volatile boolean g_swapPending = FALSE;
+
+/* Next edge of the active schedule */
+static volatile uint8 g_nextEdge = 0;
+
+/* Pins of the channels on each port, cleared at the beginning of a period unless they are set */
+static uint8 g_channelMasks[NUM_OF_PORTS];
+
+/****************************************************************************************
+ *                                      Interrupt Call Backs                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Return the output latch of the port with the GPIO port ID.
+ */
+static volatile uint8 *SoftPWM_PortRegister(uint8 Port)
+{
+	switch (Port)
+	{
+	case PORTA_ID:
+		return &PORTA;
+	case PORTB_ID:
+		return &PORTB;
+	case PORTC_ID:
+		return &PORTC;
+	default:
+		return &PORTD;
+	}
+}
+
+/*
+ * Description:
+ * Write all the edges which are due (or too close to be scheduled) then program the compare match
+ * of the next one. One port write per edge, whatever the number of channels merged in it.
+ * Last_Count is a count already reached in this period (0 at the overflow, the time of the matched edge at a
+ * compare match): a count read below it means Timer2 has wrapped while the interrupt was delayed, the edges
+ * left are then late and written at once instead of being waited for in the next period.
+ */
+static void SoftPWM_RunEdges(const SoftPWM_ScheduleType *Schedule_Ptr, uint8 Last_Count)
+{
+	uint8 Edge = g_nextEdge;
+	const SoftPWM_EdgeType *Edge_Ptr;
+	boolean Late = FALSE;
+	uint8 Count;
+
+	while (Edge < Schedule_Ptr -> Num_Of_Edges)
+	{
+		Edge_Ptr = &Schedule_Ptr -> Edges[Edge];
+
+		/* Busy wait the few ticks left so the edge is written on time */
+		do
+		{
+			Count = TCNT2;
+			if (Count < Last_Count)
+			{
+				Late = TRUE;
+			}
+			Last_Count = Count;
+
+			if (!Late && ((uint16)Edge_Ptr -> Time > (uint16)Count + SOFT_PWM_EDGE_MARGIN_TICKS))
+			{
+				/* Clear any old match then wait for this edge */
+				OCR2 = Edge_Ptr -> Time;
+				TIFR = (1 << OCF2);
+				SET_BIT(TIMSK, OCIE2);
+				g_nextEdge = Edge;
+				return;
+			}
+		} while (!Late && (Count < Edge_Ptr -> Time));
+
+		*SoftPWM_PortRegister(Edge_Ptr -> Port) &= ~(Edge_Ptr -> Clear_Mask);
+		Edge++;
+	}
+
+	/* No more edges in this period */
+	CLEAR_BIT(TIMSK, OCIE2);
+	g_nextEdge = Edge;
+}
+
+/*
+ * Description:
+ * Timer2 overflow: beginning of a new period.
+ */
+static void SoftPWM_PeriodStart(void)
+{
+	const SoftPWM_ScheduleType *Schedule_Ptr;
+	uint8 Port;
+
+	if (g_swapPending)
+	{
+		g_activeSchedule ^= 1;
+		g_swapPending = FALSE;
+	}
+
+	Schedule_Ptr = &g_schedules[g_activeSchedule];
+
+	/* The channels at 0 are cleared too, one of them may have been left high at 255 by the last schedule */
+	for (Port = 0; Port < NUM_OF_PORTS; Port++)
+	{
+		if (g_channelMasks[Port] != 0)
+		{
+			*SoftPWM_PortRegister(Port) = (*SoftPWM_PortRegister(Port) & ~g_channelMasks[Port]) | Schedule_Ptr -> Set_Masks[Port];
+		}
+	}
+
+	g_nextEdge = 0;
+	SoftPWM_RunEdges(Schedule_Ptr, 0);
+}
+
+/*
+ * Description:
+ * Timer2 compare match: the next edge is due.
+ */
+static void SoftPWM_EdgeDue(void)
+{
+	const SoftPWM_ScheduleType *Schedule_Ptr = &g_schedules[g_activeSchedule];
+
+	SoftPWM_RunEdges(Schedule_Ptr, Schedule_Ptr -> Edges[g_nextEdge].Time);
+}
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the software PWM engine.
+ * 1. Setup the channel pins as output pins (low).
+ * 2. Start Timer2 in the Normal Mode with the overflow and compare match call backs.
+ */
+void SoftPWM_Init(const SoftPWM_ChannelConfigType *Channels_Ptr, uint8 Num_Of_Channels)
+{
+	TIMER2_ConfigType Timer2_Config = {0, 0, Normal_0, SOFT_PWM_TIMER2_PRESCALER};
+	uint8 Channel;
+
+	if (Num_Of_Channels > SOFT_PWM_MAX_CHANNELS)
+	{
+		Num_Of_Channels = SOFT_PWM_MAX_CHANNELS;
+	}
+
+	g_channels = Channels_Ptr;
+	g_numOfChannels = Num_Of_Channels;
+
+	for (Channel = 0; Channel < NUM_OF_PORTS; Channel++)
+	{
+		g_channelMasks[Channel] = 0;
+	}
+
+	for (Channel = 0; Channel < Num_Of_Channels; Channel++)
+	{
+		GPIO_SetupPinDirection(Channels_Ptr[Channel].Port, Channels_Ptr[Channel].Pin, OUTPUT_PIN);
+		GPIO_WritePin(Channels_Ptr[Channel].Port, Channels_Ptr[Channel].Pin, LOGIC_LOW);
+		g_channelMasks[Channels_Ptr[Channel].Port] |= (1 << Channels_Ptr[Channel].Pin);
+		g_duties[Channel] = 0;
+	}
+
+	/* Both schedules are empty: every pin stays low */
+	g_activeSchedule = 0;
+	g_swapPending = FALSE;
+	g_schedules[0].Num_Of_Edges = 0;
+	g_schedules[1].Num_Of_Edges = 0;
+	for (Channel = 0; Channel < NUM_OF_PORTS; Channel++)
+	{
+		g_schedules[0].Set_Masks[Channel] = 0;
+		g_schedules[1].Set_Masks[Channel] = 0;
+	}
+
+	Timer2_SetCallBack(SoftPWM_PeriodStart);
+	Timer2_SetCompareCallBack(SoftPWM_EdgeDue);
+	Timer2_NonPWM_Mode_Init(&Timer2_Config);
+}
+
+/*
+ * Description:
+ * Set the duty cycle of one channel (0 = always low, 255 = always high), it is applied by SoftPWM_Commit.
+ */
+void SoftPWM_SetDuty(uint8 Channel, uint8 Duty)
+{
+	if (Channel < g_numOfChannels)
+	{
+		g_duties[Channel] = Duty;
+	}
+}
+
+/*
+ * Description:
+ * Build the edge list of the new duty cycles and publish it, the interrupt starts using it at the
+ * beginning of the next period so the outputs never glitch.
+ * 1. Sort the channels by their duty cycle.
+ * 2. Merge the channels which fall at the same time on the same port into one edge (one port write).
+ * 3. Write the list into the back buffer and request the swap.
+ */
+void SoftPWM_Commit(void)
+{
+	uint8 Order[SOFT_PWM_MAX_CHANNELS];
+	SoftPWM_ScheduleType *Schedule_Ptr;
+	SoftPWM_EdgeType *Edge_Ptr;
+	const SoftPWM_ChannelConfigType *Channel_Ptr;
+	uint8 Channel;
+	uint8 Duty;
+	uint8 Edge;
+	uint8 i;
+	uint8 j;
+
+	/*
+	 * The interrupt must not swap while the back buffer is written, the active buffer is stable then.
+	 * The barriers keep the compiler from moving the writes of the back buffer (not volatile) before
+	 * the clear or after the publish of the swap request.
+	 */
+	g_swapPending = FALSE;
+	ISR_SYNC_BARRIER();
+	Schedule_Ptr = &g_schedules[g_activeSchedule ^ 1];
+
+	/* Insertion sort of the channels by duty cycle (8 channels at most) */
+	for (i = 0; i < g_numOfChannels; i++)
+	{
+		Channel = i;
+		j = i;
+		while ((j > 0) && (g_duties[Order[j - 1]] > g_duties[Channel]))
+		{
+			Order[j] = Order[j - 1];
+			j--;
+		}
+		Order[j] = Channel;
+	}
+
+	for (i = 0; i < NUM_OF_PORTS; i++)
+	{
+		Schedule_Ptr -> Set_Masks[i] = 0;
+	}
+
+	Edge = 0;
+	for (i = 0; i < g_numOfChannels; i++)
+	{
+		Channel_Ptr = &g_channels[Order[i]];
+		Duty = g_duties[Order[i]];
+
+		/* Duty 0: the pin is never set, so it needs no edge */
+		if (Duty == 0)
+		{
+			continue;
+		}
+
+		Schedule_Ptr -> Set_Masks[Channel_Ptr -> Port] |= (1 << Channel_Ptr -> Pin);
+
+		/* Duty 255: the pin is never cleared */
+		if (Duty == 0xFF)
+		{
+			continue;
+		}
+
+		/* Look for an edge at the same time on the same port (the edges are sorted by time) */
+		for (j = Edge; j > 0; j--)
+		{
+			Edge_Ptr = &Schedule_Ptr -> Edges[j - 1];
+
+			if (Edge_Ptr -> Time != Duty)
+			{
+				j = 0;
+				break;
+			}
+			if (Edge_Ptr -> Port == Channel_Ptr -> Port)
+			{
+				Edge_Ptr -> Clear_Mask |= (1 << Channel_Ptr -> Pin);
+				break;
+			}
+		}
+
+		if (j == 0)
+		{
+			Edge_Ptr = &Schedule_Ptr -> Edges[Edge];
+			Edge_Ptr -> Time = Duty;
+			Edge_Ptr -> Port = Channel_Ptr -> Port;
+			Edge_Ptr -> Clear_Mask = (1 << Channel_Ptr -> Pin);
+			Edge++;
+		}
+	}
+
+	Schedule_Ptr -> Num_Of_Edges = Edge;
+
+	/* Publish the back buffer, it becomes active at the next overflow */
+	ISR_SYNC_BARRIER();
+	g_swapPending = TRUE;
+}
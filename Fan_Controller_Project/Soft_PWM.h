@@ -0,0 +1,76 @@
+/*******************************************************************************************************************
+ * File Name: Soft_PWM.h
+ * Date: 19/10/2026
+ * Driver: Software PWM Engine (Sorted Edge Scheduling on Timer2) Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+
+#ifndef SOFT_PWM_H_
+#define SOFT_PWM_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+#define SOFT_PWM_MAX_CHANNELS                      8
+
+/*
+ * Timer2 runs in the Normal Mode: the overflow starts the period and the compare match walks the edges.
+ * F_CPU/8/256 = 488Hz at 1MHz, the same frequency as the hardware PWM channels.
+ * Timer2 cannot be used by the Fan Array (OC2) at the same time.
+ */
+#define SOFT_PWM_TIMER2_PRESCALER                  TIMER2_Prescaler_8
+
+/*
+ * The interrupts write the channel pins with a read-modify-write of their PORT register. The other pins of
+ * these ports must be written with GPIO_WritePin (interrupts disabled during its read-modify-write) or in a
+ * critical section, and a port written whole (GPIO_WritePORT, e.g. the LCD data port in LCD_BIT_MODE 8)
+ * must not hold a channel.
+ */
+
+/*
+ * Edges closer than this number of Timer2 ticks to the current count are written in the same interrupt
+ * instead of waiting for a compare match which would be missed (about the interrupt entry/exit time).
+ */
+#define SOFT_PWM_EDGE_MARGIN_TICKS                 12
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+typedef struct
+{
+	uint8 Port;
+	uint8 Pin;
+}SoftPWM_ChannelConfigType;
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the software PWM engine.
+ * 1. Setup the channel pins as output pins (low).
+ * 2. Start Timer2 in the Normal Mode with the overflow and compare match call backs.
+ */
+void SoftPWM_Init(const SoftPWM_ChannelConfigType *Channels_Ptr, uint8 Num_Of_Channels);
+
+/*
+ * Description:
+ * Set the duty cycle of one channel (0 = always low, 255 = always high), it is applied by SoftPWM_Commit.
+ */
+void SoftPWM_SetDuty(uint8 Channel, uint8 Duty);
+
+/*
+ * Description:
+ * Build the edge list of the new duty cycles and publish it, the interrupt starts using it at the
+ * beginning of the next period so the outputs never glitch.
+ * 1. Sort the channels by their duty cycle.
+ * 2. Merge the channels which fall at the same time on the same port into one edge (one port write).
+ * 3. Write the list into the back buffer and request the swap.
+ */
+void SoftPWM_Commit(void);
+
+#endif /* SOFT_PWM_H_ */
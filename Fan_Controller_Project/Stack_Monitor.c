@@ -0,0 +1,89 @@
+/*******************************************************************************************************************
+ * File Name: Stack_Monitor.c
+ * Date: 19/10/2026
+ * Driver: Stack Painting and RAM Usage Monitor Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include "Stack_Monitor.h"
+
+/***************************************************************************************
+ *                                     Linker Symbols                                  *
+ ***************************************************************************************/
+
+/* Provided by the avr-libc linker script and malloc */
+extern uint8 __data_start;
+extern uint8 _end;
+extern uint8 __heap_start;
+extern char *__brkval;
+
+/***************************************************************************************
+ *                                       Startup Code                                  *
+ ***************************************************************************************/
+
+#if defined(__AVR__)
+
+/*
+ * Paint the free RAM from the end of .bss (_end) up to the top of the stack (__stack = RAMEND).
+ * It runs in .init3, after the stack pointer is set by .init2 and before main is called, so nothing
+ * is using that RAM yet. The loop uses only registers because there is no C environment at this point.
+ */
+void StackMonitor_Paint(void) __attribute__((naked, used, section(".init3")));
+void StackMonitor_Paint(void)
+{
+	__asm__ __volatile__
+	(
+		"    ldi r30, lo8(_end)       \n"
+		"    ldi r31, hi8(_end)       \n"
+		"    ldi r24, %0              \n"
+		"    ldi r25, hi8(__stack)    \n"
+		"    rjmp 2f                  \n"
+		"1:  st Z+, r24               \n"
+		"2:  cpi r30, lo8(__stack)    \n"
+		"    cpc r31, r25             \n"
+		"    brlo 1b                  \n"
+		"    breq 1b                  \n"
+		:
+		: "i" (STACK_MONITOR_CANARY)
+	);
+}
+
+#endif
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Return the number of bytes above the heap which still hold the canary pattern, it is the worst
+ * case free RAM observed since reset.
+ */
+uint16 StackMonitor_GetUnusedRam(void)
+{
+	const uint8 *Ptr = (__brkval != 0) ? (const uint8 *)__brkval : &_end;
+	uint16 Count = 0;
+
+	while ((Ptr <= (const uint8 *)RAMEND) && (*Ptr == STACK_MONITOR_CANARY))
+	{
+		Ptr++;
+		Count++;
+	}
+
+	return Count;
+}
+
+/*
+ * Description:
+ * Fill the report with the static data, heap and stack usage of the RAM.
+ */
+void StackMonitor_GetReport(StackMonitor_ReportType *Report_Ptr)
+{
+	uint16 Heap_End = (__brkval != 0) ? (uint16)__brkval : (uint16)&_end;
+
+	Report_Ptr -> Ram_Size = (uint16)(RAMEND + 1 - (uint16)&__data_start);
+	Report_Ptr -> Data_Bss_Size = (uint16)&_end - (uint16)&__data_start;
+	Report_Ptr -> Heap_Size = (__brkval != 0) ? (uint16)(__brkval - (char *)&__heap_start) : 0;
+	Report_Ptr -> Free_Ram_Min = StackMonitor_GetUnusedRam();
+	Report_Ptr -> Stack_High_Water = (uint16)(RAMEND + 1 - Heap_End - Report_Ptr -> Free_Ram_Min);
+}
@@ -0,0 +1,52 @@
+/*******************************************************************************************************************
+ * File Name: Stack_Monitor.h
+ * Date: 19/10/2026
+ * Driver: Stack Painting and RAM Usage Monitor Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+
+#ifndef STACK_MONITOR_H_
+#define STACK_MONITOR_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/*
+ * The startup code fills the free RAM between the end of .bss and the top of the stack with this
+ * pattern, the bytes still holding it were never used by the stack or the heap.
+ */
+#define STACK_MONITOR_CANARY                       0xC5
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+typedef struct
+{
+	uint16 Ram_Size;             /* Total internal SRAM */
+	uint16 Data_Bss_Size;        /* Static data: .data + .bss */
+	uint16 Heap_Size;            /* Heap currently allocated by malloc */
+	uint16 Stack_High_Water;     /* Deepest stack usage since reset */
+	uint16 Free_Ram_Min;         /* Worst case free RAM observed between the heap and the stack */
+}StackMonitor_ReportType;
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Return the number of bytes above the heap which still hold the canary pattern, it is the worst
+ * case free RAM observed since reset.
+ */
+uint16 StackMonitor_GetUnusedRam(void);
+
+/*
+ * Description:
+ * Fill the report with the static data, heap and stack usage of the RAM.
+ */
+void StackMonitor_GetReport(StackMonitor_ReportType *Report_Ptr);
+
+#endif /* STACK_MONITOR_H_ */
@@ -0,0 +1,90 @@
+/*******************************************************************************************************************
+ * File Name: Sys_Time.c
+ * Date: 19/10/2026
+ * Driver: System Time Base Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Isr_Sync.h"
+#include "Sys_Time.h"
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+static uint32 g_tickPeriod_us = 0;
+
+/* Microseconds which are not yet a complete millisecond or a complete second */
+static volatile uint16 g_remainder_us = 0;
+static volatile uint16 g_remainder_ms = 0;
+
+ISR_SYNC_SNAPSHOT_DEFINE(SysTime_CounterSnapshot, uint32)
+
+/* Written by SysTime_Tick only, read without disabling the interrupts */
+static SysTime_CounterSnapshot_Type g_milliseconds;
+static SysTime_CounterSnapshot_Type g_seconds;
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialize the system time base.
+ * The tick period is the time between two calls of SysTime_Tick in microseconds
+ * (For example: the Timer0 overflow period given by Timer0_GetOverflowPeriod_us).
+ */
+void SysTime_Init(uint32 Tick_Period_us)
+{
+	uint8 Sreg = IsrSync_EnterCritical();
+
+	g_tickPeriod_us = Tick_Period_us;
+	g_remainder_us = 0;
+	g_remainder_ms = 0;
+	SysTime_CounterSnapshot_Store(&g_milliseconds, 0);
+	SysTime_CounterSnapshot_Store(&g_seconds, 0);
+	IsrSync_ExitCritical(Sreg);
+}
+
+/*
+ * Description:
+ * Advance the system time by one tick, it is called from the interrupt context (Timer0 Call Back).
+ */
+void SysTime_Tick(void)
+{
+	uint32 Elapsed_us = g_tickPeriod_us + g_remainder_us;
+	uint16 Elapsed_ms = (uint16)(Elapsed_us / 1000);
+
+	g_remainder_us = (uint16)(Elapsed_us - ((uint32)Elapsed_ms * 1000));
+
+	if (Elapsed_ms != 0)
+	{
+		SysTime_CounterSnapshot_Store(&g_milliseconds, g_milliseconds.Value + Elapsed_ms);
+		Elapsed_ms += g_remainder_ms;
+
+		while (Elapsed_ms >= 1000)
+		{
+			SysTime_CounterSnapshot_Store(&g_seconds, g_seconds.Value + 1);
+			Elapsed_ms -= 1000;
+		}
+
+		g_remainder_ms = Elapsed_ms;
+	}
+}
+
+/*
+ * Description:
+ * Return the number of milliseconds since startup (wraps after ~49 days).
+ */
+uint32 SysTime_GetMilliseconds(void)
+{
+	return SysTime_CounterSnapshot_Load(&g_milliseconds);
+}
+
+/*
+ * Description:
+ * Return the number of seconds since startup.
+ */
+uint32 SysTime_GetSeconds(void)
+{
+	return SysTime_CounterSnapshot_Load(&g_seconds);
+}
@@ -0,0 +1,42 @@
+/*******************************************************************************************************************
+ * File Name: Sys_Time.h
+ * Date: 19/10/2026
+ * Driver: System Time Base Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+
+#ifndef SYS_TIME_H_
+#define SYS_TIME_H_
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialize the system time base.
+ * The tick period is the time between two calls of SysTime_Tick in microseconds
+ * (For example: the Timer0 overflow period given by Timer0_GetOverflowPeriod_us).
+ */
+void SysTime_Init(uint32 Tick_Period_us);
+
+/*
+ * Description:
+ * Advance the system time by one tick, it is called from the interrupt context (Timer0 Call Back).
+ */
+void SysTime_Tick(void);
+
+/*
+ * Description:
+ * Return the number of milliseconds since startup (wraps after ~49 days).
+ */
+uint32 SysTime_GetMilliseconds(void);
+
+/*
+ * Description:
+ * Return the number of seconds since startup.
+ */
+uint32 SysTime_GetSeconds(void);
+
+#endif /* SYS_TIME_H_ */
@@ -5,8 +5,10 @@
  * Author: Youssef Zaki
  ******************************************************************************************************************/
 #include <avr/io.h>
+#include <avr/interrupt.h>
 #include "Common_Macros.h"
 #include "GPIO.h"
+#include "Isr_Sync.h"
 #include "TIMER0.h"
 
 /***************************************************************************************
@@ -14,7 +16,29 @@
  ***************************************************************************************/
 
 /* Global variables to hold the address of the call back function in the application */
-static volatile void (*g_CallBackPtr)(void) = NULL_PTR;
+static void (* volatile g_CallBackPtr)(void) = NULL_PTR;
+
+/***************************************************************************************
+ *                                  Interrupt Service Routines                         *
+ ***************************************************************************************/
+
+ISR(TIMER0_OVF_vect)
+{
+	if (g_CallBackPtr != NULL_PTR)
+	{
+		/* Call the Call Back function in the application after the timer overflow */
+		(*g_CallBackPtr)();
+	}
+}
+
+ISR(TIMER0_COMP_vect)
+{
+	if (g_CallBackPtr != NULL_PTR)
+	{
+		/* Call the Call Back function in the application after the compare match */
+		(*g_CallBackPtr)();
+	}
+}
 
 /****************************************************************************************
  *                                      Functions Definitions                           *
@@ -68,6 +92,7 @@ void Timer0_NonPWM_Mode_Init(const TIMER0_ConfigType* Config_Ptr)
  * 4. Setup the direction for OC0 as output pin through the GPIO driver.
  * 5. Configuration the PWM Mode (Phase Correct or Fast)
  * 6. Setup the PWM mode with Non-Inverting.
+ * 7. If a Call Back function is already set, enable the overflow interrupt to call it once every PWM period.
  */
 void Timer0_PWM_Mode_Init(const TIMER0_ConfigType* Config_Ptr)
 {
@@ -93,6 +118,11 @@ void Timer0_PWM_Mode_Init(const TIMER0_ConfigType* Config_Ptr)
 		 */
 		TCCR0 = (TCCR0 & 0x07) | (1 << WGM00) | (1<<WGM01) | (1<<COM01);
 	}
+
+	if (g_CallBackPtr != NULL_PTR)
+	{
+		SET_BIT(TIMSK, TOIE0);
+	}
 }
 
 /*
@@ -104,6 +134,52 @@ void TIMER0_PWM_Start(uint8 Duty_Cycle)
 	OCR0 = ((float)((Duty_Cycle)*255)/100);
 }
 
+/*
+ * Description:
+ * Set the OCR0 compare value directly (0 to 255).
+ */
+void Timer0_PWM_SetCompare(uint8 Compare_Value)
+{
+	OCR0 = Compare_Value;
+}
+
+/*
+ * Description:
+ * Return the time between two overflows of Timer0 in microseconds for the required configuration.
+ * Fast PWM and Normal modes count 256 steps, Phase Correct PWM mode counts 510 steps (up then down).
+ */
+uint32 Timer0_GetOverflowPeriod_us(const TIMER0_ConfigType* Config_Ptr)
+{
+	uint16 Prescaler_Division;
+	uint16 Counts;
+
+	switch (Config_Ptr -> Prescalar)
+	{
+	case Prescaler_1:
+		Prescaler_Division = 1;
+		break;
+	case Prescaler_8:
+		Prescaler_Division = 8;
+		break;
+	case Prescaler_64:
+		Prescaler_Division = 64;
+		break;
+	case Prescaler_256:
+		Prescaler_Division = 256;
+		break;
+	case Prescaler_1024:
+		Prescaler_Division = 1024;
+		break;
+	default:
+		/* No clock or external clock, the period is not known */
+		return 0;
+	}
+
+	Counts = (Config_Ptr -> Timer_Mode == PhaseCorrect_PWM_1) ? 510 : 256;
+
+	return (uint32)(((uint64)Prescaler_Division * Counts * 1000000UL) / F_CPU);
+}
+
 /*
  * Description:
  * De-initialization of Timer0 (Disable)
@@ -121,5 +197,9 @@ void Timer0_DeInit(void)
  */
 void Timer0_SetCallBack(void(*a_ptr)(void))
 {
+	/* The 16-bit address is read by the interrupts, it must not be seen half written */
+	uint8 Sreg = IsrSync_EnterCritical();
+
 	g_CallBackPtr = a_ptr;
+	IsrSync_ExitCritical(Sreg);
 }
@@ -64,6 +64,7 @@ void Timer0_NonPWM_Mode_Init(const TIMER0_ConfigType* Config_Ptr);
  * 4. Setup the direction for OC0 as output pin through the GPIO driver.
  * 5. Configuration the PWM Mode (Phase Correct or Fast)
  * 6. Setup the PWM mode with Non-Inverting.
+ * 7. If a Call Back function is already set, enable the overflow interrupt to call it once every PWM period.
  */
 void Timer0_PWM_Mode_Init(const TIMER0_ConfigType* Config_Ptr);
 
@@ -73,6 +74,19 @@ void Timer0_PWM_Mode_Init(const TIMER0_ConfigType* Config_Ptr);
  */
 void TIMER0_PWM_Start(uint8 Duty_Cycle);
 
+/*
+ * Description:
+ * Set the OCR0 compare value directly (0 to 255).
+ */
+void Timer0_PWM_SetCompare(uint8 Compare_Value);
+
+/*
+ * Description:
+ * Return the time between two overflows of Timer0 in microseconds for the required configuration.
+ * Fast PWM and Normal modes count 256 steps, Phase Correct PWM mode counts 510 steps (up then down).
+ */
+uint32 Timer0_GetOverflowPeriod_us(const TIMER0_ConfigType* Config_Ptr);
+
 /*
  * Description:
  * De-initialization of Timer0 (Disable)
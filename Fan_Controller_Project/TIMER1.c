@@ -0,0 +1,258 @@
+/*******************************************************************************************************************
+ * File Name: TIMER1.c
+ * Date: 19/10/2026
+ * Driver: ATmega32 Timer1 Driver Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "Common_Macros.h"
+#include "GPIO.h"
+#include "Isr_Sync.h"
+#include "TIMER1.h"
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+/* The value the counter wraps at in the current mode */
+static uint16 g_timer1Top = 0xFFFF;
+
+/* Global variable to hold the address of the compare B call back function in the application */
+static void (* volatile g_CompareBCallBackPtr)(void) = NULL_PTR;
+
+/***************************************************************************************
+ *                                  Interrupt Service Routines                         *
+ ***************************************************************************************/
+
+ISR(TIMER1_COMPB_vect)
+{
+	if (g_CompareBCallBackPtr != NULL_PTR)
+	{
+		(*g_CompareBCallBackPtr)();
+	}
+}
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of Timer1 as a free running 16-bit counter (Normal Mode, TOP = 0xFFFF).
+ * 1. Let the TCNT1 Register = 0.
+ * 2. Configure the TCCR1A and TCCR1B Registers for the Normal Mode with the OC1A/OC1B pins disconnected.
+ * 3. Enable CS12:0 bits according to the required pre-scalar.
+ * 4. No interrupts are enabled, the counter is only read by Timer1_GetCount.
+ */
+void Timer1_FreeRunning_Init(TIMER1_Clock_Select Prescalar)
+{
+	uint8 Sreg = IsrSync_EnterCritical();
+
+	TCNT1 = 0;
+	IsrSync_ExitCritical(Sreg);
+
+	/* Normal Mode: WGM13:0 = 0000, COM1A1:0 = 00, COM1B1:0 = 00 */
+	TCCR1A = 0;
+	TCCR1B = (Prescalar & 0x07);
+
+	g_timer1Top = 0xFFFF;
+}
+
+/*
+ * Description:
+ * Initialization of Timer1 in the Fast PWM Mode with TOP = ICR1 (Mode 14).
+ * 1. Let ICR1 = the TOP value, the PWM frequency = F_CPU / (N * (TOP + 1)) and the resolution is TOP + 1 steps.
+ * 2. Setup the direction of OC1A (PD5) and/or OC1B (PD4) as output pins through the GPIO driver.
+ * 3. Start with a duty cycle of zero (outputs disconnected and low).
+ * 4. Enable CS12:0 bits according to the required pre-scalar.
+ */
+void Timer1_PWM_Init(const TIMER1_PWM_ConfigType *Config_Ptr)
+{
+	uint8 Sreg;
+
+	if ((Config_Ptr -> Channels) & TIMER1_Channel_A)
+	{
+		GPIO_SetupPinDirection(PORTD_ID, PIN5_ID, OUTPUT_PIN);
+		GPIO_WritePin(PORTD_ID, PIN5_ID, LOGIC_LOW);
+	}
+	if ((Config_Ptr -> Channels) & TIMER1_Channel_B)
+	{
+		GPIO_SetupPinDirection(PORTD_ID, PIN4_ID, OUTPUT_PIN);
+		GPIO_WritePin(PORTD_ID, PIN4_ID, LOGIC_LOW);
+	}
+
+	/* Stop the timer while the 16-bit registers are written */
+	TCCR1B = 0;
+
+	Sreg = IsrSync_EnterCritical();
+	TCNT1 = 0;
+	ICR1 = Config_Ptr -> Top;
+	OCR1A = 0;
+	OCR1B = 0;
+	IsrSync_ExitCritical(Sreg);
+
+	g_timer1Top = Config_Ptr -> Top;
+
+	/*
+	 * Fast PWM Mode with TOP = ICR1: WGM13:0 = 1110
+	 * COM1A1:0 = COM1B1:0 = 00, the outputs are connected by Timer1_PWM_SetCompare (Non-Inverting)
+	 */
+	TCCR1A = (1 << WGM11);
+	TCCR1B = (1 << WGM13) | (1 << WGM12) | ((Config_Ptr -> Prescalar) & 0x07);
+}
+
+/*
+ * Description:
+ * Set the compare value of the required channel (0 to TOP).
+ * A compare value of zero disconnects the output and keeps it low, so there is no one tick spike at BOTTOM.
+ */
+void Timer1_PWM_SetCompare(TIMER1_PWM_Channel Channel, uint16 Compare_Value)
+{
+	uint8 Sreg;
+
+	if (Compare_Value > g_timer1Top)
+	{
+		Compare_Value = g_timer1Top;
+	}
+
+	Sreg = IsrSync_EnterCritical();
+
+	if (Channel == TIMER1_OC1A)
+	{
+		OCR1A = Compare_Value;
+
+		if (Compare_Value == 0)
+		{
+			/* Normal port operation, PD5 is already low */
+			TCCR1A &= ~((1 << COM1A1) | (1 << COM1A0));
+		}
+		else
+		{
+			/* Clear OC1A on compare match, set OC1A at BOTTOM (Non-Inverting) */
+			TCCR1A = (TCCR1A & ~(1 << COM1A0)) | (1 << COM1A1);
+		}
+	}
+	else
+	{
+		OCR1B = Compare_Value;
+
+		if (Compare_Value == 0)
+		{
+			/* Normal port operation, PD4 is already low */
+			TCCR1A &= ~((1 << COM1B1) | (1 << COM1B0));
+		}
+		else
+		{
+			/* Clear OC1B on compare match, set OC1B at BOTTOM (Non-Inverting) */
+			TCCR1A = (TCCR1A & ~(1 << COM1B0)) | (1 << COM1B1);
+		}
+	}
+
+	IsrSync_ExitCritical(Sreg);
+}
+
+/*
+ * Description:
+ * Return the current value of the TCNT1 Register.
+ * The 16-bit read is done with the interrupts disabled because the high byte goes through the
+ * TEMP Register which is shared by all the 16-bit registers of Timer1.
+ */
+uint16 Timer1_GetCount(void)
+{
+	uint16 Count;
+	uint8 Sreg = IsrSync_EnterCritical();
+
+	Count = TCNT1;
+	IsrSync_ExitCritical(Sreg);
+
+	return Count;
+}
+
+/*
+ * Description:
+ * Return the TOP value the counter wraps at.
+ */
+uint16 Timer1_GetTop(void)
+{
+	return g_timer1Top;
+}
+
+/*
+ * Description:
+ * Schedule the compare B interrupt Ticks counts from now (free running mode, 1 to 0xFFFF counts).
+ * OCR1B is free in the free running mode, so the profiler timestamps can share the counter.
+ */
+void Timer1_ScheduleCompareB(uint16 Ticks)
+{
+	uint8 Sreg = IsrSync_EnterCritical();
+
+	OCR1B = TCNT1 + Ticks;
+	TIFR = (1 << OCF1B);
+	TIMSK |= (1 << OCIE1B);
+	IsrSync_ExitCritical(Sreg);
+}
+
+/*
+ * Description:
+ * Schedule the next compare B interrupt Ticks counts after the last compare match, called from the compare B
+ * call back so a sequence of intervals does not add up the interrupt latencies. If that time is already past
+ * (the call back ran longer than Ticks), the interrupt is scheduled at the next counts instead.
+ */
+void Timer1_NextCompareB(uint16 Ticks)
+{
+	uint16 Match;
+	uint16 Now;
+	uint8 Sreg = IsrSync_EnterCritical();
+
+	Match = OCR1B + Ticks;
+	Now = TCNT1;
+
+	/* Past or too close to be caught: the compare unit only matches when the counter reaches OCR1B */
+	if (((uint16)(Match - Now) < TIMER1_COMPARE_MIN_AHEAD) || ((uint16)(Match - Now) > Ticks))
+	{
+		Match = Now + TIMER1_COMPARE_MIN_AHEAD;
+	}
+
+	OCR1B = Match;
+	IsrSync_ExitCritical(Sreg);
+}
+
+/*
+ * Description:
+ * Disable the compare B interrupt, a pending compare match is cleared.
+ */
+void Timer1_StopCompareB(void)
+{
+	uint8 Sreg = IsrSync_EnterCritical();
+
+	TIMSK &= ~(1 << OCIE1B);
+	TIFR = (1 << OCF1B);
+	IsrSync_ExitCritical(Sreg);
+}
+
+/*
+ * Description:
+ * Function to set the Call Back function address, called from the Timer1 compare B interrupt.
+ */
+void Timer1_SetCompareBCallBack(void(*a_ptr)(void))
+{
+	/* The 16-bit address is read by the interrupt */
+	uint8 Sreg = IsrSync_EnterCritical();
+
+	g_CompareBCallBackPtr = a_ptr;
+	IsrSync_ExitCritical(Sreg);
+}
+
+/*
+ * Description:
+ * De-initialization of Timer1 (Disable)
+ */
+void Timer1_DeInit(void)
+{
+	TCCR1A = 0;
+	TCCR1B = 0;
+	TCNT1 = 0;
+	TIMSK &= ~((1 << TICIE1) | (1 << OCIE1A) | (1 << OCIE1B) | (1 << TOIE1));
+	g_timer1Top = 0xFFFF;
+}
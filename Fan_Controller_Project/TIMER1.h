@@ -0,0 +1,137 @@
+/*******************************************************************************************************************
+ * File Name: TIMER1.h
+ * Date: 19/10/2026
+ * Driver: ATmega32 Timer1 Driver Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+
+#ifndef TIMER1_H_
+#define TIMER1_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/* TOP (ICR1) value which gives the required PWM frequency in the Fast PWM Mode, usable in #if too */
+#define TIMER1_PWM_TOP(Frequency_Hz, Prescaler_Division)   ((F_CPU / ((Prescaler_Division) * 1UL * (Frequency_Hz))) - 1)
+
+/*
+ * Counts between now and the earliest compare match Timer1_NextCompareB can still catch: OCR1B is written some
+ * cycles after TCNT1 is read, a match passed meanwhile would only come after the counter wraps (65ms at 1MHz)
+ */
+#define TIMER1_COMPARE_MIN_AHEAD                  16
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+typedef enum
+{
+	TIMER1_No_Clock,
+	TIMER1_Prescaler_1,
+	TIMER1_Prescaler_8,
+	TIMER1_Prescaler_64,
+	TIMER1_Prescaler_256,
+	TIMER1_Prescaler_1024,
+	TIMER1_External_Clock_Falling_Edge,
+	TIMER1_External_Clock_Rising_Edge
+}TIMER1_Clock_Select;
+
+typedef enum
+{
+	TIMER1_OC1A, TIMER1_OC1B
+}TIMER1_PWM_Channel;
+
+/* Channels enabled by Timer1_PWM_Init, OC1A is PD5 and OC1B is PD4 */
+typedef enum
+{
+	TIMER1_Channel_A = 1, TIMER1_Channel_B = 2, TIMER1_Channel_A_B = 3
+}TIMER1_PWM_ChannelsEnable;
+
+typedef struct
+{
+	uint16 Top;
+	TIMER1_Clock_Select Prescalar;
+	TIMER1_PWM_ChannelsEnable Channels;
+}TIMER1_PWM_ConfigType;
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of Timer1 as a free running 16-bit counter (Normal Mode, TOP = 0xFFFF).
+ * 1. Let the TCNT1 Register = 0.
+ * 2. Configure the TCCR1A and TCCR1B Registers for the Normal Mode with the OC1A/OC1B pins disconnected.
+ * 3. Enable CS12:0 bits according to the required pre-scalar.
+ * 4. No interrupts are enabled, the counter is only read by Timer1_GetCount.
+ */
+void Timer1_FreeRunning_Init(TIMER1_Clock_Select Prescalar);
+
+/*
+ * Description:
+ * Initialization of Timer1 in the Fast PWM Mode with TOP = ICR1 (Mode 14).
+ * 1. Let ICR1 = the TOP value, the PWM frequency = F_CPU / (N * (TOP + 1)) and the resolution is TOP + 1 steps.
+ * 2. Setup the direction of OC1A (PD5) and/or OC1B (PD4) as output pins through the GPIO driver.
+ * 3. Start with a duty cycle of zero (outputs disconnected and low).
+ * 4. Enable CS12:0 bits according to the required pre-scalar.
+ */
+void Timer1_PWM_Init(const TIMER1_PWM_ConfigType *Config_Ptr);
+
+/*
+ * Description:
+ * Set the compare value of the required channel (0 to TOP).
+ * A compare value of zero disconnects the output and keeps it low, so there is no one tick spike at BOTTOM.
+ */
+void Timer1_PWM_SetCompare(TIMER1_PWM_Channel Channel, uint16 Compare_Value);
+
+/*
+ * Description:
+ * Return the current value of the TCNT1 Register.
+ * The 16-bit read is done with the interrupts disabled because the high byte goes through the
+ * TEMP Register which is shared by all the 16-bit registers of Timer1.
+ */
+uint16 Timer1_GetCount(void);
+
+/*
+ * Description:
+ * Return the TOP value the counter wraps at.
+ */
+uint16 Timer1_GetTop(void);
+
+/*
+ * Description:
+ * Schedule the compare B interrupt Ticks counts from now (free running mode, 1 to 0xFFFF counts).
+ * OCR1B is free in the free running mode, so the profiler timestamps can share the counter.
+ */
+void Timer1_ScheduleCompareB(uint16 Ticks);
+
+/*
+ * Description:
+ * Schedule the next compare B interrupt Ticks counts after the last compare match, called from the compare B
+ * call back so a sequence of intervals does not add up the interrupt latencies. If that time is already past
+ * (the call back ran longer than Ticks), the interrupt is scheduled at the next counts instead.
+ */
+void Timer1_NextCompareB(uint16 Ticks);
+
+/*
+ * Description:
+ * Disable the compare B interrupt, a pending compare match is cleared.
+ */
+void Timer1_StopCompareB(void);
+
+/*
+ * Description:
+ * Function to set the Call Back function address, called from the Timer1 compare B interrupt.
+ */
+void Timer1_SetCompareBCallBack(void(*a_ptr)(void));
+
+/*
+ * Description:
+ * De-initialization of Timer1 (Disable)
+ */
+void Timer1_DeInit(void);
+
+#endif /* TIMER1_H_ */
@@ -0,0 +1,172 @@
+/*******************************************************************************************************************
+ * File Name: TIMER2.c
+ * Date: 19/10/2026
+ * Driver: ATmega32 Timer2 Driver Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "Common_Macros.h"
+#include "GPIO.h"
+#include "Isr_Sync.h"
+#include "TIMER2.h"
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+/* Global variables to hold the address of the call back functions in the application */
+static void (* volatile g_CallBackPtr)(void) = NULL_PTR;
+static void (* volatile g_CompareCallBackPtr)(void) = NULL_PTR;
+
+/***************************************************************************************
+ *                                  Interrupt Service Routines                         *
+ ***************************************************************************************/
+
+ISR(TIMER2_OVF_vect)
+{
+	if (g_CallBackPtr != NULL_PTR)
+	{
+		(*g_CallBackPtr)();
+	}
+}
+
+ISR(TIMER2_COMP_vect)
+{
+	if (g_CompareCallBackPtr != NULL_PTR)
+	{
+		(*g_CompareCallBackPtr)();
+	}
+}
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of Timer2 (Enable Timer2)
+ * 1. Let the TCNT2 Register = The Start value of the timer.
+ * 2. Enable CS22:0 bits according to the required pre-scalar
+ * 3. Configure the TCCR2 Register according to the Timer2 Mode (Normal or CTC).
+ * 4. Configure the TIMSK Register (Interrupt Mask) according to Timer2 Mode.
+ * 5. In CTC Mode Let OCR2 = the compare value (TOP Value)
+ */
+void Timer2_NonPWM_Mode_Init(const TIMER2_ConfigType* Config_Ptr)
+{
+	TCNT2 = Config_Ptr -> Initial_Value;
+
+	if (Config_Ptr -> Timer_Mode == Normal_0)
+	{
+		/* Configuration of Normal Mode: WGM21 = 0, WGM20 = 0, COM21 = 0, COM20 = 0 */
+		TCCR2 = (1 << FOC2) | ((Config_Ptr -> Prescalar) & 0x07);
+
+		SET_BIT(TIMSK, TOIE2);
+	}
+
+	else if (Config_Ptr -> Timer_Mode == CTC_2)
+	{
+		OCR2 = Config_Ptr -> Compare_Value;
+
+		/* Configuration of CTC Mode: WGM21 = 1, WGM20 = 0, COM21 = 0, COM20 = 0 */
+		TCCR2 = (1 << FOC2) | (1 << WGM21) | ((Config_Ptr -> Prescalar) & 0x07);
+
+		SET_BIT(TIMSK, OCIE2);
+	}
+}
+
+/*
+ * Description:
+ * The function responsible for trigger the Timer2 with the PWM Mode.
+ * 1. Let the TCNT2 Register = The Start value of the timer.
+ * 2. Setup the direction for OC2 (PD7) as output pin through the GPIO driver.
+ * 3. Configuration the PWM Mode (Phase Correct or Fast) with Non-Inverting output.
+ * 4. Enable CS22:0 bits according to the required pre-scalar.
+ */
+void Timer2_PWM_Mode_Init(const TIMER2_ConfigType* Config_Ptr)
+{
+	TCNT2 = Config_Ptr -> Initial_Value;
+	OCR2 = Config_Ptr -> Compare_Value;
+
+	GPIO_SetupPinDirection(PORTD_ID, PIN7_ID, OUTPUT_PIN);
+
+	if (Config_Ptr -> Timer_Mode == PhaseCorrect_PWM_1)
+	{
+		/* Phase Correct Mode (Non-Inverting): WGM21 = 0, WGM20 = 1, COM21 = 1, COM20 = 0 */
+		TCCR2 = (1 << WGM20) | (1 << COM21) | ((Config_Ptr -> Prescalar) & 0x07);
+	}
+
+	else if (Config_Ptr -> Timer_Mode == Fast_PWM_3)
+	{
+		/* Fast PWM Mode (Non-Inverting): WGM21 = 1, WGM20 = 1, COM21 = 1, COM20 = 0 */
+		TCCR2 = (1 << WGM20) | (1 << WGM21) | (1 << COM21) | ((Config_Ptr -> Prescalar) & 0x07);
+	}
+}
+
+/*
+ * Description:
+ * Set the OCR2 compare value directly (0 to 255).
+ */
+void Timer2_SetCompare(uint8 Compare_Value)
+{
+	OCR2 = Compare_Value;
+}
+
+/*
+ * Description:
+ * Restart the count of Timer2 from 0 and clear a pending compare match, the mode and the clock are kept
+ * (the prescaler is shared with Timer0/Timer1 and not reset, the first tick can come early by up to one tick).
+ */
+void Timer2_Restart(void)
+{
+	TCNT2 = 0;
+
+	/* Writing a one clears the flag, the other flags are not changed */
+	TIFR = (1 << OCF2);
+}
+
+/*
+ * Description:
+ * Return the current count of Timer2 (TCNT2).
+ */
+uint8 Timer2_GetCount(void)
+{
+	return TCNT2;
+}
+
+/*
+ * Description:
+ * De-initialization of Timer2 (Disable)
+ */
+void Timer2_DeInit(void)
+{
+	TCCR2 = 0;
+	TCNT2 = 0;
+	TIMSK &= ~((1 << OCIE2) | (1 << TOIE2));
+}
+
+/*
+ * Description:
+ * Function to set the Call Back function address, called from the Timer2 overflow interrupt.
+ */
+void Timer2_SetCallBack(void(*a_ptr)(void))
+{
+	/* The 16-bit address is read by the interrupt */
+	uint8 Sreg = IsrSync_EnterCritical();
+
+	g_CallBackPtr = a_ptr;
+	IsrSync_ExitCritical(Sreg);
+}
+
+/*
+ * Description:
+ * Function to set the Call Back function address, called from the Timer2 compare match interrupt.
+ */
+void Timer2_SetCompareCallBack(void(*a_ptr)(void))
+{
+	/* The 16-bit address is read by the interrupt */
+	uint8 Sreg = IsrSync_EnterCritical();
+
+	g_CompareCallBackPtr = a_ptr;
+	IsrSync_ExitCritical(Sreg);
+}
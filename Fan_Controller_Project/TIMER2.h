@@ -0,0 +1,101 @@
+/*******************************************************************************************************************
+ * File Name: TIMER2.h
+ * Date: 19/10/2026
+ * Driver: ATmega32 Timer2 Driver Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+#include "TIMER0.h"
+
+#ifndef TIMER2_H_
+#define TIMER2_H_
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+/* Timer2 has its own pre-scaler values (32 and 128) and no external clock input */
+typedef enum
+{
+	TIMER2_No_Clock,
+	TIMER2_Prescaler_1,
+	TIMER2_Prescaler_8,
+	TIMER2_Prescaler_32,
+	TIMER2_Prescaler_64,
+	TIMER2_Prescaler_128,
+	TIMER2_Prescaler_256,
+	TIMER2_Prescaler_1024
+}TIMER2_Clock_Select;
+
+/* The modes are the same as Timer0 (WaveFormGenerationMode) */
+typedef struct
+{
+	uint8 Initial_Value;
+	uint8 Compare_Value;
+	WaveFormGenerationMode Timer_Mode;
+	TIMER2_Clock_Select Prescalar;
+}TIMER2_ConfigType;
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of Timer2 (Enable Timer2)
+ * 1. Let the TCNT2 Register = The Start value of the timer.
+ * 2. Enable CS22:0 bits according to the required pre-scalar
+ * 3. Configure the TCCR2 Register according to the Timer2 Mode (Normal or CTC).
+ * 4. Configure the TIMSK Register (Interrupt Mask) according to Timer2 Mode.
+ * 5. In CTC Mode Let OCR2 = the compare value (TOP Value)
+ */
+void Timer2_NonPWM_Mode_Init(const TIMER2_ConfigType* Config_Ptr);
+
+/*
+ * Description:
+ * The function responsible for trigger the Timer2 with the PWM Mode.
+ * 1. Let the TCNT2 Register = The Start value of the timer.
+ * 2. Setup the direction for OC2 (PD7) as output pin through the GPIO driver.
+ * 3. Configuration the PWM Mode (Phase Correct or Fast) with Non-Inverting output.
+ * 4. Enable CS22:0 bits according to the required pre-scalar.
+ */
+void Timer2_PWM_Mode_Init(const TIMER2_ConfigType* Config_Ptr);
+
+/*
+ * Description:
+ * Set the OCR2 compare value directly (0 to 255).
+ */
+void Timer2_SetCompare(uint8 Compare_Value);
+
+/*
+ * Description:
+ * Restart the count of Timer2 from 0 and clear a pending compare match, the mode and the clock are kept
+ * (the prescaler is shared with Timer0/Timer1 and not reset, the first tick can come early by up to one tick).
+ */
+void Timer2_Restart(void);
+
+/*
+ * Description:
+ * Return the current count of Timer2 (TCNT2).
+ */
+uint8 Timer2_GetCount(void);
+
+/*
+ * Description:
+ * De-initialization of Timer2 (Disable)
+ */
+void Timer2_DeInit(void);
+
+/*
+ * Description:
+ * Function to set the Call Back function address, called from the Timer2 overflow interrupt.
+ */
+void Timer2_SetCallBack(void(*a_ptr)(void));
+
+/*
+ * Description:
+ * Function to set the Call Back function address, called from the Timer2 compare match interrupt.
+ */
+void Timer2_SetCompareCallBack(void(*a_ptr)(void));
+
+#endif /* TIMER2_H_ */
@@ -0,0 +1,161 @@
+/*******************************************************************************************************************
+ * File Name: TMP102.c
+ * Date: 19/10/2026
+ * Driver: TMP102 Digital Temperature Sensor Driver (TWI, Non-Blocking) Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Common_Macros.h"
+#include "TWI.h"
+#include "Sys_Time.h"
+#include "TMP102.h"
+
+/*******************************************************************************
+ *                              Types Declaration                              *
+ *******************************************************************************/
+
+typedef enum
+{
+	TMP102_IDLE, TMP102_START, TMP102_WAIT, TMP102_CHECK, TMP102_FETCH, TMP102_READY, TMP102_ERROR
+}TMP102_StateType;
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+static const uint8 g_startCommand[] = {TMP102_CONFIG_REGISTER, TMP102_CONFIG_ONE_SHOT, TMP102_CONFIG_LOW_BYTE};
+static const uint8 g_configPointer[] = {TMP102_CONFIG_REGISTER};
+static const uint8 g_temperaturePointer[] = {TMP102_TEMPERATURE_REGISTER};
+
+/* Register read by the last transfer, most significant byte first */
+static uint8 g_register[2];
+
+static TMP102_StateType g_state = TMP102_IDLE;
+static uint32 g_convertStart_ms = 0;
+
+/* The TMP102 behind the sensor interface (Temp_Sensor.h) */
+const TempSensor_DriverType g_TMP102Sensor =
+{
+	TMP102_StartConversion, TMP102_PollConversion, TMP102_ReadConversion
+};
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the TMP102 driver and of the TWI (TWI_Init).
+ */
+void TMP102_Init(void)
+{
+	TWI_Init();
+	g_state = TMP102_IDLE;
+}
+
+/*
+ * Description:
+ * Sensor interface: start a one-shot conversion. Return FALSE if the TWI is busy.
+ */
+boolean TMP102_StartConversion(void)
+{
+	if (!TWI_StartTransfer(TMP102_ADDRESS, g_startCommand, sizeof(g_startCommand), NULL_PTR, 0))
+	{
+		return FALSE;
+	}
+
+	g_state = TMP102_START;
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Sensor interface: move the conversion on (check of the OS bit once the conversion time is elapsed, then
+ * read of the temperature register) and return its state, never waits.
+ */
+TempSensor_StatusType TMP102_PollConversion(void)
+{
+	TWI_StatusType Bus = TWI_GetStatus();
+	uint32 Elapsed_ms;
+
+	switch (g_state)
+	{
+	case TMP102_START:
+	case TMP102_CHECK:
+	case TMP102_FETCH:
+		if (Bus == TWI_BUSY)
+		{
+			return TEMP_SENSOR_BUSY;
+		}
+		if (Bus != TWI_DONE)
+		{
+			g_state = TMP102_ERROR;
+			return TEMP_SENSOR_ERROR;
+		}
+		break;
+
+	case TMP102_WAIT:
+		break;
+
+	case TMP102_READY:
+		return TEMP_SENSOR_READY;
+
+	default:
+		return TEMP_SENSOR_ERROR;
+	}
+
+	/* The transfer of the state is over (or the conversion time is running) */
+	Elapsed_ms = SysTime_GetMilliseconds() - g_convertStart_ms;
+
+	switch (g_state)
+	{
+	case TMP102_START:
+		g_convertStart_ms = SysTime_GetMilliseconds();
+		g_state = TMP102_WAIT;
+		break;
+
+	case TMP102_WAIT:
+		/* The stop condition of the last transfer may still be on the bus, tried again next time */
+		if ((Elapsed_ms >= TMP102_CONVERSION_MS) &&
+				TWI_StartTransfer(TMP102_ADDRESS, g_configPointer, sizeof(g_configPointer), g_register, sizeof(g_register)))
+		{
+			g_state = TMP102_CHECK;
+		}
+		break;
+
+	case TMP102_CHECK:
+		if (BIT_IS_SET(g_register[0], TMP102_CONFIG_OS_BIT))
+		{
+			if (TWI_StartTransfer(TMP102_ADDRESS, g_temperaturePointer, sizeof(g_temperaturePointer), g_register, sizeof(g_register)))
+			{
+				g_state = TMP102_FETCH;
+			}
+		}
+		else if (Elapsed_ms >= TMP102_TIMEOUT_MS)
+		{
+			g_state = TMP102_ERROR;
+			return TEMP_SENSOR_ERROR;
+		}
+		else
+		{
+			/* Still converting, check again at the next poll */
+			g_state = TMP102_WAIT;
+		}
+		break;
+
+	default:
+		g_state = TMP102_READY;
+		return TEMP_SENSOR_READY;
+	}
+
+	return TEMP_SENSOR_BUSY;
+}
+
+/*
+ * Description:
+ * Sensor interface: return the temperature of the finished conversion in 1/16 degree.
+ */
+sint16 TMP102_ReadConversion(void)
+{
+	/* 12-bit two's complement left aligned in the 16-bit register */
+	return (sint16)(((uint16)g_register[0] << 8) | g_register[1]) >> 4;
+}
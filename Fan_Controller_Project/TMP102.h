@@ -0,0 +1,85 @@
+/*******************************************************************************************************************
+ * File Name: TMP102.h
+ * Date: 19/10/2026
+ * Driver: TMP102 Digital Temperature Sensor Driver (TWI, Non-Blocking) Header File
+ * Author: Youssef Zaki
+ *
+ * The sensor stays in the shutdown mode and makes one-shot conversions: the start writes the configuration
+ * with OS = 1 and SD = 1, the OS bit reads 1 again once the conversion is finished (26ms typical), then the
+ * temperature register is read (12 bits, 0.0625C). Every step is an interrupt driven TWI transfer (TWI.h)
+ * started by TMP102_PollConversion from the main loop when the previous one is over.
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+#include "Temp_Sensor.h"
+#include "LCD.h"
+
+#ifndef TMP102_H_
+#define TMP102_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/* 7-bit address of the sensor (ADD0 pin to ground) */
+#define TMP102_ADDRESS                             0x48
+
+/* Registers (pointer register values) */
+#define TMP102_TEMPERATURE_REGISTER                0x00
+#define TMP102_CONFIG_REGISTER                     0x01
+
+/* Configuration: one-shot (OS) and shutdown (SD), R1:R0 read only at 11, 12-bit format (EM = 0), 4Hz */
+#define TMP102_CONFIG_ONE_SHOT                     0xE1
+#define TMP102_CONFIG_LOW_BYTE                     0xA0
+#define TMP102_CONFIG_OS_BIT                       7
+
+/* Wait before the first check of the OS bit, and the longest conversion before an error */
+#define TMP102_CONVERSION_MS                       30
+#define TMP102_TIMEOUT_MS                          100
+
+/*
+ * The 4-bit LCD data pins are PA3..PA6: the LM35 (ADC0, ADC1) and the current shunt (ADC7, Current_Sense.h which
+ * rejects a shunt pin among them) keep their ADC pins.
+ */
+#if ((TEMP_SENSOR_SOURCE == TEMP_SENSOR_SOURCE_TMP102) && (LCD_BIT_MODE == 8))
+
+#error "The TWI pins PC0 and PC1 are LCD data pins in LCD_BIT_MODE 8, use LCD_BIT_MODE 4 with the TMP102"
+
+#endif
+
+/******************************************************************************************
+ *                                    External Variables                                  *
+ ******************************************************************************************/
+
+/* The TMP102 behind the sensor interface (Temp_Sensor.h) */
+extern const TempSensor_DriverType g_TMP102Sensor;
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the TMP102 driver and of the TWI (TWI_Init).
+ */
+void TMP102_Init(void);
+
+/*
+ * Description:
+ * Sensor interface: start a one-shot conversion. Return FALSE if the TWI is busy.
+ */
+boolean TMP102_StartConversion(void);
+
+/*
+ * Description:
+ * Sensor interface: move the conversion on (check of the OS bit once the conversion time is elapsed, then
+ * read of the temperature register) and return its state, never waits.
+ */
+TempSensor_StatusType TMP102_PollConversion(void);
+
+/*
+ * Description:
+ * Sensor interface: return the temperature of the finished conversion in 1/16 degree.
+ */
+sint16 TMP102_ReadConversion(void);
+
+#endif /* TMP102_H_ */
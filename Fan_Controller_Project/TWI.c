@@ -0,0 +1,175 @@
+/*******************************************************************************************************************
+ * File Name: TWI.c
+ * Date: 19/10/2026
+ * Driver: ATmega32 TWI (I2C) Master Driver, Interrupt Driven, Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "Common_Macros.h"
+#include "TWI.h"
+
+/*******************************************************************************
+ *                              Macros Definitions                             *
+ *******************************************************************************/
+
+/* Status codes of the master modes (TWSR with the prescaler bits masked) */
+#define TWI_STATUS_MASK                            0xF8
+#define TWI_START                                  0x08
+#define TWI_REPEATED_START                         0x10
+#define TWI_MT_SLA_ACK                             0x18
+#define TWI_MT_SLA_NACK                            0x20
+#define TWI_MT_DATA_ACK                            0x28
+#define TWI_MT_DATA_NACK                           0x30
+#define TWI_ARBITRATION_LOST                       0x38
+#define TWI_MR_SLA_ACK                             0x40
+#define TWI_MR_SLA_NACK                            0x48
+#define TWI_MR_DATA_ACK                            0x50
+#define TWI_MR_DATA_NACK                           0x58
+
+/* TWCR values: next step with the interrupt enabled, and the stop condition (the TWI goes idle) */
+#define TWI_CONTINUE                               ((1 << TWINT) | (1 << TWEN) | (1 << TWIE))
+#define TWI_STOP                                   ((1 << TWINT) | (1 << TWEN) | (1 << TWSTO))
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+static volatile TWI_StatusType g_status = TWI_IDLE;
+
+/* Transfer in progress, owned by the TWI interrupt while g_status is TWI_BUSY */
+static uint8 g_address = 0;
+static const uint8 *g_writePtr = NULL_PTR;
+static uint8 *g_readPtr = NULL_PTR;
+static uint8 g_writeLength = 0;
+static uint8 g_readLength = 0;
+static uint8 g_index = 0;
+
+/***************************************************************************************
+ *                                  Interrupt Service Routines                         *
+ ***************************************************************************************/
+
+ISR(TWI_vect)
+{
+	switch (TWSR & TWI_STATUS_MASK)
+	{
+	case TWI_START:
+	case TWI_REPEATED_START:
+		/* The write part first, the read part after the repeated start (SLA+W alone if nothing is read) */
+		if ((g_index < g_writeLength) || (g_readLength == 0))
+		{
+			TWDR = (uint8)(g_address << 1);
+		}
+		else
+		{
+			g_index = 0;
+			TWDR = (uint8)((g_address << 1) | 1);
+		}
+		TWCR = TWI_CONTINUE;
+		break;
+
+	case TWI_MT_SLA_ACK:
+	case TWI_MT_DATA_ACK:
+		if (g_index < g_writeLength)
+		{
+			TWDR = g_writePtr[g_index];
+			g_index++;
+			TWCR = TWI_CONTINUE;
+		}
+		else if (g_readLength != 0)
+		{
+			TWCR = TWI_CONTINUE | (1 << TWSTA);
+		}
+		else
+		{
+			TWCR = TWI_STOP;
+			g_status = TWI_DONE;
+		}
+		break;
+
+	case TWI_MR_SLA_ACK:
+		/* Acknowledge every byte but the last one */
+		TWCR = TWI_CONTINUE | ((g_readLength > 1) ? (1 << TWEA) : 0);
+		break;
+
+	case TWI_MR_DATA_ACK:
+		g_readPtr[g_index] = TWDR;
+		g_index++;
+		TWCR = TWI_CONTINUE | ((g_index < (g_readLength - 1)) ? (1 << TWEA) : 0);
+		break;
+
+	case TWI_MR_DATA_NACK:
+		g_readPtr[g_index] = TWDR;
+		TWCR = TWI_STOP;
+		g_status = TWI_DONE;
+		break;
+
+	case TWI_ARBITRATION_LOST:
+		/* Another master has the bus, release it without a stop condition */
+		TWCR = (1 << TWINT) | (1 << TWEN);
+		g_status = TWI_ERROR;
+		break;
+
+	default:
+		/* Address or data not acknowledged, or bus error */
+		TWCR = TWI_STOP;
+		g_status = TWI_ERROR;
+		break;
+	}
+}
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the TWI as a master.
+ * 1. Set the bit rate (TWBR = TWI_BIT_RATE_REGISTER, prescaler 1).
+ * 2. Enable the TWI, its interrupt is enabled by each transfer.
+ */
+void TWI_Init(void)
+{
+	TWBR = (uint8)TWI_BIT_RATE_REGISTER;
+	TWSR = 0;
+	TWCR = (1 << TWEN);
+	g_status = TWI_IDLE;
+}
+
+/*
+ * Description:
+ * Start a transfer with the 7-bit address: Write_Length bytes of Write_Ptr, then (repeated start) Read_Length
+ * bytes into Read_Ptr; either length may be 0. The buffers are used by the interrupt until the end of the
+ * transfer. Return FALSE if a transfer or its stop condition is still in progress.
+ */
+boolean TWI_StartTransfer(uint8 Address, const uint8 *Write_Ptr, uint8 Write_Length, uint8 *Read_Ptr, uint8 Read_Length)
+{
+	/* TWSTO is cleared by the hardware once the stop condition of the last transfer is on the bus */
+	if ((g_status == TWI_BUSY) || BIT_IS_SET(TWCR, TWSTO))
+	{
+		return FALSE;
+	}
+
+	g_address = Address;
+	g_writePtr = Write_Ptr;
+	g_writeLength = Write_Length;
+	g_readPtr = Read_Ptr;
+	g_readLength = Read_Length;
+	g_index = 0;
+	g_status = TWI_BUSY;
+
+	/* Start condition, the interrupt does the rest */
+	TWCR = TWI_CONTINUE | (1 << TWSTA);
+
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Return the state of the last transfer: TWI_BUSY while it runs, then TWI_DONE, or TWI_ERROR if the device
+ * did not acknowledge its address or a written byte, or the bus was lost (arbitration, bus error).
+ */
+TWI_StatusType TWI_GetStatus(void)
+{
+	return g_status;
+}
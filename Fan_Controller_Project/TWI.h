@@ -0,0 +1,67 @@
+/*******************************************************************************************************************
+ * File Name: TWI.h
+ * Date: 19/10/2026
+ * Driver: ATmega32 TWI (I2C) Master Driver, Interrupt Driven, Header File
+ * Author: Youssef Zaki
+ *
+ * A transfer (start, address and write, repeated start, address and read, stop) is run by the TWI interrupt
+ * from the status codes of TWSR, one byte per interrupt, so the main loop only starts it and checks its state.
+ * SCL is PC0 and SDA is PC1, with external pull-ups: the LCD data port must not be PORTC (LCD_BIT_MODE 4).
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+
+#ifndef TWI_H_
+#define TWI_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/* SCL frequency, with the TWI prescaler at 1: SCL = F_CPU / (16 + 2 * TWBR) */
+#define TWI_BIT_RATE_HZ                            25000UL
+#define TWI_BIT_RATE_REGISTER                      ((F_CPU / TWI_BIT_RATE_HZ - 16) / 2)
+
+/* The master needs TWBR of 10 at least for a stable SCL */
+#if ((TWI_BIT_RATE_REGISTER < 10) || (TWI_BIT_RATE_REGISTER > 255))
+
+#error "TWI_BIT_RATE_HZ gives a TWBR out of 10 to 255 at F_CPU, change it"
+
+#endif
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+typedef enum
+{
+	TWI_IDLE, TWI_BUSY, TWI_DONE, TWI_ERROR
+}TWI_StatusType;
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the TWI as a master.
+ * 1. Set the bit rate (TWBR = TWI_BIT_RATE_REGISTER, prescaler 1).
+ * 2. Enable the TWI, its interrupt is enabled by each transfer.
+ */
+void TWI_Init(void);
+
+/*
+ * Description:
+ * Start a transfer with the 7-bit address: Write_Length bytes of Write_Ptr, then (repeated start) Read_Length
+ * bytes into Read_Ptr; either length may be 0. The buffers are used by the interrupt until the end of the
+ * transfer. Return FALSE if a transfer or its stop condition is still in progress.
+ */
+boolean TWI_StartTransfer(uint8 Address, const uint8 *Write_Ptr, uint8 Write_Length, uint8 *Read_Ptr, uint8 Read_Length);
+
+/*
+ * Description:
+ * Return the state of the last transfer: TWI_BUSY while it runs, then TWI_DONE, or TWI_ERROR if the device
+ * did not acknowledge its address or a written byte, or the bus was lost (arbitration, bus error).
+ */
+TWI_StatusType TWI_GetStatus(void);
+
+#endif /* TWI_H_ */
@@ -0,0 +1,334 @@
+/*******************************************************************************************************************
+ * File Name: Temp_History.c
+ * Date: 19/10/2026
+ * Driver: Temperature History Log (Wear-Leveled EEPROM Ring) Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "CRC.h"
+#include "EEPROM.h"
+#include "Sys_Time.h"
+#include "Temp_History.h"
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+/* Records waiting for the next batch write */
+static TempHistory_RecordType g_pendingRecords[TEMP_HISTORY_BATCH_SIZE];
+static uint8 g_pendingCount = 0;
+static boolean g_flushRequested = FALSE;
+
+/* Records which are being written by the EEPROM driver, must not change till the write is completed */
+static TempHistory_RecordType g_flushRecords[TEMP_HISTORY_BATCH_SIZE];
+
+/* Head of the ring: the slot and the sequence number of the next record */
+static uint8 g_headSlot = 0;
+static uint16 g_nextSequence = 0;
+
+/* Summary of the current period */
+static uint32 g_periodIndex = 0;
+static uint8 g_minimum = 0xFF;
+static uint8 g_maximum = 0;
+static uint32 g_sum = 0;
+static uint32 g_count = 0;
+static uint8 g_overTemperatureEvents = 0;
+
+/* Over temperature event tracking */
+static uint8 g_overTemperatureLimit = 0xFF;
+static boolean g_eventActive = FALSE;
+static uint8 g_eventPeak = 0;
+static uint32 g_eventStart = 0;
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+static uint16 TempHistory_SlotAddress(uint8 Slot)
+{
+	return TEMP_HISTORY_EEPROM_START + ((uint16)Slot * TEMP_HISTORY_RECORD_SIZE);
+}
+
+/*
+ * Description:
+ * Read one slot of the ring and return TRUE if it holds a valid record.
+ */
+static boolean TempHistory_ReadSlot(uint8 Slot, TempHistory_RecordType *Record_Ptr)
+{
+	EEPROM_ReadBlock(TempHistory_SlotAddress(Slot), (uint8 *)Record_Ptr, sizeof(TempHistory_RecordType));
+
+	return TempHistory_IsRecordValid(Record_Ptr);
+}
+
+/*
+ * Description:
+ * Return TRUE if the slot belongs to the newest lap of the ring, it holds the record number Slot
+ * counted from the record found in slot 0.
+ */
+static boolean TempHistory_IsNewestLap(uint8 Slot, uint16 First_Sequence)
+{
+	TempHistory_RecordType Record;
+
+	return (TempHistory_ReadSlot(Slot, &Record) && ((uint16)(Record.Sequence - First_Sequence) == Slot)) ? TRUE : FALSE;
+}
+
+/*
+ * Description:
+ * Queue a new record for the next batch write.
+ */
+static void TempHistory_AddRecord(uint8 Type, uint8 Data0, uint8 Data1, uint8 Data2, uint8 Data3)
+{
+	TempHistory_RecordType *Record_Ptr;
+
+	if (g_pendingCount >= TEMP_HISTORY_BATCH_SIZE)
+	{
+		/* The EEPROM could not keep up, the record is lost */
+		return;
+	}
+
+	Record_Ptr = &g_pendingRecords[g_pendingCount];
+	Record_Ptr -> Sequence = g_nextSequence;
+	Record_Ptr -> Type = Type;
+	Record_Ptr -> Data[0] = Data0;
+	Record_Ptr -> Data[1] = Data1;
+	Record_Ptr -> Data[2] = Data2;
+	Record_Ptr -> Data[3] = Data3;
+	Record_Ptr -> Crc = CRC8_MAXIM_Calculate((const uint8 *)Record_Ptr, sizeof(TempHistory_RecordType) - 1);
+
+	g_nextSequence++;
+	g_pendingCount++;
+
+	if (g_pendingCount == TEMP_HISTORY_BATCH_SIZE)
+	{
+		g_flushRequested = TRUE;
+	}
+}
+
+/*
+ * Description:
+ * Start a new summary period.
+ */
+static void TempHistory_StartPeriod(uint32 Period_Index)
+{
+	g_periodIndex = Period_Index;
+	g_minimum = 0xFF;
+	g_maximum = 0;
+	g_sum = 0;
+	g_count = 0;
+	g_overTemperatureEvents = 0;
+}
+
+/*
+ * Description:
+ * Write the queued records which fit before the end of the ring, the rest are written by the next call.
+ */
+static void TempHistory_StartBatchWrite(void)
+{
+	uint8 Count;
+	uint8 i;
+
+	if (EEPROM_IsBusy())
+	{
+		return;
+	}
+
+	Count = g_pendingCount;
+
+	if (Count > (TEMP_HISTORY_NUM_OF_SLOTS - g_headSlot))
+	{
+		Count = TEMP_HISTORY_NUM_OF_SLOTS - g_headSlot;
+	}
+
+	for (i = 0; i < Count; i++)
+	{
+		g_flushRecords[i] = g_pendingRecords[i];
+	}
+
+	if (!EEPROM_WriteBlock(TempHistory_SlotAddress(g_headSlot), (const uint8 *)g_flushRecords, (uint16)Count * sizeof(TempHistory_RecordType)))
+	{
+		return;
+	}
+
+	/* Remove the written records from the queue */
+	for (i = Count; i < g_pendingCount; i++)
+	{
+		g_pendingRecords[i - Count] = g_pendingRecords[i];
+	}
+	g_pendingCount -= Count;
+
+	g_headSlot += Count;
+	if (g_headSlot >= TEMP_HISTORY_NUM_OF_SLOTS)
+	{
+		g_headSlot = 0;
+	}
+
+	if (g_pendingCount == 0)
+	{
+		g_flushRequested = FALSE;
+	}
+}
+
+/*
+ * Description:
+ * Initialize the history log (called once at startup).
+ * 1. Find the head of the ring by a binary search over the sequence numbers of the stored records.
+ * 2. Start a new summary period.
+ * 3. The over temperature limit is the temperature which starts an over temperature event.
+ */
+void TempHistory_Init(uint8 OverTemperature_Limit)
+{
+	TempHistory_RecordType Record;
+	uint16 First_Sequence;
+	uint8 Low;
+	uint8 High;
+	uint8 Middle;
+
+	g_overTemperatureLimit = OverTemperature_Limit;
+	g_pendingCount = 0;
+	g_flushRequested = FALSE;
+	g_eventActive = FALSE;
+
+	if (TempHistory_ReadSlot(0, &Record))
+	{
+		/*
+		 * Slots [0, Head) hold the records of the newest lap with consecutive sequence numbers,
+		 * slots [Head, NUM_OF_SLOTS) are erased or hold the older lap, so the head is the first slot
+		 * which breaks the sequence and it can be found with a binary search.
+		 */
+		First_Sequence = Record.Sequence;
+		Low = 1;
+		High = TEMP_HISTORY_NUM_OF_SLOTS;
+
+		while (Low < High)
+		{
+			Middle = Low + ((High - Low) / 2);
+
+			if (TempHistory_IsNewestLap(Middle, First_Sequence))
+			{
+				Low = Middle + 1;
+			}
+			else
+			{
+				High = Middle;
+			}
+		}
+
+		g_headSlot = (Low >= TEMP_HISTORY_NUM_OF_SLOTS) ? 0 : Low;
+		g_nextSequence = First_Sequence + Low;
+	}
+	else if (TempHistory_ReadSlot(TEMP_HISTORY_NUM_OF_SLOTS - 1, &Record))
+	{
+		/* The write of slot 0 was interrupted after the ring wrapped around, continue after the last slot */
+		g_headSlot = 0;
+		g_nextSequence = Record.Sequence + 1;
+	}
+	else
+	{
+		/* Empty ring */
+		g_headSlot = 0;
+		g_nextSequence = 0;
+	}
+
+	TempHistory_StartPeriod(SysTime_GetSeconds() / TEMP_HISTORY_PERIOD_SECONDS);
+}
+
+/*
+ * Description:
+ * Feed a new temperature sample to the summary of the current period.
+ */
+void TempHistory_AddSample(uint8 Temperature)
+{
+	uint32 Now = SysTime_GetSeconds();
+	uint32 Duration_Minutes;
+
+	if (Temperature < g_minimum)
+	{
+		g_minimum = Temperature;
+	}
+	if (Temperature > g_maximum)
+	{
+		g_maximum = Temperature;
+	}
+	g_sum += Temperature;
+	g_count++;
+
+	if (!g_eventActive)
+	{
+		if (Temperature >= g_overTemperatureLimit)
+		{
+			g_eventActive = TRUE;
+			g_eventPeak = Temperature;
+			g_eventStart = Now;
+			g_overTemperatureEvents++;
+		}
+	}
+	else if (Temperature > g_eventPeak)
+	{
+		g_eventPeak = Temperature;
+	}
+	else if ((uint16)Temperature + TEMP_HISTORY_EVENT_HYSTERESIS <= g_overTemperatureLimit)
+	{
+		g_eventActive = FALSE;
+
+		Duration_Minutes = (Now - g_eventStart) / 60;
+		if (Duration_Minutes > 0xFF)
+		{
+			Duration_Minutes = 0xFF;
+		}
+
+		TempHistory_AddRecord(TEMP_HISTORY_RECORD_OVER_TEMPERATURE, g_eventPeak, (uint8)Duration_Minutes,
+				(uint8)((g_eventStart % TEMP_HISTORY_PERIOD_SECONDS) / 60), 0);
+	}
+}
+
+/*
+ * Description:
+ * Periodic task called from the main loop.
+ * 1. Close the summary period when it is elapsed and queue its record.
+ * 2. Write the queued records to the EEPROM when a complete batch is ready (non-blocking).
+ */
+void TempHistory_Task(void)
+{
+	uint32 Period_Index = SysTime_GetSeconds() / TEMP_HISTORY_PERIOD_SECONDS;
+
+	if (Period_Index != g_periodIndex)
+	{
+		if (g_count != 0)
+		{
+			TempHistory_AddRecord(TEMP_HISTORY_RECORD_HOURLY, g_minimum, g_maximum, (uint8)(g_sum / g_count),
+					g_overTemperatureEvents);
+		}
+
+		TempHistory_StartPeriod(Period_Index);
+	}
+
+	if (g_flushRequested && (g_pendingCount != 0))
+	{
+		TempHistory_StartBatchWrite();
+	}
+}
+
+/*
+ * Description:
+ * Request writing the queued records to the EEPROM even if the batch is not complete.
+ */
+void TempHistory_Flush(void)
+{
+	if (g_pendingCount != 0)
+	{
+		g_flushRequested = TRUE;
+	}
+}
+
+/*
+ * Description:
+ * Return TRUE if the record has a known type and a correct CRC.
+ */
+boolean TempHistory_IsRecordValid(const TempHistory_RecordType *Record_Ptr)
+{
+	if ((Record_Ptr -> Type != TEMP_HISTORY_RECORD_HOURLY) && (Record_Ptr -> Type != TEMP_HISTORY_RECORD_OVER_TEMPERATURE))
+	{
+		return FALSE;
+	}
+
+	return (CRC8_MAXIM_Calculate((const uint8 *)Record_Ptr, sizeof(TempHistory_RecordType) - 1) == Record_Ptr -> Crc) ? TRUE : FALSE;
+}
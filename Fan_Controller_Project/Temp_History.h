@@ -0,0 +1,96 @@
+/*******************************************************************************************************************
+ * File Name: Temp_History.h
+ * Date: 19/10/2026
+ * Driver: Temperature History Log (Wear-Leveled EEPROM Ring) Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+
+#ifndef TEMP_HISTORY_H_
+#define TEMP_HISTORY_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/*
+ * The history ring uses the EEPROM after the configuration block (0x0000 - 0x003F) till the end.
+ * Every record is written to the next slot of the ring, so each slot is programmed only once every
+ * TEMP_HISTORY_NUM_OF_SLOTS records: with one record per hour that is once every 5 days, far below
+ * the ~100k write endurance of the EEPROM cells.
+ */
+#define TEMP_HISTORY_EEPROM_START                  0x0040
+#define TEMP_HISTORY_EEPROM_END                    1024
+#define TEMP_HISTORY_RECORD_SIZE                   8
+#define TEMP_HISTORY_NUM_OF_SLOTS                  ((TEMP_HISTORY_EEPROM_END - TEMP_HISTORY_EEPROM_START) / TEMP_HISTORY_RECORD_SIZE)
+
+/* Records are accumulated in RAM and written to the EEPROM in batches of this size */
+#define TEMP_HISTORY_BATCH_SIZE                    4
+
+/* Length of one summary period in seconds */
+#define TEMP_HISTORY_PERIOD_SECONDS                3600UL
+
+/* The over temperature event ends when the temperature falls this amount below the limit */
+#define TEMP_HISTORY_EVENT_HYSTERESIS              2
+
+/* Record Types */
+#define TEMP_HISTORY_RECORD_HOURLY                 0x01
+#define TEMP_HISTORY_RECORD_OVER_TEMPERATURE       0x02
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+/*
+ * One record of the ring exactly as it is stored in the EEPROM.
+ * Hourly record:           Data = {Minimum, Maximum, Mean, Number of over temperature events}
+ * Over temperature record: Data = {Peak, Duration in minutes, Start minute in the hour, Reserved}
+ */
+typedef struct
+{
+	uint16 Sequence;
+	uint8 Type;
+	uint8 Data[4];
+	uint8 Crc;
+}TempHistory_RecordType;
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialize the history log (called once at startup).
+ * 1. Find the head of the ring by a binary search over the sequence numbers of the stored records.
+ * 2. Start a new summary period.
+ * 3. The over temperature limit is the temperature which starts an over temperature event.
+ */
+void TempHistory_Init(uint8 OverTemperature_Limit);
+
+/*
+ * Description:
+ * Feed a new temperature sample to the summary of the current period.
+ */
+void TempHistory_AddSample(uint8 Temperature);
+
+/*
+ * Description:
+ * Periodic task called from the main loop.
+ * 1. Close the summary period when it is elapsed and queue its record.
+ * 2. Write the queued records to the EEPROM when a complete batch is ready (non-blocking).
+ */
+void TempHistory_Task(void);
+
+/*
+ * Description:
+ * Request writing the queued records to the EEPROM even if the batch is not complete.
+ */
+void TempHistory_Flush(void);
+
+/*
+ * Description:
+ * Return TRUE if the record has a known type and a correct CRC.
+ */
+boolean TempHistory_IsRecordValid(const TempHistory_RecordType *Record_Ptr);
+
+#endif /* TEMP_HISTORY_H_ */
@@ -0,0 +1,262 @@
+/*******************************************************************************************************************
+ * File Name: Temp_Monitor.c
+ * Date: 19/10/2026
+ * Driver: Event Driven Temperature Monitor (Band and Value Changes in the ADC Interrupt) Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include <util/atomic.h>
+#include "ADC.h"
+#include "LM35.h"
+#include "Sample_Rate.h"
+#include "Fan_Safety.h"
+#include "Temp_Monitor.h"
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+/* First ADC code of each threshold of the fan curve */
+static uint16 g_bandCodes[FAN_CURVE_NUM_OF_THRESHOLDS];
+
+/* Codes of the displayed temperature, empty at startup so the first sample posts an event */
+static volatile uint16 g_displayLow = 1;
+static volatile uint16 g_displayHigh = 0;
+
+/* Latest sample and its level, the level is invalid at startup so the first sample posts an event */
+static volatile uint16 g_code = 0;
+static volatile uint8 g_level = 0xFF;
+
+static volatile uint8 g_events = 0;
+
+/****************************************************************************************
+ *                                      Interrupt Call Backs                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Check a new sample (raw code of the LM35 scale) against the displayed temperature and the fan curve levels
+ * and post the events, only compares raw codes.
+ */
+static void TempMonitor_CheckCode(uint16 Code)
+{
+	uint8 Level = 0;
+
+	g_code = Code;
+
+	if ((Code < g_displayLow) || (Code > g_displayHigh))
+	{
+		g_events |= TEMP_MONITOR_EVENT_VALUE;
+	}
+
+	while ((Level < FAN_CURVE_NUM_OF_THRESHOLDS) && (Code >= g_bandCodes[Level]))
+	{
+		Level++;
+	}
+
+	if (Level != g_level)
+	{
+		g_level = Level;
+		g_events |= TEMP_MONITOR_EVENT_BAND;
+	}
+}
+
+#if (TEMP_SENSOR_SOURCE == TEMP_SENSOR_SOURCE_LM35)
+
+/*
+ * Description:
+ * Called from the ADC interrupt for every new (averaged) result: only compares raw codes.
+ */
+static void TempMonitor_SampleReady(void)
+{
+	uint16 Code = ADC_GetResult(LM35_ADC_SLOT);
+
+	TempMonitor_CheckCode(Code);
+
+	/* The slope of the results sets the rate of the next ones */
+	SampleRate_Update(Code);
+}
+
+#endif
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the temperature monitor (after LM35_StartSynchronizedSampling).
+ * 1. Convert the thresholds of the fan curve to raw ADC codes once, so the interrupt only compares codes.
+ * 2. Register the ADC call back which checks every new result (LM35 source, the digital sensors give their
+ *    results to TempMonitor_PostTemperature).
+ * 3. The first result always posts both events.
+ * 4. Start the adaptive sampling rate (Sample_Rate.c) at the fastest rate, every result updates it (LM35 source).
+ */
+void TempMonitor_Init(const FanCurve_Type *Curve_Ptr)
+{
+	TempMonitor_SetCurve(Curve_Ptr);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_displayLow = 1;
+		g_displayHigh = 0;
+		g_level = 0xFF;
+		g_events = 0;
+	}
+
+#if (TEMP_SENSOR_SOURCE == TEMP_SENSOR_SOURCE_LM35)
+	SampleRate_Init();
+	ADC_SetCallBack(LM35_ADC_SLOT, TempMonitor_SampleReady);
+#endif
+}
+
+/*
+ * Description:
+ * Give a result of a digital sensor (TempSensor_Task call back, 1/16 degree) to the monitor: it is converted
+ * to the code of the same whole degree on the LM35 scale and checked as an ADC result, and by the over
+ * temperature check of Fan_Safety.c. TEMP_SENSOR_INVALID is taken as MAX_LM35_TEMPERATURE, so a lost sensor
+ * latches the over temperature fault (full speed).
+ */
+void TempMonitor_PostTemperature(sint16 Temperature)
+{
+	sint16 Degrees = (Temperature == TEMP_SENSOR_INVALID) ? MAX_LM35_TEMPERATURE : (Temperature >> TEMP_SENSOR_FRACTION_BITS);
+	uint16 Code;
+
+	if (Degrees < 0)
+	{
+		Degrees = 0;
+	}
+	else if (Degrees > MAX_LM35_TEMPERATURE)
+	{
+		Degrees = MAX_LM35_TEMPERATURE;
+	}
+	Code = LM35_TemperatureToCode((uint8)Degrees);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		TempMonitor_CheckCode(Code);
+	}
+
+	FanSafety_CheckCode(Code);
+}
+
+/*
+ * Description:
+ * Convert the thresholds of the fan curve to raw ADC codes again (after the curve is changed), and post
+ * TEMP_MONITOR_EVENT_BAND so the speeds of the new curve are applied.
+ */
+void TempMonitor_SetCurve(const FanCurve_Type *Curve_Ptr)
+{
+	uint16 Codes[FAN_CURVE_NUM_OF_THRESHOLDS];
+	uint8 Level;
+
+	for (Level = 0; Level < FAN_CURVE_NUM_OF_THRESHOLDS; Level++)
+	{
+		Codes[Level] = LM35_TemperatureToCode(Curve_Ptr -> Thresholds[Level]);
+	}
+
+	/*
+	 * The level is checked again with the new codes by the next sample, the band event makes the main loop
+	 * apply the speeds of the new curve at once (none before the first sample, it posts the event anyway)
+	 */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		for (Level = 0; Level < FAN_CURVE_NUM_OF_THRESHOLDS; Level++)
+		{
+			g_bandCodes[Level] = Codes[Level];
+		}
+
+		if (g_level != 0xFF)
+		{
+			g_events |= TEMP_MONITOR_EVENT_BAND;
+		}
+	}
+}
+
+/*
+ * Description:
+ * Return the events posted since the last call and clear them.
+ */
+uint8 TempMonitor_GetEvents(void)
+{
+	uint8 Events;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		Events = g_events;
+		g_events = 0;
+	}
+
+	return Events;
+}
+
+/*
+ * Description:
+ * Return TRUE if events are posted, without clearing them (can be called with the interrupts disabled).
+ */
+boolean TempMonitor_HasEvents(void)
+{
+	return (g_events != 0) ? TRUE : FALSE;
+}
+
+/*
+ * Description:
+ * Return the temperature of the latest sample and make it the displayed value, then the interrupt
+ * posts TEMP_MONITOR_EVENT_VALUE only when a sample falls outside the codes of this temperature.
+ */
+uint8 TempMonitor_GetTemperature(void)
+{
+	uint16 Code;
+	uint16 Low;
+	uint16 High;
+	uint8 Temperature;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		Code = g_code;
+	}
+
+	/* The unit conversion is only done here, when the value changed */
+	Temperature = LM35_ConvertToTemperature(Code);
+	Low = LM35_TemperatureToCode(Temperature);
+	High = (Temperature == 0xFF) ? ADC_MAX_VALUE : (LM35_TemperatureToCode(Temperature + 1) - 1);
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		g_displayLow = Low;
+		g_displayHigh = High;
+
+		/* A sample of another temperature may have arrived during the conversion */
+		if ((g_code < Low) || (g_code > High))
+		{
+			g_events |= TEMP_MONITOR_EVENT_VALUE;
+		}
+	}
+
+	return Temperature;
+}
+
+/*
+ * Description:
+ * Return the temperature of the latest sample without changing the displayed value (for the readers other
+ * than the display, e.g. Modbus_Slave.c).
+ */
+uint8 TempMonitor_GetLatestTemperature(void)
+{
+	uint16 Code;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		Code = g_code;
+	}
+
+	return LM35_ConvertToTemperature(Code);
+}
+
+/*
+ * Description:
+ * Return the level of the fan curve of the latest sample (index of FanCurve_Type Speeds).
+ */
+uint8 TempMonitor_GetLevel(void)
+{
+	return g_level;
+}
@@ -0,0 +1,85 @@
+/*******************************************************************************************************************
+ * File Name: Temp_Monitor.h
+ * Date: 19/10/2026
+ * Driver: Event Driven Temperature Monitor (Band and Value Changes in the ADC Interrupt) Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+#include "Fan_Curve.h"
+#include "Temp_Sensor.h"
+
+#ifndef TEMP_MONITOR_H_
+#define TEMP_MONITOR_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/* Events posted by the ADC interrupt, returned by TempMonitor_GetEvents */
+#define TEMP_MONITOR_EVENT_VALUE                   0x01    /* The displayed temperature changed */
+#define TEMP_MONITOR_EVENT_BAND                    0x02    /* The level of the fan curve changed */
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the temperature monitor (after LM35_StartSynchronizedSampling).
+ * 1. Convert the thresholds of the fan curve to raw ADC codes once, so the interrupt only compares codes.
+ * 2. Register the ADC call back which checks every new result (LM35 source, the digital sensors give their
+ *    results to TempMonitor_PostTemperature).
+ * 3. The first result always posts both events.
+ * 4. Start the adaptive sampling rate (Sample_Rate.c) at the fastest rate, every result updates it (LM35 source).
+ */
+void TempMonitor_Init(const FanCurve_Type *Curve_Ptr);
+
+/*
+ * Description:
+ * Give a result of a digital sensor (TempSensor_Task call back, 1/16 degree) to the monitor: it is converted
+ * to the code of the same whole degree on the LM35 scale and checked as an ADC result, and by the over
+ * temperature check of Fan_Safety.c. TEMP_SENSOR_INVALID is taken as MAX_LM35_TEMPERATURE, so a lost sensor
+ * latches the over temperature fault (full speed).
+ */
+void TempMonitor_PostTemperature(sint16 Temperature);
+
+/*
+ * Description:
+ * Convert the thresholds of the fan curve to raw ADC codes again (after the curve is changed), and post
+ * TEMP_MONITOR_EVENT_BAND so the speeds of the new curve are applied.
+ */
+void TempMonitor_SetCurve(const FanCurve_Type *Curve_Ptr);
+
+/*
+ * Description:
+ * Return the events posted since the last call and clear them.
+ */
+uint8 TempMonitor_GetEvents(void);
+
+/*
+ * Description:
+ * Return TRUE if events are posted, without clearing them (can be called with the interrupts disabled).
+ */
+boolean TempMonitor_HasEvents(void);
+
+/*
+ * Description:
+ * Return the temperature of the latest sample and make it the displayed value, then the interrupt
+ * posts TEMP_MONITOR_EVENT_VALUE only when a sample falls outside the codes of this temperature.
+ */
+uint8 TempMonitor_GetTemperature(void);
+
+/*
+ * Description:
+ * Return the temperature of the latest sample without changing the displayed value (for the readers other
+ * than the display, e.g. Modbus_Slave.c).
+ */
+uint8 TempMonitor_GetLatestTemperature(void);
+
+/*
+ * Description:
+ * Return the level of the fan curve of the latest sample (index of FanCurve_Type Speeds).
+ */
+uint8 TempMonitor_GetLevel(void);
+
+#endif /* TEMP_MONITOR_H_ */
@@ -0,0 +1,159 @@
+/*******************************************************************************************************************
+ * File Name: Temp_Sensor.c
+ * Date: 19/10/2026
+ * Driver: Temperature Sensor Interface (Start Conversion / Poll Ready / Read Result) Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Temp_Sensor.h"
+
+#if (TEMP_SENSOR_SOURCE == TEMP_SENSOR_SOURCE_DS18B20)
+
+#include "DS18B20.h"
+
+#define TEMP_SENSOR_DRIVER                         (&g_DS18B20Sensor)
+#define TEMP_SENSOR_DRIVER_INIT()                  DS18B20_Init()
+
+#elif (TEMP_SENSOR_SOURCE == TEMP_SENSOR_SOURCE_TMP102)
+
+#include "TMP102.h"
+
+#define TEMP_SENSOR_DRIVER                         (&g_TMP102Sensor)
+#define TEMP_SENSOR_DRIVER_INIT()                  TMP102_Init()
+
+#endif
+
+#if (TEMP_SENSOR_SOURCE != TEMP_SENSOR_SOURCE_LM35)
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+/* Global variable to hold the address of the result call back function in the application */
+static void (*g_ResultCallBackPtr)(sint16 Temperature) = NULL_PTR;
+
+/* TRUE while a conversion is in progress, FALSE while waiting for the next period */
+static boolean g_converting = FALSE;
+
+/* TRUE when the next conversion is started at once (first one, or retry of a failed one) */
+static boolean g_startNow = TRUE;
+
+static uint32 g_lastStart_ms = 0;
+static uint8 g_failuresInRow = 0;
+static uint16 g_failureCount = 0;
+
+#endif
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Start a conversion of the sensor, poll it until it is finished and return its result in 1/16 degree,
+ * or TEMP_SENSOR_INVALID (blocking, for the sensors whose conversion is short such as the LM35).
+ */
+sint16 TempSensor_Measure(const TempSensor_DriverType *Sensor_Ptr)
+{
+	TempSensor_StatusType Status;
+
+	if (!(*(Sensor_Ptr -> Start))())
+	{
+		return TEMP_SENSOR_INVALID;
+	}
+
+	do
+	{
+		Status = (*(Sensor_Ptr -> Poll))();
+	} while (Status == TEMP_SENSOR_BUSY);
+
+	return (Status == TEMP_SENSOR_READY) ? (*(Sensor_Ptr -> Read))() : TEMP_SENSOR_INVALID;
+}
+
+#if (TEMP_SENSOR_SOURCE != TEMP_SENSOR_SOURCE_LM35)
+
+/*
+ * Description:
+ * Initialization of the digital sensor of TEMP_SENSOR_SOURCE and of its bus. The first conversion is started
+ * by the first TempSensor_Task, every result is given to the call back (from the main loop).
+ */
+void TempSensor_Init(void (*Result_Ptr)(sint16 Temperature))
+{
+	g_ResultCallBackPtr = Result_Ptr;
+	g_converting = FALSE;
+	g_startNow = TRUE;
+	g_failuresInRow = 0;
+	g_failureCount = 0;
+
+	TEMP_SENSOR_DRIVER_INIT();
+}
+
+/*
+ * Description:
+ * Periodic task called from the main loop: start a conversion every TEMP_SENSOR_PERIOD_MS, poll the one in
+ * progress and give its result to the call back when it is finished (never waits for the sensor).
+ */
+void TempSensor_Task(uint32 Now_ms)
+{
+	TempSensor_StatusType Status;
+	sint16 Temperature;
+
+	if (!g_converting)
+	{
+		if (!g_startNow && ((uint32)(Now_ms - g_lastStart_ms) < TEMP_SENSOR_PERIOD_MS))
+		{
+			return;
+		}
+
+		/* A busy bus is tried again at the next turn of the main loop */
+		if ((*(TEMP_SENSOR_DRIVER -> Start))())
+		{
+			g_converting = TRUE;
+			g_startNow = FALSE;
+			g_lastStart_ms = Now_ms;
+		}
+		return;
+	}
+
+	Status = (*(TEMP_SENSOR_DRIVER -> Poll))();
+	if (Status == TEMP_SENSOR_BUSY)
+	{
+		return;
+	}
+	g_converting = FALSE;
+
+	if (Status == TEMP_SENSOR_READY)
+	{
+		g_failuresInRow = 0;
+		Temperature = (*(TEMP_SENSOR_DRIVER -> Read))();
+	}
+	else
+	{
+		g_failureCount++;
+		g_failuresInRow++;
+
+		/* A single failure (e.g. a corrupted bit) is retried at once, the last result stays valid meanwhile */
+		if (g_failuresInRow < TEMP_SENSOR_MAX_FAILURES)
+		{
+			g_startNow = TRUE;
+			return;
+		}
+		g_failuresInRow = TEMP_SENSOR_MAX_FAILURES;
+		Temperature = TEMP_SENSOR_INVALID;
+	}
+
+	if (g_ResultCallBackPtr != NULL_PTR)
+	{
+		(*g_ResultCallBackPtr)(Temperature);
+	}
+}
+
+/*
+ * Description:
+ * Return the number of failed conversions since startup.
+ */
+uint16 TempSensor_GetFailureCount(void)
+{
+	return g_failureCount;
+}
+
+#endif
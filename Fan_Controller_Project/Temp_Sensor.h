@@ -0,0 +1,114 @@
+/*******************************************************************************************************************
+ * File Name: Temp_Sensor.h
+ * Date: 19/10/2026
+ * Driver: Temperature Sensor Interface (Start Conversion / Poll Ready / Read Result) Header File
+ * Author: Youssef Zaki
+ *
+ * Every sensor driver gives the same three functions (TempSensor_DriverType), none of them waits for a slow
+ * conversion (the LM35 one is a single ADC conversion of 104us, run by its Start):
+ *     Start  start a conversion (FALSE if the sensor cannot start one now, e.g. its bus is busy),
+ *     Poll   return the progress of the conversion, the driver moves its own bus transfers on from here,
+ *     Read   return the result of the finished conversion in 1/16 degree (TEMP_SENSOR_FRACTION_BITS).
+ * Drivers: LM35 (g_LM35Sensor, ADC), DS18B20 (g_DS18B20Sensor, 1-Wire timed by Timer1) and TMP102
+ * (g_TMP102Sensor, interrupt driven TWI).
+ * TEMP_SENSOR_SOURCE selects the sensor of the fan control. With the LM35 the results keep coming from the ADC
+ * interrupt (Temp_Monitor.c, Fan_Safety.c) and TempSensor_Init/TempSensor_Task are compiled out. With a digital
+ * sensor TempSensor_Task, called from the main loop, starts a conversion every TEMP_SENSOR_PERIOD_MS and gives
+ * each result to the call back (TempMonitor_PostTemperature), so the 750ms conversion of the DS18B20 never
+ * blocks the control loop.
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+
+#ifndef TEMP_SENSOR_H_
+#define TEMP_SENSOR_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+#define TEMP_SENSOR_SOURCE_LM35                    0
+#define TEMP_SENSOR_SOURCE_DS18B20                 1
+#define TEMP_SENSOR_SOURCE_TMP102                  2
+
+/* Sensor of the fan control (the build can give it) */
+#ifndef TEMP_SENSOR_SOURCE
+#define TEMP_SENSOR_SOURCE                         TEMP_SENSOR_SOURCE_LM35
+#endif
+
+/* Results are in 1/16 degree, the resolution of the DS18B20 and of the TMP102 */
+#define TEMP_SENSOR_FRACTION_BITS                  4
+
+/* Result given to the call back when the sensor does not answer or its data is corrupted */
+#define TEMP_SENSOR_INVALID                        ((sint16)0x8000)
+
+/* Time between the starts of two conversions of a digital sensor */
+#define TEMP_SENSOR_PERIOD_MS                      1000
+
+/* Consecutive failed conversions before TEMP_SENSOR_INVALID is given, a single failure is only retried */
+#define TEMP_SENSOR_MAX_FAILURES                   3
+
+#if ((TEMP_SENSOR_SOURCE != TEMP_SENSOR_SOURCE_LM35) && (TEMP_SENSOR_SOURCE != TEMP_SENSOR_SOURCE_DS18B20) && \
+		(TEMP_SENSOR_SOURCE != TEMP_SENSOR_SOURCE_TMP102))
+
+#error "TEMP_SENSOR_SOURCE should be TEMP_SENSOR_SOURCE_LM35, TEMP_SENSOR_SOURCE_DS18B20 or TEMP_SENSOR_SOURCE_TMP102"
+
+#endif
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+typedef enum
+{
+	TEMP_SENSOR_BUSY, TEMP_SENSOR_READY, TEMP_SENSOR_ERROR
+}TempSensor_StatusType;
+
+typedef struct
+{
+	boolean (*Start)(void);
+	TempSensor_StatusType (*Poll)(void);
+	sint16 (*Read)(void);
+}TempSensor_DriverType;
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Start a conversion of the sensor, poll it until it is finished and return its result in 1/16 degree,
+ * or TEMP_SENSOR_INVALID (blocking, for the sensors whose conversion is short such as the LM35).
+ */
+sint16 TempSensor_Measure(const TempSensor_DriverType *Sensor_Ptr);
+
+#if (TEMP_SENSOR_SOURCE != TEMP_SENSOR_SOURCE_LM35)
+
+/*
+ * Description:
+ * Initialization of the digital sensor of TEMP_SENSOR_SOURCE and of its bus. The first conversion is started
+ * by the first TempSensor_Task, every result is given to the call back (from the main loop).
+ */
+void TempSensor_Init(void (*Result_Ptr)(sint16 Temperature));
+
+/*
+ * Description:
+ * Periodic task called from the main loop: start a conversion every TEMP_SENSOR_PERIOD_MS, poll the one in
+ * progress and give its result to the call back when it is finished (never waits for the sensor).
+ */
+void TempSensor_Task(uint32 Now_ms);
+
+/*
+ * Description:
+ * Return the number of failed conversions since startup.
+ */
+uint16 TempSensor_GetFailureCount(void);
+
+#else
+
+#define TempSensor_Init(Result_Ptr)
+#define TempSensor_Task(Now_ms)
+#define TempSensor_GetFailureCount()               0
+
+#endif
+
+#endif /* TEMP_SENSOR_H_ */
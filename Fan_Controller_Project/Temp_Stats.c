@@ -0,0 +1,299 @@
+/*******************************************************************************************************************
+ * File Name: Temp_Stats.c
+ * Date: 19/10/2026
+ * Driver: Sliding Window Temperature Statistics (Minimum, Maximum and Mean over 1, 10 and 60 Minutes) Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Temp_Stats.h"
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+/* Summary of a group of samples: a complete bucket of a ring or the bucket being filled */
+typedef struct
+{
+	uint8 Minimum;
+	uint8 Maximum;
+	uint8 Count;
+	uint32 Sum;
+}TempStats_BucketType;
+
+/*
+ * Ring of the complete buckets of a window in g_buckets[First .. First + Num_Of_Buckets - 1], and its two
+ * monotonic deques in the same range of g_minQueue/g_maxQueue: the bucket indexes with an increasing minimum
+ * (decreasing maximum) from the oldest to the newest, the front holds the minimum (maximum) of the ring.
+ */
+typedef struct
+{
+	uint8 First;
+	uint8 Num_Of_Buckets;
+	uint8 Next;
+	uint8 Filled;
+	uint8 Min_Head;
+	uint8 Min_Count;
+	uint8 Max_Head;
+	uint8 Max_Count;
+	uint32 Sum;
+	TempStats_BucketType Partial;
+}TempStats_WindowType;
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+static TempStats_BucketType g_buckets[TEMP_STATS_TOTAL_BUCKETS];
+static uint8 g_minQueue[TEMP_STATS_TOTAL_BUCKETS];
+static uint8 g_maxQueue[TEMP_STATS_TOTAL_BUCKETS];
+
+static TempStats_WindowType g_windows[TEMP_STATS_NUM_OF_WINDOWS];
+
+/* Number of buckets of each window */
+static const uint8 g_numOfBuckets[TEMP_STATS_NUM_OF_WINDOWS] =
+{
+	TEMP_STATS_BUCKETS_1_MIN, TEMP_STATS_BUCKETS_10_MIN, TEMP_STATS_BUCKETS_60_MIN
+};
+
+/* Number of samples in a bucket of each window */
+static const uint16 g_bucketSamples[TEMP_STATS_NUM_OF_WINDOWS] =
+{
+	TEMP_STATS_SAMPLES_PER_BUCKET,
+	TEMP_STATS_SAMPLES_PER_BUCKET * TEMP_STATS_BUCKETS_1_MIN,
+	TEMP_STATS_SAMPLES_PER_BUCKET * TEMP_STATS_BUCKETS_1_MIN * TEMP_STATS_BUCKETS_10_MIN
+};
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Empty a bucket: the minimum and the maximum start from the opposite limits, so the first merge sets both.
+ */
+static void TempStats_ResetBucket(TempStats_BucketType *Bucket_Ptr)
+{
+	Bucket_Ptr -> Minimum = 0xFF;
+	Bucket_Ptr -> Maximum = 0;
+	Bucket_Ptr -> Count = 0;
+	Bucket_Ptr -> Sum = 0;
+}
+
+/*
+ * Description:
+ * Add a bucket (or a single sample with Count = 1) to the bucket being filled.
+ */
+static void TempStats_Merge(TempStats_BucketType *Partial_Ptr, uint8 Minimum, uint8 Maximum, uint32 Sum)
+{
+	if (Minimum < Partial_Ptr -> Minimum)
+	{
+		Partial_Ptr -> Minimum = Minimum;
+	}
+	if (Maximum > Partial_Ptr -> Maximum)
+	{
+		Partial_Ptr -> Maximum = Maximum;
+	}
+	Partial_Ptr -> Sum += Sum;
+	Partial_Ptr -> Count++;
+}
+
+/*
+ * Description:
+ * Push the bucket being filled of a window to its ring, over the oldest bucket when the ring is full.
+ * 1. The index of the oldest bucket can only be at the front of the deques, it is removed from them.
+ * 2. The indexes of the buckets which can never be the minimum (maximum) again are removed from the back,
+ *    every index is pushed and removed once so the cost is O(1) amortized.
+ */
+static void TempStats_PushBucket(TempStats_WindowType *Window_Ptr)
+{
+	uint8 Index = Window_Ptr -> Next;
+	uint8 Size = Window_Ptr -> Num_Of_Buckets;
+	TempStats_BucketType *Buckets = &g_buckets[Window_Ptr -> First];
+	uint8 *Min_Queue = &g_minQueue[Window_Ptr -> First];
+	uint8 *Max_Queue = &g_maxQueue[Window_Ptr -> First];
+	uint8 Back;
+
+	if (Window_Ptr -> Filled == Size)
+	{
+		Window_Ptr -> Sum -= Buckets[Index].Sum;
+
+		if ((Window_Ptr -> Min_Count != 0) && (Min_Queue[Window_Ptr -> Min_Head] == Index))
+		{
+			Window_Ptr -> Min_Head = (Window_Ptr -> Min_Head + 1 == Size) ? 0 : (Window_Ptr -> Min_Head + 1);
+			Window_Ptr -> Min_Count--;
+		}
+		if ((Window_Ptr -> Max_Count != 0) && (Max_Queue[Window_Ptr -> Max_Head] == Index))
+		{
+			Window_Ptr -> Max_Head = (Window_Ptr -> Max_Head + 1 == Size) ? 0 : (Window_Ptr -> Max_Head + 1);
+			Window_Ptr -> Max_Count--;
+		}
+	}
+	else
+	{
+		Window_Ptr -> Filled++;
+	}
+
+	Buckets[Index] = Window_Ptr -> Partial;
+	Window_Ptr -> Sum += Window_Ptr -> Partial.Sum;
+
+	while (Window_Ptr -> Min_Count != 0)
+	{
+		Back = Window_Ptr -> Min_Head + Window_Ptr -> Min_Count - 1;
+		Back = (Back >= Size) ? (Back - Size) : Back;
+
+		if (Buckets[Min_Queue[Back]].Minimum < Buckets[Index].Minimum)
+		{
+			break;
+		}
+		Window_Ptr -> Min_Count--;
+	}
+	Back = Window_Ptr -> Min_Head + Window_Ptr -> Min_Count;
+	Min_Queue[(Back >= Size) ? (Back - Size) : Back] = Index;
+	Window_Ptr -> Min_Count++;
+
+	while (Window_Ptr -> Max_Count != 0)
+	{
+		Back = Window_Ptr -> Max_Head + Window_Ptr -> Max_Count - 1;
+		Back = (Back >= Size) ? (Back - Size) : Back;
+
+		if (Buckets[Max_Queue[Back]].Maximum > Buckets[Index].Maximum)
+		{
+			break;
+		}
+		Window_Ptr -> Max_Count--;
+	}
+	Back = Window_Ptr -> Max_Head + Window_Ptr -> Max_Count;
+	Max_Queue[(Back >= Size) ? (Back - Size) : Back] = Index;
+	Window_Ptr -> Max_Count++;
+
+	Window_Ptr -> Next = (Index + 1 == Size) ? 0 : (Index + 1);
+}
+
+/*
+ * Description:
+ * Empty all the windows (called once at startup).
+ */
+void TempStats_Init(void)
+{
+	uint8 First = 0;
+	uint8 Window;
+
+	for (Window = 0; Window < TEMP_STATS_NUM_OF_WINDOWS; Window++)
+	{
+		g_windows[Window].First = First;
+		g_windows[Window].Num_Of_Buckets = g_numOfBuckets[Window];
+		g_windows[Window].Next = 0;
+		g_windows[Window].Filled = 0;
+		g_windows[Window].Min_Head = 0;
+		g_windows[Window].Min_Count = 0;
+		g_windows[Window].Max_Head = 0;
+		g_windows[Window].Max_Count = 0;
+		g_windows[Window].Sum = 0;
+		TempStats_ResetBucket(&g_windows[Window].Partial);
+
+		First += g_numOfBuckets[Window];
+	}
+}
+
+/*
+ * Description:
+ * Add a sample (one per second) to the bucket being filled, and push the complete buckets to their windows.
+ * Return TRUE if a bucket of the 1 minute window was completed, so the displayed results can be refreshed
+ * once per bucket instead of once per sample.
+ */
+boolean TempStats_AddSample(uint8 Temperature)
+{
+	TempStats_WindowType *Window_Ptr = &g_windows[0];
+	uint8 Window;
+
+	TempStats_Merge(&Window_Ptr -> Partial, Temperature, Temperature, Temperature);
+
+	if (Window_Ptr -> Partial.Count < TEMP_STATS_SAMPLES_PER_BUCKET)
+	{
+		return FALSE;
+	}
+
+	/* A complete bucket of a window is one more bucket of the next window, till a bucket is not complete */
+	for (Window = 0; Window < TEMP_STATS_NUM_OF_WINDOWS; Window++)
+	{
+		Window_Ptr = &g_windows[Window];
+
+		TempStats_PushBucket(Window_Ptr);
+
+		if (Window + 1 < TEMP_STATS_NUM_OF_WINDOWS)
+		{
+			TempStats_Merge(&g_windows[Window + 1].Partial, Window_Ptr -> Partial.Minimum, Window_Ptr -> Partial.Maximum,
+					Window_Ptr -> Partial.Sum);
+		}
+		TempStats_ResetBucket(&Window_Ptr -> Partial);
+
+		if ((Window + 1 >= TEMP_STATS_NUM_OF_WINDOWS) || (g_windows[Window + 1].Partial.Count < Window_Ptr -> Num_Of_Buckets))
+		{
+			break;
+		}
+	}
+
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Get the minimum, maximum and (rounded) mean temperature of a window (TEMP_STATS_WINDOW_x).
+ * Return FALSE if the window is not valid or has no sample yet.
+ */
+boolean TempStats_GetWindow(uint8 Window, TempStats_ResultType *Result_Ptr)
+{
+	const TempStats_WindowType *Window_Ptr;
+	uint8 Minimum = 0xFF;
+	uint8 Maximum = 0;
+	uint32 Sum = 0;
+	uint16 Count = 0;
+	uint8 Level;
+
+	if ((Window >= TEMP_STATS_NUM_OF_WINDOWS) || (Result_Ptr == NULL_PTR))
+	{
+		return FALSE;
+	}
+
+	Window_Ptr = &g_windows[Window];
+
+	/* The complete buckets: the running sum and the fronts of the deques */
+	if (Window_Ptr -> Filled != 0)
+	{
+		Minimum = g_buckets[Window_Ptr -> First + g_minQueue[Window_Ptr -> First + Window_Ptr -> Min_Head]].Minimum;
+		Maximum = g_buckets[Window_Ptr -> First + g_maxQueue[Window_Ptr -> First + Window_Ptr -> Max_Head]].Maximum;
+		Sum = Window_Ptr -> Sum;
+		Count = (uint16)Window_Ptr -> Filled * g_bucketSamples[Window];
+	}
+
+	/* The bucket being filled: its complete finer buckets, and theirs, down to the samples of the 1 minute window */
+	for (Level = 0; Level <= Window; Level++)
+	{
+		Window_Ptr = &g_windows[Level];
+
+		if (Window_Ptr -> Partial.Count != 0)
+		{
+			if (Window_Ptr -> Partial.Minimum < Minimum)
+			{
+				Minimum = Window_Ptr -> Partial.Minimum;
+			}
+			if (Window_Ptr -> Partial.Maximum > Maximum)
+			{
+				Maximum = Window_Ptr -> Partial.Maximum;
+			}
+			Sum += Window_Ptr -> Partial.Sum;
+			Count += (Level == 0) ? Window_Ptr -> Partial.Count : ((uint16)Window_Ptr -> Partial.Count * g_bucketSamples[Level - 1]);
+		}
+	}
+
+	if (Count == 0)
+	{
+		return FALSE;
+	}
+
+	Result_Ptr -> Minimum = Minimum;
+	Result_Ptr -> Maximum = Maximum;
+	Result_Ptr -> Mean = (uint8)((Sum + (Count / 2)) / Count);
+	Result_Ptr -> Num_Of_Samples = Count;
+
+	return TRUE;
+}
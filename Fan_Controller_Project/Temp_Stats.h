@@ -0,0 +1,112 @@
+/*******************************************************************************************************************
+ * File Name: Temp_Stats.h
+ * Date: 19/10/2026
+ * Driver: Sliding Window Temperature Statistics (Minimum, Maximum and Mean over 1, 10 and 60 Minutes) Header File
+ * Author: Youssef Zaki
+ *
+ * The main loop feeds one temperature per second. The samples are summarized in buckets and each window is a
+ * ring of the latest buckets of its level:
+ *     1 minute:   6 buckets of 10 seconds (built from the samples)
+ *     10 minutes: 10 buckets of 1 minute  (built from the buckets of the 1 minute window)
+ *     60 minutes: 6 buckets of 10 minutes (built from the buckets of the 10 minutes window)
+ * Every ring keeps the running sum of its buckets and two monotonic deques of bucket indexes, so the minimum
+ * and the maximum are at the front of the deques. A sample costs O(1) cycles (amortized over the buckets) and
+ * the RAM of a window is fixed by its number of buckets.
+ * A window result covers its complete buckets plus the bucket being filled: between the window length and the
+ * window length plus one bucket (60 to 70 seconds for the 1 minute window).
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+
+#ifndef TEMP_STATS_H_
+#define TEMP_STATS_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/* Window indexes of TempStats_GetWindow, from the finest to the coarsest */
+#define TEMP_STATS_WINDOW_1_MIN                    0
+#define TEMP_STATS_WINDOW_10_MIN                   1
+#define TEMP_STATS_WINDOW_60_MIN                   2
+#define TEMP_STATS_NUM_OF_WINDOWS                  3
+
+/* Number of samples (seconds) in a bucket of the 1 minute window */
+#define TEMP_STATS_SAMPLES_PER_BUCKET              10
+
+/* Number of buckets of each window, a bucket of a window is the whole length of the previous one */
+#define TEMP_STATS_BUCKETS_1_MIN                   6
+#define TEMP_STATS_BUCKETS_10_MIN                  10
+#define TEMP_STATS_BUCKETS_60_MIN                  6
+
+#define TEMP_STATS_TOTAL_BUCKETS                   (TEMP_STATS_BUCKETS_1_MIN + TEMP_STATS_BUCKETS_10_MIN + TEMP_STATS_BUCKETS_60_MIN)
+
+/* Samples in the longest window (with its bucket being filled), counted in 16 bits */
+#define TEMP_STATS_MAX_WINDOW_SAMPLES              (TEMP_STATS_SAMPLES_PER_BUCKET * TEMP_STATS_BUCKETS_1_MIN * \
+                                                    TEMP_STATS_BUCKETS_10_MIN * (TEMP_STATS_BUCKETS_60_MIN + 1))
+
+/* 1 to show the maximum of TEMP_STATS_LCD_WINDOW on the LCD (row 0 after the fan state), 0 to disable it */
+#define TEMP_STATS_LCD_ENABLED                     0
+#define TEMP_STATS_LCD_WINDOW                      TEMP_STATS_WINDOW_10_MIN
+
+#if ((TEMP_STATS_BUCKETS_1_MIN < 2) || (TEMP_STATS_BUCKETS_10_MIN < 2) || (TEMP_STATS_BUCKETS_60_MIN < 2))
+
+#error "Every window of the temperature statistics should have 2 buckets at least"
+
+#endif
+
+#if ((TEMP_STATS_SAMPLES_PER_BUCKET > 255) || (TEMP_STATS_TOTAL_BUCKETS > 255))
+
+#error "The temperature statistics count the samples of a bucket and the buckets in 8 bits"
+
+#endif
+
+#if (TEMP_STATS_MAX_WINDOW_SAMPLES > 65535)
+
+#error "The samples of the longest window of the temperature statistics should fit in 16 bits"
+
+#endif
+
+#if ((TEMP_STATS_LCD_ENABLED != 0) && (TEMP_STATS_LCD_ENABLED != 1))
+
+#error "TEMP_STATS_LCD_ENABLED should be 0 or 1"
+
+#endif
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+typedef struct
+{
+	uint8 Minimum;
+	uint8 Maximum;
+	uint8 Mean;
+	uint16 Num_Of_Samples;
+}TempStats_ResultType;
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Empty all the windows (called once at startup).
+ */
+void TempStats_Init(void);
+
+/*
+ * Description:
+ * Add a sample (one per second) to the bucket being filled, and push the complete buckets to their windows.
+ * Return TRUE if a bucket of the 1 minute window was completed, so the displayed results can be refreshed
+ * once per bucket instead of once per sample.
+ */
+boolean TempStats_AddSample(uint8 Temperature);
+
+/*
+ * Description:
+ * Get the minimum, maximum and (rounded) mean temperature of a window (TEMP_STATS_WINDOW_x).
+ * Return FALSE if the window is not valid or has no sample yet.
+ */
+boolean TempStats_GetWindow(uint8 Window, TempStats_ResultType *Result_Ptr);
+
+#endif /* TEMP_STATS_H_ */
@@ -0,0 +1,244 @@
+/*******************************************************************************************************************
+ * File Name: UART.c
+ * Date: 19/10/2026
+ * Driver: ATmega32 USART Driver Source File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "Common_Macros.h"
+#include "Isr_Sync.h"
+#include "UART.h"
+
+/***************************************************************************************
+ *                                         Global Variables                            *
+ ***************************************************************************************/
+
+ISR_SYNC_QUEUE_DEFINE(UART_RxQueue, uint8, UART_RX_QUEUE_SIZE)
+
+/* Filled by the Receive Complete Interrupt, emptied by UART_ReceiveByte */
+static UART_RxQueue_Type g_rxQueue;
+
+/* Receive call back, the received bytes are given to it instead of the queue when it is set */
+static void (* volatile g_ReceiveCallBackPtr)(uint8 Data, boolean Error) = NULL_PTR;
+
+/* Called from the Transmit Complete Interrupt at the end of the transmission of UART_StartTransmit */
+static void (* volatile g_TransmitCallBackPtr)(void) = NULL_PTR;
+
+/* Buffer of the interrupt driven transmission, owned by the Data Register Empty Interrupt while it is enabled */
+static const uint8 *g_txData = NULL_PTR;
+static volatile uint8 g_txLength = 0;
+static volatile uint8 g_txIndex = 0;
+static volatile boolean g_txBusy = FALSE;
+
+/***************************************************************************************
+ *                                  Interrupt Service Routines                         *
+ ***************************************************************************************/
+
+ISR(USART_RXC_vect)
+{
+	/* The error flags (frame error, data overrun, parity error) belong to the byte in UDR, read them first */
+	boolean Error = (UCSRA & ((1 << FE) | (1 << DOR) | (1 << PE))) ? TRUE : FALSE;
+
+	/* Reading UDR clears the interrupt flag, the byte is dropped if the queue is full */
+	uint8 Data = UDR;
+
+	if (g_ReceiveCallBackPtr != NULL_PTR)
+	{
+		(*g_ReceiveCallBackPtr)(Data, Error);
+	}
+	else
+	{
+		UART_RxQueue_Push(&g_rxQueue, Data);
+	}
+}
+
+/* Enabled only while bytes are left, so every interrupt writes one byte */
+ISR(USART_UDRE_vect)
+{
+	UDR = g_txData[g_txIndex];
+	g_txIndex++;
+
+	/* After the last byte, wait for the end of its stop bits (the transmit shift register is empty) */
+	if (g_txIndex >= g_txLength)
+	{
+		UCSRB = (UCSRB & ~(1 << UDRIE)) | (1 << TXCIE);
+	}
+}
+
+ISR(USART_TXC_vect)
+{
+	CLEAR_BIT(UCSRB, TXCIE);
+	g_txBusy = FALSE;
+
+	if (g_TransmitCallBackPtr != NULL_PTR)
+	{
+		(*g_TransmitCallBackPtr)();
+	}
+}
+
+/****************************************************************************************
+ *                                      Functions Definitions                           *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the USART (Asynchronous Mode, 8-bit data).
+ * 1. Enable the double transmission speed (U2X) to reduce the baud rate error at the low clock frequencies.
+ * 2. Enable the receiver, its Receive Complete Interrupt and the transmitter.
+ * 3. Configure the frame format (parity and stop bits) in the UCSRC Register (URSEL = 1).
+ * 4. Calculate the UBRR value from F_CPU and the required baud rate.
+ */
+void UART_Init(const UART_ConfigType *Config_Ptr)
+{
+	uint16 Ubrr_Value;
+
+	UART_RxQueue_Init(&g_rxQueue);
+
+	UCSRA = (1 << U2X);
+	UCSRB = (1 << RXCIE) | (1 << RXEN) | (1 << TXEN);
+
+	/* URSEL = 1 to write UCSRC, UCSZ1:0 = 11 for 8-bit data */
+	UCSRC = (1 << URSEL) | (1 << UCSZ1) | (1 << UCSZ0) | ((Config_Ptr -> Parity) << 4) | ((Config_Ptr -> Stop_Bits) << 3);
+
+	/* Baud Rate = F_CPU / (8 * (UBRR + 1)) in the double speed mode, rounded to the nearest value */
+	Ubrr_Value = (uint16)(((F_CPU + (4UL * Config_Ptr -> Baud_Rate)) / (8UL * Config_Ptr -> Baud_Rate)) - 1);
+
+	/* URSEL = 0 to write UBRRH */
+	UBRRH = (uint8)(Ubrr_Value >> 8) & 0x0F;
+	UBRRL = (uint8)Ubrr_Value;
+}
+
+/*
+ * Description:
+ * Send one byte, wait until the transmit buffer (UDR) is empty first (Polling Technique).
+ */
+void UART_SendByte(uint8 Data)
+{
+	while (BIT_IS_CLEAR(UCSRA, UDRE));
+
+	UDR = Data;
+}
+
+/*
+ * Description:
+ * Wait until a byte is in the receive queue then return it.
+ */
+uint8 UART_ReceiveByte(void)
+{
+	uint8 Data;
+
+	while (!UART_RxQueue_Pop(&g_rxQueue, &Data));
+
+	return Data;
+}
+
+/*
+ * Description:
+ * Return TRUE if a received byte is waiting in the receive queue.
+ */
+boolean UART_IsByteReceived(void)
+{
+	return (UART_RxQueue_Count(&g_rxQueue) != 0) ? TRUE : FALSE;
+}
+
+/*
+ * Description:
+ * Start the interrupt driven transmission of Length bytes (1 to 255), without waiting.
+ * The Data Register Empty Interrupt writes the bytes and the Transmit Complete Interrupt calls the transmit
+ * call back when the last stop bit is sent. The buffer must not be changed before the end of the transmission.
+ * Return FALSE if a transmission is still in progress.
+ */
+boolean UART_StartTransmit(const uint8 *Data_Ptr, uint8 Length)
+{
+	if (g_txBusy || (Length == 0))
+	{
+		return FALSE;
+	}
+
+	g_txData = Data_Ptr;
+	g_txLength = Length;
+	g_txIndex = 0;
+	g_txBusy = TRUE;
+
+	/* Clear the Transmit Complete flag of a previous byte (write one), FE/DOR/PE must be written zero */
+	UCSRA = (UCSRA & ((1 << U2X) | (1 << MPCM))) | (1 << TXC);
+
+	SET_BIT(UCSRB, UDRIE);
+
+	return TRUE;
+}
+
+/*
+ * Description:
+ * Return TRUE while a transmission started by UART_StartTransmit is in progress.
+ */
+boolean UART_IsTransmitting(void)
+{
+	return g_txBusy;
+}
+
+/*
+ * Description:
+ * Function to set the Call Back function address, called from the Receive Complete Interrupt with every
+ * received byte and TRUE if it has a frame, overrun or parity error. The receive queue is not used while it is set.
+ */
+void UART_SetReceiveCallBack(void(*a_ptr)(uint8 Data, boolean Error))
+{
+	/* The 16-bit address is read by the interrupt */
+	uint8 Sreg = IsrSync_EnterCritical();
+
+	g_ReceiveCallBackPtr = a_ptr;
+	IsrSync_ExitCritical(Sreg);
+}
+
+/*
+ * Description:
+ * Function to set the Call Back function address, called from the Transmit Complete Interrupt at the end of a
+ * transmission started by UART_StartTransmit.
+ */
+void UART_SetTransmitCallBack(void(*a_ptr)(void))
+{
+	/* The 16-bit address is read by the interrupt */
+	uint8 Sreg = IsrSync_EnterCritical();
+
+	g_TransmitCallBackPtr = a_ptr;
+	IsrSync_ExitCritical(Sreg);
+}
+
+/*
+ * Description:
+ * Send a null terminated string.
+ */
+void UART_SendString(const char *Str)
+{
+	while (*Str != '\0')
+	{
+		UART_SendByte(*Str);
+		Str++;
+	}
+}
+
+/*
+ * Description:
+ * Send an unsigned number in decimal.
+ */
+void UART_SendUnsigned(uint32 Value)
+{
+	/* 3 digits per byte are enough for any uint32 value */
+	char buff[sizeof(uint32) * 3];
+	uint8 i = 0;
+
+	do
+	{
+		buff[i] = '0' + (Value % 10);
+		Value /= 10;
+		i++;
+	} while (Value != 0);
+
+	while (i != 0)
+	{
+		i--;
+		UART_SendByte(buff[i]);
+	}
+}
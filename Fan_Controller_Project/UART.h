@@ -0,0 +1,116 @@
+/*******************************************************************************************************************
+ * File Name: UART.h
+ * Date: 19/10/2026
+ * Driver: ATmega32 USART Driver Header File
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "Standard_Types.h"
+
+#ifndef UART_H_
+#define UART_H_
+
+/****************************************************************************************
+ *                                    Macros Definitions                                *
+ ****************************************************************************************/
+
+/*
+ * The Receive Complete Interrupt queues the received bytes (single producer single consumer queue, Isr_Sync.h),
+ * a power of 2 up to 128. The bytes received while the queue is full are lost.
+ */
+#define UART_RX_QUEUE_SIZE                         16
+
+/****************************************************************************************
+ *                                      Types Declaration                               *
+ ****************************************************************************************/
+
+typedef enum
+{
+	UART_Parity_Disabled, UART_Parity_Reserved, UART_Parity_Even, UART_Parity_Odd
+}UART_ParityType;
+
+typedef enum
+{
+	UART_One_Stop_Bit, UART_Two_Stop_Bits
+}UART_StopBitType;
+
+typedef struct
+{
+	uint32 Baud_Rate;
+	UART_ParityType Parity;
+	UART_StopBitType Stop_Bits;
+}UART_ConfigType;
+
+/****************************************************************************************
+ *                                      Functions Prototypes                            *
+ ****************************************************************************************/
+
+/*
+ * Description:
+ * Initialization of the USART (Asynchronous Mode, 8-bit data).
+ * 1. Enable the double transmission speed (U2X) to reduce the baud rate error at the low clock frequencies.
+ * 2. Enable the receiver, its Receive Complete Interrupt and the transmitter.
+ * 3. Configure the frame format (parity and stop bits) in the UCSRC Register (URSEL = 1).
+ * 4. Calculate the UBRR value from F_CPU and the required baud rate.
+ */
+void UART_Init(const UART_ConfigType *Config_Ptr);
+
+/*
+ * Description:
+ * Send one byte, wait until the transmit buffer (UDR) is empty first (Polling Technique).
+ */
+void UART_SendByte(uint8 Data);
+
+/*
+ * Description:
+ * Wait until a byte is in the receive queue then return it.
+ */
+uint8 UART_ReceiveByte(void);
+
+/*
+ * Description:
+ * Return TRUE if a received byte is waiting in the receive queue.
+ */
+boolean UART_IsByteReceived(void);
+
+/*
+ * Description:
+ * Start the interrupt driven transmission of Length bytes (1 to 255), without waiting.
+ * The Data Register Empty Interrupt writes the bytes and the Transmit Complete Interrupt calls the transmit
+ * call back when the last stop bit is sent. The buffer must not be changed before the end of the transmission.
+ * Return FALSE if a transmission is still in progress.
+ */
+boolean UART_StartTransmit(const uint8 *Data_Ptr, uint8 Length);
+
+/*
+ * Description:
+ * Return TRUE while a transmission started by UART_StartTransmit is in progress.
+ */
+boolean UART_IsTransmitting(void);
+
+/*
+ * Description:
+ * Function to set the Call Back function address, called from the Receive Complete Interrupt with every
+ * received byte and TRUE if it has a frame, overrun or parity error. The receive queue is not used while it is set.
+ */
+void UART_SetReceiveCallBack(void(*a_ptr)(uint8 Data, boolean Error));
+
+/*
+ * Description:
+ * Function to set the Call Back function address, called from the Transmit Complete Interrupt at the end of a
+ * transmission started by UART_StartTransmit.
+ */
+void UART_SetTransmitCallBack(void(*a_ptr)(void));
+
+/*
+ * Description:
+ * Send a null terminated string.
+ */
+void UART_SendString(const char *Str);
+
+/*
+ * Description:
+ * Send an unsigned number in decimal.
+ */
+void UART_SendUnsigned(uint32 Value);
+
+#endif /* UART_H_ */
@@ -0,0 +1,158 @@
+/*******************************************************************************************************************
+ * File Name: adc_sync_noise.cpp
+ * Date: 19/10/2026
+ * Tool: Host-side simulation of the LM35 reading noise, free running ADC versus PWM synchronized ADC
+ * Author: Youssef Zaki
+ *
+ * The sensor signal seen by the ADC is modeled as the LM35 voltage plus:
+ *     - a ground shift while the motor is driven (OC0 high),
+ *     - a damped ringing after each switching edge of OC0,
+ *     - white noise.
+ * The free running/polled ADC samples at any phase of the PWM period, the synchronized ADC samples
+ * 2 ADC clock cycles after the Timer0 overflow (ADC_StartTriggered with TIMER0_OVF).
+ * Build and run on the host:
+ *     g++ -O2 -std=c++17 -DF_CPU=1000000UL -I../Thermal_Sim/shim -I../../Fan_Controller_Project adc_sync_noise.cpp \
+ *         -o adc_sync_noise
+ *     ./adc_sync_noise
+ ******************************************************************************************************************/
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+extern "C"
+{
+#include "LM35.h"
+}
+
+namespace
+{
+
+/* Target settings of the application at F_CPU = 1MHz */
+constexpr double F_CPU_HZ = 1000000.0;
+constexpr double PWM_PERIOD_S = 256.0 * 8.0 / F_CPU_HZ;
+constexpr double ADC_CLOCK_S = 8.0 / F_CPU_HZ;
+constexpr double SAMPLE_DELAY_S = 2.0 * ADC_CLOCK_S;
+constexpr double VREF_V = MAX_VOLTAGE_REFERENCE;
+constexpr int ADC_MAX = ADC_MAX_DIGITAL_VALUE;
+constexpr int SAMPLES_PER_RESULT = 8;
+
+/* LM35_ConvertToTemperature: MAX_LM35_TEMPERATURE at MAX_VOLTAGE_SENSOR, about 0.25C per code */
+constexpr double CELSIUS_PER_CODE = (MAX_VOLTAGE_REFERENCE * MAX_LM35_TEMPERATURE) / (MAX_VOLTAGE_SENSOR * ADC_MAX_DIGITAL_VALUE);
+
+/* Model of the board (typical values for a small fan motor sharing the ground return) */
+constexpr double SENSOR_V = 0.300;
+constexpr double GROUND_SHIFT_V = 0.006;
+constexpr double RINGING_V = 0.050;
+constexpr double RINGING_TAU_S = 3e-6;
+constexpr double RINGING_HZ = 1e6;
+constexpr double WHITE_NOISE_V = 0.001;
+
+constexpr int NUM_OF_READINGS = 20000;
+
+double Ringing(double Time_Since_Edge)
+{
+	return RINGING_V * std::exp(-Time_Since_Edge / RINGING_TAU_S) * std::cos(2.0 * M_PI * RINGING_HZ * Time_Since_Edge);
+}
+
+/* Voltage at the ADC input at a phase (seconds from the Timer0 overflow) of a PWM period with the duty cycle (0..1) */
+double SensorVoltage(double Phase, double Duty, std::mt19937 &Generator)
+{
+	std::normal_distribution<double> Noise(0.0, WHITE_NOISE_V);
+	double High_Time = Duty * PWM_PERIOD_S;
+	double Voltage = SENSOR_V + Noise(Generator);
+
+	if (Duty <= 0.0)
+	{
+		return Voltage;
+	}
+
+	if (Phase < High_Time)
+	{
+		Voltage += GROUND_SHIFT_V + Ringing(Phase);
+	}
+	else
+	{
+		Voltage += Ringing(Phase - High_Time);
+	}
+	return Voltage;
+}
+
+int Convert(double Voltage)
+{
+	long Code = std::lround(Voltage * ADC_MAX / VREF_V);
+
+	return static_cast<int>(std::min<long>(std::max<long>(Code, 0), ADC_MAX));
+}
+
+struct Stats
+{
+	double Mean;
+	double Deviation;
+	int Min;
+	int Max;
+};
+
+Stats Measure(const std::vector<int> &Codes)
+{
+	Stats Result = {0.0, 0.0, ADC_MAX, 0};
+
+	for (int Code : Codes)
+	{
+		Result.Mean += Code;
+		Result.Min = std::min(Result.Min, Code);
+		Result.Max = std::max(Result.Max, Code);
+	}
+	Result.Mean /= Codes.size();
+	for (int Code : Codes)
+	{
+		Result.Deviation += (Code - Result.Mean) * (Code - Result.Mean);
+	}
+	Result.Deviation = std::sqrt(Result.Deviation / Codes.size());
+	return Result;
+}
+
+void Print(const char *Name, const Stats &Result)
+{
+	std::printf("    %-22s mean %7.2f  stddev %5.2f LSB  spread %3d LSB (%4.1fC)\n",
+			Name, Result.Mean, Result.Deviation, Result.Max - Result.Min, (Result.Max - Result.Min) * CELSIUS_PER_CODE);
+}
+
+} /* namespace */
+
+int main()
+{
+	const double Duties[] = {0.0, 0.25, 0.5, 0.75, 1.0};
+	std::mt19937 Generator(1234);
+	std::uniform_real_distribution<double> Random_Phase(0.0, PWM_PERIOD_S);
+
+	std::printf("Ideal code %d\n", Convert(SENSOR_V));
+
+	for (double Duty : Duties)
+	{
+		std::vector<int> Free_Running;
+		std::vector<int> Synchronized;
+		std::vector<int> Averaged;
+
+		for (int Reading = 0; Reading < NUM_OF_READINGS; Reading++)
+		{
+			int Sum = 0;
+
+			Free_Running.push_back(Convert(SensorVoltage(Random_Phase(Generator), Duty, Generator)));
+			Synchronized.push_back(Convert(SensorVoltage(SAMPLE_DELAY_S, Duty, Generator)));
+
+			for (int Sample = 0; Sample < SAMPLES_PER_RESULT; Sample++)
+			{
+				Sum += Convert(SensorVoltage(SAMPLE_DELAY_S, Duty, Generator));
+			}
+			Averaged.push_back(Sum / SAMPLES_PER_RESULT);
+		}
+
+		std::printf("Duty %3.0f%%\n", Duty * 100.0);
+		Print("free running", Measure(Free_Running));
+		Print("synchronized", Measure(Synchronized));
+		Print("synchronized average 8", Measure(Averaged));
+	}
+
+	return 0;
+}
@@ -0,0 +1,237 @@
+/*******************************************************************************************************************
+ * File Name: adaptive_sampling.cpp
+ * Date: 19/10/2026
+ * Tool: Host-side benchmark of the adaptive sampling rate (Sample_Rate.c) against the fixed rate
+ * Author: Youssef Zaki
+ *
+ * A six hour temperature trace (stable ambient with slow drift, a slow heat load, a fast step and a cool down,
+ * plus the sensor noise) is sampled by a model of the ADC schedule of the application: the LM35 slot and the
+ * current sensing slot in turn, one turn per Timer0 PWM period, 8 LM35 samples per result. The firmware
+ * Sample_Rate.c itself sets the interval of the LM35 slot.
+ * The CPU duty is estimated from the number of interrupts, each one waking the CPU from the Idle mode for
+ * its own cycles and one pass of the main loop. The current is estimated from the ATmega32 typical values at
+ * 1MHz/5V (1.1mA active, 0.35mA idle).
+ * Build and run on the host:
+ *     gcc -O2 -c -Ishim -I../../Fan_Controller_Project ../../Fan_Controller_Project/Sample_Rate.c -o sample_rate.o
+ *     g++ -O2 -std=c++17 -I../../Fan_Controller_Project adaptive_sampling.cpp sample_rate.o -o adaptive_sampling
+ *     ./adaptive_sampling
+ ******************************************************************************************************************/
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+extern "C"
+{
+#include "Sample_Rate.h"
+
+/* Interval requested by Sample_Rate.c, used from the next turn of the LM35 slot */
+static unsigned g_requestedInterval = 1;
+
+void ADC_SetInterval(uint8 Slot, uint8 Interval)
+{
+	(void)Slot;
+	g_requestedInterval = (Interval == 0) ? 1 : Interval;
+}
+}
+
+namespace
+{
+
+constexpr double PWM_PERIOD_S = 256.0 * 8.0 / 1000000.0;
+constexpr double TRACE_S = 6.0 * 3600.0;
+constexpr int SAMPLES_PER_RESULT = 8;
+constexpr double CODES_PER_DEGREE = 1023.0 * 1.5 / (2.56 * 150.0);
+constexpr double SENSOR_NOISE_C = 0.15;
+constexpr int THRESHOLDS[] = {30, 60, 90, 120};
+
+/* Cycles per event at 1MHz (estimates from the generated code of the interrupts and of the main loop) */
+constexpr double CYCLES_PER_PERIOD = 2048.0;
+constexpr double TIMER0_ISR_CYCLES = 90.0;
+constexpr double ADC_ISR_CYCLES = 110.0;
+constexpr double RESULT_CYCLES = 220.0;          /* Temp_Monitor and Sample_Rate call backs */
+constexpr double MAIN_LOOP_PASS_CYCLES = 150.0;  /* one pass of the main loop after each wake up */
+constexpr double EVENT_CYCLES = 4000.0;          /* conversion and LCD writes of one displayed value */
+constexpr double ACTIVE_MA = 1.1;
+constexpr double IDLE_MA = 0.35;
+
+/* Temperature of the trace in C */
+double TraceTemperature(double Time_s)
+{
+	double Temperature = 24.0 + 2.0 * std::sin(Time_s * 2.0 * M_PI / (6.0 * 3600.0));
+
+	/* Slow heat load at 1h: +12C in 2 minutes, then back in 20 minutes */
+	if (Time_s > 3600.0)
+	{
+		double Rise = std::min(1.0, (Time_s - 3600.0) / 120.0);
+		double Decay = (Time_s > 3720.0) ? std::exp(-(Time_s - 3720.0) / 400.0) : 1.0;
+		Temperature += 12.0 * Rise * Decay;
+	}
+
+	/* Fast step at 3h: +40C in 5 seconds, held 10 minutes, then cools down with a 2 minute time constant */
+	if (Time_s > 3.0 * 3600.0)
+	{
+		double Rise = std::min(1.0, (Time_s - 3.0 * 3600.0) / 5.0);
+		double Hold_End = 3.0 * 3600.0 + 600.0;
+		double Decay = (Time_s > Hold_End) ? std::exp(-(Time_s - Hold_End) / 120.0) : 1.0;
+		Temperature += 40.0 * Rise * Decay;
+	}
+
+	return Temperature;
+}
+
+int Level(double Temperature)
+{
+	int Result = 0;
+
+	while ((Result < 4) && (Temperature >= THRESHOLDS[Result]))
+	{
+		Result++;
+	}
+	return Result;
+}
+
+struct Report
+{
+	unsigned long Conversions = 0;
+	unsigned long Results = 0;
+	unsigned long Events = 0;
+	double Cpu_Duty = 0.0;
+	double Current_mA = 0.0;
+	double Worst_Latency_s = 0.0;
+	unsigned Level_Changes = 0;
+	double Time_At_Slowest = 0.0;
+};
+
+Report Run(bool Adaptive)
+{
+	std::mt19937 Generator(7);
+	std::normal_distribution<double> Noise(0.0, SENSOR_NOISE_C);
+	const unsigned long Periods = (unsigned long)(TRACE_S / PWM_PERIOD_S);
+	Report Result;
+	unsigned Interval = 1;
+	unsigned Countdown = 0;
+	unsigned Sample_Count = 0;
+	unsigned Sample_Sum = 0;
+	unsigned Last_Temperature = 0xFFFF;
+	int True_Level = Level(TraceTemperature(0.0));
+	int Seen_Level = True_Level;
+	double Level_Change_Time = -1.0;
+	double Cycles = 0.0;
+
+	g_requestedInterval = 1;
+	SampleRate_Init();
+
+	for (unsigned long Period = 0; Period < Periods; Period++)
+	{
+		double Time_s = Period * PWM_PERIOD_S;
+		double Temperature = TraceTemperature(Time_s);
+
+		/* Timer0 overflow: system time, ADC_Tick and the motor profile */
+		Cycles += TIMER0_ISR_CYCLES + MAIN_LOOP_PASS_CYCLES;
+
+		if (Level(Temperature) != True_Level)
+		{
+			True_Level = Level(Temperature);
+			if (Level_Change_Time < 0.0)
+			{
+				Level_Change_Time = Time_s;
+			}
+		}
+
+		/* Odd turns: current sensing, always converted */
+		if ((Period & 1) != 0)
+		{
+			Result.Conversions++;
+			Cycles += ADC_ISR_CYCLES + MAIN_LOOP_PASS_CYCLES;
+			continue;
+		}
+
+		/* Even turns: LM35 slot, converted once every Interval of its turns */
+		if (Countdown != 0)
+		{
+			Countdown--;
+			continue;
+		}
+		Interval = Adaptive ? g_requestedInterval : 1;
+		Countdown = Interval - 1;
+
+		Result.Conversions++;
+		Cycles += ADC_ISR_CYCLES + MAIN_LOOP_PASS_CYCLES;
+		Sample_Sum += (unsigned)std::lround(std::max(0.0, (Temperature + Noise(Generator)) * CODES_PER_DEGREE));
+
+		if (++Sample_Count < SAMPLES_PER_RESULT)
+		{
+			continue;
+		}
+
+		unsigned Code = Sample_Sum / SAMPLES_PER_RESULT;
+		Sample_Sum = 0;
+		Sample_Count = 0;
+		Result.Results++;
+		Cycles += RESULT_CYCLES;
+
+		if (Adaptive)
+		{
+			SampleRate_Update((uint16)Code);
+		}
+
+		/* An event wakes the main loop for the conversion and the LCD when the displayed temperature changes */
+		if ((unsigned)(Code / CODES_PER_DEGREE) != Last_Temperature)
+		{
+			Last_Temperature = (unsigned)(Code / CODES_PER_DEGREE);
+			Result.Events++;
+			Cycles += EVENT_CYCLES;
+		}
+
+		int Level_Now = Level(Code / CODES_PER_DEGREE);
+		if (Level_Now != Seen_Level)
+		{
+			Seen_Level = Level_Now;
+			Result.Level_Changes++;
+			if (Level_Change_Time >= 0.0)
+			{
+				Result.Worst_Latency_s = std::max(Result.Worst_Latency_s, Time_s - Level_Change_Time);
+			}
+		}
+		if (Seen_Level == True_Level)
+		{
+			Level_Change_Time = -1.0;
+		}
+
+		if (Interval == (1u << SAMPLE_RATE_MAX_INTERVAL_SHIFT))
+		{
+			Result.Time_At_Slowest += Interval * 2.0 * SAMPLES_PER_RESULT * PWM_PERIOD_S;
+		}
+	}
+
+	Result.Cpu_Duty = Cycles / (Periods * CYCLES_PER_PERIOD);
+	Result.Current_mA = Result.Cpu_Duty * ACTIVE_MA + (1.0 - Result.Cpu_Duty) * IDLE_MA;
+	return Result;
+}
+
+void Print(const char *Name, const Report &Result)
+{
+	std::printf("%-9s %10lu %8lu %7lu   %5.2f%%   %.3fmA   %6.2fs   %3u   %5.1f%%\n", Name, Result.Conversions,
+			Result.Results, Result.Events, Result.Cpu_Duty * 100.0, Result.Current_mA, Result.Worst_Latency_s,
+			Result.Level_Changes, Result.Time_At_Slowest / TRACE_S * 100.0);
+}
+
+} /* namespace */
+
+int main()
+{
+	Report Fixed = Run(false);
+	Report Adaptive = Run(true);
+
+	std::printf("6h trace, slowest interval %u\n", 1u << SAMPLE_RATE_MAX_INTERVAL_SHIFT);
+	std::printf("mode      conversions  results  events   CPU duty  current   latency  levels  slowest\n");
+	Print("fixed", Fixed);
+	Print("adaptive", Adaptive);
+	std::printf("ADC conversions -%.1f%%, LM35 results -%.1f%%, CPU duty -%.1f%%, current -%.1f%%\n",
+			100.0 * (1.0 - (double)Adaptive.Conversions / Fixed.Conversions),
+			100.0 * (1.0 - (double)Adaptive.Results / Fixed.Results),
+			100.0 * (1.0 - Adaptive.Cpu_Duty / Fixed.Cpu_Duty),
+			100.0 * (1.0 - Adaptive.Current_mA / Fixed.Current_mA));
+
+	return 0;
+}
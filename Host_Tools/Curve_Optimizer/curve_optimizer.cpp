@@ -0,0 +1,770 @@
+/*******************************************************************************************************************
+ * File Name: curve_optimizer.cpp
+ * Date: 19/10/2026
+ * Tool: Host-side parallel optimizer of the fan curve thresholds and speeds
+ * Author: Youssef Zaki
+ *
+ * Each candidate curve is scored by a closed loop run of the controller against the thermal plant of Thermal_Sim:
+ *     - a result every --sample-period (the fastest rate of Sample_Rate.c) gives the LM35 code of the plant
+ *       temperature plus the sensor noise (4 codes per C with the 2.56V reference),
+ *     - the level is given by FanCurve_GetLevel of the firmware (Fan_Curve.c, linked), a level with another speed
+ *       is one DcMotor_Rotate call (a speed change),
+ *     - the plant is a thermal mass heated by a power profile and cooled by natural convection plus the fan
+ *       airflow, which follows the drive duty cycle with a first order lag and stalls under a minimum duty.
+ * The scenarios are the --heat profile and, with --trace, a recorded sensor trace of Trace_Replay taken as the
+ * temperature the device reaches without the fan (its heat load is G_natural * (T_trace - ambient)).
+ * The score of a candidate (lower is better) sums, averaged over the scenarios:
+ *     w_temp * RMS of the temperature above --target (C) + w_energy * average fan power (W, cube of the speed)
+ *     + w_switch * speed changes per hour, plus a penalty if the critical temperature of Fan_Safety.h is reached.
+ * The candidates of a generation are evaluated by a work stealing thread pool: every worker takes the candidates
+ * of its own queue from the back and steals from the front of another queue once its own is empty. Every run uses
+ * the same noise sequence and the mutations are drawn on the main thread, so the result does not depend on the
+ * number of threads. The best curve is written as a header for the build and/or as an EEPROM image of the
+ * configuration block (Fan_Config.h layout and CRC, Intel HEX as used by avrdude).
+ * Build and run on the host:
+ *     gcc -O2 -std=gnu99 -I../../Fan_Controller_Project -c ../../Fan_Controller_Project/Fan_Curve.c
+ *     gcc -O2 -std=gnu99 -I../../Fan_Controller_Project -c ../../Fan_Controller_Project/CRC.c
+ *     g++ -O2 -std=c++17 -pthread -DF_CPU=1000000UL -I../Thermal_Sim/shim -I../Thermal_Sim -I../Trace_Replay \
+ *         -I../../Fan_Controller_Project curve_optimizer.cpp Fan_Curve.o CRC.o -o curve_optimizer
+ *     ./curve_optimizer --generations 40 --header Fan_Curve_Optimized.h --eeprom fan_config.eep
+ * Options (defaults in brackets):
+ *     --hours H, --heat h:W,...     scenario of Thermal_Sim [6, 0:0,0.25:20,2:45,4:10]
+ *     --trace file.trc              add a recorded trace scenario [none]
+ *     --ambient, --mass, --g-natural, --g-fan, --fan-tau, --stall, --noise   plant of Thermal_Sim (thermal_plant.h)
+ *     --fan-watts W                 fan power at full speed [3]
+ *     --target C                    temperature above which the error is counted [50]
+ *     --w-temp, --w-energy, --w-switch   weights of the score [1, 1, 0.05]
+ *     --sample-period s             time between two results [0.065]
+ *     --population N, --generations N, --seed N   evolution [64, 40, 1]
+ *     --sweep C                     evaluate every threshold set on a C grid (default speeds) instead
+ *     --threads N                   worker threads [all cores]
+ *     --scaling                     time one batch with 1, 2, 4 ... --threads and report the speedup
+ *     --header file, --eeprom file  outputs [none]
+ ******************************************************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "thermal_plant.h"
+#include "trace_file.h"
+
+extern "C"
+{
+#include "Standard_Types.h"
+#include "CRC.h"
+#include "Fan_Curve.h"
+#include "Fan_Config.h"
+#include "Fan_Safety.h"
+}
+
+namespace
+{
+
+constexpr double CODES_PER_DEGREE = 4.0;
+constexpr double CRITICAL_PENALTY = 1000.0;
+
+static_assert(sizeof(FanConfig_Type) == 20, "the configuration block must have the AVR layout");
+
+/****************************************************************************************
+ *                                  Options and Scenarios                               *
+ ****************************************************************************************/
+
+struct HeatStep
+{
+	double Start_s;
+	double Watts;
+};
+
+struct Options
+{
+	double Hours = 6.0;
+	std::vector<HeatStep> Heat = {{0.0, 0.0}, {0.25 * 3600.0, 20.0}, {2.0 * 3600.0, 45.0}, {4.0 * 3600.0, 10.0}};
+	std::string Trace;
+	ThermalPlantParams Plant;
+	double Noise_C = 0.2;
+	double Fan_Watts = 3.0;
+	double Target_C = 50.0;
+	double W_Temp = 1.0;
+	double W_Energy = 1.0;
+	double W_Switch = 0.05;
+	double Sample_Period_s = 0.065;
+	int Population = 64;
+	int Generations = 40;
+	unsigned Seed = 1;
+	int Sweep_C = 0;
+	unsigned Threads = 0;
+	bool Scaling = false;
+	std::string Header;
+	std::string Eeprom;
+};
+
+/* Heat power and sensor noise of every result of one scenario, the same noise is used for every candidate */
+struct Scenario
+{
+	std::string Name;
+	std::vector<float> Watts;
+	std::vector<float> Noise_C;
+};
+
+struct Score
+{
+	double Total = 0.0;
+	double Excess_C = 0.0;
+	double Fan_W = 0.0;
+	double Switches_per_h = 0.0;
+	double Max_C = 0.0;
+};
+
+struct Candidate
+{
+	FanCurve_Type Curve;
+	Score Result;
+};
+
+Options g_options;
+std::vector<Scenario> g_scenarios;
+
+void AddNoise(Scenario &Run)
+{
+	std::mt19937 Generator(g_options.Seed);
+	std::normal_distribution<double> Noise(0.0, g_options.Noise_C);
+
+	Run.Noise_C.resize(Run.Watts.size());
+	for (float &Value : Run.Noise_C)
+	{
+		Value = (float)Noise(Generator);
+	}
+}
+
+Scenario HeatScenario()
+{
+	Scenario Heat;
+	size_t Count = (size_t)(g_options.Hours * 3600.0 / g_options.Sample_Period_s);
+
+	Heat.Name = "heat profile";
+	Heat.Watts.resize(Count);
+	for (size_t Index = 0; Index < Count; Index++)
+	{
+		double Time_s = Index * g_options.Sample_Period_s;
+		double Watts = 0.0;
+
+		for (const HeatStep &Step : g_options.Heat)
+		{
+			if (Time_s >= Step.Start_s)
+			{
+				Watts = Step.Watts;
+			}
+		}
+		Heat.Watts[Index] = (float)Watts;
+	}
+	AddNoise(Heat);
+	return Heat;
+}
+
+/* The trace is streamed once, only the heat load at every result is kept */
+Scenario TraceScenario(const char *Path)
+{
+	TraceReader Reader;
+	Scenario Trace;
+	double Volts_per_Code;
+	uint64_t Period_Cycles = (uint64_t)(g_options.Sample_Period_s * 1e6);
+
+	Reader.Open(Path);
+	Volts_per_Code = ((Reader.Header().Refs == 1) ? 5.0 : 2.56) / 1024.0;
+	Trace.Name = Path;
+
+	for (uint64_t Cycles = 0; Reader.Seek(Cycles); Cycles += Period_Cycles)
+	{
+		double Temperature_C = Reader.Code() * Volts_per_Code / 0.010;
+
+		Trace.Watts.push_back((float)std::max(0.0, g_options.Plant.G_Natural * (Temperature_C - g_options.Plant.Ambient_C)));
+	}
+	AddNoise(Trace);
+	return Trace;
+}
+
+/****************************************************************************************
+ *                                      Evaluation                                      *
+ ****************************************************************************************/
+
+Score Evaluate(const FanCurve_Type &Curve)
+{
+	Score Total;
+
+	for (const Scenario &Run : g_scenarios)
+	{
+		double Dt_s = g_options.Sample_Period_s;
+		ThermalPlantState Plant;
+		double Drive_Duty = 0.0;
+		double Excess_Sum = 0.0;
+		double Fan_Energy = 0.0;
+		double Max_C;
+		unsigned long Switches = 0;
+		int Speed = -1;
+
+		Plant.Temperature_C = g_options.Plant.Ambient_C;
+		Max_C = Plant.Temperature_C;
+
+		for (size_t Index = 0; Index < Run.Watts.size(); Index++)
+		{
+			long Code = std::lround((Plant.Temperature_C + Run.Noise_C[Index]) * CODES_PER_DEGREE);
+			uint8 Measured = (uint8)std::min(255L, std::max(0L, Code) / (long)CODES_PER_DEGREE);
+			double Excess;
+			int New_Speed = Curve.Speeds[FanCurve_GetLevel(&Curve, Measured)];
+
+			if (New_Speed != Speed)
+			{
+				Switches += (Speed >= 0) ? 1 : 0;
+				Speed = New_Speed;
+				Drive_Duty = Speed / 100.0;
+			}
+
+			/* The optimizer changes the speed without the brake profile */
+			StepThermalPlant(g_options.Plant, Drive_Duty, false, Run.Watts[Index], Dt_s, &Plant);
+
+			Excess = std::max(0.0, Plant.Temperature_C - g_options.Target_C);
+			Excess_Sum += Excess * Excess;
+			Fan_Energy += g_options.Fan_Watts * Plant.Fan_Speed * Plant.Fan_Speed * Plant.Fan_Speed;
+			Max_C = std::max(Max_C, Plant.Temperature_C);
+		}
+
+		double Hours = Run.Watts.size() * Dt_s / 3600.0;
+		Score Part;
+
+		Part.Excess_C = std::sqrt(Excess_Sum / Run.Watts.size());
+		Part.Fan_W = Fan_Energy / Run.Watts.size();
+		Part.Switches_per_h = Switches / Hours;
+		Part.Max_C = Max_C;
+
+		Total.Excess_C += Part.Excess_C / g_scenarios.size();
+		Total.Fan_W += Part.Fan_W / g_scenarios.size();
+		Total.Switches_per_h += Part.Switches_per_h / g_scenarios.size();
+		Total.Max_C = std::max(Total.Max_C, Part.Max_C);
+	}
+
+	Total.Total = g_options.W_Temp * Total.Excess_C + g_options.W_Energy * Total.Fan_W +
+			g_options.W_Switch * Total.Switches_per_h +
+			((Total.Max_C >= FAN_SAFETY_CRITICAL_TEMPERATURE) ? CRITICAL_PENALTY : 0.0);
+	return Total;
+}
+
+/****************************************************************************************
+ *                                  Work Stealing Pool                                  *
+ ****************************************************************************************/
+
+class WorkStealingPool
+{
+public:
+	explicit WorkStealingPool(unsigned Threads) : m_queues(Threads)
+	{
+		for (unsigned Index = 0; Index < Threads; Index++)
+		{
+			m_workers.emplace_back(&WorkStealingPool::Worker, this, Index);
+		}
+	}
+
+	~WorkStealingPool()
+	{
+		{
+			std::lock_guard<std::mutex> Lock(m_mutex);
+			m_stop = true;
+		}
+		m_wake.notify_all();
+		for (std::thread &Thread : m_workers)
+		{
+			Thread.join();
+		}
+	}
+
+	/* Run Task(0) .. Task(Count - 1) and wait until all of them are done */
+	void Run(size_t Count, const std::function<void(size_t)> &Task)
+	{
+		size_t Workers = m_queues.size();
+
+		/* Contiguous blocks, one per worker, the imbalance is taken care of by the stealing */
+		for (size_t Index = 0; Index < Workers; Index++)
+		{
+			Queue &Own = m_queues[Index];
+			std::lock_guard<std::mutex> Lock(Own.Mutex);
+
+			for (size_t Item = Index * Count / Workers; Item < (Index + 1) * Count / Workers; Item++)
+			{
+				Own.Items.push_back(Item);
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> Lock(m_mutex);
+			m_task = &Task;
+			m_remaining = Count;
+			m_batch++;
+		}
+		m_wake.notify_all();
+
+		std::unique_lock<std::mutex> Lock(m_mutex);
+		m_done.wait(Lock, [this] { return m_remaining == 0; });
+		m_task = nullptr;
+	}
+
+	unsigned long Steals() const
+	{
+		return m_steals;
+	}
+
+private:
+	struct Queue
+	{
+		std::mutex Mutex;
+		std::deque<size_t> Items;
+	};
+
+	bool PopOwn(size_t Index, size_t &Item)
+	{
+		Queue &Own = m_queues[Index];
+		std::lock_guard<std::mutex> Lock(Own.Mutex);
+
+		if (Own.Items.empty())
+		{
+			return false;
+		}
+		Item = Own.Items.back();
+		Own.Items.pop_back();
+		return true;
+	}
+
+	bool Steal(size_t Index, size_t &Item)
+	{
+		for (size_t Offset = 1; Offset < m_queues.size(); Offset++)
+		{
+			Queue &Victim = m_queues[(Index + Offset) % m_queues.size()];
+			std::lock_guard<std::mutex> Lock(Victim.Mutex);
+
+			if (!Victim.Items.empty())
+			{
+				Item = Victim.Items.front();
+				Victim.Items.pop_front();
+				m_steals++;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void Worker(size_t Index)
+	{
+		unsigned long Seen_Batch = 0;
+
+		while (true)
+		{
+			const std::function<void(size_t)> *Task;
+			size_t Item;
+
+			{
+				std::unique_lock<std::mutex> Lock(m_mutex);
+				m_wake.wait(Lock, [&] { return m_stop || (m_batch != Seen_Batch); });
+				if (m_stop)
+				{
+					return;
+				}
+				Seen_Batch = m_batch;
+				Task = m_task;
+			}
+
+			while (PopOwn(Index, Item) || Steal(Index, Item))
+			{
+				(*Task)(Item);
+
+				std::lock_guard<std::mutex> Lock(m_mutex);
+				if (--m_remaining == 0)
+				{
+					m_done.notify_one();
+				}
+			}
+		}
+	}
+
+	std::vector<Queue> m_queues;
+	std::vector<std::thread> m_workers;
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	const std::function<void(size_t)> *m_task = nullptr;
+	size_t m_remaining = 0;
+	unsigned long m_batch = 0;
+	bool m_stop = false;
+	std::atomic<unsigned long> m_steals{0};
+};
+
+void EvaluateAll(WorkStealingPool &Pool, std::vector<Candidate> &Candidates)
+{
+	Pool.Run(Candidates.size(), [&Candidates](size_t Index) {
+		Candidates[Index].Result = Evaluate(Candidates[Index].Curve);
+	});
+}
+
+/****************************************************************************************
+ *                                       Search                                         *
+ ****************************************************************************************/
+
+/* Ascending thresholds within 1..150C and non decreasing speeds within 0..100% */
+void Repair(FanCurve_Type &Curve)
+{
+	std::sort(Curve.Thresholds, Curve.Thresholds + FAN_CURVE_NUM_OF_THRESHOLDS);
+	for (int Level = 0; Level < FAN_CURVE_NUM_OF_THRESHOLDS; Level++)
+	{
+		int Minimum = (Level == 0) ? 1 : (Curve.Thresholds[Level - 1] + 1);
+
+		Curve.Thresholds[Level] = (uint8)std::min(150 - (FAN_CURVE_NUM_OF_THRESHOLDS - 1 - Level),
+				std::max(Minimum, (int)Curve.Thresholds[Level]));
+	}
+
+	std::sort(Curve.Speeds, Curve.Speeds + FAN_CURVE_NUM_OF_LEVELS);
+	for (uint8 &Speed : Curve.Speeds)
+	{
+		Speed = (uint8)std::min(100, (int)Speed);
+	}
+}
+
+FanCurve_Type Mutate(const FanCurve_Type &Parent, std::mt19937 &Generator)
+{
+	std::normal_distribution<double> Step(0.0, 1.0);
+	FanCurve_Type Child = Parent;
+
+	for (uint8 &Threshold : Child.Thresholds)
+	{
+		Threshold = (uint8)std::max(1L, std::min(150L, std::lround(Threshold + 5.0 * Step(Generator))));
+	}
+	for (uint8 &Speed : Child.Speeds)
+	{
+		Speed = (uint8)std::max(0L, std::min(100L, std::lround(Speed + 8.0 * Step(Generator))));
+	}
+
+	Repair(Child);
+	return Child;
+}
+
+bool Better(const Candidate &First, const Candidate &Second)
+{
+	return First.Result.Total < Second.Result.Total;
+}
+
+Candidate Optimize(WorkStealingPool &Pool, const FanCurve_Type &Baseline)
+{
+	std::mt19937 Generator(g_options.Seed);
+	std::vector<Candidate> Population(g_options.Population);
+	size_t Elites = std::max<size_t>(1, Population.size() / 4);
+
+	Population[0].Curve = Baseline;
+	for (size_t Index = 1; Index < Population.size(); Index++)
+	{
+		Population[Index].Curve = Mutate(Baseline, Generator);
+	}
+
+	for (int Generation = 0; Generation < g_options.Generations; Generation++)
+	{
+		EvaluateAll(Pool, Population);
+		std::stable_sort(Population.begin(), Population.end(), Better);
+
+		std::printf("generation %3d  best %8.4f  (%.2fC excess, %.3fW, %.1f changes/h)\n", Generation,
+				Population[0].Result.Total, Population[0].Result.Excess_C, Population[0].Result.Fan_W,
+				Population[0].Result.Switches_per_h);
+
+		/* The elites are kept (and evaluated again, the runs are deterministic), the others are replaced */
+		for (size_t Index = Elites; Index < Population.size(); Index++)
+		{
+			Population[Index].Curve = Mutate(Population[Generator() % Elites].Curve, Generator);
+		}
+	}
+
+	EvaluateAll(Pool, Population);
+	std::stable_sort(Population.begin(), Population.end(), Better);
+	return Population[0];
+}
+
+Candidate Sweep(WorkStealingPool &Pool, const FanCurve_Type &Baseline)
+{
+	std::vector<Candidate> Candidates;
+	std::vector<int> Grid;
+
+	for (int Threshold = g_options.Sweep_C; Threshold <= 150; Threshold += g_options.Sweep_C)
+	{
+		Grid.push_back(Threshold);
+	}
+
+	/* Every ascending choice of FAN_CURVE_NUM_OF_THRESHOLDS grid points */
+	std::vector<bool> Mask(Grid.size(), false);
+	std::fill(Mask.begin(), Mask.begin() + std::min<size_t>(FAN_CURVE_NUM_OF_THRESHOLDS, Grid.size()), true);
+	do
+	{
+		Candidate Item;
+		int Level = 0;
+
+		Item.Curve = Baseline;
+		for (size_t Index = 0; Index < Grid.size(); Index++)
+		{
+			if (Mask[Index])
+			{
+				Item.Curve.Thresholds[Level++] = (uint8)Grid[Index];
+			}
+		}
+		Candidates.push_back(Item);
+	} while (std::prev_permutation(Mask.begin(), Mask.end()));
+
+	EvaluateAll(Pool, Candidates);
+	std::printf("swept %zu threshold sets on a %dC grid\n", Candidates.size(), g_options.Sweep_C);
+	return *std::min_element(Candidates.begin(), Candidates.end(), Better);
+}
+
+void MeasureScaling(const FanCurve_Type &Baseline)
+{
+	std::mt19937 Generator(g_options.Seed);
+	std::vector<Candidate> Batch(std::max(64, g_options.Population));
+	unsigned Maximum = (g_options.Threads != 0) ? g_options.Threads : std::max(1u, std::thread::hardware_concurrency());
+	double Single_s = 0.0;
+
+	for (Candidate &Item : Batch)
+	{
+		Item.Curve = Mutate(Baseline, Generator);
+	}
+
+	std::printf("threads  seconds  speedup  efficiency  steals\n");
+	for (unsigned Threads = 1; ; Threads = std::min(Maximum, Threads * 2))
+	{
+		WorkStealingPool Pool(Threads);
+		auto Start = std::chrono::steady_clock::now();
+		double Seconds;
+
+		EvaluateAll(Pool, Batch);
+		Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+		Single_s = (Threads == 1) ? Seconds : Single_s;
+
+		std::printf("%7u  %7.3f  %7.2f  %9.0f%%  %6lu\n", Threads, Seconds, Single_s / Seconds,
+				100.0 * Single_s / Seconds / Threads, Pool.Steals());
+		if (Threads == Maximum)
+		{
+			break;
+		}
+	}
+}
+
+/****************************************************************************************
+ *                                        Outputs                                       *
+ ****************************************************************************************/
+
+std::string CurveText(const FanCurve_Type &Curve)
+{
+	char Text[64];
+
+	std::snprintf(Text, sizeof(Text), "{{%u, %u, %u, %u}, {%u, %u, %u, %u, %u}}", Curve.Thresholds[0],
+			Curve.Thresholds[1], Curve.Thresholds[2], Curve.Thresholds[3], Curve.Speeds[0], Curve.Speeds[1],
+			Curve.Speeds[2], Curve.Speeds[3], Curve.Speeds[4]);
+	return Text;
+}
+
+void WriteHeader(const char *Path, const Candidate &Best)
+{
+	FILE *File = std::fopen(Path, "w");
+	std::time_t Now = std::time(nullptr);
+	char Date[16];
+	std::string Name(Path);
+
+	if (!File)
+	{
+		std::perror(Path);
+		std::exit(1);
+	}
+
+	Name = Name.substr(Name.find_last_of('/') + 1);
+	std::strftime(Date, sizeof(Date), "%d/%m/%Y", std::localtime(&Now));
+
+	std::fprintf(File,
+			"/*******************************************************************************************************************\n"
+			" * File Name: %s\n"
+			" * Date: %s\n"
+			" * Driver: Fan Curve Written by Host_Tools/Curve_Optimizer\n"
+			" * Author: Youssef Zaki\n"
+			" *\n"
+			" * Score %.4f: %.2fC RMS above %.0fC, %.3fW average fan power, %.1f speed changes per hour, max %.1fC.\n"
+			" * Pass it to the build (-include %s) to make it the compiled default curve of Fan_Config.h.\n"
+			" ******************************************************************************************************************/\n"
+			"#ifndef FAN_CURVE_OPTIMIZED_H_\n"
+			"#define FAN_CURVE_OPTIMIZED_H_\n"
+			"\n"
+			"#define FAN_CONFIG_DEFAULT_CURVE                   %s\n"
+			"\n"
+			"#endif /* FAN_CURVE_OPTIMIZED_H_ */\n",
+			Name.c_str(), Date, Best.Result.Total, Best.Result.Excess_C, g_options.Target_C, Best.Result.Fan_W,
+			Best.Result.Switches_per_h, Best.Result.Max_C, Name.c_str(), CurveText(Best.Curve).c_str());
+	std::fclose(File);
+}
+
+/* Intel HEX image of the configuration block, exactly as FanConfig_Save writes it */
+void WriteEeprom(const char *Path, const Candidate &Best)
+{
+	FanConfig_Type Config = {FAN_CONFIG_MAGIC, FAN_CONFIG_VERSION, sizeof(FanConfig_Type),
+			FAN_CONFIG_DEFAULT_SENSOR_CHANNEL, FAN_CONFIG_DEFAULT_ADC_VOLTAGE_REF, FAN_CONFIG_DEFAULT_ADC_PRESCALAR,
+			FAN_CONFIG_DEFAULT_ADC_TRIGGER_SOURCE, FAN_CONFIG_DEFAULT_TIMER0_MODE, FAN_CONFIG_DEFAULT_TIMER0_PRESCALAR,
+			Best.Curve, 0};
+	const uint8_t *Bytes = (const uint8_t *)&Config;
+	FILE *File = std::fopen(Path, "w");
+
+	if (!File)
+	{
+		std::perror(Path);
+		std::exit(1);
+	}
+
+	Config.Crc = CRC16_CCITT_Calculate(Bytes, sizeof(FanConfig_Type) - sizeof(uint16));
+
+	for (size_t Offset = 0; Offset < sizeof(FanConfig_Type); Offset += 16)
+	{
+		size_t Length = std::min<size_t>(16, sizeof(FanConfig_Type) - Offset);
+		unsigned Address = FAN_CONFIG_EEPROM_ADDRESS + Offset;
+		unsigned Sum = Length + (Address >> 8) + (Address & 0xFF);
+
+		std::fprintf(File, ":%02X%04X00", (unsigned)Length, Address);
+		for (size_t Index = 0; Index < Length; Index++)
+		{
+			std::fprintf(File, "%02X", Bytes[Offset + Index]);
+			Sum += Bytes[Offset + Index];
+		}
+		std::fprintf(File, "%02X\n", (unsigned)(-Sum & 0xFF));
+	}
+	std::fprintf(File, ":00000001FF\n");
+	std::fclose(File);
+}
+
+/****************************************************************************************
+ *                                    Option Parsing                                    *
+ ****************************************************************************************/
+
+std::vector<HeatStep> ParseHeat(const char *Text)
+{
+	std::vector<HeatStep> Steps;
+	std::string Remaining(Text);
+
+	while (!Remaining.empty())
+	{
+		size_t Comma = Remaining.find(',');
+		std::string Item = Remaining.substr(0, Comma);
+		double Hours = 0.0;
+		double Watts = 0.0;
+
+		if (std::sscanf(Item.c_str(), "%lf:%lf", &Hours, &Watts) != 2)
+		{
+			std::fprintf(stderr, "bad heat step \"%s\", expected hours:watts\n", Item.c_str());
+			std::exit(1);
+		}
+		Steps.push_back({Hours * 3600.0, Watts});
+		Remaining = (Comma == std::string::npos) ? "" : Remaining.substr(Comma + 1);
+	}
+	return Steps;
+}
+
+void ParseOptions(int Argc, char **Argv)
+{
+	for (int Index = 1; Index < Argc; Index++)
+	{
+		const char *Name = Argv[Index];
+		const char *Value = (Index + 1 < Argc) ? Argv[Index + 1] : "";
+
+		if (!std::strcmp(Name, "--scaling"))
+		{
+			g_options.Scaling = true;
+			continue;
+		}
+
+		Index++;
+		if (!std::strcmp(Name, "--hours")) g_options.Hours = std::atof(Value);
+		else if (!std::strcmp(Name, "--heat")) g_options.Heat = ParseHeat(Value);
+		else if (!std::strcmp(Name, "--trace")) g_options.Trace = Value;
+		else if (ParseThermalPlantOption(Name, Value, &g_options.Plant)) continue;
+		else if (!std::strcmp(Name, "--noise")) g_options.Noise_C = std::atof(Value);
+		else if (!std::strcmp(Name, "--fan-watts")) g_options.Fan_Watts = std::atof(Value);
+		else if (!std::strcmp(Name, "--target")) g_options.Target_C = std::atof(Value);
+		else if (!std::strcmp(Name, "--w-temp")) g_options.W_Temp = std::atof(Value);
+		else if (!std::strcmp(Name, "--w-energy")) g_options.W_Energy = std::atof(Value);
+		else if (!std::strcmp(Name, "--w-switch")) g_options.W_Switch = std::atof(Value);
+		else if (!std::strcmp(Name, "--sample-period")) g_options.Sample_Period_s = std::atof(Value);
+		else if (!std::strcmp(Name, "--population")) g_options.Population = std::max(2, std::atoi(Value));
+		else if (!std::strcmp(Name, "--generations")) g_options.Generations = std::atoi(Value);
+		else if (!std::strcmp(Name, "--seed")) g_options.Seed = (unsigned)std::atol(Value);
+		else if (!std::strcmp(Name, "--sweep")) g_options.Sweep_C = std::max(1, std::atoi(Value));
+		else if (!std::strcmp(Name, "--threads")) g_options.Threads = (unsigned)std::atoi(Value);
+		else if (!std::strcmp(Name, "--header")) g_options.Header = Value;
+		else if (!std::strcmp(Name, "--eeprom")) g_options.Eeprom = Value;
+		else
+		{
+			std::fprintf(stderr, "unknown option %s\n", Name);
+			std::exit(1);
+		}
+	}
+}
+
+void PrintCandidate(const char *Title, const Candidate &Item)
+{
+	std::printf("%-9s %s  score %.4f: %.2fC RMS above %.0fC, %.3fW fan, %.1f changes/h, max %.1fC\n", Title,
+			CurveText(Item.Curve).c_str(), Item.Result.Total, Item.Result.Excess_C, g_options.Target_C,
+			Item.Result.Fan_W, Item.Result.Switches_per_h, Item.Result.Max_C);
+}
+
+} /* namespace */
+
+int main(int Argc, char **Argv)
+{
+	const FanCurve_Type Baseline = FAN_CONFIG_DEFAULT_CURVE;
+	Candidate Initial;
+	Candidate Best;
+	unsigned Threads;
+
+	ParseOptions(Argc, Argv);
+	Threads = (g_options.Threads != 0) ? g_options.Threads : std::max(1u, std::thread::hardware_concurrency());
+
+	g_scenarios.push_back(HeatScenario());
+	if (!g_options.Trace.empty())
+	{
+		g_scenarios.push_back(TraceScenario(g_options.Trace.c_str()));
+	}
+
+	if (g_options.Scaling)
+	{
+		MeasureScaling(Baseline);
+		return 0;
+	}
+
+	WorkStealingPool Pool(Threads);
+	auto Start = std::chrono::steady_clock::now();
+
+	Initial.Curve = Baseline;
+	Initial.Result = Evaluate(Baseline);
+
+	Best = (g_options.Sweep_C != 0) ? Sweep(Pool, Baseline) : Optimize(Pool, Baseline);
+
+	PrintCandidate("default", Initial);
+	PrintCandidate("best", Best);
+	std::printf("%u threads, %.2fs\n", Threads,
+			std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count());
+
+	if (!g_options.Header.empty())
+	{
+		WriteHeader(g_options.Header.c_str(), Best);
+	}
+	if (!g_options.Eeprom.empty())
+	{
+		WriteEeprom(g_options.Eeprom.c_str(), Best);
+	}
+	return 0;
+}
@@ -0,0 +1,515 @@
+/*******************************************************************************************************************
+ * File Name: eeprom_store.cpp
+ * Date: 19/10/2026
+ * Tool: Host-side checks of the data kept in the EEPROM (Fan_Config.c, Temp_History.c)
+ * Author: Youssef Zaki
+ *
+ * The firmware sources are compiled for the host against the register shim of Thermal_Sim and driven directly.
+ * The shim models the EEPROM of the ATmega32 (1024 bytes, erased to 0xFF):
+ *     - setting EERE reads the byte at EEAR into EEDR,
+ *     - setting EEWE (EEMWE must be set) programs EEDR at EEAR, EEWE stays set for EEPROM_WRITE_ACCESSES
+ *       register accesses and the byte is written when it clears (each programmed byte is counted),
+ *     - the EEPROM Ready interrupt is called at a register access while EERIE is set, EEWE is clear and the
+ *       I bit of SREG is set, so the main context keeps running between the bytes of a block write.
+ * Checks:
+ *     fanconfig  FanConfig_Load of an erased EEPROM, of a saved block and of a saved block with each field
+ *                corrupted in turn (magic, version, length, CRC, data, a clock setting of another F_CPU with a
+ *                correct CRC): the compiled defaults must be loaded whenever a check fails. FanConfig_Save is
+ *                refused while a write is in progress, writes the copy taken when it was called (g_FanConfig
+ *                is changed during the write), calls the call back once and programs only the changed bytes.
+ *     history    Temp_History.c fed with one sample per simulated minute (Sys_Time ticks of one minute), with
+ *                over temperature events in some hours: the records stay in RAM till a batch is complete or
+ *                TempHistory_Flush is called, the ring is filled past one full wrap, and after every restart
+ *                (TempHistory_Init with the records not yet written lost, with the head in the middle of the
+ *                ring and right after a wrap) the next record must be written at the head found by the search,
+ *                with the next sequence number. Every slot is compared with the records expected in it.
+ * The tool returns 1 if a check fails.
+ * Build and run on the host:
+ *     for f in EEPROM CRC Fan_Config Sys_Time Temp_History; do gcc -O2 -std=gnu99 -DF_CPU=1000000UL -I../Thermal_Sim/shim \
+ *         -I../../Fan_Controller_Project -c ../../Fan_Controller_Project/$f.c -o $f.o; done
+ *     g++ -O2 -std=c++17 -DF_CPU=1000000UL -I../Thermal_Sim/shim -I../../Fan_Controller_Project eeprom_store.cpp \
+ *         *.o -o eeprom_store
+ *     ./eeprom_store
+ * Options: --only NAME
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+#include "Standard_Types.h"
+#include "CRC.h"
+#include "EEPROM.h"
+#include "Fan_Config.h"
+#include "Sys_Time.h"
+#include "Temp_History.h"
+
+void Shim_Isr_EE_RDY(void);
+}
+
+namespace
+{
+
+/****************************************************************************************
+ *                                      Register Shim                                   *
+ ****************************************************************************************/
+
+uint8_t g_registers8[SHIM_NUM_OF_REGISTERS8];
+uint16_t g_registers16[SHIM_NUM_OF_REGISTERS16];
+
+constexpr uint8_t SREG_I = 0x80;
+
+/* Register accesses while a byte is programmed (8.5ms on the real EEPROM) */
+constexpr unsigned EEPROM_WRITE_ACCESSES = 20;
+
+uint8_t g_eeprom[EEPROM_SIZE];
+unsigned g_writeCountdown = 0;
+unsigned g_programmedBytes = 0;
+unsigned g_writesWithoutMasterEnable = 0;
+bool g_inIsr = false;
+
+/* The effects of the previous access, then an enabled EEPROM Ready interrupt is taken */
+void Service()
+{
+	uint8_t &Eecr = g_registers8[SHIM_EECR];
+	uint16_t Address = g_registers16[SHIM_EEAR] & (EEPROM_SIZE - 1);
+
+	if (Eecr & (1 << EERE))
+	{
+		g_registers8[SHIM_EEDR] = g_eeprom[Address];
+		Eecr &= (uint8_t)~(1 << EERE);
+	}
+
+	if (Eecr & (1 << EEWE))
+	{
+		if (g_writeCountdown == 0)
+		{
+			if (!(Eecr & (1 << EEMWE)))
+			{
+				g_writesWithoutMasterEnable++;
+			}
+			g_writeCountdown = EEPROM_WRITE_ACCESSES;
+		}
+		else if (--g_writeCountdown == 0)
+		{
+			g_eeprom[Address] = g_registers8[SHIM_EEDR];
+			g_programmedBytes++;
+			Eecr &= (uint8_t)~((1 << EEWE) | (1 << EEMWE));
+		}
+	}
+
+	if (!g_inIsr && (g_registers8[SHIM_SREG] & SREG_I) && (Eecr & (1 << EERIE)) && !(Eecr & (1 << EEWE)))
+	{
+		g_inIsr = true;
+		g_registers8[SHIM_SREG] &= (uint8_t)~SREG_I;
+		Shim_Isr_EE_RDY();
+		g_registers8[SHIM_SREG] |= SREG_I;
+		g_inIsr = false;
+	}
+}
+
+} /* namespace */
+
+extern "C" volatile uint8_t *Shim_Register8(Shim_Register8Id Id)
+{
+	Service();
+	return &g_registers8[Id];
+}
+
+extern "C" volatile uint16_t *Shim_Register16(Shim_Register16Id Id)
+{
+	Service();
+	return &g_registers16[Id];
+}
+
+extern "C" void Shim_Sleep(void)
+{
+}
+
+namespace
+{
+
+/****************************************************************************************
+ *                                        Checks                                        *
+ ****************************************************************************************/
+
+unsigned g_failures = 0;
+
+void Check(bool Condition, const char *Scenario, const char *Format, unsigned Value, unsigned Expected)
+{
+	if (!Condition)
+	{
+		g_failures++;
+		std::printf("%-10s FAIL %s: %u, expected %u\n", Scenario, Format, Value, Expected);
+	}
+}
+
+void ResetRegisters()
+{
+	std::memset(g_registers8, 0, sizeof(g_registers8));
+	std::memset(g_registers16, 0, sizeof(g_registers16));
+	std::memset(g_eeprom, EEPROM_ERASED_BYTE, sizeof(g_eeprom));
+	g_writeCountdown = 0;
+	g_programmedBytes = 0;
+	g_writesWithoutMasterEnable = 0;
+	sei();
+}
+
+/* Let the EEPROM Ready interrupt program the block, the main context only polls */
+void WaitWrite()
+{
+	while (EEPROM_IsBusy())
+	{
+	}
+}
+
+/*-------------------------------------------- fanconfig ----------------------------------------------*/
+
+unsigned g_saveCallBacks = 0;
+
+void OnSaveDone()
+{
+	g_saveCallBacks++;
+}
+
+bool ConfigEquals(const FanConfig_Type &A, const FanConfig_Type &B)
+{
+	return std::memcmp(&A, &B, sizeof(FanConfig_Type)) == 0;
+}
+
+/* The stored block with one byte changed, and with the CRC made correct again if required */
+void CorruptAndLoad(const uint8_t *Image, size_t Offset, uint8_t Value, bool Fix_Crc, const char *Field,
+		const FanConfig_Type &Defaults)
+{
+	char Label[64];
+	uint16 Crc;
+	boolean Valid;
+
+	std::memcpy(&g_eeprom[FAN_CONFIG_EEPROM_ADDRESS], Image, sizeof(FanConfig_Type));
+	g_eeprom[FAN_CONFIG_EEPROM_ADDRESS + Offset] = Value;
+	if (Fix_Crc)
+	{
+		Crc = CRC16_CCITT_Calculate(&g_eeprom[FAN_CONFIG_EEPROM_ADDRESS], sizeof(FanConfig_Type) - sizeof(uint16));
+		std::memcpy(&g_eeprom[FAN_CONFIG_EEPROM_ADDRESS + offsetof(FanConfig_Type, Crc)], &Crc, sizeof(Crc));
+	}
+
+	std::memset(&g_FanConfig, 0x55, sizeof(g_FanConfig));
+	Valid = FanConfig_Load();
+
+	std::snprintf(Label, sizeof(Label), "load with a bad %s", Field);
+	Check(!Valid, "fanconfig", Label, Valid, FALSE);
+	std::snprintf(Label, sizeof(Label), "defaults used after a bad %s", Field);
+	Check(ConfigEquals(g_FanConfig, Defaults), "fanconfig", Label, 0, 1);
+}
+
+void RunFanConfig()
+{
+	FanConfig_Type Defaults;
+	FanConfig_Type Saved;
+	uint8_t Image[sizeof(FanConfig_Type)];
+	boolean Result;
+	unsigned Programmed;
+	unsigned Changed_Bytes = 0;
+	unsigned Failures = g_failures;
+
+	ResetRegisters();
+	EEPROM_SetCallBack(OnSaveDone);
+
+	FanConfig_LoadDefaults();
+	Defaults = g_FanConfig;
+
+	/* Erased EEPROM */
+	std::memset(&g_FanConfig, 0, sizeof(g_FanConfig));
+	Result = FanConfig_Load();
+	Check(!Result, "fanconfig", "load of an erased EEPROM", Result, FALSE);
+	Check(ConfigEquals(g_FanConfig, Defaults), "fanconfig", "defaults used for an erased EEPROM", 0, 1);
+
+	/* Save a changed curve, the block is written from the copy taken by FanConfig_Save */
+	g_FanConfig.Curve.Thresholds[0] = 35;
+	g_FanConfig.Curve.Speeds[4] = 90;
+	g_saveCallBacks = 0;
+	Result = FanConfig_Save();
+	Saved = g_FanConfig;
+	Check(Result, "fanconfig", "save accepted", Result, TRUE);
+	Check(EEPROM_IsBusy(), "fanconfig", "write in progress after the save", EEPROM_IsBusy(), TRUE);
+
+	Result = FanConfig_Save();
+	Check(!Result, "fanconfig", "second save refused while busy", Result, FALSE);
+
+	g_FanConfig.Curve.Speeds[1] = 99;
+	WaitWrite();
+	Check(g_saveCallBacks == 1, "fanconfig", "call backs at the end of the write", g_saveCallBacks, 1);
+	Check(g_writesWithoutMasterEnable == 0, "fanconfig", "EEWE set without EEMWE", g_writesWithoutMasterEnable, 0);
+
+	for (size_t i = 0; i < sizeof(FanConfig_Type); i++)
+	{
+		Changed_Bytes += (((const uint8_t *)&Saved)[i] != EEPROM_ERASED_BYTE) ? 1 : 0;
+	}
+	Check(g_programmedBytes == Changed_Bytes, "fanconfig", "bytes programmed by the first save", g_programmedBytes, Changed_Bytes);
+
+	std::memset(&g_FanConfig, 0, sizeof(g_FanConfig));
+	Result = FanConfig_Load();
+	Check(Result, "fanconfig", "load of the saved block", Result, TRUE);
+	Check(ConfigEquals(g_FanConfig, Saved), "fanconfig", "saved block loaded as it was when saved", 0, 1);
+
+	/* Saving the same block again programs nothing */
+	Programmed = g_programmedBytes;
+	FanConfig_Save();
+	WaitWrite();
+	Check(g_programmedBytes == Programmed, "fanconfig", "bytes programmed by an unchanged save", g_programmedBytes - Programmed, 0);
+
+	/* Each field corrupted in turn */
+	std::memcpy(Image, &g_eeprom[FAN_CONFIG_EEPROM_ADDRESS], sizeof(Image));
+	CorruptAndLoad(Image, offsetof(FanConfig_Type, Magic), FAN_CONFIG_MAGIC ^ 0x01, true, "magic", Defaults);
+	CorruptAndLoad(Image, offsetof(FanConfig_Type, Version), FAN_CONFIG_VERSION + 1, true, "version", Defaults);
+	CorruptAndLoad(Image, offsetof(FanConfig_Type, Length), sizeof(FanConfig_Type) - 1, true, "length", Defaults);
+	CorruptAndLoad(Image, offsetof(FanConfig_Type, Crc), Image[offsetof(FanConfig_Type, Crc)] ^ 0x80, false, "CRC", Defaults);
+	CorruptAndLoad(Image, offsetof(FanConfig_Type, Curve), Image[offsetof(FanConfig_Type, Curve)] + 1, false, "curve byte", Defaults);
+	CorruptAndLoad(Image, offsetof(FanConfig_Type, Adc_Prescalar), CLK_4, true, "ADC prescaler", Defaults);
+	CorruptAndLoad(Image, offsetof(FanConfig_Type, Timer0_Prescalar), Image[offsetof(FanConfig_Type, Timer0_Prescalar)] + 1,
+			true, "Timer0 prescaler", Defaults);
+
+	/* The intact block is still accepted */
+	std::memcpy(&g_eeprom[FAN_CONFIG_EEPROM_ADDRESS], Image, sizeof(Image));
+	Result = FanConfig_Load();
+	Check(Result && ConfigEquals(g_FanConfig, Saved), "fanconfig", "load of the intact block", Result, TRUE);
+
+	std::printf("%-10s %s\n", "fanconfig", (g_failures != Failures) ? "errors" : "ok");
+}
+
+/*--------------------------------------------- history -----------------------------------------------*/
+
+constexpr uint8 HISTORY_LIMIT = 60;
+
+/* Records expected in the ring (index = sequence number) and records still in the RAM of the firmware */
+std::vector<TempHistory_RecordType> g_written;
+std::vector<TempHistory_RecordType> g_queued;
+unsigned g_hour = 0;
+
+void QueueRecord(uint8 Type, uint8 Data0, uint8 Data1, uint8 Data2, uint8 Data3)
+{
+	TempHistory_RecordType Record;
+
+	Record.Sequence = (uint16)(g_written.size() + g_queued.size());
+	Record.Type = Type;
+	Record.Data[0] = Data0;
+	Record.Data[1] = Data1;
+	Record.Data[2] = Data2;
+	Record.Data[3] = Data3;
+	Record.Crc = CRC8_MAXIM_Calculate((const uint8 *)&Record, sizeof(Record) - 1);
+	g_queued.push_back(Record);
+
+	if (g_queued.size() == TEMP_HISTORY_BATCH_SIZE)
+	{
+		g_written.insert(g_written.end(), g_queued.begin(), g_queued.end());
+		g_queued.clear();
+	}
+}
+
+/* One pass of the main loop: the task, then the EEPROM Ready interrupt programs what it started */
+void HistoryTask()
+{
+	TempHistory_Task();
+	WaitWrite();
+}
+
+/*
+ * One sample per minute. Every hour has its own minimum, maximum and mean, and every tenth hour an
+ * over temperature event from minute 10 to minute 21.
+ */
+void RunHours(unsigned Hours)
+{
+	for (unsigned h = 0; h < Hours; h++, g_hour++)
+	{
+		unsigned Minimum = 0xFF;
+		unsigned Maximum = 0;
+		unsigned Sum = 0;
+		unsigned Events = 0;
+
+		for (unsigned m = 0; m < 60; m++)
+		{
+			unsigned Temperature = 25 + (g_hour % 7) + (m % 3);
+			bool Event = (g_hour % 10) == 3;
+
+			if (Event && (m >= 10) && (m <= 20))
+			{
+				Temperature = HISTORY_LIMIT + 2;
+			}
+
+			HistoryTask();
+			TempHistory_AddSample((uint8)Temperature);
+			SysTime_Tick();
+
+			if (Event && (m == 21))
+			{
+				/* Peak, duration in minutes, start minute */
+				QueueRecord(TEMP_HISTORY_RECORD_OVER_TEMPERATURE, HISTORY_LIMIT + 2, 11, 10, 0);
+				Events++;
+			}
+
+			Minimum = (Temperature < Minimum) ? Temperature : Minimum;
+			Maximum = (Temperature > Maximum) ? Temperature : Maximum;
+			Sum += Temperature;
+		}
+
+		/* The hour is closed by the task at the start of the next one */
+		HistoryTask();
+		QueueRecord(TEMP_HISTORY_RECORD_HOURLY, (uint8)Minimum, (uint8)Maximum, (uint8)(Sum / 60), (uint8)Events);
+	}
+
+	/* The rest of a batch which crossed the end of the ring */
+	HistoryTask();
+}
+
+void Flush()
+{
+	TempHistory_Flush();
+	HistoryTask();
+	HistoryTask();
+
+	g_written.insert(g_written.end(), g_queued.begin(), g_queued.end());
+	g_queued.clear();
+}
+
+/* Power cycle: the time restarts and the records not yet written are lost */
+void Restart()
+{
+	SysTime_Init(60000000UL);
+	TempHistory_Init(HISTORY_LIMIT);
+	g_queued.clear();
+}
+
+/* Every slot holds the newest record written to it, or is still erased */
+void CheckRing(const char *Label)
+{
+	char Text[96];
+	unsigned Mismatches = 0;
+	unsigned First_Mismatch = 0;
+
+	for (unsigned Slot = 0; Slot < TEMP_HISTORY_NUM_OF_SLOTS; Slot++)
+	{
+		const uint8_t *Stored = &g_eeprom[TEMP_HISTORY_EEPROM_START + (Slot * TEMP_HISTORY_RECORD_SIZE)];
+		uint8_t Expected[TEMP_HISTORY_RECORD_SIZE];
+		size_t Newest = Slot;
+
+		std::memset(Expected, EEPROM_ERASED_BYTE, sizeof(Expected));
+		if (Slot < g_written.size())
+		{
+			while (Newest + TEMP_HISTORY_NUM_OF_SLOTS < g_written.size())
+			{
+				Newest += TEMP_HISTORY_NUM_OF_SLOTS;
+			}
+			std::memcpy(Expected, &g_written[Newest], sizeof(Expected));
+		}
+
+		if (std::memcmp(Stored, Expected, sizeof(Expected)) != 0)
+		{
+			First_Mismatch = (Mismatches == 0) ? Slot : First_Mismatch;
+			Mismatches++;
+		}
+	}
+
+	std::snprintf(Text, sizeof(Text), "slots different from the expected records %s (first slot %u)", Label, First_Mismatch);
+	Check(Mismatches == 0, "history", Text, Mismatches, 0);
+}
+
+void RunHistory()
+{
+	unsigned Failures = g_failures;
+	unsigned Programmed;
+	size_t Written;
+	TempHistory_RecordType Stored;
+
+	ResetRegisters();
+	g_written.clear();
+	g_queued.clear();
+	g_hour = 0;
+	Restart();
+
+	/* Less than a batch stays in RAM till it is flushed */
+	RunHours(3);
+	Check(g_programmedBytes == 0, "history", "bytes programmed before a complete batch", g_programmedBytes, 0);
+	Flush();
+	CheckRing("after the first flush");
+
+	/* Complete batches are written without a flush; fill the ring past one full wrap */
+	Programmed = g_programmedBytes;
+	Written = g_written.size();
+	while (g_written.size() == Written)
+	{
+		RunHours(1);
+	}
+	Check(g_programmedBytes > Programmed, "history", "bytes programmed by a complete batch", g_programmedBytes - Programmed, 1);
+	CheckRing("after a complete batch");
+	RunHours(TEMP_HISTORY_NUM_OF_SLOTS + 20);
+	Flush();
+	Check(g_written.size() > TEMP_HISTORY_NUM_OF_SLOTS, "history", "records written", g_written.size(), TEMP_HISTORY_NUM_OF_SLOTS + 1);
+	CheckRing("after a full wrap");
+
+	/* Restart with the head in the middle of the ring */
+	Restart();
+	RunHours(1);
+	Flush();
+	CheckRing("after a restart");
+
+	/* Restart with records in RAM: they are lost and the sequence continues after the last written one */
+	RunHours(2);
+	Restart();
+	RunHours(1);
+	Flush();
+	CheckRing("after a restart with records lost");
+
+	/* Restart right after the ring wrapped: the next record goes to slot 0 */
+	while ((g_written.size() % TEMP_HISTORY_NUM_OF_SLOTS) != 0)
+	{
+		RunHours(1);
+		Flush();
+	}
+	Restart();
+	RunHours(1);
+	Flush();
+	CheckRing("after a restart at the end of the ring");
+
+	std::memcpy(&Stored, &g_eeprom[TEMP_HISTORY_EEPROM_START], sizeof(Stored));
+	Check(TempHistory_IsRecordValid(&Stored) && (Stored.Sequence == g_written.size() - 1), "history",
+			"sequence of the record in slot 0 after the wrap", Stored.Sequence, g_written.size() - 1);
+	Check(g_writesWithoutMasterEnable == 0, "history", "EEWE set without EEMWE", g_writesWithoutMasterEnable, 0);
+
+	std::printf("%-10s %s\n", "history", (g_failures != Failures) ? "errors" : "ok");
+}
+
+} /* namespace */
+
+int main(int argc, char **argv)
+{
+	std::string Only;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ((std::strcmp(argv[i], "--only") == 0) && (i + 1 < argc))
+		{
+			Only = argv[++i];
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--only fanconfig|history]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	if (Only.empty() || (Only == "fanconfig"))
+	{
+		RunFanConfig();
+	}
+	if (Only.empty() || (Only == "history"))
+	{
+		RunHistory();
+	}
+
+	return g_failures ? 1 : 0;
+}
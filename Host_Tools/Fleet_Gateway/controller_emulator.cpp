@@ -0,0 +1,525 @@
+/*******************************************************************************************************************
+ * File Name: controller_emulator.cpp
+ * Date: 19/10/2026
+ * Tool: Load generator of Fleet_Gateway: N emulated fan controllers answering Modbus RTU polls
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "controller_emulator.h"
+#include "fleet_protocol.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace
+{
+
+enum Scenario
+{
+	SCENARIO_NORMAL, SCENARIO_OVER_TEMPERATURE, SCENARIO_STALL, SCENARIO_SENSOR_FAULT, SCENARIO_SILENT,
+	NUM_OF_SCENARIOS
+};
+
+constexpr double PI = 3.14159265358979;
+constexpr int MAX_EVENTS = 64;
+
+void Fail(const char *What)
+{
+	std::perror(What);
+	std::exit(1);
+}
+
+void SetNonBlocking(int Fd)
+{
+	fcntl(Fd, F_SETFL, fcntl(Fd, F_GETFL) | O_NONBLOCK);
+}
+
+} /* namespace */
+
+/****************************************************************************************
+ *                                   Emulated Controllers                               *
+ ****************************************************************************************/
+
+struct ControllerEmulator::Controller
+{
+	int Scenario;
+	double Base_C;
+	double Period_s;
+	double Phase;
+	uint16_t Frames_Ok;
+	uint16_t Frame_Errors;
+	std::mt19937 Noise;
+};
+
+/* A listening socket, an accepted TCP connection or the master side of a pseudo terminal */
+struct ControllerEmulator::Connection
+{
+	int Fd = -1;
+	int Link = 0;
+	bool Listener = false;
+	std::vector<uint8_t> In;
+	std::vector<uint8_t> Out;
+	int Pty_Slave_Fd = -1;
+	uint16_t Port = 0;
+	std::string Path;
+};
+
+struct ControllerEmulator::Shard
+{
+	int Epoll_Fd = -1;
+	int Stop_Fd = -1;
+	std::vector<std::unique_ptr<Connection>> Peers;
+	std::atomic<uint64_t> Requests{0};
+	std::atomic<uint64_t> Dropped{0};
+};
+
+ControllerEmulator::ControllerEmulator(const EmulatorOptions &Options) : m_options(Options)
+{
+	std::mt19937 Generator(Options.Seed);
+	std::uniform_real_distribution<double> Uniform(0.0, 1.0);
+	int Num_Of_Controllers = Options.Links * Options.Slaves;
+	int Faulty = (int)std::lround(Num_Of_Controllers * Options.Fault_Percent / 100.0);
+	int Next_Fault = 0;
+
+	m_start_ns = MonotonicNs();
+
+	/* The faulty controllers are spread over the links, their scenarios in turn */
+	for (int Index = 0; Index < Num_Of_Controllers; Index++)
+	{
+		Controller Emulated;
+		bool Is_Faulty = (Faulty > 0) && ((long)Index * Faulty / Num_Of_Controllers != (long)(Index + 1) * Faulty / Num_Of_Controllers);
+
+		Emulated.Scenario = SCENARIO_NORMAL;
+		if (Is_Faulty)
+		{
+			Emulated.Scenario = 1 + (Next_Fault++ % (NUM_OF_SCENARIOS - 1));
+		}
+		Emulated.Base_C = 28.0 + 17.0 * Uniform(Generator);
+		Emulated.Period_s = 60.0 + 240.0 * Uniform(Generator);
+		Emulated.Phase = 2.0 * PI * Uniform(Generator);
+		Emulated.Frames_Ok = 0;
+		Emulated.Frame_Errors = 0;
+		Emulated.Noise.seed(Generator());
+		m_controllers.push_back(Emulated);
+	}
+
+	for (int Link = 0; Link < Options.Links; Link++)
+	{
+		std::unique_ptr<Connection> Endpoint(new Connection);
+
+		Endpoint -> Link = Link;
+		if (Options.Pty_Prefix.empty())
+		{
+			struct sockaddr_in Address = {};
+			socklen_t Address_Length = sizeof(Address);
+			int Reuse = 1;
+
+			Endpoint -> Fd = socket(AF_INET, SOCK_STREAM, 0);
+			setsockopt(Endpoint -> Fd, SOL_SOCKET, SO_REUSEADDR, &Reuse, sizeof(Reuse));
+			Address.sin_family = AF_INET;
+			Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			Address.sin_port = htons((uint16_t)(Options.Base_Port ? Options.Base_Port + Link : 0));
+			if (bind(Endpoint -> Fd, (struct sockaddr *)&Address, sizeof(Address)) || listen(Endpoint -> Fd, 16))
+			{
+				Fail("emulator listening socket");
+			}
+			getsockname(Endpoint -> Fd, (struct sockaddr *)&Address, &Address_Length);
+			Endpoint -> Port = ntohs(Address.sin_port);
+			Endpoint -> Listener = true;
+		}
+		else
+		{
+			struct termios Settings;
+
+			Endpoint -> Fd = posix_openpt(O_RDWR | O_NOCTTY);
+			if ((Endpoint -> Fd < 0) || grantpt(Endpoint -> Fd) || unlockpt(Endpoint -> Fd))
+			{
+				Fail("pseudo terminal");
+			}
+
+			/* The slave side stays open and raw, as in Thermal_Sim */
+			Endpoint -> Pty_Slave_Fd = open(ptsname(Endpoint -> Fd), O_RDWR | O_NOCTTY);
+			tcgetattr(Endpoint -> Pty_Slave_Fd, &Settings);
+			cfmakeraw(&Settings);
+			tcsetattr(Endpoint -> Pty_Slave_Fd, TCSANOW, &Settings);
+
+			Endpoint -> Path = Options.Pty_Prefix + std::to_string(Link);
+			unlink(Endpoint -> Path.c_str());
+			if (symlink(ptsname(Endpoint -> Fd), Endpoint -> Path.c_str()))
+			{
+				Fail(Endpoint -> Path.c_str());
+			}
+		}
+		SetNonBlocking(Endpoint -> Fd);
+		m_links.push_back(std::move(Endpoint));
+	}
+
+	for (unsigned Index = 0; Index < std::max(1u, Options.Threads); Index++)
+	{
+		std::unique_ptr<Shard> Own(new Shard);
+		struct epoll_event Event = {};
+
+		Own -> Epoll_Fd = epoll_create1(0);
+		Own -> Stop_Fd = eventfd(0, EFD_NONBLOCK);
+		Event.events = EPOLLIN;
+		Event.data.ptr = nullptr;
+		epoll_ctl(Own -> Epoll_Fd, EPOLL_CTL_ADD, Own -> Stop_Fd, &Event);
+		m_shards.push_back(std::move(Own));
+	}
+
+	for (size_t Link = 0; Link < m_links.size(); Link++)
+	{
+		struct epoll_event Event = {};
+
+		Event.events = EPOLLIN;
+		Event.data.ptr = m_links[Link].get();
+		epoll_ctl(m_shards[Link % m_shards.size()] -> Epoll_Fd, EPOLL_CTL_ADD, m_links[Link] -> Fd, &Event);
+	}
+
+	for (std::unique_ptr<Shard> &Own : m_shards)
+	{
+		m_threads.emplace_back(&ControllerEmulator::Serve, this, std::ref(*Own));
+	}
+}
+
+ControllerEmulator::~ControllerEmulator()
+{
+	uint64_t One = 1;
+
+	m_stop = true;
+	for (std::unique_ptr<Shard> &Own : m_shards)
+	{
+		if (write(Own -> Stop_Fd, &One, sizeof(One)) != sizeof(One))
+		{
+			std::perror("emulator stop");
+		}
+	}
+	for (std::thread &Thread : m_threads)
+	{
+		Thread.join();
+	}
+
+	for (std::unique_ptr<Shard> &Own : m_shards)
+	{
+		for (std::unique_ptr<Connection> &Peer : Own -> Peers)
+		{
+			close(Peer -> Fd);
+		}
+		close(Own -> Stop_Fd);
+		close(Own -> Epoll_Fd);
+	}
+	for (std::unique_ptr<Connection> &Endpoint : m_links)
+	{
+		close(Endpoint -> Fd);
+		if (Endpoint -> Pty_Slave_Fd >= 0)
+		{
+			close(Endpoint -> Pty_Slave_Fd);
+			unlink(Endpoint -> Path.c_str());
+		}
+	}
+}
+
+std::vector<std::string> ControllerEmulator::Endpoints() const
+{
+	std::vector<std::string> Endpoints;
+	std::string Addresses = "@1-" + std::to_string(m_options.Slaves);
+
+	for (const std::unique_ptr<Connection> &Endpoint : m_links)
+	{
+		Endpoints.push_back((Endpoint -> Listener ? "tcp:127.0.0.1:" + std::to_string(Endpoint -> Port) : Endpoint -> Path) + Addresses);
+	}
+	return Endpoints;
+}
+
+uint64_t ControllerEmulator::Requests() const
+{
+	uint64_t Requests = 0;
+
+	for (const std::unique_ptr<Shard> &Own : m_shards)
+	{
+		Requests += Own -> Requests.load(std::memory_order_relaxed);
+	}
+	return Requests;
+}
+
+std::vector<int> ControllerEmulator::ScenarioCounts() const
+{
+	std::vector<int> Counts(NUM_OF_SCENARIOS, 0);
+
+	for (const Controller &Emulated : m_controllers)
+	{
+		Counts[Emulated.Scenario]++;
+	}
+	return Counts;
+}
+
+/****************************************************************************************
+ *                                       Registers                                      *
+ ****************************************************************************************/
+
+void ControllerEmulator::FillRegisters(Controller &Emulated, uint16_t *Registers)
+{
+	static const FanCurve_Type Curve = FAN_CONFIG_DEFAULT_CURVE;
+	double Time_s = (MonotonicNs() - m_start_ns) / 1e9;
+	double Temperature = Emulated.Base_C + 6.0 * std::sin(2.0 * PI * Time_s / Emulated.Period_s + Emulated.Phase) +
+			std::uniform_real_distribution<double>(-0.5, 0.5)(Emulated.Noise);
+	double Winding_mA = 250.0;
+	uint16_t Flags = 0;
+	uint16_t Duty;
+	uint8_t Reading;
+	uint32_t Uptime = (uint32_t)Time_s;
+
+	if (Emulated.Scenario == SCENARIO_OVER_TEMPERATURE)
+	{
+		double Cycle_s = std::fmod(Time_s, 80.0);
+
+		Temperature = Emulated.Base_C + 1.5 * ((Cycle_s < 40.0) ? Cycle_s : (80.0 - Cycle_s));
+	}
+
+	Reading = (uint8_t)std::lround(std::min(255.0, std::max(0.0, Temperature)));
+	Duty = (uint16_t)(FanCurve_GetSpeed(&Curve, Reading) * 10);
+
+	if (Emulated.Scenario == SCENARIO_STALL)
+	{
+		double Cycle_s = std::fmod(Time_s, 30.0);
+
+		if (Cycle_s < 5.0)
+		{
+			/* Locked rotor, at least the first speed of the curve */
+			Duty = std::max<uint16_t>(Duty, 250);
+			Winding_mA = 1000.0;
+		}
+		else if (Cycle_s < 10.0)
+		{
+			Duty = 0;
+			Flags |= MODBUS_FAULT_CURRENT_CUTOFF;
+		}
+	}
+	if ((Emulated.Scenario == SCENARIO_SENSOR_FAULT) && (std::fmod(Time_s, 20.0) < 8.0))
+	{
+		Reading = 0;
+	}
+
+	std::memset(Registers, 0, FLEET_POLL_REGISTERS * sizeof(uint16_t));
+	Registers[MODBUS_INPUT_TEMPERATURE] = Reading;
+	Registers[MODBUS_INPUT_DUTY] = Duty;
+	Registers[MODBUS_INPUT_FAN_RPM] = 0xFFFF;
+	Registers[MODBUS_INPUT_FAULT_FLAGS] = Flags;
+	Registers[MODBUS_INPUT_CURVE_LEVEL] = FanCurve_GetLevel(&Curve, Reading);
+	Registers[MODBUS_INPUT_CURRENT_AVERAGE] = (uint16_t)(Winding_mA * Duty / 1000.0);
+	Registers[MODBUS_INPUT_CURRENT_PEAK] = (uint16_t)((Duty > 0) ? Winding_mA : 0.0);
+	Registers[MODBUS_INPUT_UPTIME_HIGH] = (uint16_t)(Uptime >> 16);
+	Registers[MODBUS_INPUT_UPTIME_LOW] = (uint16_t)Uptime;
+	for (int Window = 0; Window < 3; Window++)
+	{
+		Registers[MODBUS_INPUT_STATS_FIRST + 3 * Window] = (uint16_t)std::max(0, Reading - 1 - Window);
+		Registers[MODBUS_INPUT_STATS_FIRST + 3 * Window + 1] = (uint16_t)(Reading + 1 + Window);
+		Registers[MODBUS_INPUT_STATS_FIRST + 3 * Window + 2] = Reading;
+	}
+	Registers[MODBUS_INPUT_FRAMES_OK] = Emulated.Frames_Ok;
+	Registers[MODBUS_INPUT_FRAME_ERRORS] = Emulated.Frame_Errors;
+}
+
+/* Build the answer of a complete request of a link, return its length (0: no answer) */
+size_t ControllerEmulator::Answer(const uint8_t *Request, size_t Length, int Link, uint8_t *Response)
+{
+	static const FanCurve_Type Curve = FAN_CONFIG_DEFAULT_CURVE;
+	uint8_t Address = Request[0];
+	uint16_t Registers[FLEET_POLL_REGISTERS];
+	uint16_t Start = GetWord(&Request[2]);
+	uint16_t Count = GetWord(&Request[4]);
+	uint16_t Num_Of_Registers = (Request[1] == FLEET_READ_INPUT_REGISTERS) ? MODBUS_NUM_OF_INPUT_REGISTERS : MODBUS_NUM_OF_HOLDING_REGISTERS;
+	uint8_t Exception = 0;
+
+	if ((Address == 0) || (Address > m_options.Slaves))
+	{
+		return 0;
+	}
+
+	Controller &Emulated = m_controllers[(size_t)Link * m_options.Slaves + Address - 1];
+
+	if (!CrcValid(Request, Length))
+	{
+		Emulated.Frame_Errors++;
+		return 0;
+	}
+	Emulated.Frames_Ok++;
+	if (Emulated.Scenario == SCENARIO_SILENT)
+	{
+		return 0;
+	}
+
+	Response[0] = Address;
+	Response[1] = Request[1];
+	if ((Request[1] != FLEET_READ_INPUT_REGISTERS) && (Request[1] != FLEET_READ_HOLDING_REGISTERS))
+	{
+		Exception = 0x01;
+	}
+	else if ((Count == 0) || (Count > MODBUS_MAX_REGISTERS))
+	{
+		Exception = 0x03;
+	}
+	else if ((Start >= Num_Of_Registers) || (Count > Num_Of_Registers - Start))
+	{
+		Exception = 0x02;
+	}
+
+	if (Exception != 0)
+	{
+		Response[1] |= 0x80;
+		Response[2] = Exception;
+		return AppendCrc(Response, 3);
+	}
+
+	if (Request[1] == FLEET_READ_INPUT_REGISTERS)
+	{
+		FillRegisters(Emulated, Registers);
+	}
+	else
+	{
+		for (int Index = 0; Index < FAN_CURVE_NUM_OF_THRESHOLDS; Index++)
+		{
+			Registers[MODBUS_HOLDING_THRESHOLDS_FIRST + Index] = Curve.Thresholds[Index];
+		}
+		for (int Index = 0; Index < FAN_CURVE_NUM_OF_LEVELS; Index++)
+		{
+			Registers[MODBUS_HOLDING_SPEEDS_FIRST + Index] = Curve.Speeds[Index];
+		}
+		Registers[MODBUS_HOLDING_SAVE] = 0;
+	}
+
+	Response[2] = (uint8_t)(Count * 2);
+	for (uint16_t Index = 0; Index < Count; Index++)
+	{
+		PutWord(&Response[3 + 2 * Index], Registers[Start + Index]);
+	}
+	return AppendCrc(Response, 3 + 2 * Count);
+}
+
+/****************************************************************************************
+ *                                         Links                                        *
+ ****************************************************************************************/
+
+void ControllerEmulator::Accept(Shard &Own, Connection &Listener)
+{
+	int Fd;
+
+	while ((Fd = accept(Listener.Fd, nullptr, nullptr)) >= 0)
+	{
+		std::unique_ptr<Connection> Peer(new Connection);
+		struct epoll_event Event = {};
+		int No_Delay = 1;
+
+		setsockopt(Fd, IPPROTO_TCP, TCP_NODELAY, &No_Delay, sizeof(No_Delay));
+		SetNonBlocking(Fd);
+		Peer -> Fd = Fd;
+		Peer -> Link = Listener.Link;
+		Event.events = EPOLLIN;
+		Event.data.ptr = Peer.get();
+		epoll_ctl(Own.Epoll_Fd, EPOLL_CTL_ADD, Fd, &Event);
+		Own.Peers.push_back(std::move(Peer));
+	}
+}
+
+void ControllerEmulator::Receive(Shard &Own, Connection &Peer)
+{
+	uint8_t Buffer[4096];
+	ssize_t Length;
+
+	while ((Length = read(Peer.Fd, Buffer, sizeof(Buffer))) > 0)
+	{
+		Peer.In.insert(Peer.In.end(), Buffer, Buffer + Length);
+	}
+	if ((Length == 0) && (Peer.Pty_Slave_Fd < 0))
+	{
+		/* Closed by the gateway: forget the connection */
+		epoll_ctl(Own.Epoll_Fd, EPOLL_CTL_DEL, Peer.Fd, nullptr);
+		close(Peer.Fd);
+		for (std::unique_ptr<Connection> &Other : Own.Peers)
+		{
+			if (Other.get() == &Peer)
+			{
+				std::swap(Other, Own.Peers.back());
+				Own.Peers.pop_back();
+				break;
+			}
+		}
+		return;
+	}
+
+	/* Every complete request in the buffer, an impossible length drops the buffer (resynchronization) */
+	size_t Used = 0;
+
+	while (Used < Peer.In.size())
+	{
+		size_t Needed = RequestLength(&Peer.In[Used], Peer.In.size() - Used);
+		uint8_t Response[FLEET_MAX_FRAME];
+		size_t Response_Length;
+
+		if ((Needed == 0) || (Needed > FLEET_MAX_FRAME))
+		{
+			Used = (Needed > FLEET_MAX_FRAME) ? Peer.In.size() : Used;
+			break;
+		}
+		if (Peer.In.size() - Used < Needed)
+		{
+			break;
+		}
+
+		Response_Length = Answer(&Peer.In[Used], Needed, Peer.Link, Response);
+		Used += Needed;
+		Own.Requests.fetch_add(1, std::memory_order_relaxed);
+		if (Response_Length > 0)
+		{
+			Peer.Out.insert(Peer.Out.end(), Response, Response + Response_Length);
+		}
+	}
+	Peer.In.erase(Peer.In.begin(), Peer.In.begin() + Used);
+
+	/* The answers are small, a full socket buffer only drops them (the gateway times out) */
+	if (!Peer.Out.empty() && (write(Peer.Fd, Peer.Out.data(), Peer.Out.size()) != (ssize_t)Peer.Out.size()))
+	{
+		Own.Dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+	Peer.Out.clear();
+}
+
+void ControllerEmulator::Serve(Shard &Own)
+{
+	struct epoll_event Events[MAX_EVENTS];
+
+	while (!m_stop.load(std::memory_order_relaxed))
+	{
+		int Count = epoll_wait(Own.Epoll_Fd, Events, MAX_EVENTS, -1);
+
+		for (int Index = 0; Index < Count; Index++)
+		{
+			Connection *Peer = (Connection *)Events[Index].data.ptr;
+
+			if (Peer == nullptr)
+			{
+				return;
+			}
+			if (Peer -> Listener)
+			{
+				Accept(Own, *Peer);
+			}
+			else
+			{
+				Receive(Own, *Peer);
+			}
+		}
+	}
+}
@@ -0,0 +1,76 @@
+/*******************************************************************************************************************
+ * File Name: controller_emulator.h
+ * Date: 19/10/2026
+ * Tool: Load generator of Fleet_Gateway: N emulated fan controllers answering Modbus RTU polls
+ * Author: Youssef Zaki
+ *
+ * Every link is a TCP listening socket on 127.0.0.1 (or a pseudo terminal) with Slaves controllers behind it,
+ * addresses 1..Slaves, as on an RS-485 bus. A controller answers the functions 03 and 04 with the register map
+ * of Modbus_Slave.h (other functions: exception 01, other addresses: no answer, like the firmware), its
+ * temperature follows a slow cycle around its own base and its duty cycle is FanCurve_GetSpeed of the firmware
+ * with the default curve. Fault_Percent of the controllers run a fault scenario, in turn:
+ *     over temperature  the temperature climbs 1.5C/s from the base for 40s, then drops back (alert and clear)
+ *     stall             5s of locked rotor (drive current of 1A), then 5s cut off (fault flag), then 20s normal
+ *     sensor fault      the temperature reads 0C (open LM35) 8s out of 20s
+ *     silent            never answers (dead controller or cable)
+ * The links are shared between Threads threads, each with its own epoll set; the answers are sent at once
+ * (no line time), so the emulator can saturate the gateway.
+ ******************************************************************************************************************/
+#ifndef CONTROLLER_EMULATOR_H_
+#define CONTROLLER_EMULATOR_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct EmulatorOptions
+{
+	int Links = 64;
+	int Slaves = 4;
+	int Base_Port = 0;            /* TCP ports Base_Port, Base_Port + 1 ..., 0 for ports given by the system */
+	std::string Pty_Prefix;       /* pseudo terminals (symbolic links Prefix0, Prefix1 ...) instead of TCP */
+	double Fault_Percent = 10.0;
+	unsigned Threads = 1;
+	unsigned Seed = 1;
+};
+
+class ControllerEmulator
+{
+public:
+	explicit ControllerEmulator(const EmulatorOptions &Options);
+	~ControllerEmulator();
+
+	ControllerEmulator(const ControllerEmulator &) = delete;
+	ControllerEmulator &operator=(const ControllerEmulator &) = delete;
+
+	/* Endpoints of the links for the gateway ("tcp:127.0.0.1:<port>@1-<Slaves>" or "<pty link>@1-<Slaves>") */
+	std::vector<std::string> Endpoints() const;
+
+	/* Requests answered since the start, and the number of controllers of each scenario */
+	uint64_t Requests() const;
+	std::vector<int> ScenarioCounts() const;
+
+private:
+	struct Controller;
+	struct Connection;
+	struct Shard;
+
+	void Serve(Shard &Own);
+	void Accept(Shard &Own, Connection &Listener);
+	void Receive(Shard &Own, Connection &Peer);
+	size_t Answer(const uint8_t *Request, size_t Length, int Link, uint8_t *Response);
+	void FillRegisters(Controller &Emulated, uint16_t *Registers);
+
+	EmulatorOptions m_options;
+	std::vector<Controller> m_controllers;
+	std::vector<std::unique_ptr<Connection>> m_links;
+	std::vector<std::unique_ptr<Shard>> m_shards;
+	std::vector<std::thread> m_threads;
+	std::atomic<bool> m_stop{false};
+	int64_t m_start_ns;
+};
+
+#endif /* CONTROLLER_EMULATOR_H_ */
@@ -0,0 +1,1188 @@
+/*******************************************************************************************************************
+ * File Name: fleet_gateway.cpp
+ * Date: 19/10/2026
+ * Tool: Host-side gateway polling a fleet of fan controllers over Modbus RTU, with alerts and a load benchmark
+ * Author: Youssef Zaki
+ *
+ * Threads of the gateway:
+ *     - I/O threads: each one owns a share of the links (serial ports, pseudo terminals, TCP connections to
+ *       127.0.0.1) in its own epoll set. A link is an RS-485 bus: its controllers are polled one at a time
+ *       (function 04, all the input registers of Modbus_Slave.h), a round every --poll-ms. The I/O thread only
+ *       finds the end of the response from its byte count (or the timeout) and hands the raw frame over.
+ *     - Decode workers: the frames of a controller always go to the same worker (controller index modulo the
+ *       workers), over one lock-free single producer single consumer queue per I/O thread and worker
+ *       (spsc_queue.h). The worker checks the CRC (CRC16_MODBUS_Calculate of the firmware), decodes the
+ *       registers into the latest state of the controller and runs the alert rules. A worker with nothing to
+ *       do sleeps on an eventfd, which an I/O thread only writes when the worker said it was going to sleep.
+ *     - The main thread reads the state table for the reports and prints the alert events, which the workers
+ *       post on their own queues.
+ * The state of a controller is written by its worker only and read with a sequence counter (the sequence
+ * snapshots of Isr_Sync.h): the reader copies it again if a write was in progress, the writer never waits.
+ * Alert rules (raised and cleared once, printed as events):
+ *     over temperature   temperature >= --alert-temp, or the over temperature flag, cleared 2C below
+ *     stall              current cutoff flag, or a drive duty >= 15% with a winding current (average current /
+ *                        duty) >= --stall-ma: the locked rotor draws the stall current
+ *     sensor fault       temperature of 0C (open LM35 or shorted output) or >= 150C (the range of the sensor)
+ *     offline            --offline-polls polls in a row without a valid response
+ * Latencies: ingest is from the end of the response (I/O thread wake up) to the state and alerts updated by the
+ * worker, round trip is from the request written to the end of the response.
+ * Build on the host:
+ *     gcc -O2 -std=gnu99 -DF_CPU=1000000UL -I../Thermal_Sim/shim -I../../Fan_Controller_Project \
+ *         -c ../../Fan_Controller_Project/CRC.c ../../Fan_Controller_Project/Fan_Curve.c
+ *     g++ -O2 -std=c++17 -pthread -DF_CPU=1000000UL -I../Thermal_Sim/shim -I../../Fan_Controller_Project \
+ *         fleet_gateway.cpp controller_emulator.cpp CRC.o Fan_Curve.o -o fleet_gateway
+ * Commands (defaults in brackets):
+ *     ./fleet_gateway gateway <link> ... [--io-threads 1] [--workers 2] [--poll-ms 1000] [--timeout-ms 200]
+ *             [--alert-temp 60] [--stall-ma 700] [--offline-polls 3] [--report-s 5] [--duration-s 0 = Ctrl+C]
+ *             [--addresses 1] [--baud 9600] [--quiet]
+ *         a link is tcp:[127.0.0.1:]<port>[-<last port>] or the path of a serial port or pseudo terminal,
+ *         followed by @<first>-<last> addresses (--addresses otherwise)
+ *     ./fleet_gateway emulate [--links 64] [--slaves 4] [--port 15020] [--pty prefix] [--faults 10]
+ *             [--emulator-threads 1] [--seed 1]
+ *         emulated controllers (controller_emulator.h), the link list for the gateway is printed
+ *     ./fleet_gateway bench [--links 64] [--slaves 4] [--faults 0] [--threads 1,2,4,8] [--io-threads 1]
+ *             [--emulator-threads 1] [--poll-ms 0] [--warmup-s 1] [--seconds 3]
+ *         gateway against an emulator in the same process, messages per second and latency percentiles for
+ *         each number of decode workers (--poll-ms 0 polls as fast as the links answer)
+ ******************************************************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "controller_emulator.h"
+#include "fleet_protocol.h"
+#include "spsc_queue.h"
+
+namespace
+{
+
+constexpr size_t MESSAGE_QUEUE_SIZE = 1024;
+constexpr size_t ALERT_QUEUE_SIZE = 4096;
+constexpr int MAX_EVENTS = 64;
+constexpr int64_t SCAN_PERIOD_NS = 1000000;
+constexpr int64_t RECONNECT_PERIOD_NS = 1000000000;
+constexpr int WORKER_IDLE_SPINS = 64;
+constexpr uint16_t SENSOR_MAX_C = 150;
+constexpr uint16_t STALL_MIN_DUTY = 150;
+constexpr uint16_t OVER_TEMPERATURE_HYSTERESIS_C = 2;
+
+enum Alert
+{
+	ALERT_OVER_TEMPERATURE, ALERT_STALL, ALERT_SENSOR_FAULT, ALERT_OFFLINE, NUM_OF_ALERTS
+};
+
+const char *const ALERT_NAMES[NUM_OF_ALERTS] = {"over temperature", "stall", "sensor fault", "offline"};
+
+struct GatewayOptions
+{
+	unsigned Io_Threads = 1;
+	unsigned Workers = 2;
+	double Poll_ms = 1000.0;
+	double Timeout_ms = 200.0;
+	uint16_t Alert_Temperature_C = 60;
+	uint16_t Stall_mA = 700;
+	unsigned Offline_Polls = 3;
+	int Baud = 9600;
+	std::string Addresses = "1";
+};
+
+/****************************************************************************************
+ *                                Latency Histogram                                     *
+ ****************************************************************************************/
+
+/*
+ * Log-linear histogram of nanoseconds: 16 buckets per power of 2 (6% resolution). Written by one thread
+ * (relaxed stores of its own counters), read by any thread.
+ */
+class LatencyHistogram
+{
+public:
+	static constexpr int SUB_BITS = 4;
+	static constexpr int NUM_OF_BUCKETS = (64 - SUB_BITS + 1) << SUB_BITS;
+
+	void Add(int64_t Value_ns)
+	{
+		std::atomic<uint64_t> &Bucket = m_counts[Index((uint64_t)std::max<int64_t>(0, Value_ns))];
+
+		Bucket.store(Bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	std::vector<uint64_t> Counts() const
+	{
+		std::vector<uint64_t> Counts(NUM_OF_BUCKETS);
+
+		for (int Bucket = 0; Bucket < NUM_OF_BUCKETS; Bucket++)
+		{
+			Counts[Bucket] = m_counts[Bucket].load(std::memory_order_relaxed);
+		}
+		return Counts;
+	}
+
+	static int Index(uint64_t Value)
+	{
+		int Exponent;
+
+		if (Value < (1u << SUB_BITS))
+		{
+			return (int)Value;
+		}
+		Exponent = 63 - __builtin_clzll(Value);
+		return ((Exponent - SUB_BITS + 1) << SUB_BITS) + (int)((Value >> (Exponent - SUB_BITS)) & ((1u << SUB_BITS) - 1));
+	}
+
+	/* Upper bound of a bucket */
+	static double Value(int Bucket)
+	{
+		int Octave = Bucket >> SUB_BITS;
+		int Sub = Bucket & ((1 << SUB_BITS) - 1);
+
+		if (Octave == 0)
+		{
+			return Sub + 1;
+		}
+		return std::ldexp((double)((1 << SUB_BITS) + Sub + 1), Octave - 1);
+	}
+
+	/* Percentile (0..1) of counts summed over several histograms, in microseconds */
+	static double Percentile_us(const std::vector<uint64_t> &Counts, double Fraction)
+	{
+		uint64_t Total = 0;
+		uint64_t Seen = 0;
+
+		for (uint64_t Count : Counts)
+		{
+			Total += Count;
+		}
+		if (Total == 0)
+		{
+			return 0.0;
+		}
+		for (int Bucket = 0; Bucket < NUM_OF_BUCKETS; Bucket++)
+		{
+			Seen += Counts[Bucket];
+			if ((double)Seen >= Fraction * Total)
+			{
+				return Value(Bucket) / 1e3;
+			}
+		}
+		return Value(NUM_OF_BUCKETS - 1) / 1e3;
+	}
+
+private:
+	std::atomic<uint64_t> m_counts[NUM_OF_BUCKETS] = {};
+};
+
+void AddCounts(std::vector<uint64_t> &Sum, const std::vector<uint64_t> &Counts, int Sign = 1)
+{
+	Sum.resize(Counts.size(), 0);
+	for (size_t Bucket = 0; Bucket < Counts.size(); Bucket++)
+	{
+		Sum[Bucket] += (Sign > 0) ? Counts[Bucket] : (uint64_t)0 - Counts[Bucket];
+	}
+}
+
+/****************************************************************************************
+ *                                 Messages and State                                   *
+ ****************************************************************************************/
+
+/* A response (Length 0: no valid response before the timeout, or the link is down) */
+struct Message
+{
+	uint32_t Controller;
+	uint8_t Length;
+	uint8_t Frame[FLEET_MAX_FRAME];
+	int64_t Sent_ns;
+	int64_t Received_ns;
+};
+
+struct AlertEvent
+{
+	uint32_t Controller;
+	uint8_t Alert;
+	bool Raised;
+	uint16_t Temperature;
+	int64_t Time_ns;
+};
+
+using MessageQueue = SpscQueue<Message, MESSAGE_QUEUE_SIZE>;
+using AlertQueue = SpscQueue<AlertEvent, ALERT_QUEUE_SIZE>;
+
+struct ControllerState
+{
+	uint16_t Registers[FLEET_POLL_REGISTERS];
+	int64_t Updated_ns;
+	uint32_t Responses;
+	uint32_t Failures;
+	uint32_t Bad_Frames;
+	uint16_t Failures_In_Row;
+	uint8_t Alerts;
+	bool Seen;
+	float Temperature_Average;
+};
+
+/* Written by the worker of the controller, read by any thread with Load */
+struct alignas(SPSC_CACHE_LINE) ControllerSlot
+{
+	std::atomic<uint32_t> Sequence{0};
+	ControllerState State = {};
+
+	ControllerState Load() const
+	{
+		ControllerState Copy;
+		uint32_t Before;
+
+		do
+		{
+			Before = Sequence.load(std::memory_order_acquire);
+			std::memcpy(&Copy, &State, sizeof(Copy));
+			std::atomic_thread_fence(std::memory_order_acquire);
+		} while ((Before & 1) || (Before != Sequence.load(std::memory_order_relaxed)));
+		return Copy;
+	}
+};
+
+/****************************************************************************************
+ *                                        Gateway                                       *
+ ****************************************************************************************/
+
+struct GatewayStats
+{
+	uint64_t Messages = 0;
+	uint64_t Failures = 0;
+	uint64_t Bad_Frames = 0;
+	uint64_t Queue_Full = 0;
+	uint64_t Alerts_Dropped = 0;
+	std::vector<uint64_t> Ingest;
+	std::vector<uint64_t> Round_Trip;
+};
+
+class Gateway
+{
+public:
+	Gateway(const GatewayOptions &Options, const std::vector<std::string> &Links) : m_options(Options)
+	{
+		for (const std::string &Spec : Links)
+		{
+			ParseLink(Spec);
+		}
+		if (m_links.empty())
+		{
+			std::fprintf(stderr, "no link\n");
+			std::exit(1);
+		}
+		m_slots.reset(new ControllerSlot[m_names.size()]);
+
+		for (unsigned Index = 0; Index < std::max(1u, Options.Workers); Index++)
+		{
+			std::unique_ptr<Worker> Own(new Worker);
+
+			Own -> Wake_Fd = eventfd(0, 0);
+			for (unsigned Io = 0; Io < std::max(1u, Options.Io_Threads); Io++)
+			{
+				Own -> Inputs.emplace_back(new MessageQueue);
+			}
+			m_workers.push_back(std::move(Own));
+		}
+		for (unsigned Index = 0; Index < std::max(1u, Options.Io_Threads); Index++)
+		{
+			std::unique_ptr<IoThread> Own(new IoThread);
+
+			Own -> Index = Index;
+			Own -> Epoll_Fd = epoll_create1(0);
+			m_ios.push_back(std::move(Own));
+		}
+		for (size_t Index = 0; Index < m_links.size(); Index++)
+		{
+			m_links[Index] -> Io = (unsigned)(Index % m_ios.size());
+			m_ios[m_links[Index] -> Io] -> Links.push_back(m_links[Index].get());
+			Connect(*m_links[Index]);
+		}
+
+		for (std::unique_ptr<Worker> &Own : m_workers)
+		{
+			Own -> Thread = std::thread(&Gateway::RunWorker, this, std::ref(*Own));
+		}
+		for (std::unique_ptr<IoThread> &Own : m_ios)
+		{
+			Own -> Thread = std::thread(&Gateway::RunIo, this, std::ref(*Own));
+		}
+	}
+
+	~Gateway()
+	{
+		m_stop = true;
+		for (std::unique_ptr<IoThread> &Own : m_ios)
+		{
+			Own -> Thread.join();
+			close(Own -> Epoll_Fd);
+		}
+		for (std::unique_ptr<Worker> &Own : m_workers)
+		{
+			Wake(*Own, true);
+			Own -> Thread.join();
+			close(Own -> Wake_Fd);
+		}
+		for (std::unique_ptr<Link> &Bus : m_links)
+		{
+			if (Bus -> Fd >= 0)
+			{
+				close(Bus -> Fd);
+			}
+		}
+	}
+
+	size_t NumOfControllers() const
+	{
+		return m_names.size();
+	}
+
+	const std::string &Name(uint32_t Controller) const
+	{
+		return m_names[Controller];
+	}
+
+	ControllerState State(uint32_t Controller) const
+	{
+		return m_slots[Controller].Load();
+	}
+
+	GatewayStats Stats() const
+	{
+		GatewayStats Stats;
+
+		for (const std::unique_ptr<Worker> &Own : m_workers)
+		{
+			Stats.Messages += Own -> Messages.load(std::memory_order_relaxed);
+			Stats.Failures += Own -> Failures.load(std::memory_order_relaxed);
+			Stats.Bad_Frames += Own -> Bad_Frames.load(std::memory_order_relaxed);
+			Stats.Alerts_Dropped += Own -> Alerts_Dropped.load(std::memory_order_relaxed);
+			AddCounts(Stats.Ingest, Own -> Ingest.Counts());
+			AddCounts(Stats.Round_Trip, Own -> Round_Trip.Counts());
+		}
+		for (const std::unique_ptr<IoThread> &Own : m_ios)
+		{
+			Stats.Queue_Full += Own -> Queue_Full.load(std::memory_order_relaxed);
+		}
+		return Stats;
+	}
+
+	/* Main thread: take the alert events posted by the workers */
+	template <typename Handler>
+	void DrainAlerts(Handler &&Handle)
+	{
+		AlertEvent Event;
+
+		for (std::unique_ptr<Worker> &Own : m_workers)
+		{
+			while (Own -> Alerts.TryPop(Event))
+			{
+				Handle(Event);
+			}
+		}
+	}
+
+private:
+	struct Link
+	{
+		std::string Name;
+		std::string Path;
+		uint16_t Port = 0;
+		int Fd = -1;
+		unsigned Io = 0;
+		std::vector<uint8_t> Addresses;
+		std::vector<uint32_t> Controllers;
+		size_t Next = 0;
+		bool Waiting = false;
+		int64_t Sent_ns = 0;
+		int64_t Deadline_ns = 0;
+		int64_t Round_ns = 0;
+		int64_t Reconnect_ns = 0;
+		uint8_t Rx[FLEET_MAX_FRAME];
+		size_t Rx_Length = 0;
+	};
+
+	struct alignas(SPSC_CACHE_LINE) Worker
+	{
+		std::vector<std::unique_ptr<MessageQueue>> Inputs;
+		AlertQueue Alerts;
+		int Wake_Fd = -1;
+		std::atomic<bool> Sleeping{false};
+		std::atomic<uint64_t> Messages{0};
+		std::atomic<uint64_t> Failures{0};
+		std::atomic<uint64_t> Bad_Frames{0};
+		std::atomic<uint64_t> Alerts_Dropped{0};
+		LatencyHistogram Ingest;
+		LatencyHistogram Round_Trip;
+		std::thread Thread;
+	};
+
+	struct IoThread
+	{
+		unsigned Index = 0;
+		int Epoll_Fd = -1;
+		std::vector<Link *> Links;
+		std::atomic<uint64_t> Queue_Full{0};
+		std::thread Thread;
+	};
+
+	/* tcp:[host:]port[-last]@first-last or path@first-last */
+	void ParseLink(const std::string &Spec)
+	{
+		size_t At = Spec.find('@');
+		std::string Endpoint = Spec.substr(0, At);
+		std::string Range = (At == std::string::npos) ? m_options.Addresses : Spec.substr(At + 1);
+		int First_Address = 1;
+		int Last_Address = 1;
+		int First_Port = 0;
+		int Last_Port = 0;
+
+		if (std::sscanf(Range.c_str(), "%d-%d", &First_Address, &Last_Address) == 1)
+		{
+			Last_Address = First_Address;
+		}
+		if ((First_Address < 1) || (Last_Address > 247) || (Last_Address < First_Address))
+		{
+			std::fprintf(stderr, "bad addresses %s\n", Range.c_str());
+			std::exit(1);
+		}
+
+		if (Endpoint.compare(0, 4, "tcp:") == 0)
+		{
+			std::string Ports = Endpoint.substr(Endpoint.rfind(':') + 1);
+
+			if (std::sscanf(Ports.c_str(), "%d-%d", &First_Port, &Last_Port) == 1)
+			{
+				Last_Port = First_Port;
+			}
+		}
+
+		for (int Port = First_Port; Port <= Last_Port; Port++)
+		{
+			std::unique_ptr<Link> Bus(new Link);
+
+			if (Port != 0)
+			{
+				Bus -> Port = (uint16_t)Port;
+				Bus -> Name = "tcp:" + std::to_string(Port);
+			}
+			else
+			{
+				Bus -> Path = Endpoint;
+				Bus -> Name = Endpoint;
+			}
+			for (int Address = First_Address; Address <= Last_Address; Address++)
+			{
+				Bus -> Addresses.push_back((uint8_t)Address);
+				Bus -> Controllers.push_back((uint32_t)m_names.size());
+				m_names.push_back(Bus -> Name + "@" + std::to_string(Address));
+			}
+			m_links.push_back(std::move(Bus));
+		}
+	}
+
+	/* Open a link (non-blocking), the I/O thread of the link adds it to its epoll set */
+	void Connect(Link &Bus)
+	{
+		if (Bus.Port != 0)
+		{
+			struct sockaddr_in Address = {};
+			int No_Delay = 1;
+
+			Bus.Fd = socket(AF_INET, SOCK_STREAM, 0);
+			Address.sin_family = AF_INET;
+			Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			Address.sin_port = htons(Bus.Port);
+			if (connect(Bus.Fd, (struct sockaddr *)&Address, sizeof(Address)))
+			{
+				close(Bus.Fd);
+				Bus.Fd = -1;
+				return;
+			}
+			setsockopt(Bus.Fd, IPPROTO_TCP, TCP_NODELAY, &No_Delay, sizeof(No_Delay));
+		}
+		else
+		{
+			struct termios Settings;
+
+			Bus.Fd = open(Bus.Path.c_str(), O_RDWR | O_NOCTTY);
+			if (Bus.Fd < 0)
+			{
+				return;
+			}
+
+			/* Raw 8E1 as the controller, the baud rate is ignored by a pseudo terminal */
+			if (tcgetattr(Bus.Fd, &Settings) == 0)
+			{
+				speed_t Speed = (m_options.Baud == 19200) ? B19200 : (m_options.Baud == 38400) ? B38400 : B9600;
+
+				cfmakeraw(&Settings);
+				Settings.c_cflag |= PARENB | CLOCAL | CREAD;
+				Settings.c_cflag &= ~(PARODD | CSTOPB);
+				cfsetispeed(&Settings, Speed);
+				cfsetospeed(&Settings, Speed);
+				tcsetattr(Bus.Fd, TCSANOW, &Settings);
+				tcflush(Bus.Fd, TCIOFLUSH);
+			}
+		}
+		fcntl(Bus.Fd, F_SETFL, fcntl(Bus.Fd, F_GETFL) | O_NONBLOCK);
+
+		struct epoll_event Event = {};
+
+		Event.events = EPOLLIN;
+		Event.data.ptr = &Bus;
+		epoll_ctl(m_ios[Bus.Io] -> Epoll_Fd, EPOLL_CTL_ADD, Bus.Fd, &Event);
+	}
+
+	void Disconnect(Link &Bus, int64_t Now_ns)
+	{
+		epoll_ctl(m_ios[Bus.Io] -> Epoll_Fd, EPOLL_CTL_DEL, Bus.Fd, nullptr);
+		close(Bus.Fd);
+		Bus.Fd = -1;
+		Bus.Reconnect_ns = Now_ns + RECONNECT_PERIOD_NS;
+	}
+
+	/****************************************************************************************
+	 *                                       I/O Threads                                    *
+	 ****************************************************************************************/
+
+	void Wake(Worker &Own, bool Always = false)
+	{
+		uint64_t One = 1;
+
+		/* Only when the worker said it was going to sleep: no system call per message under load */
+		if (Always || Own.Sleeping.exchange(false, std::memory_order_seq_cst))
+		{
+			if (write(Own.Wake_Fd, &One, sizeof(One)) != sizeof(One))
+			{
+				std::perror("worker wake up");
+			}
+		}
+	}
+
+	void Post(IoThread &Own, const Message &Item)
+	{
+		Worker &Target = *m_workers[Item.Controller % m_workers.size()];
+		MessageQueue &Queue = *Target.Inputs[Own.Index];
+
+		/* Back pressure: the links of this thread wait, no message is lost */
+		while (!Queue.TryPush(Item))
+		{
+			Own.Queue_Full.fetch_add(1, std::memory_order_relaxed);
+			Wake(Target);
+			std::this_thread::yield();
+		}
+		Wake(Target);
+	}
+
+	/* The current poll is over (response, timeout or link down): next controller, or end of the round */
+	void Finish(IoThread &Own, Link &Bus, size_t Length, int64_t Now_ns)
+	{
+		Message Item;
+
+		Item.Controller = Bus.Controllers[Bus.Next];
+		Item.Length = (uint8_t)Length;
+		Item.Sent_ns = Bus.Sent_ns;
+		Item.Received_ns = Now_ns;
+		std::memcpy(Item.Frame, Bus.Rx, Length);
+		Post(Own, Item);
+
+		Bus.Waiting = false;
+		Bus.Rx_Length = 0;
+		Bus.Next++;
+		if (Bus.Next >= Bus.Addresses.size())
+		{
+			Bus.Next = 0;
+			Bus.Round_ns += (int64_t)(m_options.Poll_ms * 1e6);
+
+			/* A late round starts at once, the lost rounds are not made up */
+			Bus.Round_ns = std::max(Bus.Round_ns, Now_ns - (int64_t)(m_options.Poll_ms * 1e6));
+		}
+	}
+
+	/* Send the next poll of a link if its round is due */
+	void Poll(IoThread &Own, Link &Bus, int64_t Now_ns)
+	{
+		uint8_t Request[8];
+		size_t Length;
+
+		if (Bus.Waiting || (Now_ns < Bus.Round_ns))
+		{
+			return;
+		}
+
+		Bus.Sent_ns = Now_ns;
+		if (Bus.Fd < 0)
+		{
+			/* A link down fails every poll, so its controllers go offline */
+			Finish(Own, Bus, 0, Now_ns);
+			return;
+		}
+
+		Length = BuildReadRequest(Request, Bus.Addresses[Bus.Next], FLEET_READ_INPUT_REGISTERS, 0, FLEET_POLL_REGISTERS);
+		Bus.Waiting = true;
+		Bus.Deadline_ns = Now_ns + (int64_t)(m_options.Timeout_ms * 1e6);
+		Bus.Rx_Length = 0;
+		if (write(Bus.Fd, Request, Length) != (ssize_t)Length)
+		{
+			Disconnect(Bus, Now_ns);
+			Finish(Own, Bus, 0, Now_ns);
+		}
+	}
+
+	void Receive(IoThread &Own, Link &Bus, int64_t Now_ns)
+	{
+		uint8_t Buffer[512];
+		ssize_t Length;
+
+		while ((Length = read(Bus.Fd, Buffer, sizeof(Buffer))) > 0)
+		{
+			for (ssize_t Index = 0; Index < Length; Index++)
+			{
+				size_t Expected;
+
+				/* Bytes outside of a poll (late response) are dropped */
+				if (!Bus.Waiting)
+				{
+					break;
+				}
+				Bus.Rx[Bus.Rx_Length++] = Buffer[Index];
+				Expected = ResponseLength(Bus.Rx, Bus.Rx_Length);
+				if (((Expected != 0) && (Bus.Rx_Length >= Expected)) || (Bus.Rx_Length >= FLEET_MAX_FRAME))
+				{
+					Finish(Own, Bus, Bus.Rx_Length, Now_ns);
+					Poll(Own, Bus, Now_ns);
+				}
+			}
+		}
+
+		if ((Length == 0) || ((Length < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK)))
+		{
+			Disconnect(Bus, Now_ns);
+			if (Bus.Waiting)
+			{
+				Finish(Own, Bus, 0, Now_ns);
+			}
+		}
+	}
+
+	/* Timeouts, due rounds and reconnections, once per SCAN_PERIOD_NS */
+	void Scan(IoThread &Own, int64_t Now_ns)
+	{
+		for (Link *Bus : Own.Links)
+		{
+			if ((Bus -> Fd < 0) && (Now_ns >= Bus -> Reconnect_ns))
+			{
+				Connect(*Bus);
+				Bus -> Reconnect_ns = Now_ns + RECONNECT_PERIOD_NS;
+			}
+			if (Bus -> Waiting && (Now_ns >= Bus -> Deadline_ns))
+			{
+				Finish(Own, *Bus, 0, Now_ns);
+			}
+			Poll(Own, *Bus, Now_ns);
+		}
+	}
+
+	void RunIo(IoThread &Own)
+	{
+		struct epoll_event Events[MAX_EVENTS];
+		int64_t Next_Scan_ns = 0;
+
+		for (Link *Bus : Own.Links)
+		{
+			Bus -> Round_ns = MonotonicNs();
+		}
+
+		while (!m_stop.load(std::memory_order_relaxed))
+		{
+			int64_t Now_ns = MonotonicNs();
+			int Count;
+
+			if (Now_ns >= Next_Scan_ns)
+			{
+				Scan(Own, Now_ns);
+				Next_Scan_ns = Now_ns + SCAN_PERIOD_NS;
+			}
+
+			Count = epoll_wait(Own.Epoll_Fd, Events, MAX_EVENTS, (int)std::max<int64_t>(0, (Next_Scan_ns - Now_ns + 999999) / 1000000));
+			Now_ns = MonotonicNs();
+			for (int Index = 0; Index < Count; Index++)
+			{
+				Link &Bus = *(Link *)Events[Index].data.ptr;
+
+				if (Bus.Fd >= 0)
+				{
+					Receive(Own, Bus, Now_ns);
+				}
+			}
+		}
+	}
+
+	/****************************************************************************************
+	 *                                     Decode Workers                                   *
+	 ****************************************************************************************/
+
+	void Raise(Worker &Own, uint32_t Controller, ControllerState &State, int Alert, bool Active, int64_t Now_ns)
+	{
+		AlertEvent Event;
+
+		if (Active == ((State.Alerts >> Alert) & 1))
+		{
+			return;
+		}
+		State.Alerts ^= (uint8_t)(1 << Alert);
+
+		Event.Controller = Controller;
+		Event.Alert = (uint8_t)Alert;
+		Event.Raised = Active;
+		Event.Temperature = State.Registers[MODBUS_INPUT_TEMPERATURE];
+		Event.Time_ns = Now_ns;
+		if (!Own.Alerts.TryPush(Event))
+		{
+			Own.Alerts_Dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	/* Decode a response into the state of its controller and run the alert rules */
+	void Decode(Worker &Own, const Message &Item)
+	{
+		ControllerSlot &Slot = m_slots[Item.Controller];
+		ControllerState State = Slot.State;
+		bool Valid = (Item.Length == FLEET_POLL_RESPONSE) && CrcValid(Item.Frame, Item.Length) &&
+				(Item.Frame[1] == FLEET_READ_INPUT_REGISTERS) && (Item.Frame[2] == 2 * FLEET_POLL_REGISTERS);
+		int64_t Now_ns;
+
+		if (Valid)
+		{
+			uint16_t Temperature;
+			uint16_t Duty;
+			uint16_t Flags;
+			bool Sensor_Fault;
+			bool Over_Temperature;
+			bool Stall;
+
+			for (int Register = 0; Register < FLEET_POLL_REGISTERS; Register++)
+			{
+				State.Registers[Register] = GetWord(&Item.Frame[3 + 2 * Register]);
+			}
+			Temperature = State.Registers[MODBUS_INPUT_TEMPERATURE];
+			Duty = State.Registers[MODBUS_INPUT_DUTY];
+			Flags = State.Registers[MODBUS_INPUT_FAULT_FLAGS];
+
+			State.Temperature_Average = State.Seen ? (0.9f * State.Temperature_Average + 0.1f * Temperature) : Temperature;
+			State.Seen = true;
+			State.Responses++;
+			State.Failures_In_Row = 0;
+
+			Sensor_Fault = (Temperature == 0) || (Temperature >= SENSOR_MAX_C);
+			Over_Temperature = (Flags & MODBUS_FAULT_OVER_TEMPERATURE) || (!Sensor_Fault &&
+					((Temperature >= m_options.Alert_Temperature_C) || ((State.Alerts & (1 << ALERT_OVER_TEMPERATURE)) &&
+					(Temperature + OVER_TEMPERATURE_HYSTERESIS_C > m_options.Alert_Temperature_C))));
+			Stall = (Flags & MODBUS_FAULT_CURRENT_CUTOFF) || ((Duty >= STALL_MIN_DUTY) &&
+					((uint32_t)State.Registers[MODBUS_INPUT_CURRENT_AVERAGE] * 1000u / Duty >= m_options.Stall_mA));
+
+			Now_ns = MonotonicNs();
+			Raise(Own, Item.Controller, State, ALERT_SENSOR_FAULT, Sensor_Fault, Now_ns);
+			Raise(Own, Item.Controller, State, ALERT_OVER_TEMPERATURE, Over_Temperature, Now_ns);
+			Raise(Own, Item.Controller, State, ALERT_STALL, Stall, Now_ns);
+			Raise(Own, Item.Controller, State, ALERT_OFFLINE, false, Now_ns);
+		}
+		else
+		{
+			if (Item.Length != 0)
+			{
+				State.Bad_Frames++;
+				Own.Bad_Frames.fetch_add(1, std::memory_order_relaxed);
+			}
+			State.Failures++;
+			State.Failures_In_Row++;
+			Own.Failures.fetch_add(1, std::memory_order_relaxed);
+
+			Now_ns = MonotonicNs();
+			Raise(Own, Item.Controller, State, ALERT_OFFLINE, State.Failures_In_Row >= m_options.Offline_Polls, Now_ns);
+		}
+		State.Updated_ns = Now_ns;
+
+		/* Sequence snapshot: odd while the state is written */
+		uint32_t Sequence = Slot.Sequence.load(std::memory_order_relaxed);
+
+		Slot.Sequence.store(Sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		std::memcpy(&Slot.State, &State, sizeof(State));
+		Slot.Sequence.store(Sequence + 2, std::memory_order_release);
+
+		Own.Messages.store(Own.Messages.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		if (Valid)
+		{
+			Own.Ingest.Add(Now_ns - Item.Received_ns);
+			Own.Round_Trip.Add(Item.Received_ns - Item.Sent_ns);
+		}
+	}
+
+	bool DrainInputs(Worker &Own)
+	{
+		Message Item;
+		bool Any = false;
+
+		for (std::unique_ptr<MessageQueue> &Queue : Own.Inputs)
+		{
+			while (Queue -> TryPop(Item))
+			{
+				Decode(Own, Item);
+				Any = true;
+			}
+		}
+		return Any;
+	}
+
+	void RunWorker(Worker &Own)
+	{
+		int Idle = 0;
+
+		while (!m_stop.load(std::memory_order_relaxed))
+		{
+			uint64_t Count;
+
+			if (DrainInputs(Own))
+			{
+				Idle = 0;
+				continue;
+			}
+			if (++Idle < WORKER_IDLE_SPINS)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			/* Say it before the last check, so a message pushed after the check always writes the eventfd */
+			Own.Sleeping.store(true, std::memory_order_seq_cst);
+			if (DrainInputs(Own))
+			{
+				Own.Sleeping.store(false, std::memory_order_relaxed);
+				Idle = 0;
+				continue;
+			}
+			if (read(Own.Wake_Fd, &Count, sizeof(Count)) < 0)
+			{
+				std::perror("worker sleep");
+			}
+			Idle = 0;
+		}
+		DrainInputs(Own);
+	}
+
+	GatewayOptions m_options;
+	std::vector<std::string> m_names;
+	std::unique_ptr<ControllerSlot[]> m_slots;
+	std::vector<std::unique_ptr<Link>> m_links;
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::vector<std::unique_ptr<IoThread>> m_ios;
+	std::atomic<bool> m_stop{false};
+};
+
+/****************************************************************************************
+ *                                        Commands                                      *
+ ****************************************************************************************/
+
+volatile std::sig_atomic_t g_stop = 0;
+
+struct CommandLine
+{
+	std::vector<std::string> Positional;
+	std::vector<std::pair<std::string, std::string>> Named;
+
+	CommandLine(int Argc, char **Argv, const std::vector<std::string> &Flags)
+	{
+		for (int Index = 2; Index < Argc; Index++)
+		{
+			std::string Argument = Argv[Index];
+
+			if (Argument.compare(0, 2, "--") != 0)
+			{
+				Positional.push_back(Argument);
+			}
+			else if (std::find(Flags.begin(), Flags.end(), Argument) != Flags.end())
+			{
+				Named.push_back({Argument, "1"});
+			}
+			else if (Index + 1 < Argc)
+			{
+				Named.push_back({Argument, Argv[++Index]});
+			}
+			else
+			{
+				std::fprintf(stderr, "missing value of %s\n", Argument.c_str());
+				std::exit(1);
+			}
+		}
+	}
+
+	template <typename Apply>
+	void Each(Apply &&Handle) const
+	{
+		for (const auto &Option : Named)
+		{
+			if (!Handle(Option.first, Option.second.c_str()))
+			{
+				std::fprintf(stderr, "unknown option %s\n", Option.first.c_str());
+				std::exit(1);
+			}
+		}
+	}
+};
+
+bool GatewayOption(GatewayOptions &Options, const std::string &Name, const char *Value)
+{
+	if (Name == "--io-threads") Options.Io_Threads = (unsigned)std::atoi(Value);
+	else if (Name == "--workers") Options.Workers = (unsigned)std::atoi(Value);
+	else if (Name == "--poll-ms") Options.Poll_ms = std::atof(Value);
+	else if (Name == "--timeout-ms") Options.Timeout_ms = std::atof(Value);
+	else if (Name == "--alert-temp") Options.Alert_Temperature_C = (uint16_t)std::atoi(Value);
+	else if (Name == "--stall-ma") Options.Stall_mA = (uint16_t)std::atoi(Value);
+	else if (Name == "--offline-polls") Options.Offline_Polls = (unsigned)std::atoi(Value);
+	else if (Name == "--addresses") Options.Addresses = Value;
+	else if (Name == "--baud") Options.Baud = std::atoi(Value);
+	else return false;
+	return true;
+}
+
+bool EmulatorOption(EmulatorOptions &Options, const std::string &Name, const char *Value)
+{
+	if (Name == "--links") Options.Links = std::atoi(Value);
+	else if (Name == "--slaves") Options.Slaves = std::atoi(Value);
+	else if (Name == "--port") Options.Base_Port = std::atoi(Value);
+	else if (Name == "--pty") Options.Pty_Prefix = Value;
+	else if (Name == "--faults") Options.Fault_Percent = std::atof(Value);
+	else if (Name == "--emulator-threads") Options.Threads = (unsigned)std::atoi(Value);
+	else if (Name == "--seed") Options.Seed = (unsigned)std::atoi(Value);
+	else return false;
+	return true;
+}
+
+void PrintReport(const Gateway &Fleet, const GatewayStats &Now, const GatewayStats &Before, double Interval_s, double Time_s)
+{
+	std::vector<uint64_t> Ingest = Now.Ingest;
+	int Alerts[NUM_OF_ALERTS] = {};
+	size_t Online = 0;
+
+	AddCounts(Ingest, Before.Ingest, -1);
+	for (uint32_t Controller = 0; Controller < Fleet.NumOfControllers(); Controller++)
+	{
+		ControllerState State = Fleet.State(Controller);
+
+		Online += (State.Seen && !(State.Alerts & (1 << ALERT_OFFLINE))) ? 1 : 0;
+		for (int Alert = 0; Alert < NUM_OF_ALERTS; Alert++)
+		{
+			Alerts[Alert] += (State.Alerts >> Alert) & 1;
+		}
+	}
+
+	std::printf("%7.1fs  %8.0f msg/s  online %zu/%zu  alerts: over temperature %d, stall %d, sensor fault %d, offline %d  "
+			"ingest p50 %.1fus p99 %.1fus\n", Time_s, (Now.Messages - Before.Messages) / Interval_s, Online,
+			Fleet.NumOfControllers(), Alerts[ALERT_OVER_TEMPERATURE], Alerts[ALERT_STALL], Alerts[ALERT_SENSOR_FAULT],
+			Alerts[ALERT_OFFLINE], LatencyHistogram::Percentile_us(Ingest, 0.5), LatencyHistogram::Percentile_us(Ingest, 0.99));
+	std::fflush(stdout);
+}
+
+int RunGateway(int Argc, char **Argv)
+{
+	CommandLine Line(Argc, Argv, {"--quiet"});
+	GatewayOptions Options;
+	double Report_s = 5.0;
+	double Duration_s = 0.0;
+	bool Quiet = false;
+
+	Line.Each([&](const std::string &Name, const char *Value)
+	{
+		if (Name == "--report-s") Report_s = std::atof(Value);
+		else if (Name == "--duration-s") Duration_s = std::atof(Value);
+		else if (Name == "--quiet") Quiet = true;
+		else return GatewayOption(Options, Name, Value);
+		return true;
+	});
+
+	Gateway Fleet(Options, Line.Positional);
+	int64_t Start_ns = MonotonicNs();
+	int64_t Next_Report_ns = Start_ns + (int64_t)(Report_s * 1e9);
+	GatewayStats Before = Fleet.Stats();
+
+	std::signal(SIGINT, [](int) { g_stop = 1; });
+	std::printf("%zu controllers, %u I/O threads, %u workers\n", Fleet.NumOfControllers(), Options.Io_Threads, Options.Workers);
+
+	while (!g_stop && ((Duration_s <= 0.0) || (MonotonicNs() - Start_ns < (int64_t)(Duration_s * 1e9))))
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+		Fleet.DrainAlerts([&](const AlertEvent &Event)
+		{
+			if (!Quiet)
+			{
+				std::printf("%7.1fs  %-24s %-16s %s (temperature %uC)\n", (Event.Time_ns - Start_ns) / 1e9,
+						Fleet.Name(Event.Controller).c_str(), ALERT_NAMES[Event.Alert], Event.Raised ? "RAISED" : "cleared",
+						(unsigned)Event.Temperature);
+			}
+		});
+
+		if (MonotonicNs() >= Next_Report_ns)
+		{
+			GatewayStats Now = Fleet.Stats();
+
+			PrintReport(Fleet, Now, Before, Report_s, (MonotonicNs() - Start_ns) / 1e9);
+			Before = Now;
+			Next_Report_ns += (int64_t)(Report_s * 1e9);
+		}
+	}
+	return 0;
+}
+
+int RunEmulator(int Argc, char **Argv)
+{
+	CommandLine Line(Argc, Argv, {});
+	EmulatorOptions Options;
+
+	Options.Base_Port = 15020;
+	Line.Each([&](const std::string &Name, const char *Value) { return EmulatorOption(Options, Name, Value); });
+
+	ControllerEmulator Emulator(Options);
+	std::vector<int> Scenarios = Emulator.ScenarioCounts();
+
+	std::printf("%d controllers: %d normal, %d over temperature, %d stall, %d sensor fault, %d silent\n",
+			Options.Links * Options.Slaves, Scenarios[0], Scenarios[1], Scenarios[2], Scenarios[3], Scenarios[4]);
+	if (Options.Pty_Prefix.empty())
+	{
+		std::printf("links: tcp:%d-%d@1-%d\n", Options.Base_Port, Options.Base_Port + Options.Links - 1, Options.Slaves);
+	}
+	else
+	{
+		std::printf("links: %s0 .. %s%d (addresses 1-%d)\n", Options.Pty_Prefix.c_str(), Options.Pty_Prefix.c_str(),
+				Options.Links - 1, Options.Slaves);
+	}
+	std::fflush(stdout);
+
+	std::signal(SIGINT, [](int) { g_stop = 1; });
+	while (!g_stop)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+	std::printf("%llu requests answered\n", (unsigned long long)Emulator.Requests());
+	return 0;
+}
+
+int RunBench(int Argc, char **Argv)
+{
+	CommandLine Line(Argc, Argv, {});
+	EmulatorOptions Emulated;
+	GatewayOptions Options;
+	std::vector<unsigned> Thread_Counts = {1, 2, 4, 8};
+	double Warmup_s = 1.0;
+	double Seconds = 3.0;
+
+	Emulated.Fault_Percent = 0.0;
+	Options.Poll_ms = 0.0;
+	Line.Each([&](const std::string &Name, const char *Value)
+	{
+		if (Name == "--threads")
+		{
+			Thread_Counts.clear();
+			for (const char *Item = Value; *Item; )
+			{
+				Thread_Counts.push_back((unsigned)std::strtoul(Item, (char **)&Item, 10));
+				Item += (*Item == ',') ? 1 : 0;
+			}
+		}
+		else if (Name == "--warmup-s") Warmup_s = std::atof(Value);
+		else if (Name == "--seconds") Seconds = std::atof(Value);
+		else if (!EmulatorOption(Emulated, Name, Value)) return GatewayOption(Options, Name, Value);
+		return true;
+	});
+
+	std::printf("%d links x %d controllers, %u I/O threads, %u emulator threads, poll %.0fms, %u cores\n",
+			Emulated.Links, Emulated.Slaves, Options.Io_Threads, std::max(1u, Emulated.Threads), Options.Poll_ms,
+			std::thread::hardware_concurrency());
+	std::printf("workers      msg/s   ingest p50     p99   p99.9     max (us)   round trip p50     p99 (us)   queue full\n");
+
+	for (unsigned Workers : Thread_Counts)
+	{
+		ControllerEmulator Emulator(Emulated);
+		GatewayOptions Run = Options;
+		GatewayStats First;
+		GatewayStats Last;
+		std::vector<uint64_t> Ingest;
+		std::vector<uint64_t> Round_Trip;
+		double Max_us = 0.0;
+
+		Run.Workers = Workers;
+		{
+			Gateway Fleet(Run, Emulator.Endpoints());
+
+			std::this_thread::sleep_for(std::chrono::duration<double>(Warmup_s));
+			First = Fleet.Stats();
+			std::this_thread::sleep_for(std::chrono::duration<double>(Seconds));
+			Last = Fleet.Stats();
+			Fleet.DrainAlerts([](const AlertEvent &) {});
+		}
+
+		Ingest = Last.Ingest;
+		AddCounts(Ingest, First.Ingest, -1);
+		Round_Trip = Last.Round_Trip;
+		AddCounts(Round_Trip, First.Round_Trip, -1);
+		for (int Bucket = 0; Bucket < LatencyHistogram::NUM_OF_BUCKETS; Bucket++)
+		{
+			if (Ingest[Bucket] != 0)
+			{
+				Max_us = LatencyHistogram::Value(Bucket) / 1e3;
+			}
+		}
+
+		std::printf("%7u %10.0f   %10.1f %7.1f %7.1f %9.1f   %14.1f %7.1f   %10llu\n", Workers,
+				(Last.Messages - First.Messages) / Seconds, LatencyHistogram::Percentile_us(Ingest, 0.5),
+				LatencyHistogram::Percentile_us(Ingest, 0.99), LatencyHistogram::Percentile_us(Ingest, 0.999), Max_us,
+				LatencyHistogram::Percentile_us(Round_Trip, 0.5), LatencyHistogram::Percentile_us(Round_Trip, 0.99),
+				(unsigned long long)(Last.Queue_Full - First.Queue_Full));
+		std::fflush(stdout);
+	}
+	return 0;
+}
+
+} /* namespace */
+
+int main(int Argc, char **Argv)
+{
+	std::string Command = (Argc > 1) ? Argv[1] : "";
+
+	if (Command == "gateway")
+	{
+		return RunGateway(Argc, Argv);
+	}
+	if (Command == "emulate")
+	{
+		return RunEmulator(Argc, Argv);
+	}
+	if (Command == "bench")
+	{
+		return RunBench(Argc, Argv);
+	}
+
+	std::fprintf(stderr, "usage: fleet_gateway gateway <link> ... | emulate | bench  [options, see the header of fleet_gateway.cpp]\n");
+	return 1;
+}
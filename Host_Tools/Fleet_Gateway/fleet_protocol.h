@@ -0,0 +1,113 @@
+/*******************************************************************************************************************
+ * File Name: fleet_protocol.h
+ * Date: 19/10/2026
+ * Tool: Modbus RTU framing shared by the gateway and the controller emulator of Fleet_Gateway
+ * Author: Youssef Zaki
+ *
+ * The register map is the one of Modbus_Slave.h and the CRC is CRC16_MODBUS_Calculate of the firmware (CRC.c,
+ * linked), so the gateway and the emulator speak exactly what the controller speaks. The same RTU frames are
+ * carried on the serial lines, the pseudo terminals and the TCP connections (RTU over TCP, no MBAP header):
+ * on a byte stream the end of a frame is found from its function code and byte count instead of the t3.5
+ * silence, which a TCP connection does not keep.
+ ******************************************************************************************************************/
+#ifndef FLEET_PROTOCOL_H_
+#define FLEET_PROTOCOL_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+extern "C"
+{
+#include "Standard_Types.h"
+#include "CRC.h"
+#include "Fan_Curve.h"
+#include "Fan_Config.h"
+#include "Modbus_Slave.h"
+}
+
+constexpr uint8_t FLEET_READ_HOLDING_REGISTERS = 0x03;
+constexpr uint8_t FLEET_READ_INPUT_REGISTERS = 0x04;
+constexpr size_t FLEET_MAX_FRAME = MODBUS_MAX_FRAME_SIZE;
+
+/* The poll of the gateway: all the input registers of a controller in one request */
+constexpr uint16_t FLEET_POLL_REGISTERS = MODBUS_NUM_OF_INPUT_REGISTERS;
+constexpr size_t FLEET_POLL_RESPONSE = 5 + 2 * FLEET_POLL_REGISTERS;
+
+static_assert(FLEET_POLL_RESPONSE <= FLEET_MAX_FRAME, "the poll response fits in a frame of the controller");
+
+inline int64_t MonotonicNs()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline uint16_t GetWord(const uint8_t *Data)
+{
+	return (uint16_t)((Data[0] << 8) | Data[1]);
+}
+
+inline void PutWord(uint8_t *Data, uint16_t Value)
+{
+	Data[0] = (uint8_t)(Value >> 8);
+	Data[1] = (uint8_t)Value;
+}
+
+/* Append the CRC (low byte first) to a frame of Length bytes, return the new length */
+inline size_t AppendCrc(uint8_t *Frame, size_t Length)
+{
+	uint16_t Crc = CRC16_MODBUS_Calculate(Frame, (uint16)Length);
+
+	Frame[Length] = (uint8_t)Crc;
+	Frame[Length + 1] = (uint8_t)(Crc >> 8);
+	return Length + 2;
+}
+
+/* A frame with its CRC is valid if the CRC over the whole frame is 0 */
+inline bool CrcValid(const uint8_t *Frame, size_t Length)
+{
+	return (Length >= 4) && (CRC16_MODBUS_Calculate(Frame, (uint16)Length) == 0);
+}
+
+/* Length of a response from its first bytes, 0 while it is not known yet */
+inline size_t ResponseLength(const uint8_t *Frame, size_t Received)
+{
+	if (Received < 3)
+	{
+		return 0;
+	}
+	if (Frame[1] & 0x80)
+	{
+		return 5;
+	}
+	if ((Frame[1] == FLEET_READ_HOLDING_REGISTERS) || (Frame[1] == FLEET_READ_INPUT_REGISTERS))
+	{
+		return 5 + (size_t)Frame[2];
+	}
+	return 8;
+}
+
+/* Length of a request from its first bytes, 0 while it is not known yet (write multiple has a byte count) */
+inline size_t RequestLength(const uint8_t *Frame, size_t Received)
+{
+	if (Received < 2)
+	{
+		return 0;
+	}
+	if (Frame[1] == 0x10)
+	{
+		return (Received < 7) ? 0 : 9 + (size_t)Frame[6];
+	}
+	return 8;
+}
+
+/* Read request of Count registers from Start, return its length */
+inline size_t BuildReadRequest(uint8_t *Frame, uint8_t Address, uint8_t Function, uint16_t Start, uint16_t Count)
+{
+	Frame[0] = Address;
+	Frame[1] = Function;
+	PutWord(&Frame[2], Start);
+	PutWord(&Frame[4], Count);
+	return AppendCrc(Frame, 6);
+}
+
+#endif /* FLEET_PROTOCOL_H_ */
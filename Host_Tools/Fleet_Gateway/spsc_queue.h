@@ -0,0 +1,85 @@
+/*******************************************************************************************************************
+ * File Name: spsc_queue.h
+ * Date: 19/10/2026
+ * Tool: Lock-free single producer single consumer queue of Fleet_Gateway (I/O threads to decode workers)
+ * Author: Youssef Zaki
+ *
+ * The host counterpart of the ISR_SYNC_QUEUE_DEFINE queues of the firmware (Isr_Sync.h): a ring of Size items
+ * (a power of 2), the producer only writes the head index and the consumer only writes the tail index, so no
+ * lock and no read-modify-write instruction is needed. On the host the indexes are atomics: the release store
+ * of an index publishes the item (push) or the free place (pop) to the other thread, and both indexes sit on
+ * their own cache line with a cached copy of the other index, so the two threads only share a line when the
+ * queue looks full or empty to one of them.
+ ******************************************************************************************************************/
+#ifndef SPSC_QUEUE_H_
+#define SPSC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+constexpr size_t SPSC_CACHE_LINE = 64;
+
+template <typename Type, size_t Size>
+class SpscQueue
+{
+	static_assert((Size >= 2) && ((Size & (Size - 1)) == 0), "the size of the queue is a power of 2");
+
+public:
+	/* Producer side, false if the queue is full */
+	bool TryPush(const Type &Item)
+	{
+		uint64_t Head = m_head.load(std::memory_order_relaxed);
+
+		if (Head - m_cachedTail >= Size)
+		{
+			m_cachedTail = m_tail.load(std::memory_order_acquire);
+			if (Head - m_cachedTail >= Size)
+			{
+				return false;
+			}
+		}
+
+		m_items[Head & (Size - 1)] = Item;
+		m_head.store(Head + 1, std::memory_order_release);
+		return true;
+	}
+
+	/* Consumer side, false if the queue is empty */
+	bool TryPop(Type &Item)
+	{
+		uint64_t Tail = m_tail.load(std::memory_order_relaxed);
+
+		if (Tail == m_cachedHead)
+		{
+			m_cachedHead = m_head.load(std::memory_order_acquire);
+			if (Tail == m_cachedHead)
+			{
+				return false;
+			}
+		}
+
+		Item = m_items[Tail & (Size - 1)];
+		m_tail.store(Tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	/* Either side, a snapshot */
+	bool Empty() const
+	{
+		return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+	}
+
+private:
+	/* Producer line: its index and its copy of the consumer index */
+	alignas(SPSC_CACHE_LINE) std::atomic<uint64_t> m_head{0};
+	uint64_t m_cachedTail = 0;
+
+	/* Consumer line */
+	alignas(SPSC_CACHE_LINE) std::atomic<uint64_t> m_tail{0};
+	uint64_t m_cachedHead = 0;
+
+	alignas(SPSC_CACHE_LINE) Type m_items[Size];
+};
+
+#endif /* SPSC_QUEUE_H_ */
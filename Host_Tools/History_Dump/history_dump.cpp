@@ -0,0 +1,139 @@
+/*******************************************************************************************************************
+ * File Name: history_dump.cpp
+ * Date: 19/10/2026
+ * Tool: Host-side dump and decoder of the temperature history log stored in the EEPROM
+ * Author: Youssef Zaki
+ *
+ * Read the EEPROM content from the target, for example:
+ *     avrdude -c usbasp -p m32 -U eeprom:r:eeprom.bin:r
+ * Build and run on the host:
+ *     g++ -O2 -std=c++17 -I../../Fan_Controller_Project history_dump.cpp -x c ../../Fan_Controller_Project/CRC.c -o history_dump
+ *     ./history_dump eeprom.bin
+ ******************************************************************************************************************/
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+extern "C"
+{
+#include "CRC.h"
+#include "Temp_History.h"
+}
+
+static_assert(sizeof(TempHistory_RecordType) == TEMP_HISTORY_RECORD_SIZE, "Record layout differs from the target");
+
+namespace
+{
+
+struct Slot
+{
+	unsigned Index;
+	TempHistory_RecordType Record;
+};
+
+/* The EEPROM is little endian, decode it explicitly so the tool does not depend on the host */
+TempHistory_RecordType DecodeRecord(const unsigned char *Bytes)
+{
+	TempHistory_RecordType Record;
+
+	Record.Sequence = static_cast<uint16>(Bytes[0] | (Bytes[1] << 8));
+	Record.Type = Bytes[2];
+	std::copy(Bytes + 3, Bytes + 7, Record.Data);
+	Record.Crc = Bytes[7];
+	return Record;
+}
+
+bool IsValid(const unsigned char *Bytes, const TempHistory_RecordType &Record)
+{
+	if ((Record.Type != TEMP_HISTORY_RECORD_HOURLY) && (Record.Type != TEMP_HISTORY_RECORD_OVER_TEMPERATURE))
+	{
+		return false;
+	}
+	return CRC8_MAXIM_Calculate(Bytes, TEMP_HISTORY_RECORD_SIZE - 1) == Record.Crc;
+}
+
+} /* namespace */
+
+int main(int argc, char **argv)
+{
+	if (argc != 2)
+	{
+		std::fprintf(stderr, "usage: %s <eeprom.bin>\n", argv[0]);
+		return 2;
+	}
+
+	std::ifstream File(argv[1], std::ios::binary);
+	if (!File)
+	{
+		std::fprintf(stderr, "cannot open %s\n", argv[1]);
+		return 1;
+	}
+
+	std::vector<unsigned char> Image((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+	if (Image.size() < TEMP_HISTORY_EEPROM_END)
+	{
+		std::fprintf(stderr, "%s: expected a %d bytes EEPROM image, got %zu bytes\n", argv[1], TEMP_HISTORY_EEPROM_END, Image.size());
+		return 1;
+	}
+
+	std::vector<Slot> Slots;
+	unsigned Invalid = 0;
+
+	for (unsigned i = 0; i < TEMP_HISTORY_NUM_OF_SLOTS; i++)
+	{
+		const unsigned char *Bytes = &Image[TEMP_HISTORY_EEPROM_START + (i * TEMP_HISTORY_RECORD_SIZE)];
+		TempHistory_RecordType Record = DecodeRecord(Bytes);
+
+		if (IsValid(Bytes, Record))
+		{
+			Slots.push_back({i, Record});
+		}
+		else
+		{
+			Invalid++;
+		}
+	}
+
+	if (Slots.empty())
+	{
+		std::printf("history log is empty (%u slots)\n", static_cast<unsigned>(TEMP_HISTORY_NUM_OF_SLOTS));
+		return 0;
+	}
+
+	/* Order by age using serial number arithmetic relative to the newest record, so the 16-bit wrap is handled */
+	uint16 Newest = Slots.front().Record.Sequence;
+	for (const Slot &S : Slots)
+	{
+		if (static_cast<int16_t>(S.Record.Sequence - Newest) > 0)
+		{
+			Newest = S.Record.Sequence;
+		}
+	}
+	std::sort(Slots.begin(), Slots.end(), [Newest](const Slot &A, const Slot &B)
+	{
+		return static_cast<uint16>(Newest - A.Record.Sequence) > static_cast<uint16>(Newest - B.Record.Sequence);
+	});
+
+	std::printf("%-8s %-5s %-18s %s\n", "sequence", "slot", "type", "data");
+	for (const Slot &S : Slots)
+	{
+		const TempHistory_RecordType &R = S.Record;
+
+		if (R.Type == TEMP_HISTORY_RECORD_HOURLY)
+		{
+			std::printf("%-8u %-5u %-18s min=%uC max=%uC mean=%uC over_temperature_events=%u\n", R.Sequence, S.Index,
+					"hourly", R.Data[0], R.Data[1], R.Data[2], R.Data[3]);
+		}
+		else
+		{
+			std::printf("%-8u %-5u %-18s peak=%uC duration=%umin start_minute=%u\n", R.Sequence, S.Index,
+					"over_temperature", R.Data[0], R.Data[1], R.Data[2]);
+		}
+	}
+	std::printf("%zu records, %u empty or corrupted slots, next sequence %u\n", Slots.size(), Invalid,
+			static_cast<unsigned>(static_cast<uint16>(Newest + 1)));
+
+	return 0;
+}
@@ -0,0 +1,577 @@
+/*******************************************************************************************************************
+ * File Name: isr_stress.cpp
+ * Date: 19/10/2026
+ * Tool: Stress of the data shared with the interrupts (Isr_Sync.h) with emulated interrupt preemption
+ * Author: Youssef Zaki
+ *
+ * The interrupt is a POSIX timer signal (every --period-us microseconds) which preempts the main context at any
+ * instruction, like an AVR interrupt. The I bit of the shim SREG is honoured: a signal received while it is clear
+ * only marks the interrupt pending, and it is taken at the next register access after the I bit is set again (the
+ * AVR takes it after the instruction which sets I). The I bit is clear while the interrupt runs, and it cannot be
+ * nested. Each scenario runs for --seconds seconds and counts the errors seen by the checker:
+ *     snapshot  the interrupt stores a 16-byte value (4 equal words of a counter) with ISR_SYNC_SNAPSHOT_DEFINE,
+ *               the main context loads it: the 4 words must be equal and the counter must not go back.
+ *     queue     the interrupt pushes numbered 8-byte items to an ISR_SYNC_QUEUE_DEFINE queue of 8 items (the item
+ *               number only advances when the push succeeds), the main context pops them with random pauses:
+ *               every item must come once, in order, with its check word.
+ *     critical  the main context increments two counters in an IsrSync_EnterCritical section with a pause between
+ *               them, the interrupt checks that they are equal.
+ *     uart      the interrupt is the Receive Complete Interrupt of UART.c, fed with a numbered byte while the queue
+ *               has room, the main context reads with UART_IsByteReceived/UART_ReceiveByte: no byte lost or repeated.
+ *     systime   the interrupt is SysTime_Tick (Sys_Time.c), the main context reads SysTime_GetMilliseconds and
+ *               SysTime_GetSeconds: they never go back, and the total matches the number of ticks.
+ *     gpio      the interrupt toggles PA0 with a read-modify-write of PORTA like Soft_PWM.c, the main context
+ *               writes PA1..PA7 with GPIO_WritePin (GPIO.c): no write of either side is lost.
+ * With --unprotected the snapshot, critical and gpio scenarios use plain accesses instead (no sequence counter, no
+ * critical section), to show that the errors are found when the protection is missing.
+ * The tool returns 1 if a protected scenario has an error (or if an unprotected one has none: not enough preemption).
+ * Build and run on the host:
+ *     for f in UART Sys_Time GPIO; do gcc -O2 -std=gnu99 -DF_CPU=1000000UL -I../Thermal_Sim/shim \
+ *         -I../../Fan_Controller_Project -c ../../Fan_Controller_Project/$f.c -o $f.o; done
+ *     g++ -O2 -std=c++17 -DF_CPU=1000000UL -I../Thermal_Sim/shim -I../../Fan_Controller_Project isr_stress.cpp \
+ *         UART.o Sys_Time.o GPIO.o -o isr_stress -lrt
+ *     ./isr_stress && ./isr_stress --unprotected
+ * Options: --seconds S [2], --period-us N [20], --only NAME
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <signal.h>
+#include <time.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+extern "C"
+{
+#include "Standard_Types.h"
+#include "Isr_Sync.h"
+#include "UART.h"
+#include "Sys_Time.h"
+#include "GPIO.h"
+
+void Shim_Isr_USART_RXC(void);
+}
+
+namespace
+{
+
+/****************************************************************************************
+ *                                      Register Shim                                   *
+ ****************************************************************************************/
+
+uint8_t g_registers8[SHIM_NUM_OF_REGISTERS8];
+uint16_t g_registers16[SHIM_NUM_OF_REGISTERS16];
+
+constexpr uint8_t SREG_I = 0x80;
+
+/* The interrupt of the running scenario */
+void (*volatile g_isr)(void) = nullptr;
+
+volatile sig_atomic_t g_inIsr = 0;
+volatile sig_atomic_t g_pending = 0;
+
+struct Counters
+{
+	unsigned long Interrupts = 0;
+	unsigned long Deferred = 0;
+	unsigned long Operations = 0;
+	unsigned long Errors = 0;
+};
+
+Counters g_counters;
+
+/* Enter the interrupt like the AVR: I cleared on entry and set again by RETI */
+void RunIsr()
+{
+	g_inIsr = 1;
+	g_registers8[SHIM_SREG] &= (uint8_t)~SREG_I;
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+	g_isr();
+	std::atomic_signal_fence(std::memory_order_seq_cst);
+	g_registers8[SHIM_SREG] |= SREG_I;
+	g_counters.Interrupts++;
+	g_inIsr = 0;
+}
+
+void OnTimerSignal(int)
+{
+	if (g_inIsr || (g_isr == nullptr))
+	{
+		return;
+	}
+	if (!(g_registers8[SHIM_SREG] & SREG_I))
+	{
+		g_pending = 1;
+		return;
+	}
+	RunIsr();
+}
+
+/* A pending interrupt is taken as soon as the main context has the I bit set */
+void TakePending()
+{
+	sigset_t Signals;
+	sigset_t Previous;
+
+	if (!g_pending || g_inIsr || !(g_registers8[SHIM_SREG] & SREG_I))
+	{
+		return;
+	}
+
+	sigemptyset(&Signals);
+	sigaddset(&Signals, SIGALRM);
+	sigprocmask(SIG_BLOCK, &Signals, &Previous);
+	if (g_pending && (g_registers8[SHIM_SREG] & SREG_I))
+	{
+		g_pending = 0;
+		g_counters.Deferred++;
+		RunIsr();
+	}
+	sigprocmask(SIG_SETMASK, &Previous, nullptr);
+}
+
+} /* namespace */
+
+extern "C" volatile uint8_t *Shim_Register8(Shim_Register8Id Id)
+{
+	if (!g_inIsr)
+	{
+		TakePending();
+	}
+	return &g_registers8[Id];
+}
+
+extern "C" volatile uint16_t *Shim_Register16(Shim_Register16Id Id)
+{
+	return &g_registers16[Id];
+}
+
+extern "C" void Shim_Sleep(void)
+{
+}
+
+namespace
+{
+
+/****************************************************************************************
+ *                                       Scenarios                                      *
+ ****************************************************************************************/
+
+bool g_unprotected = false;
+
+/* Widen the windows between the accesses so the signals land in them */
+void Pause(unsigned Count)
+{
+	for (volatile unsigned i = 0; i < Count; i++)
+	{
+	}
+}
+
+uint32_t g_random = 12345;
+
+uint32_t Random()
+{
+	g_random = g_random * 1103515245u + 12345u;
+	return g_random >> 16;
+}
+
+/*------------------------------------------- snapshot ----------------------------------------------*/
+
+struct Wide
+{
+	uint32_t Words[4];
+};
+
+ISR_SYNC_SNAPSHOT_DEFINE(Stress_WideSnapshot, Wide)
+
+Stress_WideSnapshot_Type g_wide;
+uint32_t g_wideCounter = 0;
+
+void SnapshotIsr()
+{
+	Wide Value;
+
+	g_wideCounter++;
+	for (uint32_t &Word : Value.Words)
+	{
+		Word = g_wideCounter;
+	}
+
+	if (g_unprotected)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			((volatile uint32_t *)g_wide.Value.Words)[i] = Value.Words[i];
+		}
+	}
+	else
+	{
+		Stress_WideSnapshot_Store(&g_wide, Value);
+	}
+}
+
+void SnapshotMain()
+{
+	static uint32_t Last = 0;
+	Wide Value;
+
+	if (g_unprotected)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			Value.Words[i] = ((volatile uint32_t *)g_wide.Value.Words)[i];
+			Pause(4);
+		}
+	}
+	else
+	{
+		Value = Stress_WideSnapshot_Load(&g_wide);
+	}
+
+	if ((Value.Words[0] != Value.Words[1]) || (Value.Words[1] != Value.Words[2]) || (Value.Words[2] != Value.Words[3]) ||
+			(Value.Words[0] < Last))
+	{
+		g_counters.Errors++;
+	}
+	Last = Value.Words[3];
+	(void)Shim_Register8(SHIM_SREG);
+}
+
+/*-------------------------------------------- queue ------------------------------------------------*/
+
+struct Item
+{
+	uint32_t Number;
+	uint32_t Check;
+};
+
+ISR_SYNC_QUEUE_DEFINE(Stress_ItemQueue, Item, 8)
+
+Stress_ItemQueue_Type g_queue;
+uint32_t g_nextPush = 0;
+uint32_t g_nextPop = 0;
+unsigned long g_queueFull = 0;
+
+void QueueIsr()
+{
+	Item New = {g_nextPush, ~g_nextPush * 2654435761u};
+
+	if (Stress_ItemQueue_Push(&g_queue, New))
+	{
+		g_nextPush++;
+	}
+	else
+	{
+		g_queueFull++;
+	}
+}
+
+void QueueMain()
+{
+	Item Popped;
+
+	while (Stress_ItemQueue_Pop(&g_queue, &Popped))
+	{
+		if ((Popped.Number != g_nextPop) || (Popped.Check != ~Popped.Number * 2654435761u))
+		{
+			g_counters.Errors++;
+		}
+		g_nextPop = Popped.Number + 1;
+	}
+
+	/* Let the queue fill up from time to time (a pause of ~10 interrupts) */
+	Pause(((Random() % 64) == 0) ? 200000 : (Random() % 2000));
+	(void)Shim_Register8(SHIM_SREG);
+}
+
+/*------------------------------------------- critical ----------------------------------------------*/
+
+volatile uint32_t g_pairA = 0;
+volatile uint32_t g_pairB = 0;
+
+void CriticalIsr()
+{
+	if (g_pairA != g_pairB)
+	{
+		g_counters.Errors++;
+	}
+}
+
+void CriticalMain()
+{
+	uint8 Sreg = 0;
+
+	if (!g_unprotected)
+	{
+		Sreg = IsrSync_EnterCritical();
+	}
+
+	g_pairA = g_pairA + 1;
+	Pause(20);
+	g_pairB = g_pairB + 1;
+
+	if (!g_unprotected)
+	{
+		IsrSync_ExitCritical(Sreg);
+	}
+	(void)Shim_Register8(SHIM_SREG);
+}
+
+/*--------------------------------------------- uart ------------------------------------------------*/
+
+volatile uint32_t g_uartFed = 0;
+volatile uint32_t g_uartRead = 0;
+
+void UartIsr()
+{
+	/* The read count lags the queue, so the queue has at least this room */
+	if (g_uartFed - g_uartRead < UART_RX_QUEUE_SIZE)
+	{
+		g_registers8[SHIM_UDR] = (uint8_t)g_uartFed;
+		Shim_Isr_USART_RXC();
+		g_uartFed = g_uartFed + 1;
+	}
+}
+
+void UartMain()
+{
+	while (UART_IsByteReceived())
+	{
+		if (UART_ReceiveByte() != (uint8)g_uartRead)
+		{
+			g_counters.Errors++;
+		}
+		g_uartRead = g_uartRead + 1;
+	}
+	Pause(((Random() % 64) == 0) ? 200000 : (Random() % 2000));
+}
+
+/*-------------------------------------------- systime ----------------------------------------------*/
+
+/* 1024us per tick as the Timer0 overflow at 1MHz with F_CPU/8 */
+constexpr uint32_t TICK_PERIOD_US = 1024;
+
+volatile unsigned long g_ticks = 0;
+
+void SysTimeIsr()
+{
+	SysTime_Tick();
+	g_ticks = g_ticks + 1;
+}
+
+void SysTimeMain()
+{
+	static uint32_t Last_Milliseconds = 0;
+	static uint32_t Last_Seconds = 0;
+	uint32_t Milliseconds = SysTime_GetMilliseconds();
+	uint32_t Seconds = SysTime_GetSeconds();
+
+	if ((Milliseconds < Last_Milliseconds) || (Seconds < Last_Seconds))
+	{
+		g_counters.Errors++;
+	}
+	Last_Milliseconds = Milliseconds;
+	Last_Seconds = Seconds;
+}
+
+bool SysTimeFinal()
+{
+	uint32_t Expected = (uint32_t)(((uint64_t)g_ticks * TICK_PERIOD_US) / 1000);
+
+	return SysTime_GetMilliseconds() == Expected;
+}
+
+/*--------------------------------------------- gpio ------------------------------------------------*/
+
+volatile uint8_t g_pin0 = 0;
+
+void GpioIsr()
+{
+	g_pin0 = g_pin0 ^ 1;
+	if (g_pin0)
+	{
+		PORTA |= (1 << PIN0_ID);
+	}
+	else
+	{
+		PORTA &= ~(1 << PIN0_ID);
+	}
+}
+
+void GpioMain()
+{
+	static uint8_t Expected = 0;
+	uint8_t Pin = (uint8_t)(1 + (Random() % 7));
+	uint8_t Value = (uint8_t)(Random() & 1);
+	uint8_t Port;
+	uint8 Sreg;
+
+	if (g_unprotected)
+	{
+		Port = PORTA;
+		Pause(20);
+		PORTA = Value ? (Port | (1 << Pin)) : (Port & ~(1 << Pin));
+	}
+	else
+	{
+		GPIO_WritePin(PORTA_ID, Pin, Value);
+	}
+	Expected = Value ? (Expected | (1 << Pin)) : (Expected & ~(1 << Pin));
+
+	/* Both sides must be seen in the latch */
+	Sreg = IsrSync_EnterCritical();
+	Port = g_registers8[SHIM_PORTA];
+	if (((Port & 0xFE) != Expected) || ((Port & 0x01) != g_pin0))
+	{
+		g_counters.Errors++;
+		g_registers8[SHIM_PORTA] = (uint8_t)(Expected | g_pin0);
+	}
+	IsrSync_ExitCritical(Sreg);
+}
+
+/****************************************************************************************
+ *                                         Runner                                       *
+ ****************************************************************************************/
+
+struct Scenario
+{
+	const char *Name;
+	bool Has_Unprotected;
+	void (*Isr)(void);
+	void (*Main)(void);
+	bool (*Final)(void);
+};
+
+const Scenario g_scenarios[] =
+{
+	{"snapshot", true, SnapshotIsr, SnapshotMain, nullptr},
+	{"queue", false, QueueIsr, QueueMain, nullptr},
+	{"critical", true, CriticalIsr, CriticalMain, nullptr},
+	{"uart", false, UartIsr, UartMain, nullptr},
+	{"systime", false, SysTimeIsr, SysTimeMain, SysTimeFinal},
+	{"gpio", true, GpioIsr, GpioMain, nullptr},
+};
+
+double Now()
+{
+	timespec Time;
+
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	return Time.tv_sec + Time.tv_nsec / 1e9;
+}
+
+void Usage()
+{
+	std::fprintf(stderr, "usage: isr_stress [--seconds S] [--period-us N] [--only NAME] [--unprotected]\n");
+	std::exit(2);
+}
+
+} /* namespace */
+
+int main(int argc, char **argv)
+{
+	double Seconds = 2.0;
+	long Period_us = 20;
+	std::string Only;
+	int Failures = 0;
+	timer_t Timer;
+	sigevent Event = {};
+	itimerspec Interval = {};
+	struct sigaction Action = {};
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string Arg = argv[i];
+
+		if ((Arg == "--seconds") && (i + 1 < argc))
+		{
+			Seconds = std::atof(argv[++i]);
+		}
+		else if ((Arg == "--period-us") && (i + 1 < argc))
+		{
+			Period_us = std::atol(argv[++i]);
+		}
+		else if ((Arg == "--only") && (i + 1 < argc))
+		{
+			Only = argv[++i];
+		}
+		else if (Arg == "--unprotected")
+		{
+			g_unprotected = true;
+		}
+		else
+		{
+			Usage();
+		}
+	}
+
+	Action.sa_handler = OnTimerSignal;
+	sigemptyset(&Action.sa_mask);
+	sigaction(SIGALRM, &Action, nullptr);
+
+	Event.sigev_notify = SIGEV_SIGNAL;
+	Event.sigev_signo = SIGALRM;
+	timer_create(CLOCK_MONOTONIC, &Event, &Timer);
+
+	/* The firmware runs with the interrupts enabled */
+	UART_ConfigType Uart_Config = {9600, UART_Parity_Disabled, UART_One_Stop_Bit};
+	UART_Init(&Uart_Config);
+	SysTime_Init(TICK_PERIOD_US);
+	g_registers8[SHIM_SREG] = SREG_I;
+
+	std::printf("scenario   mode         interrupts  deferred  operations   errors\n");
+
+	for (const Scenario &Test : g_scenarios)
+	{
+		bool Unprotected = g_unprotected && Test.Has_Unprotected;
+		double End;
+
+		if ((!Only.empty() && (Only != Test.Name)) || (g_unprotected && !Test.Has_Unprotected))
+		{
+			continue;
+		}
+
+		g_counters = Counters();
+		g_isr = Test.Isr;
+
+		Interval.it_value.tv_nsec = Period_us * 1000;
+		Interval.it_interval.tv_nsec = Period_us * 1000;
+		timer_settime(Timer, 0, &Interval, nullptr);
+
+		End = Now() + Seconds;
+		while (Now() < End)
+		{
+			for (int i = 0; i < 1000; i++)
+			{
+				Test.Main();
+				g_counters.Operations++;
+			}
+		}
+
+		Interval = {};
+		timer_settime(Timer, 0, &Interval, nullptr);
+		g_isr = nullptr;
+		g_pending = 0;
+
+		if ((Test.Final != nullptr) && !Test.Final())
+		{
+			g_counters.Errors++;
+		}
+
+		std::printf("%-10s %-12s %10lu %9lu %11lu %8lu", Test.Name, Unprotected ? "unprotected" : "protected",
+				g_counters.Interrupts, g_counters.Deferred, g_counters.Operations, g_counters.Errors);
+		if (std::strcmp(Test.Name, "queue") == 0)
+		{
+			std::printf("   (%lu items, queue full %lu times)", (unsigned long)g_nextPop, g_queueFull);
+		}
+		std::printf("\n");
+
+		if ((Unprotected && (g_counters.Errors == 0)) || (!Unprotected && (g_counters.Errors != 0)))
+		{
+			Failures++;
+		}
+	}
+
+	return (Failures != 0) ? 1 : 0;
+}
@@ -0,0 +1,367 @@
+/*******************************************************************************************************************
+ * File Name: hd44780.cpp
+ * Date: 19/10/2026
+ * Tool: Virtual HD44780 LCD controller driven by the pins of the register shim
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#include "hd44780.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+
+/* HD44780U datasheet, VCC = 4.5V..5.5V, fosc = 270kHz */
+constexpr uint64_t T_CYCLE_E_NS = 500;
+constexpr uint64_t T_PULSE_E_NS = 230;
+constexpr uint64_t T_ADDRESS_SETUP_NS = 40;
+constexpr uint64_t T_ADDRESS_HOLD_NS = 10;
+constexpr uint64_t T_DATA_SETUP_NS = 80;
+constexpr uint64_t T_DATA_HOLD_NS = 10;
+constexpr uint64_t T_POWER_ON_NS = 15000000;
+constexpr uint64_t T_CLEAR_HOME_NS = 1520000;
+constexpr uint64_t T_INSTRUCTION_NS = 37000;
+constexpr uint64_t T_DATA_WRITE_NS = 37000 + 4000;
+
+/* Only the first violations are logged, all of them are counted */
+constexpr size_t MAX_LOG_LINES = 200;
+
+} /* namespace */
+
+HD44780::HD44780(const HD44780_Wiring &Wiring, int Columns, int Rows) :
+		m_wiring(Wiring), m_columns(Columns), m_rows(Rows)
+{
+	/* The DDRAM content is random after the power on, the tests clear it first: start with spaces */
+	std::memset(m_ddram, ' ', sizeof(m_ddram));
+	std::memset(m_cgram, 0, sizeof(m_cgram));
+}
+
+uint8_t HD44780::DataBus(const uint8_t Ports[4]) const
+{
+	uint8_t Bus = 0;
+	int First = (m_wiring.Bit_Mode == 4) ? 4 : 0;
+
+	/* In the 4-bit wiring DB0..DB3 are not connected and read as 0 */
+	for (int Bit = First; Bit < 8; Bit++)
+	{
+		if (Pin(Ports, m_wiring.Data_Port, m_wiring.Data_Bits[Bit]))
+		{
+			Bus |= (uint8_t)(1 << Bit);
+		}
+	}
+	return Bus;
+}
+
+void HD44780::Note(uint64_t Time_ns, unsigned long &Counter, const char *Format, ...)
+{
+	char Text[160];
+	int Length;
+	va_list Arguments;
+
+	Counter++;
+	if (m_log.size() >= MAX_LOG_LINES)
+	{
+		return;
+	}
+
+	Length = std::snprintf(Text, sizeof(Text), "%10.3fms  ", Time_ns / 1e6);
+	va_start(Arguments, Format);
+	std::vsnprintf(Text + Length, sizeof(Text) - Length, Format, Arguments);
+	va_end(Arguments);
+	m_log.push_back(Text);
+}
+
+void HD44780::Update(uint64_t Time_ns, const uint8_t Ports[4])
+{
+	bool E = Pin(Ports, m_wiring.E_Port, m_wiring.E_Bit);
+	bool Rs = Pin(Ports, m_wiring.Rs_Port, m_wiring.Rs_Bit);
+	uint8_t Bus = DataBus(Ports);
+
+	if (Rs != m_rs)
+	{
+		if (m_e)
+		{
+			Note(Time_ns, m_totals.Timing_Violations, "RS changed while E is high");
+		}
+		else if (m_anyRise && (Time_ns - m_fall_ns < T_ADDRESS_HOLD_NS))
+		{
+			Note(Time_ns, m_totals.Timing_Violations, "tAH: RS changed %lluns after E fell",
+					(unsigned long long)(Time_ns - m_fall_ns));
+		}
+		m_rs = Rs;
+		m_rsChange_ns = Time_ns;
+	}
+
+	if (Bus != m_bus)
+	{
+		if (!m_e && m_anyRise && (Time_ns - m_fall_ns < T_DATA_HOLD_NS))
+		{
+			Note(Time_ns, m_totals.Timing_Violations, "tH: data changed %lluns after E fell",
+					(unsigned long long)(Time_ns - m_fall_ns));
+		}
+		m_bus = Bus;
+		m_busChange_ns = Time_ns;
+	}
+
+	if (E && !m_e)
+	{
+		if (Time_ns < T_POWER_ON_NS)
+		{
+			Note(Time_ns, m_totals.Timing_Violations, "enable pulse %.3fms after the power on (15ms)", Time_ns / 1e6);
+		}
+		if (m_anyRise && (Time_ns - m_rise_ns < T_CYCLE_E_NS))
+		{
+			Note(Time_ns, m_totals.Timing_Violations, "tcycE: %lluns between enable pulses",
+					(unsigned long long)(Time_ns - m_rise_ns));
+		}
+		if (Time_ns - m_rsChange_ns < T_ADDRESS_SETUP_NS)
+		{
+			Note(Time_ns, m_totals.Timing_Violations, "tAS: E rose %lluns after RS", (unsigned long long)(Time_ns - m_rsChange_ns));
+		}
+
+		m_riseBusy = Time_ns < m_busyUntil_ns;
+		if (m_riseBusy)
+		{
+			Note(Time_ns, m_totals.Busy_Violations, "transfer while busy, %.1fus too early",
+					(m_busyUntil_ns - Time_ns) / 1e3);
+		}
+
+		m_rise_ns = Time_ns;
+		m_anyRise = true;
+	}
+	else if (!E && m_e)
+	{
+		if (Time_ns - m_rise_ns < T_PULSE_E_NS)
+		{
+			Note(Time_ns, m_totals.Timing_Violations, "PWEH: enable pulse of %lluns", (unsigned long long)(Time_ns - m_rise_ns));
+		}
+		if (Time_ns - m_busChange_ns < T_DATA_SETUP_NS)
+		{
+			Note(Time_ns, m_totals.Timing_Violations, "tDSW: data set %lluns before E fell",
+					(unsigned long long)(Time_ns - m_busChange_ns));
+		}
+
+		m_fall_ns = Time_ns;
+		Transfer(Time_ns, m_rs, m_bus);
+	}
+	m_e = E;
+}
+
+/* One enable pulse: a whole byte in the 8-bit mode, a nibble (high first) in the 4-bit mode */
+void HD44780::Transfer(uint64_t Time_ns, bool Rs, uint8_t Bus)
+{
+	m_totals.Enable_Pulses++;
+
+	if (m_riseBusy && Strict_Busy)
+	{
+		return;
+	}
+
+	if (m_eightBit)
+	{
+		Execute(Time_ns, Rs, Bus);
+	}
+	else if (m_highNibble)
+	{
+		m_nibble = Bus & 0xF0;
+		m_highNibble = false;
+	}
+	else
+	{
+		m_highNibble = true;
+		Execute(Time_ns, Rs, (uint8_t)(m_nibble | (Bus >> 4)));
+	}
+}
+
+void HD44780::Execute(uint64_t Time_ns, bool Rs, uint8_t Value)
+{
+	uint64_t Execution_ns;
+
+	if (Rs)
+	{
+		m_totals.Data_Bytes++;
+		WriteData(Value);
+		Execution_ns = T_DATA_WRITE_NS;
+	}
+	else
+	{
+		m_totals.Instructions++;
+		Execution_ns = Instruction(Time_ns, Value);
+	}
+
+	m_busyUntil_ns = Time_ns + Execution_ns;
+	m_totals.Busy_ns += Execution_ns;
+}
+
+int HD44780::DdramIndex(uint8_t Address) const
+{
+	/* Two lines: 0x00..0x27 and 0x40..0x67, one line: 0x00..0x4F */
+	if (m_twoLines)
+	{
+		return (Address >= 0x40) ? (DDRAM_LINE_LENGTH + Address - 0x40) : Address;
+	}
+	return Address;
+}
+
+void HD44780::MoveAddress(int Direction)
+{
+	if (m_addressCgram)
+	{
+		m_address = (uint8_t)((m_address + Direction) & (CGRAM_SIZE - 1));
+	}
+	else if (m_twoLines)
+	{
+		int Line = (m_address >= 0x40) ? 1 : 0;
+		int Offset = (m_address & 0x3F) + Direction;
+
+		if (Offset >= DDRAM_LINE_LENGTH)
+		{
+			Offset = 0;
+			Line ^= 1;
+		}
+		else if (Offset < 0)
+		{
+			Offset = DDRAM_LINE_LENGTH - 1;
+			Line ^= 1;
+		}
+		m_address = (uint8_t)(Line * 0x40 + Offset);
+	}
+	else
+	{
+		m_address = (uint8_t)((m_address + DDRAM_SIZE + Direction) % DDRAM_SIZE);
+	}
+}
+
+void HD44780::WriteData(uint8_t Data)
+{
+	int Direction = m_increment ? 1 : -1;
+
+	if (m_addressCgram)
+	{
+		m_cgram[m_address] = Data;
+	}
+	else
+	{
+		m_ddram[DdramIndex(m_address)] = Data;
+		if (m_shiftOnWrite)
+		{
+			m_shift += Direction;
+		}
+	}
+	MoveAddress(Direction);
+}
+
+/* Execute an instruction and return its execution time */
+uint64_t HD44780::Instruction(uint64_t Time_ns, uint8_t Command)
+{
+	if (Command & 0x80)
+	{
+		uint8_t Address = Command & 0x7F;
+
+		if ((m_twoLines && ((Address & 0x3F) >= DDRAM_LINE_LENGTH)) || (!m_twoLines && (Address >= DDRAM_SIZE)))
+		{
+			Note(Time_ns, m_totals.Address_Errors, "DDRAM address 0x%02X does not exist", Address);
+			Address = 0;
+		}
+		m_address = Address;
+		m_addressCgram = false;
+	}
+	else if (Command & 0x40)
+	{
+		m_address = Command & 0x3F;
+		m_addressCgram = true;
+	}
+	else if (Command & 0x20)
+	{
+		/* The 4-bit mode starts with the next transfer, the line count is only changed here */
+		m_eightBit = (Command & 0x10) != 0;
+		m_twoLines = (Command & 0x08) != 0;
+		m_highNibble = true;
+	}
+	else if (Command & 0x10)
+	{
+		bool Right = (Command & 0x04) != 0;
+
+		if (Command & 0x08)
+		{
+			m_shift += Right ? -1 : 1;
+		}
+		else
+		{
+			MoveAddress(Right ? 1 : -1);
+		}
+	}
+	else if (Command & 0x08)
+	{
+		m_displayOn = (Command & 0x04) != 0;
+	}
+	else if (Command & 0x04)
+	{
+		m_increment = (Command & 0x02) != 0;
+		m_shiftOnWrite = (Command & 0x01) != 0;
+	}
+	else if (Command & 0x02)
+	{
+		m_address = 0;
+		m_addressCgram = false;
+		m_shift = 0;
+		return T_CLEAR_HOME_NS;
+	}
+	else if (Command & 0x01)
+	{
+		std::memset(m_ddram, ' ', sizeof(m_ddram));
+		m_address = 0;
+		m_addressCgram = false;
+		m_increment = true;
+		m_shift = 0;
+		return T_CLEAR_HOME_NS;
+	}
+	return T_INSTRUCTION_NS;
+}
+
+std::string HD44780::Row(int Row) const
+{
+	std::string Text;
+	int Base = ((Row & 1) ? 0x40 : 0x00) + ((Row >= 2) ? m_columns : 0);
+
+	for (int Column = 0; Column < m_columns; Column++)
+	{
+		int Offset = (((Base & 0x3F) + Column + m_shift) % DDRAM_LINE_LENGTH + DDRAM_LINE_LENGTH) % DDRAM_LINE_LENGTH;
+		uint8_t Code = m_ddram[DdramIndex((uint8_t)((Base & 0x40) + Offset))];
+
+		if (!m_displayOn || (Row >= m_rows))
+		{
+			Text += ' ';
+		}
+		else if (Code < 0x10)
+		{
+			Text += (char)('0' + (Code & 0x07));
+		}
+		else
+		{
+			Text += ((Code >= 0x20) && (Code < 0x7F)) ? (char)Code : '?';
+		}
+	}
+	return Text;
+}
+
+void HD44780::BeginFrame()
+{
+	m_frameStart = m_totals;
+}
+
+HD44780_Counters HD44780::EndFrame()
+{
+	HD44780_Counters Frame;
+
+	Frame.Data_Bytes = m_totals.Data_Bytes - m_frameStart.Data_Bytes;
+	Frame.Instructions = m_totals.Instructions - m_frameStart.Instructions;
+	Frame.Enable_Pulses = m_totals.Enable_Pulses - m_frameStart.Enable_Pulses;
+	Frame.Busy_Violations = m_totals.Busy_Violations - m_frameStart.Busy_Violations;
+	Frame.Timing_Violations = m_totals.Timing_Violations - m_frameStart.Timing_Violations;
+	Frame.Address_Errors = m_totals.Address_Errors - m_frameStart.Address_Errors;
+	Frame.Busy_ns = m_totals.Busy_ns - m_frameStart.Busy_ns;
+	return Frame;
+}
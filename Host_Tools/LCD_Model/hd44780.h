@@ -0,0 +1,152 @@
+/*******************************************************************************************************************
+ * File Name: hd44780.h
+ * Date: 19/10/2026
+ * Tool: Virtual HD44780 LCD controller driven by the pins of the register shim
+ * Author: Youssef Zaki
+ *
+ * The model sees the PORTA..PORTD values after every change with the time of the write, and decodes the
+ * transfers like the controller: RS and the data bus are latched on the falling edge of E, in the 8-bit mode or
+ * as two nibbles on DB4..DB7 once a function set with DL = 0 is received (the controller always starts in the
+ * 8-bit mode, so the nibbles of the 4-bit initialization are taken as 8-bit instructions until then).
+ * It keeps the DDRAM (2 x 40 characters), the CGRAM (64 bytes), the address counter, the entry mode, the display
+ * control, the display shift and the function set.
+ * The bus timing is checked against the HD44780U datasheet (VCC = 5V, fosc = 270kHz):
+ *     tcycE >= 500ns, PWEH >= 230ns, tAS >= 40ns, tAH >= 10ns, tDSW >= 80ns, tH >= 10ns,
+ *     15ms after the power on before the first instruction,
+ *     no transfer while busy: 1.52ms after clear display/return home, 37us after the other instructions,
+ *     37us + 4us (tADD) after a data write.
+ * The violations are counted and logged; a transfer received while busy is executed anyway, unless Strict_Busy
+ * is set, then it is lost as on the real controller.
+ * The bytes, the instructions and the enable pulses are counted in total and per frame (BeginFrame/EndFrame).
+ ******************************************************************************************************************/
+#ifndef HD44780_H_
+#define HD44780_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* Pins of the LCD: port index (0 = PORTA .. 3 = PORTD) and bit, the data pins are DB0..DB7 (DB4..DB7 only in 4 bit) */
+struct HD44780_Wiring
+{
+	int Bit_Mode;
+	uint8_t Rs_Port;
+	uint8_t Rs_Bit;
+	uint8_t E_Port;
+	uint8_t E_Bit;
+	uint8_t Data_Port;
+	uint8_t Data_Bits[8];
+};
+
+struct HD44780_Counters
+{
+	unsigned long Data_Bytes = 0;
+	unsigned long Instructions = 0;
+	unsigned long Enable_Pulses = 0;
+	unsigned long Busy_Violations = 0;
+	unsigned long Timing_Violations = 0;
+	unsigned long Address_Errors = 0;
+	uint64_t Busy_ns = 0;
+};
+
+class HD44780
+{
+public:
+	static constexpr int DDRAM_SIZE = 80;
+	static constexpr int DDRAM_LINE_LENGTH = 40;
+	static constexpr int CGRAM_SIZE = 64;
+
+	HD44780(const HD44780_Wiring &Wiring, int Columns, int Rows);
+
+	/* New values of the four PORT registers, written at Time_ns (only called when one of them changed) */
+	void Update(uint64_t Time_ns, const uint8_t Ports[4]);
+
+	/* Text of a row of the display (with the display shift), CGRAM characters are shown as '0'..'7' */
+	std::string Row(int Row) const;
+
+	void BeginFrame();
+	HD44780_Counters EndFrame();
+
+	const HD44780_Counters &Totals() const
+	{
+		return m_totals;
+	}
+
+	const std::vector<std::string> &Log() const
+	{
+		return m_log;
+	}
+
+	uint8_t Cgram(int Address) const
+	{
+		return m_cgram[Address & (CGRAM_SIZE - 1)];
+	}
+
+	bool Is_Display_On() const
+	{
+		return m_displayOn;
+	}
+
+	bool Is_Two_Lines() const
+	{
+		return m_twoLines;
+	}
+
+	bool Is_Eight_Bit() const
+	{
+		return m_eightBit;
+	}
+
+	bool Strict_Busy = false;
+
+private:
+	bool Pin(const uint8_t Ports[4], uint8_t Port, uint8_t Bit) const
+	{
+		return (Ports[Port] >> Bit) & 1;
+	}
+
+	uint8_t DataBus(const uint8_t Ports[4]) const;
+	void Note(uint64_t Time_ns, unsigned long &Counter, const char *Format, ...);
+	int DdramIndex(uint8_t Address) const;
+	void Transfer(uint64_t Time_ns, bool Rs, uint8_t Bus);
+	void Execute(uint64_t Time_ns, bool Rs, uint8_t Value);
+	uint64_t Instruction(uint64_t Time_ns, uint8_t Command);
+	void WriteData(uint8_t Data);
+	void MoveAddress(int Direction);
+
+	HD44780_Wiring m_wiring;
+	int m_columns;
+	int m_rows;
+
+	/* Controller state */
+	uint8_t m_ddram[DDRAM_SIZE];
+	uint8_t m_cgram[CGRAM_SIZE];
+	uint8_t m_address = 0;
+	bool m_addressCgram = false;
+	bool m_increment = true;
+	bool m_shiftOnWrite = false;
+	bool m_displayOn = false;
+	bool m_eightBit = true;
+	bool m_twoLines = false;
+	int m_shift = 0;
+	bool m_highNibble = true;
+	uint8_t m_nibble = 0;
+	uint64_t m_busyUntil_ns = 0;
+
+	/* Pin history for the timing checks */
+	bool m_e = false;
+	bool m_rs = false;
+	uint8_t m_bus = 0;
+	uint64_t m_rsChange_ns = 0;
+	uint64_t m_busChange_ns = 0;
+	uint64_t m_rise_ns = 0;
+	uint64_t m_fall_ns = 0;
+	bool m_anyRise = false;
+	bool m_riseBusy = false;
+
+	HD44780_Counters m_totals;
+	HD44780_Counters m_frameStart;
+	std::vector<std::string> m_log;
+};
+
+#endif /* HD44780_H_ */
@@ -0,0 +1,345 @@
+/*******************************************************************************************************************
+ * File Name: lcd_model.cpp
+ * Date: 19/10/2026
+ * Tool: Golden screen checks and bus cost of LCD.c on a virtual HD44780
+ * Author: Youssef Zaki
+ *
+ * LCD.c and GPIO.c are compiled for the host against the register shim of Thermal_Sim; the PORT values are given
+ * to the HD44780 model (hd44780.h) after every write, with the time of the write. The time is counted in CPU cycles:
+ * the busy waits of <util/delay.h> exactly, and every register access as --access-cycles cycles (an estimate of
+ * the GPIO driver call around it, 10 by default at -O2 on the AVR).
+ * Each frame below is one screen update of the application (FanControllerProject.c); the screen after the frame
+ * is compared with the expected rows and the cost with the budget of the frame:
+ *     CPU time, enable pulses, instructions and data bytes, the time the LCD is busy, the violations.
+ * The tool returns 1 if a screen or a budget does not match (or, with --strict, on any timing violation, the
+ * transfers received while busy are then lost as on the real controller).
+ * Build and run on the host, for each data bus width:
+ *     for mode in 8 4; do
+ *         for f in LCD GPIO; do gcc -O2 -std=gnu99 -DF_CPU=1000000UL -DLCD_BIT_MODE=$mode -I../Thermal_Sim/shim \
+ *             -I../../Fan_Controller_Project -c ../../Fan_Controller_Project/$f.c -o $f.o; done
+ *         g++ -O2 -std=c++17 -DF_CPU=1000000UL -DLCD_BIT_MODE=$mode -I../Thermal_Sim/shim -I../../Fan_Controller_Project \
+ *             lcd_model.cpp hd44780.cpp LCD.o GPIO.o -o lcd_model_$mode
+ *         ./lcd_model_$mode; done
+ * Options: --access-cycles N [10], --strict, --log (print the logged violations)
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "hd44780.h"
+
+extern "C"
+{
+#include "Standard_Types.h"
+#include "GPIO.h"
+#include "LCD.h"
+
+char *itoa(int Value, char *Buffer, int Radix);
+}
+
+namespace
+{
+
+/****************************************************************************************
+ *                                      Register Shim                                   *
+ ****************************************************************************************/
+
+constexpr double F_CPU_HZ = (double)F_CPU;
+
+uint8_t g_registers8[SHIM_NUM_OF_REGISTERS8];
+uint16_t g_registers16[SHIM_NUM_OF_REGISTERS16];
+
+uint64_t g_cycles = 0;
+uint64_t g_idleCycles = 0;
+uint64_t g_lastAccessCycles = 0;
+unsigned g_accessCycles = 10;
+uint8_t g_ports[4];
+
+HD44780_Wiring Wiring()
+{
+	HD44780_Wiring Pins;
+
+	Pins.Bit_Mode = LCD_BIT_MODE;
+	Pins.Rs_Port = LCD_RS_PORT;
+	Pins.Rs_Bit = LCD_RS_PIN;
+	Pins.E_Port = LCD_E_PORT;
+	Pins.E_Bit = LCD_E_PIN;
+	Pins.Data_Port = LCD_DATA_PORT;
+#if (LCD_BIT_MODE == 8)
+	for (uint8_t Bit = 0; Bit < 8; Bit++)
+	{
+		Pins.Data_Bits[Bit] = Bit;
+	}
+#else
+	Pins.Data_Bits[4] = LCD_DB4_PIN_ID;
+	Pins.Data_Bits[5] = LCD_DB5_PIN_ID;
+	Pins.Data_Bits[6] = LCD_DB6_PIN_ID;
+	Pins.Data_Bits[7] = LCD_DB7_PIN_ID;
+#endif
+	return Pins;
+}
+
+HD44780 g_lcd(Wiring(), 16, 2);
+
+uint64_t Nanoseconds(uint64_t Cycles)
+{
+	return (uint64_t)(Cycles * 1e9 / F_CPU_HZ);
+}
+
+/* A write is seen at the next access, it happened at the time of the previous access */
+void Service()
+{
+	const uint8_t Ports[4] = {g_registers8[SHIM_PORTA], g_registers8[SHIM_PORTB], g_registers8[SHIM_PORTC],
+			g_registers8[SHIM_PORTD]};
+
+	if (std::memcmp(Ports, g_ports, sizeof(g_ports)))
+	{
+		std::memcpy(g_ports, Ports, sizeof(g_ports));
+		g_lcd.Update(Nanoseconds(g_lastAccessCycles), Ports);
+	}
+
+	g_registers8[SHIM_PINA] = g_registers8[SHIM_PORTA];
+	g_registers8[SHIM_PINB] = g_registers8[SHIM_PORTB];
+	g_registers8[SHIM_PINC] = g_registers8[SHIM_PORTC];
+	g_registers8[SHIM_PIND] = g_registers8[SHIM_PORTD];
+}
+
+void Access()
+{
+	Service();
+	g_lastAccessCycles = g_cycles;
+	g_cycles += g_accessCycles;
+}
+
+/****************************************************************************************
+ *                                         Frames                                       *
+ ****************************************************************************************/
+
+struct Budget
+{
+	unsigned long Instructions;
+	unsigned long Data_Bytes;
+	double Cpu_ms_8;
+	double Cpu_ms_4;
+};
+
+struct Frame
+{
+	const char *Name;
+	std::function<void()> Draw;
+	const char *Row0;
+	const char *Row1;
+	Budget Limit;
+};
+
+/* The temperature update of the main loop */
+void DrawTemperature(int Temperature)
+{
+	LCD_MoveCursor(1, 10);
+	LCD_IntegerToString(Temperature);
+	if (Temperature < 100)
+	{
+		LCD_DisplayCharacter(' ');
+	}
+	if (Temperature < 10)
+	{
+		LCD_DisplayCharacter(' ');
+	}
+}
+
+void DrawFanState(const char *State)
+{
+	LCD_MoveCursor(0, 10);
+	LCD_DisplayString(State);
+}
+
+/* A thermometer glyph in CGRAM character 0, shown at the first column */
+void DrawCustomCharacter()
+{
+	static const uint8 Glyph[8] = {0x04, 0x0A, 0x0A, 0x0A, 0x0E, 0x1F, 0x1F, 0x0E};
+
+	LCD_SendCommand(0x40);
+	for (uint8 Line : Glyph)
+	{
+		LCD_DisplayCharacter(Line);
+	}
+	LCD_MoveCursor(0, 0);
+	LCD_DisplayCharacter(0);
+}
+
+/*
+ * The background initialization of the application: one LCD_InitTask per turn of the main loop, which sleeps
+ * till the next tick of the system time base (Timer0 overflow, F_CPU/8 and 256 steps). The sleep is not CPU time.
+ */
+constexpr uint64_t TICK_CYCLES = 2048;
+
+uint32 Milliseconds()
+{
+	return (uint32)((g_cycles / TICK_CYCLES) * TICK_CYCLES * 1000 / (uint64_t)F_CPU_HZ);
+}
+
+void InitInBackground()
+{
+	LCD_StartInit(Milliseconds());
+	while (!LCD_InitTask(Milliseconds()))
+	{
+		uint64_t Next_Tick = (g_cycles / TICK_CYCLES + 1) * TICK_CYCLES;
+
+		g_idleCycles += Next_Tick - g_cycles;
+		g_cycles = Next_Tick;
+	}
+}
+
+/* The budgets hold the cost of the current LCD.c (about 2ms per byte in 8 bit, 4ms in 4 bit) */
+const std::vector<Frame> g_frames =
+{
+	{"init", [] { LCD_Init(); },
+			"                ", "                ", {7, 0, 25.0, 50.0}},
+	{"labels", [] { LCD_DisplayStringRowColumn(0, 3, "Fan is "); LCD_DisplayStringRowColumn(1, 3, "Temp = "); },
+			"   Fan is       ", "   Temp =       ", {2, 14, 35.0, 120.0}},
+	{"temperature 27", [] { DrawTemperature(27); },
+			"   Fan is       ", "   Temp = 27    ", {1, 3, 7.0, 30.0}},
+	{"temperature 100", [] { DrawTemperature(100); },
+			"   Fan is       ", "   Temp = 100   ", {1, 3, 7.0, 30.0}},
+	{"temperature 9", [] { DrawTemperature(9); },
+			"   Fan is       ", "   Temp = 9     ", {1, 3, 7.0, 30.0}},
+	{"fan on", [] { DrawFanState("ON "); },
+			"   Fan is ON    ", "   Temp = 9     ", {1, 3, 7.0, 30.0}},
+	{"fan off", [] { DrawFanState("OFF"); },
+			"   Fan is OFF   ", "   Temp = 9     ", {1, 3, 7.0, 30.0}},
+	{"fault", [] { DrawFanState("MAX"); },
+			"   Fan is MAX   ", "   Temp = 9     ", {1, 3, 7.0, 30.0}},
+	{"custom character", DrawCustomCharacter,
+			"0  Fan is MAX   ", "   Temp = 9     ", {2, 9, 20.0, 80.0}},
+	{"clear", [] { LCD_ClearString(); },
+			"                ", "                ", {1, 0, 1.0, 6.0}},
+	{"background init", InitInBackground,
+			"                ", "                ", {7, 0, 1.0, 30.0}},
+	{"labels again", [] { LCD_DisplayStringRowColumn(0, 3, "Fan is "); LCD_DisplayStringRowColumn(1, 3, "Temp = "); },
+			"   Fan is       ", "   Temp =       ", {2, 14, 35.0, 120.0}},
+};
+
+} /* namespace */
+
+/****************************************************************************************
+ *                                 Shim Entry Points (C)                                *
+ ****************************************************************************************/
+
+extern "C" volatile uint8_t *Shim_Register8(Shim_Register8Id Id)
+{
+	Access();
+	return &g_registers8[Id];
+}
+
+extern "C" volatile uint16_t *Shim_Register16(Shim_Register16Id Id)
+{
+	Access();
+	return &g_registers16[Id];
+}
+
+extern "C" void Shim_Delay_us(double Microseconds)
+{
+	Service();
+	g_cycles += (uint64_t)(Microseconds * F_CPU_HZ / 1e6 + 0.5);
+}
+
+extern "C" void Shim_Sleep(void)
+{
+}
+
+extern "C" char *itoa(int Value, char *Buffer, int Radix)
+{
+	std::snprintf(Buffer, 12, (Radix == 16) ? "%x" : "%d", Value);
+	return Buffer;
+}
+
+int main(int Argc, char **Argv)
+{
+	bool Strict = false;
+	bool Print_Log = false;
+	int Failures = 0;
+
+	for (int Index = 1; Index < Argc; Index++)
+	{
+		if (!std::strcmp(Argv[Index], "--strict")) Strict = true;
+		else if (!std::strcmp(Argv[Index], "--log")) Print_Log = true;
+		else if (!std::strcmp(Argv[Index], "--access-cycles") && (Index + 1 < Argc)) g_accessCycles = std::atoi(Argv[++Index]);
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--access-cycles N] [--strict] [--log]\n", Argv[0]);
+			return 1;
+		}
+	}
+	g_lcd.Strict_Busy = Strict;
+
+	std::printf("LCD_BIT_MODE %d, F_CPU %.0fHz, %u cycles per register access\n", LCD_BIT_MODE, F_CPU_HZ, g_accessCycles);
+	std::printf("frame               result   cpu ms  pulses  instr  bytes  lcd busy us  busy viol  timing viol\n");
+
+	for (const Frame &Item : g_frames)
+	{
+		uint64_t Start = g_cycles;
+		uint64_t Start_Idle = g_idleCycles;
+		double Cpu_ms;
+		double Budget_ms = (LCD_BIT_MODE == 8) ? Item.Limit.Cpu_ms_8 : Item.Limit.Cpu_ms_4;
+		HD44780_Counters Cost;
+		std::string Row0;
+		std::string Row1;
+		std::string Result = "ok";
+
+		g_lcd.BeginFrame();
+		Item.Draw();
+		Service();
+		Cost = g_lcd.EndFrame();
+		Cpu_ms = (g_cycles - Start - (g_idleCycles - Start_Idle)) * 1e3 / F_CPU_HZ;
+		Row0 = g_lcd.Row(0);
+		Row1 = g_lcd.Row(1);
+
+		if ((Row0 != Item.Row0) || (Row1 != Item.Row1))
+		{
+			Result = "SCREEN";
+		}
+		else if ((Cost.Instructions > Item.Limit.Instructions) || (Cost.Data_Bytes > Item.Limit.Data_Bytes) ||
+				(Cpu_ms > Budget_ms))
+		{
+			Result = "BUDGET";
+		}
+		else if (Strict && (Cost.Busy_Violations || Cost.Timing_Violations || Cost.Address_Errors))
+		{
+			Result = "TIMING";
+		}
+
+		std::printf("%-18s  %-6s  %7.2f  %6lu  %5lu  %5lu  %11.1f  %9lu  %11lu\n", Item.Name, Result.c_str(), Cpu_ms,
+				Cost.Enable_Pulses, Cost.Instructions, Cost.Data_Bytes, Cost.Busy_ns / 1e3, Cost.Busy_Violations,
+				Cost.Timing_Violations + Cost.Address_Errors);
+
+		if (Result != "ok")
+		{
+			Failures++;
+			std::printf("    expected \"%s\" \"%s\"  budget %lu instr, %lu bytes, %.1fms\n", Item.Row0, Item.Row1,
+					Item.Limit.Instructions, Item.Limit.Data_Bytes, Budget_ms);
+			std::printf("    got      \"%s\" \"%s\"\n", Row0.c_str(), Row1.c_str());
+		}
+	}
+
+	if (g_lcd.Cgram(0) != 0x04 || g_lcd.Cgram(7) != 0x0E)
+	{
+		Failures++;
+		std::printf("CGRAM character 0 not written\n");
+	}
+
+	if (Print_Log)
+	{
+		for (const std::string &Line : g_lcd.Log())
+		{
+			std::printf("  %s\n", Line.c_str());
+		}
+	}
+
+	std::printf("%d failed frames; %lu busy and %lu timing violations in total\n", Failures,
+			g_lcd.Totals().Busy_Violations, g_lcd.Totals().Timing_Violations + g_lcd.Totals().Address_Errors);
+	return (Failures != 0) ? 1 : 0;
+}
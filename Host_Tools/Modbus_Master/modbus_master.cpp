@@ -0,0 +1,555 @@
+/*******************************************************************************************************************
+ * File Name: modbus_master.cpp
+ * Date: 19/10/2026
+ * Tool: Host-side Modbus RTU master for the Modbus slave of the fan controller (serial port or pseudo terminal)
+ * Author: Youssef Zaki
+ *
+ * Talks to Modbus_Slave.c over a serial port (RS-485 adapter, 9600 baud 8E1) or over the pseudo terminal of
+ * Thermal_Sim built with the slave enabled, which runs the firmware in real time:
+ *     for f in $(ls ../../Fan_Controller_Project | grep "\.c$"); do
+ *         gcc -O2 -std=gnu99 -DF_CPU=1000000UL -DMODBUS_SLAVE_ENABLED=1 -DLCD_RS_PIN=PIN3_ID \
+ *             -Dmain=Firmware_Main -I../Thermal_Sim/shim -I../../Fan_Controller_Project \
+ *             -c ../../Fan_Controller_Project/$f -o ${f%.c}.o; done
+ *     g++ -O2 -std=c++17 -DMODBUS_SLAVE_ENABLED=1 -DLCD_RS_PIN=PIN3_ID -I../Thermal_Sim/shim \
+ *         -I../../Fan_Controller_Project ../Thermal_Sim/thermal_sim.cpp *.o -o thermal_sim
+ *     ./thermal_sim --hours 1 --modbus-pty /tmp/fan_modbus &
+ *     g++ -O2 -std=c++17 modbus_master.cpp -o modbus_master
+ *     ./modbus_master /tmp/fan_modbus test
+ * The CRC is computed bit by bit here, so the table of CRC.c is checked against the reference algorithm.
+ * Commands (options: --slave N [1], --baud B [9600], --timeout ms [200]):
+ *     read-input <start> <count>          function 04
+ *     read-holding <start> <count>        function 03
+ *     write <register> <value>            function 06
+ *     write-multiple <start> <v,v,...>    function 16
+ *     monitor [seconds]                   print the named input registers every second
+ *     test                                protocol checks: reads, writes read back, exceptions, bad CRC,
+ *                                         gap inside a frame, broadcast, latency of 200 requests
+ ******************************************************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace
+{
+
+/* Registers of Modbus_Slave.h */
+constexpr int INPUT_FAULT_FLAGS = 3;
+constexpr int INPUT_FRAMES_OK = 19;
+constexpr int INPUT_FRAME_ERRORS = 20;
+constexpr int NUM_OF_INPUT_REGISTERS = 21;
+constexpr int HOLDING_SPEEDS_FIRST = 4;
+constexpr int NUM_OF_HOLDING_REGISTERS = 10;
+
+const char *const INPUT_NAMES[NUM_OF_INPUT_REGISTERS] =
+{
+	"temperature C", "duty per mille", "fan rpm", "fault flags", "curve level", "current average mA",
+	"current peak mA", "current trips", "uptime high", "uptime low",
+	"1 min minimum", "1 min maximum", "1 min mean", "10 min minimum", "10 min maximum", "10 min mean",
+	"60 min minimum", "60 min maximum", "60 min mean", "frames ok", "frame errors"
+};
+
+struct Options
+{
+	int Slave = 1;
+	int Baud = 9600;
+	int Timeout_ms = 200;
+};
+
+Options g_options;
+int g_fd = -1;
+unsigned g_failures = 0;
+
+/****************************************************************************************
+ *                                        Frames                                        *
+ ****************************************************************************************/
+
+/* CRC-16/MODBUS, reflected polynomial 0xA001, bit by bit */
+uint16_t Crc16(const uint8_t *Data, size_t Length)
+{
+	uint16_t Crc = 0xFFFF;
+
+	for (size_t Index = 0; Index < Length; Index++)
+	{
+		Crc ^= Data[Index];
+		for (int Bit = 0; Bit < 8; Bit++)
+		{
+			Crc = (Crc & 1) ? (uint16_t)((Crc >> 1) ^ 0xA001) : (uint16_t)(Crc >> 1);
+		}
+	}
+	return Crc;
+}
+
+void PutWord(std::vector<uint8_t> &Frame, int Value)
+{
+	Frame.push_back((uint8_t)(Value >> 8));
+	Frame.push_back((uint8_t)Value);
+}
+
+void AppendCrc(std::vector<uint8_t> &Frame)
+{
+	uint16_t Crc = Crc16(Frame.data(), Frame.size());
+
+	Frame.push_back((uint8_t)Crc);
+	Frame.push_back((uint8_t)(Crc >> 8));
+}
+
+speed_t BaudConstant(int Baud)
+{
+	switch (Baud)
+	{
+	case 1200: return B1200;
+	case 2400: return B2400;
+	case 4800: return B4800;
+	case 19200: return B19200;
+	case 38400: return B38400;
+	case 57600: return B57600;
+	case 115200: return B115200;
+	default: return B9600;
+	}
+}
+
+/* Raw 8E1, the baud rate is ignored by a pseudo terminal */
+void OpenPort(const char *Path)
+{
+	struct termios Settings;
+
+	g_fd = open(Path, O_RDWR | O_NOCTTY);
+	if (g_fd < 0)
+	{
+		std::perror(Path);
+		std::exit(1);
+	}
+	if (tcgetattr(g_fd, &Settings) == 0)
+	{
+		cfmakeraw(&Settings);
+		Settings.c_cflag |= PARENB | CLOCAL | CREAD;
+		Settings.c_cflag &= ~(PARODD | CSTOPB);
+		cfsetispeed(&Settings, BaudConstant(g_options.Baud));
+		cfsetospeed(&Settings, BaudConstant(g_options.Baud));
+		tcsetattr(g_fd, TCSANOW, &Settings);
+	}
+	tcflush(g_fd, TCIOFLUSH);
+}
+
+void Send(const std::vector<uint8_t> &Frame)
+{
+	if (write(g_fd, Frame.data(), Frame.size()) != (ssize_t)Frame.size())
+	{
+		std::perror("write");
+		std::exit(1);
+	}
+	tcdrain(g_fd);
+}
+
+/*
+ * Receive a response: the length is known from the function code (exception, read or write), the bytes
+ * are read till then or till the timeout. Return the frame without its CRC, empty on timeout or bad CRC.
+ */
+std::vector<uint8_t> Receive(int Timeout_ms, const char **Error_Ptr)
+{
+	std::vector<uint8_t> Frame;
+	size_t Expected = 5;
+	auto Deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(Timeout_ms);
+
+	*Error_Ptr = "timeout";
+	while (Frame.size() < Expected)
+	{
+		int Left_ms = (int)std::chrono::duration_cast<std::chrono::milliseconds>(Deadline - std::chrono::steady_clock::now()).count();
+		struct pollfd Poll = {g_fd, POLLIN, 0};
+		uint8_t Byte;
+
+		if ((Left_ms <= 0) || (poll(&Poll, 1, Left_ms) <= 0) || (read(g_fd, &Byte, 1) != 1))
+		{
+			return {};
+		}
+		Frame.push_back(Byte);
+
+		if (Frame.size() == 3)
+		{
+			uint8_t Function = Frame[1];
+
+			if (Function & 0x80)
+			{
+				Expected = 5;
+			}
+			else if ((Function == 0x03) || (Function == 0x04))
+			{
+				Expected = 5 + Frame[2];
+			}
+			else
+			{
+				Expected = 8;
+			}
+		}
+	}
+
+	if (Crc16(Frame.data(), Frame.size()) != 0)
+	{
+		*Error_Ptr = "bad CRC";
+		return {};
+	}
+	Frame.resize(Frame.size() - 2);
+	*Error_Ptr = nullptr;
+	return Frame;
+}
+
+/*
+ * One transaction: send the request (CRC appended) and receive the response of the slave.
+ * Return the response without its CRC, an exception response has the function code | 0x80.
+ */
+std::vector<uint8_t> Transaction(std::vector<uint8_t> Request, double *Latency_ms_Ptr = nullptr)
+{
+	const char *Error;
+	std::vector<uint8_t> Response;
+	auto Start = std::chrono::steady_clock::now();
+
+	AppendCrc(Request);
+	Send(Request);
+	Response = Receive(g_options.Timeout_ms, &Error);
+
+	if (Latency_ms_Ptr)
+	{
+		*Latency_ms_Ptr = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+	}
+	if (Error)
+	{
+		std::fprintf(stderr, "no response: %s\n", Error);
+		return {};
+	}
+	if ((Response[0] != Request[0]) || ((Response[1] & 0x7F) != Request[1]))
+	{
+		std::fprintf(stderr, "response of another request (address %d function %d)\n", Response[0], Response[1]);
+		return {};
+	}
+	return Response;
+}
+
+std::vector<uint8_t> ReadRequest(int Function, int Start, int Count)
+{
+	std::vector<uint8_t> Request = {(uint8_t)g_options.Slave, (uint8_t)Function};
+
+	PutWord(Request, Start);
+	PutWord(Request, Count);
+	return Request;
+}
+
+/* Read registers, an empty vector on error or exception */
+std::vector<int> ReadRegisters(int Function, int Start, int Count)
+{
+	std::vector<uint8_t> Response = Transaction(ReadRequest(Function, Start, Count));
+	std::vector<int> Values;
+
+	if (Response.empty() || (Response[1] & 0x80) || (Response[2] != Count * 2))
+	{
+		return {};
+	}
+	for (int Index = 0; Index < Count; Index++)
+	{
+		Values.push_back((Response[3 + 2 * Index] << 8) | Response[4 + 2 * Index]);
+	}
+	return Values;
+}
+
+std::vector<uint8_t> WriteSingleRequest(int Address, int Register, int Value)
+{
+	std::vector<uint8_t> Request = {(uint8_t)Address, 0x06};
+
+	PutWord(Request, Register);
+	PutWord(Request, Value);
+	return Request;
+}
+
+std::vector<uint8_t> WriteMultipleRequest(int Address, int Start, const std::vector<int> &Values)
+{
+	std::vector<uint8_t> Request = {(uint8_t)Address, 0x10};
+
+	PutWord(Request, Start);
+	PutWord(Request, (int)Values.size());
+	Request.push_back((uint8_t)(Values.size() * 2));
+	for (int Value : Values)
+	{
+		PutWord(Request, Value);
+	}
+	return Request;
+}
+
+/* Exception code of a response, 0 for a normal response, -1 without response */
+int ExceptionOf(const std::vector<uint8_t> &Response)
+{
+	if (Response.empty())
+	{
+		return -1;
+	}
+	return (Response[1] & 0x80) ? Response[2] : 0;
+}
+
+/****************************************************************************************
+ *                                       Commands                                       *
+ ****************************************************************************************/
+
+void PrintRegisters(int Function, int Start, int Count)
+{
+	std::vector<int> Values = ReadRegisters(Function, Start, Count);
+
+	if (Values.empty())
+	{
+		std::exit(1);
+	}
+	for (int Index = 0; Index < Count; Index++)
+	{
+		int Register = Start + Index;
+
+		std::printf("%3d  %5d  0x%04X", Register, Values[Index], Values[Index]);
+		if ((Function == 0x04) && (Register < NUM_OF_INPUT_REGISTERS))
+		{
+			std::printf("  %s", INPUT_NAMES[Register]);
+		}
+		std::printf("\n");
+	}
+}
+
+void PrintWriteResult(const std::vector<uint8_t> &Response)
+{
+	int Exception = ExceptionOf(Response);
+
+	if (Exception != 0)
+	{
+		std::printf("exception %d\n", Exception);
+		std::exit(1);
+	}
+	std::printf("ok\n");
+}
+
+void Monitor(double Seconds)
+{
+	auto End = std::chrono::steady_clock::now() + std::chrono::duration<double>(Seconds);
+
+	while (std::chrono::steady_clock::now() < End)
+	{
+		std::vector<int> Values = ReadRegisters(0x04, 0, NUM_OF_INPUT_REGISTERS);
+
+		if (!Values.empty())
+		{
+			std::printf("uptime %5lds  %3dC  duty %4d  faults 0x%X  level %d  current %dmA  frames %d/%d errors\n",
+					((long)Values[8] << 16) | Values[9], Values[0], Values[1], Values[3], Values[4], Values[5],
+					Values[INPUT_FRAMES_OK], Values[INPUT_FRAME_ERRORS]);
+			std::fflush(stdout);
+		}
+		std::this_thread::sleep_for(std::chrono::seconds(1));
+	}
+}
+
+void Check(bool Passed, const char *Name)
+{
+	std::printf("%-58s %s\n", Name, Passed ? "pass" : "FAIL");
+	if (!Passed)
+	{
+		g_failures++;
+	}
+}
+
+/*
+ * Send the First bytes of a frame, then the rest after Gap_ms of silence on the line. A pseudo terminal
+ * takes the bytes at once (tcdrain returns at once) and the slave side times them, so the time of the first
+ * bytes on the line is waited for here.
+ */
+void SendWithGap(const std::vector<uint8_t> &Frame, size_t First, double Gap_ms)
+{
+	double Character_ms = 11000.0 / g_options.Baud;
+	auto Start = std::chrono::steady_clock::now();
+	double Drained_ms;
+
+	Send(std::vector<uint8_t>(Frame.begin(), Frame.begin() + First));
+	Drained_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - Start).count();
+	std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(std::max(0.0, First * Character_ms - Drained_ms) + Gap_ms));
+	Send(std::vector<uint8_t>(Frame.begin() + First, Frame.end()));
+}
+
+/* TRUE if nothing valid comes back from a request which must not be answered */
+bool NoResponse()
+{
+	const char *Error;
+
+	return Receive(g_options.Timeout_ms, &Error).empty();
+}
+
+/* Wait for the silence after a request without response, so the next request starts a new frame */
+void Silence()
+{
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	tcflush(g_fd, TCIFLUSH);
+}
+
+void Test()
+{
+	std::vector<int> Inputs = ReadRegisters(0x04, 0, NUM_OF_INPUT_REGISTERS);
+	std::vector<int> Curve = ReadRegisters(0x03, 0, NUM_OF_HOLDING_REGISTERS - 1);
+	std::vector<int> Changed;
+	std::vector<uint8_t> Request;
+	std::vector<double> Latencies;
+	int Errors;
+
+	Check(Inputs.size() == NUM_OF_INPUT_REGISTERS, "read all input registers (04)");
+	Check(Curve.size() == NUM_OF_HOLDING_REGISTERS - 1, "read the fan curve (03)");
+	if ((Inputs.size() != NUM_OF_INPUT_REGISTERS) || Curve.empty())
+	{
+		return;
+	}
+	Check((Inputs[2] == 0xFFFF) && (Inputs[INPUT_FAULT_FLAGS] <= 3), "rpm not available, known fault flags");
+
+	/* Speeds of the curve written one by one (06) then all at once (16), read back */
+	Check(ExceptionOf(Transaction(WriteSingleRequest(g_options.Slave, HOLDING_SPEEDS_FIRST, 10))) == 0,
+			"write a speed (06)");
+	Changed = Curve;
+	Changed[HOLDING_SPEEDS_FIRST] = 10;
+	Check(ReadRegisters(0x03, 0, NUM_OF_HOLDING_REGISTERS - 1) == Changed, "speed read back");
+	Check(ExceptionOf(Transaction(WriteMultipleRequest(g_options.Slave, 0, Curve))) == 0, "write the curve (16)");
+	Check(ReadRegisters(0x03, 0, NUM_OF_HOLDING_REGISTERS - 1) == Curve, "curve read back");
+
+	/* Exceptions */
+	Check(ExceptionOf(Transaction({(uint8_t)g_options.Slave, 0x2B, 0x0E, 0x01, 0x00})) == 1, "unknown function: exception 1");
+	Check(ExceptionOf(Transaction(ReadRequest(0x04, NUM_OF_INPUT_REGISTERS - 1, 2))) == 2, "read past the registers: exception 2");
+	Check(ExceptionOf(Transaction(ReadRequest(0x04, 0, 0))) == 3, "read of 0 registers: exception 3");
+	Check(ExceptionOf(Transaction(WriteSingleRequest(g_options.Slave, HOLDING_SPEEDS_FIRST, 101))) == 3, "speed of 101%: exception 3");
+	Changed = Curve;
+	std::swap(Changed[0], Changed[1]);
+	Check(ExceptionOf(Transaction(WriteMultipleRequest(g_options.Slave, 0, Changed))) == 3, "thresholds out of order: exception 3");
+	Check(ReadRegisters(0x03, 0, NUM_OF_HOLDING_REGISTERS - 1) == Curve, "curve unchanged by the rejected writes");
+
+	/* Dropped frames: no response, counted as errors */
+	Errors = ReadRegisters(0x04, INPUT_FRAME_ERRORS, 1).at(0);
+	Request = ReadRequest(0x04, 0, 1);
+	AppendCrc(Request);
+	Request.back() ^= 0x55;
+	Send(Request);
+	Check(NoResponse(), "bad CRC: no response");
+	Silence();
+
+	Request = ReadRequest(0x04, 0, 1);
+	AppendCrc(Request);
+	SendWithGap(Request, 3, 3.4);
+	Check(NoResponse(), "gap of 3.4ms (between t1.5 and t3.5) in a frame: no response");
+	Silence();
+	Check(ReadRegisters(0x04, INPUT_FRAME_ERRORS, 1).at(0) >= Errors + 2, "both frames counted as errors");
+
+	Request = ReadRequest(0x04, 0, 1);
+	Request[0] = (uint8_t)(g_options.Slave % 247 + 1);
+	AppendCrc(Request);
+	Send(Request);
+	Check(NoResponse(), "other address: no response");
+	Silence();
+
+	/* Broadcast write: applied without response */
+	Request = WriteSingleRequest(0, HOLDING_SPEEDS_FIRST, 10);
+	AppendCrc(Request);
+	Send(Request);
+	Check(NoResponse(), "broadcast write: no response");
+	Silence();
+	Changed = Curve;
+	Changed[HOLDING_SPEEDS_FIRST] = 10;
+	Check(ReadRegisters(0x03, 0, NUM_OF_HOLDING_REGISTERS - 1) == Changed, "broadcast write applied");
+	Check(ExceptionOf(Transaction(WriteMultipleRequest(g_options.Slave, 0, Curve))) == 0, "curve restored");
+
+	/* Latency: request sent to response received, the largest read */
+	for (int Index = 0; Index < 200; Index++)
+	{
+		double Latency_ms;
+
+		if (!Transaction(ReadRequest(0x04, 0, NUM_OF_INPUT_REGISTERS), &Latency_ms).empty())
+		{
+			Latencies.push_back(Latency_ms);
+		}
+	}
+	Check(Latencies.size() == 200, "200 reads of all the input registers answered");
+	if (!Latencies.empty())
+	{
+		double Sum = 0.0;
+		double Max = 0.0;
+
+		for (double Latency : Latencies)
+		{
+			Sum += Latency;
+			Max = std::max(Max, Latency);
+		}
+		std::printf("round trip (8 bytes request, %d bytes response) average %.1fms max %.1fms\n",
+				5 + 2 * NUM_OF_INPUT_REGISTERS, Sum / Latencies.size(), Max);
+	}
+
+	std::printf("%u failed\n", g_failures);
+}
+
+void Usage()
+{
+	std::fprintf(stderr, "usage: modbus_master <port> read-input|read-holding <start> <count> | write <register> <value> |\n"
+			"       write-multiple <start> <v,v,...> | monitor [seconds] | test  [--slave N] [--baud B] [--timeout ms]\n");
+	std::exit(1);
+}
+
+} /* namespace */
+
+int main(int Argc, char **Argv)
+{
+	std::vector<std::string> Arguments;
+
+	for (int Index = 1; Index < Argc; Index++)
+	{
+		if (!std::strcmp(Argv[Index], "--slave") && (Index + 1 < Argc)) g_options.Slave = std::atoi(Argv[++Index]);
+		else if (!std::strcmp(Argv[Index], "--baud") && (Index + 1 < Argc)) g_options.Baud = std::atoi(Argv[++Index]);
+		else if (!std::strcmp(Argv[Index], "--timeout") && (Index + 1 < Argc)) g_options.Timeout_ms = std::atoi(Argv[++Index]);
+		else Arguments.push_back(Argv[Index]);
+	}
+	if (Arguments.size() < 2)
+	{
+		Usage();
+	}
+
+	OpenPort(Arguments[0].c_str());
+	const std::string &Command = Arguments[1];
+
+	if (((Command == "read-input") || (Command == "read-holding")) && (Arguments.size() == 4))
+	{
+		PrintRegisters((Command == "read-input") ? 0x04 : 0x03, std::atoi(Arguments[2].c_str()), std::atoi(Arguments[3].c_str()));
+	}
+	else if ((Command == "write") && (Arguments.size() == 4))
+	{
+		PrintWriteResult(Transaction(WriteSingleRequest(g_options.Slave, std::atoi(Arguments[2].c_str()), std::atoi(Arguments[3].c_str()))));
+	}
+	else if ((Command == "write-multiple") && (Arguments.size() == 4))
+	{
+		std::vector<int> Values;
+		std::string Remaining = Arguments[3];
+
+		while (!Remaining.empty())
+		{
+			size_t Comma = Remaining.find(',');
+
+			Values.push_back(std::atoi(Remaining.substr(0, Comma).c_str()));
+			Remaining = (Comma == std::string::npos) ? "" : Remaining.substr(Comma + 1);
+		}
+		PrintWriteResult(Transaction(WriteMultipleRequest(g_options.Slave, std::atoi(Arguments[2].c_str()), Values)));
+	}
+	else if (Command == "monitor")
+	{
+		Monitor((Arguments.size() > 2) ? std::atof(Arguments[2].c_str()) : 1e9);
+	}
+	else if (Command == "test")
+	{
+		Test();
+		return (g_failures == 0) ? 0 : 1;
+	}
+	else
+	{
+		Usage();
+	}
+	return 0;
+}
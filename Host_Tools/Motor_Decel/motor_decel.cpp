@@ -0,0 +1,283 @@
+/*******************************************************************************************************************
+ * File Name: motor_decel.cpp
+ * Date: 19/10/2026
+ * Tool: Host-side simulation of the fan deceleration, coasting versus the brake/drive profile of DC_Motor.c
+ * Author: Youssef Zaki
+ *
+ * A permanent magnet DC motor with a fan load (torque proportional to the square of the speed) is driven
+ * through the bridge at the Timer0 PWM frequency:
+ *     drive period: the supply is applied during the high time, the bridge is off (coasting) during the low time,
+ *     brake period: the windings are shorted for the whole period (both bridge pins and the PWM pin high).
+ * DC_Motor.c is compiled for the host against the register shim of Thermal_Sim: DcMotor_Tick is called at
+ * each Timer0 overflow and the period is run with the bridge seen on the pins (PB0/PB1, OC0/PB3 from TCCR0,
+ * OCR0 and PORTB). Coasting is the bridge at the new compare value at once, without DcMotor_Tick.
+ * Checks:
+ *     speedup   a speed up requested while the profile of a slow down is running cancels it: no brake
+ *               period after the request, and the next period drives at the new compare value.
+ * The tool returns 1 if a check fails.
+ * Build and run on the host:
+ *     for f in DC_Motor GPIO TIMER0; do gcc -O2 -std=gnu99 -DF_CPU=1000000UL -I../Thermal_Sim/shim \
+ *         -I../../Fan_Controller_Project -c ../../Fan_Controller_Project/$f.c -o $f.o; done
+ *     g++ -O2 -std=c++17 -DF_CPU=1000000UL -I../Thermal_Sim/shim -I../../Fan_Controller_Project motor_decel.cpp \
+ *         *.o -o motor_decel
+ *     ./motor_decel
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+extern "C"
+{
+#include "Standard_Types.h"
+#include "DC_Motor.h"
+}
+
+namespace
+{
+
+/****************************************************************************************
+ *                                      Register Shim                                   *
+ ****************************************************************************************/
+
+uint8_t g_registers8[SHIM_NUM_OF_REGISTERS8];
+uint16_t g_registers16[SHIM_NUM_OF_REGISTERS16];
+
+} /* namespace */
+
+extern "C" volatile uint8_t *Shim_Register8(Shim_Register8Id Id)
+{
+	return &g_registers8[Id];
+}
+
+extern "C" volatile uint16_t *Shim_Register16(Shim_Register16Id Id)
+{
+	return &g_registers16[Id];
+}
+
+extern "C" void Shim_Sleep(void)
+{
+}
+
+namespace
+{
+
+/* Timer0 Fast PWM at F_CPU = 1MHz with F_CPU/8 */
+constexpr double PWM_PERIOD_S = 256.0 * 8.0 / 1000000.0;
+constexpr int STEPS_PER_PERIOD = 64;
+
+/* Model of a 12V fan motor */
+constexpr double SUPPLY_V = 12.0;
+constexpr double RESISTANCE_OHM = 2.0;
+constexpr double KE = 0.02;                 /* V/(rad/s), also the torque constant in Nm/A */
+constexpr double INERTIA = 2e-5;            /* kg.m^2, rotor and fan */
+constexpr double FRICTION = 1e-5;           /* Nm/(rad/s) */
+constexpr double FAN_LOAD = 1.5e-7;         /* Nm/(rad/s)^2 */
+
+enum class Phase { Drive, Coast, Brake };
+
+double Step(double Speed, Phase Bridge, double Dt)
+{
+	double Current = 0.0;
+
+	if (Bridge == Phase::Drive)
+	{
+		/* The bridge diodes do not let the current reverse, the motor only coasts above the supply voltage */
+		Current = std::max(0.0, (SUPPLY_V - KE * Speed) / RESISTANCE_OHM);
+	}
+	else if (Bridge == Phase::Brake)
+	{
+		Current = -KE * Speed / RESISTANCE_OHM;
+	}
+
+	double Torque = KE * Current - FRICTION * Speed - FAN_LOAD * Speed * std::fabs(Speed);
+	return Speed + Torque / INERTIA * Dt;
+}
+
+/* High time of the PWM pin in sub steps: compare + 1 of 256 steps (nothing at 0), or the forced level */
+unsigned HighSteps()
+{
+	uint8_t Compare;
+
+	if (g_registers8[SHIM_TCCR0] & (1 << COM01))
+	{
+		Compare = g_registers8[SHIM_OCR0];
+		return (Compare == 0) ? 0 : ((Compare + 1) * STEPS_PER_PERIOD) / 256;
+	}
+	return (g_registers8[SHIM_PORTB] & (1 << PB3)) ? STEPS_PER_PERIOD : 0;
+}
+
+/* One PWM period with the bridge on the pins: PB1 alone drives CW, PB0 and PB1 short the windings */
+double BridgePeriod(double Speed, bool *Brake_Ptr)
+{
+	double Dt = PWM_PERIOD_S / STEPS_PER_PERIOD;
+	uint8_t Pins = g_registers8[SHIM_PORTB] & ((1 << PB0) | (1 << PB1));
+	unsigned High_Steps = HighSteps();
+	Phase High = Phase::Coast;
+
+	if (Pins == ((1 << PB0) | (1 << PB1)))
+	{
+		High = Phase::Brake;
+	}
+	else if (Pins == (1 << PB1))
+	{
+		High = Phase::Drive;
+	}
+	*Brake_Ptr = (High == Phase::Brake) && (High_Steps != 0);
+
+	for (unsigned Sub_Step = 0; Sub_Step < STEPS_PER_PERIOD; Sub_Step++)
+	{
+		Speed = Step(Speed, (Sub_Step < High_Steps) ? High : Phase::Coast, Dt);
+	}
+	return Speed;
+}
+
+/* DcMotor_Init with Timer0 in Fast PWM (F_CPU/8), as the application does, and the motor at the speed */
+void StartMotor(uint8 Speed)
+{
+	std::memset(g_registers8, 0, sizeof(g_registers8));
+	std::memset(g_registers16, 0, sizeof(g_registers16));
+	g_registers8[SHIM_SREG] = 0x80;
+	g_registers8[SHIM_TCCR0] = (1 << WGM00) | (1 << WGM01) | (1 << COM01) | (1 << CS01);
+
+	DcMotor_Init();
+	DcMotor_Rotate(STOP, 0);
+	if (Speed != 0)
+	{
+		DcMotor_Rotate(CW, Speed);
+	}
+}
+
+/* Periods of the firmware from the overflow: DcMotor_Tick, then the bridge on the pins */
+struct Trace
+{
+	std::vector<double> Speeds;
+	unsigned Brake_Periods = 0;
+};
+
+double RunPeriods(double Speed, unsigned Periods, bool Tick, Trace *Trace_Ptr)
+{
+	bool Brake = false;
+
+	for (unsigned Period = 0; Period < Periods; Period++)
+	{
+		if (Tick)
+		{
+			DcMotor_Tick();
+		}
+		Speed = BridgePeriod(Speed, &Brake);
+		if (Trace_Ptr != nullptr)
+		{
+			Trace_Ptr -> Speeds.push_back(Speed);
+			Trace_Ptr -> Brake_Periods += Brake ? 1 : 0;
+		}
+	}
+	return Speed;
+}
+
+double SteadySpeed(uint8 Speed)
+{
+	StartMotor(Speed);
+	return RunPeriods(0.0, 20000, true, nullptr);
+}
+
+struct Response
+{
+	double Settle_s;
+	double Undershoot;
+	unsigned Brake_Periods;
+};
+
+/* Time to enter and stay in a band of 5% of the starting speed around the final speed */
+Response Decelerate(uint8 From_Speed, uint8 To_Speed, bool Brake)
+{
+	const double Start = SteadySpeed(From_Speed);
+	const double Final = SteadySpeed(To_Speed);
+	const double Band = 0.05 * Start;
+	Trace Run;
+	double Minimum = Start;
+	double Settle_s = 0.0;
+
+	if (Brake)
+	{
+		/* The profile of DcMotor_Rotate from a motor running at the first speed */
+		StartMotor(From_Speed);
+		DcMotor_Rotate((To_Speed == 0) ? STOP : CW, To_Speed);
+	}
+	else
+	{
+		/* Coasting: the new speed applied at once */
+		StartMotor(To_Speed);
+	}
+	RunPeriods(Start, 20000, Brake, &Run);
+
+	for (size_t Period = 0; Period < Run.Speeds.size(); Period++)
+	{
+		Minimum = std::min(Minimum, Run.Speeds[Period]);
+		if (std::fabs(Run.Speeds[Period] - Final) > Band)
+		{
+			Settle_s = (Period + 1) * PWM_PERIOD_S;
+		}
+	}
+
+	return {Settle_s, (Final > Minimum) ? (Final - Minimum) / Start * 100.0 : 0.0, Run.Brake_Periods};
+}
+
+/*
+ * Slow down from full speed to 25%, then speed up to 75% while the brake profile is running:
+ * the profile is cancelled, the motor drives at 75% from the next period without any brake period.
+ */
+bool CheckSpeedUpDuringProfile()
+{
+	Trace Slow_Down;
+	Trace Speed_Up;
+	uint8_t Expected_Compare;
+	double Speed;
+	bool Ok;
+
+	StartMotor(75);
+	Expected_Compare = g_registers8[SHIM_OCR0];
+
+	Speed = SteadySpeed(100);
+	DcMotor_Rotate(CW, 25);
+	Speed = RunPeriods(Speed, 6, true, &Slow_Down);
+
+	DcMotor_Rotate(CW, 75);
+	RunPeriods(Speed, 1, true, &Speed_Up);
+	Ok = (g_registers8[SHIM_OCR0] == Expected_Compare) && (g_registers8[SHIM_TCCR0] & (1 << COM01)) &&
+			((g_registers8[SHIM_PORTB] & ((1 << PB0) | (1 << PB1))) == (1 << PB1));
+	RunPeriods(Speed, 200, true, &Speed_Up);
+	Ok = Ok && (Slow_Down.Brake_Periods != 0) && (Speed_Up.Brake_Periods == 0);
+
+	std::printf("%-10s %u brake periods of the slow down, %u after the speed up, compare %u (expected %u): %s\n",
+			"speedup", Slow_Down.Brake_Periods, Speed_Up.Brake_Periods, (unsigned)g_registers8[SHIM_OCR0],
+			(unsigned)Expected_Compare, Ok ? "ok" : "errors");
+	return Ok;
+}
+
+} /* namespace */
+
+int main()
+{
+	const uint8 Steps[][2] = {{100, 75}, {100, 50}, {100, 25}, {100, 0}, {75, 25}, {50, 0}};
+	bool Ok;
+
+	std::printf("Brake profile: %d periods for full scale, %d%% brake periods, %d brake periods to stop\n",
+			DC_MOTOR_BRAKE_PERIODS_FULL_SCALE, DC_MOTOR_BRAKE_RATIO_PERCENT, DC_MOTOR_BRAKE_STOP_PERIODS_FULL_SCALE);
+	std::printf("  from -> to    coast settle   brake settle   brake undershoot   brake periods\n");
+
+	for (const auto &Step_Speeds : Steps)
+	{
+		Response Coast = Decelerate(Step_Speeds[0], Step_Speeds[1], false);
+		Response Brake = Decelerate(Step_Speeds[0], Step_Speeds[1], true);
+
+		std::printf("  %3u%% -> %3u%%  %8.0f ms    %8.0f ms    %5.1f%%             %5u\n", Step_Speeds[0], Step_Speeds[1],
+				Coast.Settle_s * 1000.0, Brake.Settle_s * 1000.0, Brake.Undershoot, Brake.Brake_Periods);
+	}
+
+	Ok = CheckSpeedUpDuringProfile();
+
+	return Ok ? 0 : 1;
+}
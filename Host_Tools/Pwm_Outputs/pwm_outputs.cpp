@@ -0,0 +1,825 @@
+/*******************************************************************************************************************
+ * File Name: pwm_outputs.cpp
+ * Date: 19/10/2026
+ * Tool: Host-side checks of the drivers which are not used by the application (Fan_Array.c, Soft_PWM.c, Auto_Range.c)
+ * Author: Youssef Zaki
+ *
+ * The firmware sources are compiled for the host against the register shim of Thermal_Sim and driven directly:
+ *     - every register access goes through Shim_Register8/Shim_Register16, which completes the polled ADC
+ *       conversions at once with the code set by the check for the channel in ADMUX (and counts them), the
+ *       differential channels from the input voltages with an offset of the gain stage, and the first
+ *       conversion of a gain channel after a change of the channel saturated (not settled),
+ *     - every register access takes SHIM_ACCESS_CYCLES CPU cycles: Timer2 counts them (Normal Mode), sets its
+ *       overflow and compare match flags (TIFR is write one to clear and reads 0) and its interrupts are called
+ *       at the next access while the I bit of SREG is set, the compare match first like the AVR,
+ *     - the changes of the port latches are recorded with the Timer2 count at the access which sees them.
+ * Checks:
+ *     fanarray  FanArray_Init sets up the direction pins and the timers of the channels in the table,
+ *               FanArray_SetSpeed writes nothing, FanArray_UpdateAll writes the direction pins and the compare
+ *               registers of the changed fans only, FanArray_Control reads each sensor channel once and
+ *               applies the curve of every fan (FanCurve_GetSpeed).
+ *     softpwm   6 channels on 3 ports with fixed then random duty cycle sets, committed at random times while
+ *               the main context writes other pins of the same ports with GPIO_WritePin. Every period must follow
+ *               one whole set, the last one committed before its overflow: a channel at 0 stays low, at 255 stays
+ *               high, otherwise it rises at most SOFT_PWM_CHECK_TOLERANCE ticks after the overflow and falls
+ *               from its duty cycle to SOFT_PWM_CHECK_TOLERANCE ticks later. Channels with the same duty cycle
+ *               on one port fall in the same write, and the pins of the main context keep their value.
+ *     autorange LM35_GetPreciseTemperature with the sensor on ADC1: the fine range (ADC1-ADC0 10x) is entered
+ *               from the coarse one of the init, kept up to saturation, left for the coarse range when
+ *               saturated, and entered again only AUTO_RANGE_HYSTERESIS_CODES below its limit. Every read
+ *               is within a step of the temperature (the settling conversion is dropped, the offset removed),
+ *               and none waits the reference settling. With the sensor on ADC3 the ADC3-ADC2 pair is used,
+ *               on ADC2 (the default of Fan_Config) the single ended range only, and the reference of ADC_Init
+ *               (AVCC) is kept.
+ * The channels left out of the build (FAN_ARRAY_TIMER1_ENABLED, FAN_ARRAY_TIMER2_ENABLED) must leave their
+ * timer alone, build with -DTEMP_SENSOR_SOURCE=1 (and One_Wire DS18B20 Sys_Time CRC added to the list) to check it.
+ * The tool returns 1 if a check fails.
+ * Build and run on the host:
+ *     for f in GPIO TIMER0 TIMER1 TIMER2 ADC Auto_Range LM35 Temp_Sensor Fan_Curve Fan_Array Soft_PWM; do \
+ *         gcc -O2 -std=gnu99 -DF_CPU=1000000UL -I../Thermal_Sim/shim -I../../Fan_Controller_Project \
+ *             -c ../../Fan_Controller_Project/$f.c -o $f.o; done
+ *     g++ -O2 -std=c++17 -DF_CPU=1000000UL -I../Thermal_Sim/shim -I../../Fan_Controller_Project pwm_outputs.cpp \
+ *         *.o -o pwm_outputs
+ *     ./pwm_outputs
+ * Options: --only NAME
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+#include "Standard_Types.h"
+#include "GPIO.h"
+#include "ADC.h"
+#include "LM35.h"
+#include "Auto_Range.h"
+#include "Fan_Curve.h"
+#include "Fan_Array.h"
+#include "Soft_PWM.h"
+
+void Shim_Isr_TIMER2_OVF(void);
+void Shim_Isr_TIMER2_COMP(void);
+}
+
+namespace
+{
+
+/****************************************************************************************
+ *                                      Register Shim                                   *
+ ****************************************************************************************/
+
+uint8_t g_registers8[SHIM_NUM_OF_REGISTERS8];
+uint16_t g_registers16[SHIM_NUM_OF_REGISTERS16];
+
+/* An lds/sts and the few instructions around it, and the interrupt response plus the vector jump */
+constexpr uint64_t SHIM_ACCESS_CYCLES = 4;
+constexpr uint64_t SHIM_ISR_ENTRY_CYCLES = 8;
+
+constexpr uint8_t SREG_I = 0x80;
+
+/* Code of each single ended ADC channel and number of conversions of each channel */
+uint16_t g_adcCodes[8];
+unsigned g_adcConversions[8];
+
+/* Voltage of each input for the differential channels, the offset of the gain stage in codes */
+constexpr double SHIM_VREF_V = 2.56;
+double g_adcVolts[8];
+long g_adcGainOffset = 0;
+
+/* Conversions of each MUX4:0 value, the last value seen in ADMUX and whether it was converted since */
+unsigned g_muxConversions[32];
+unsigned g_lastMux = 0;
+bool g_muxSettled = true;
+
+/* Time waited in _delay_us/_delay_ms */
+double g_delayedUs = 0.0;
+
+/* CPU time, Timer2 prescaler count, interrupt flags and number of Timer2 overflows (periods) */
+uint64_t g_cycles = 0;
+uint64_t g_timer2Cycles = 0;
+uint8_t g_tifr = 0;
+uint64_t g_timer2Overflows = 0;
+bool g_inIsr = false;
+
+/* Called at each access with the latch values seen, and when the Timer2 overflow interrupt is taken */
+void (*g_portWatcher)(void) = nullptr;
+void (*g_overflowWatcher)(void) = nullptr;
+
+void Timer2Tick()
+{
+	g_registers8[SHIM_TCNT2]++;
+	if (g_registers8[SHIM_TCNT2] == 0)
+	{
+		g_tifr |= (1 << TOV2);
+		g_timer2Overflows++;
+	}
+	if (g_registers8[SHIM_TCNT2] == g_registers8[SHIM_OCR2])
+	{
+		g_tifr |= (1 << OCF2);
+	}
+}
+
+void Advance(uint64_t Cycles)
+{
+	static const uint64_t Divisions[8] = {0, 1, 8, 32, 64, 128, 256, 1024};
+	uint64_t Division = Divisions[g_registers8[SHIM_TCCR2] & 0x07];
+
+	g_cycles += Cycles;
+	if (Division == 0)
+	{
+		return;
+	}
+
+	g_timer2Cycles += Cycles;
+	while (g_timer2Cycles >= Division)
+	{
+		g_timer2Cycles -= Division;
+		Timer2Tick();
+	}
+}
+
+void RunIsr(void (*Vector)(void))
+{
+	g_inIsr = true;
+	g_registers8[SHIM_SREG] &= (uint8_t)~SREG_I;
+	Advance(SHIM_ISR_ENTRY_CYCLES);
+	if ((Vector == Shim_Isr_TIMER2_OVF) && (g_overflowWatcher != nullptr))
+	{
+		g_overflowWatcher();
+	}
+	Vector();
+	g_registers8[SHIM_SREG] |= SREG_I;
+	g_inIsr = false;
+}
+
+/* Code of a conversion of the MUX4:0 value (ATmega32 channel table) */
+uint16_t AdcCode(unsigned Mux)
+{
+	/* Positive input, negative input and gain of the channels 8 to 15 */
+	static const unsigned Gain_Channels[8][3] =
+	{
+		{0, 0, 10}, {1, 0, 10}, {0, 0, 200}, {1, 0, 200}, {2, 2, 10}, {3, 2, 10}, {2, 2, 200}, {3, 2, 200}
+	};
+	unsigned Positive;
+	unsigned Negative;
+	unsigned Gain = 1;
+	long Code;
+
+	if (Mux < 8)
+	{
+		return g_adcCodes[Mux];
+	}
+	if (Mux >= 30)
+	{
+		return (Mux == 30) ? (uint16_t)std::lround(1.22 * 1024.0 / SHIM_VREF_V) : 0;
+	}
+
+	if (Mux < 16)
+	{
+		Positive = Gain_Channels[Mux - 8][0];
+		Negative = Gain_Channels[Mux - 8][1];
+		Gain = Gain_Channels[Mux - 8][2];
+	}
+	else
+	{
+		Positive = (Mux < 24) ? (Mux - 16) : (Mux - 24);
+		Negative = (Mux < 24) ? 1 : 2;
+	}
+
+	Code = std::lround((g_adcVolts[Positive] - g_adcVolts[Negative]) * Gain * 512.0 / SHIM_VREF_V);
+	if (Gain != 1)
+	{
+		Code = g_muxSettled ? (Code + g_adcGainOffset) : ADC_DIFF_MAX_VALUE;
+	}
+	Code = std::max<long>(ADC_DIFF_MIN_VALUE, std::min<long>(ADC_DIFF_MAX_VALUE, Code));
+
+	return (uint16_t)(Code & ADC_MAX_VALUE);
+}
+
+/*
+ * The effects of the previous access: a started conversion is finished, the ones written to TIFR clear their
+ * flags, the latches are watched, then the time passes and an enabled interrupt is taken
+ */
+void Service()
+{
+	unsigned Mux = g_registers8[SHIM_ADMUX] & 0x1F;
+
+	if (Mux != g_lastMux)
+	{
+		g_lastMux = Mux;
+		g_muxSettled = false;
+	}
+
+	if (g_registers8[SHIM_ADCSRA] & (1 << ADSC))
+	{
+		g_registers16[SHIM_ADC] = AdcCode(Mux);
+		g_adcConversions[Mux & 0x07] += (Mux < 8) ? 1 : 0;
+		g_muxConversions[Mux]++;
+		g_muxSettled = true;
+		g_registers8[SHIM_ADCSRA] = (uint8_t)((g_registers8[SHIM_ADCSRA] & ~(1 << ADSC)) | (1 << ADIF));
+	}
+
+	g_tifr &= (uint8_t)~g_registers8[SHIM_TIFR];
+	g_registers8[SHIM_TIFR] = 0;
+
+	if (g_portWatcher != nullptr)
+	{
+		g_portWatcher();
+	}
+
+	Advance(SHIM_ACCESS_CYCLES);
+
+	if (g_inIsr || !(g_registers8[SHIM_SREG] & SREG_I))
+	{
+		return;
+	}
+	if ((g_registers8[SHIM_TIMSK] & (1 << OCIE2)) && (g_tifr & (1 << OCF2)))
+	{
+		g_tifr &= (uint8_t)~(1 << OCF2);
+		RunIsr(Shim_Isr_TIMER2_COMP);
+	}
+	else if ((g_registers8[SHIM_TIMSK] & (1 << TOIE2)) && (g_tifr & (1 << TOV2)))
+	{
+		g_tifr &= (uint8_t)~(1 << TOV2);
+		RunIsr(Shim_Isr_TIMER2_OVF);
+	}
+}
+
+} /* namespace */
+
+extern "C" volatile uint8_t *Shim_Register8(Shim_Register8Id Id)
+{
+	Service();
+	return &g_registers8[Id];
+}
+
+extern "C" volatile uint16_t *Shim_Register16(Shim_Register16Id Id)
+{
+	Service();
+	return &g_registers16[Id];
+}
+
+extern "C" void Shim_Sleep(void)
+{
+}
+
+extern "C" void Shim_Delay_us(double Microseconds)
+{
+	g_delayedUs += Microseconds;
+}
+
+namespace
+{
+
+/****************************************************************************************
+ *                                        Checks                                        *
+ ****************************************************************************************/
+
+unsigned g_failures = 0;
+
+void Check(bool Condition, const char *Scenario, const char *Format, unsigned Value, unsigned Expected)
+{
+	if (!Condition)
+	{
+		g_failures++;
+		std::printf("%-10s FAIL %s: %u, expected %u\n", Scenario, Format, Value, Expected);
+	}
+}
+
+void ResetRegisters()
+{
+	std::memset(g_registers8, 0, sizeof(g_registers8));
+	std::memset(g_registers16, 0, sizeof(g_registers16));
+	std::memset(g_adcConversions, 0, sizeof(g_adcConversions));
+	std::memset(g_adcVolts, 0, sizeof(g_adcVolts));
+	std::memset(g_muxConversions, 0, sizeof(g_muxConversions));
+	g_adcGainOffset = 0;
+	g_lastMux = 0;
+	g_muxSettled = true;
+	g_delayedUs = 0.0;
+	g_tifr = 0;
+	g_timer2Cycles = 0;
+	g_timer2Overflows = 0;
+	g_portWatcher = nullptr;
+	g_overflowWatcher = nullptr;
+}
+
+volatile uint8_t &PortLatch(uint8 Port)
+{
+	static const Shim_Register8Id Latches[] = {SHIM_PORTA, SHIM_PORTB, SHIM_PORTC, SHIM_PORTD};
+	return g_registers8[Latches[Port]];
+}
+
+/*--------------------------------------------- fanarray ----------------------------------------------*/
+
+const FanCurve_Type g_curveLow = {{30, 40, 50, 60}, {0, 25, 50, 75, 100}};
+const FanCurve_Type g_curveHigh = {{45, 55, 65, 75}, {0, 40, 60, 80, 100}};
+
+/* Two fans share the sensor on ADC2 */
+const FanArray_FanConfigType g_fans[] =
+{
+	{PORTB_ID, PIN0_ID, PIN1_ID, FAN_ARRAY_OC0,  ADC2, &g_curveLow},
+	{PORTC_ID, PIN0_ID, PIN1_ID, FAN_ARRAY_OC1A, ADC3, &g_curveHigh},
+	{PORTC_ID, PIN2_ID, PIN3_ID, FAN_ARRAY_OC1B, ADC2, &g_curveHigh},
+	{PORTA_ID, PIN6_ID, PIN7_ID, FAN_ARRAY_OC2,  ADC4, &g_curveLow}
+};
+constexpr unsigned NUM_OF_FANS = sizeof(g_fans) / sizeof(g_fans[0]);
+
+/* The compare register of the channel of a fan */
+unsigned CompareRegister(FanArray_PwmChannel Channel)
+{
+	switch (Channel)
+	{
+	case FAN_ARRAY_OC0:
+		return g_registers8[SHIM_OCR0];
+	case FAN_ARRAY_OC1A:
+		return g_registers16[SHIM_OCR1A];
+	case FAN_ARRAY_OC1B:
+		return g_registers16[SHIM_OCR1B];
+	default:
+		return g_registers8[SHIM_OCR2];
+	}
+}
+
+bool ChannelEnabled(FanArray_PwmChannel Channel)
+{
+	if ((Channel == FAN_ARRAY_OC1A) || (Channel == FAN_ARRAY_OC1B))
+	{
+		return FAN_ARRAY_TIMER1_ENABLED;
+	}
+	if (Channel == FAN_ARRAY_OC2)
+	{
+		return FAN_ARRAY_TIMER2_ENABLED;
+	}
+	return true;
+}
+
+/* Direction pins and compare register of one fan against the state and speed */
+void CheckFanOutputs(unsigned Fan, DcMotor_State State, unsigned Speed)
+{
+	const FanArray_FanConfigType &Config = g_fans[Fan];
+	unsigned Pins = PortLatch(Config.Direction_Port);
+	unsigned Pin_A = (Pins >> Config.Pin_A) & 1;
+	unsigned Pin_B = (Pins >> Config.Pin_B) & 1;
+	unsigned Compare = (State == STOP) ? 0 : (Speed * 255) / 100;
+
+	Check(Pin_A == ((State == A_CW) ? 1u : 0u), "fanarray", "direction pin A", Pin_A, State == A_CW);
+	Check(Pin_B == ((State == CW) ? 1u : 0u), "fanarray", "direction pin B", Pin_B, State == CW);
+	if (ChannelEnabled(Config.Pwm_Channel))
+	{
+		Check(CompareRegister(Config.Pwm_Channel) == Compare, "fanarray", "compare register", CompareRegister(Config.Pwm_Channel), Compare);
+	}
+}
+
+void RunFanArray()
+{
+	static const DcMotor_State States[NUM_OF_FANS] = {CW, A_CW, CW, CW};
+	static const uint8 Speeds[NUM_OF_FANS] = {40, 100, 7, 63};
+	uint8_t Before[4];
+
+	ResetRegisters();
+
+	/* A fan left out of the build must not start its timer, one in it must start the Fast PWM */
+	g_registers8[SHIM_PORTB] = 0xFF;
+	FanArray_Init(g_fans, NUM_OF_FANS);
+
+	Check((g_registers8[SHIM_DDRB] & 0x03) == 0x03, "fanarray", "DDRB direction pins", g_registers8[SHIM_DDRB] & 0x03, 0x03);
+	Check((g_registers8[SHIM_PORTB] & 0x03) == 0, "fanarray", "PORTB direction pins after init", g_registers8[SHIM_PORTB] & 0x03, 0);
+	Check((g_registers8[SHIM_PORTB] & 0xFC) == 0xFC, "fanarray", "PORTB other pins after init", g_registers8[SHIM_PORTB] & 0xFC, 0xFC);
+	Check((g_registers8[SHIM_TCCR1B] != 0) == FAN_ARRAY_TIMER1_ENABLED, "fanarray", "Timer1 started", g_registers8[SHIM_TCCR1B] != 0, FAN_ARRAY_TIMER1_ENABLED);
+	Check((g_registers8[SHIM_TCCR2] != 0) == FAN_ARRAY_TIMER2_ENABLED, "fanarray", "Timer2 started", g_registers8[SHIM_TCCR2] != 0, FAN_ARRAY_TIMER2_ENABLED);
+	if (FAN_ARRAY_TIMER1_ENABLED)
+	{
+		Check(g_registers16[SHIM_ICR1] == FAN_ARRAY_TIMER1_TOP, "fanarray", "Timer1 TOP", g_registers16[SHIM_ICR1], FAN_ARRAY_TIMER1_TOP);
+	}
+
+	/* The requests are only written by FanArray_UpdateAll */
+	std::memcpy(Before, &g_registers8[SHIM_PORTA], sizeof(Before));
+	for (unsigned Fan = 0; Fan < NUM_OF_FANS; Fan++)
+	{
+		FanArray_SetSpeed((uint8)Fan, States[Fan], Speeds[Fan]);
+	}
+	Check(std::memcmp(Before, &g_registers8[SHIM_PORTA], sizeof(Before)) == 0, "fanarray", "ports written before the update", 1, 0);
+	Check(g_registers8[SHIM_OCR0] == 0, "fanarray", "OCR0 before the update", g_registers8[SHIM_OCR0], 0);
+
+	FanArray_UpdateAll();
+	for (unsigned Fan = 0; Fan < NUM_OF_FANS; Fan++)
+	{
+		CheckFanOutputs(Fan, States[Fan], Speeds[Fan]);
+		Check(FanArray_GetSpeed((uint8)Fan) == Speeds[Fan], "fanarray", "FanArray_GetSpeed", FanArray_GetSpeed((uint8)Fan), Speeds[Fan]);
+	}
+
+	/* Only the changed fan is written: a compare register changed behind it stays as it is */
+	g_registers8[SHIM_OCR0] = 0x5A;
+	FanArray_SetSpeed(1, A_CW, 100);
+	FanArray_SetSpeed(2, STOP, 0);
+	FanArray_UpdateAll();
+	Check(g_registers8[SHIM_OCR0] == 0x5A, "fanarray", "OCR0 of an unchanged fan", g_registers8[SHIM_OCR0], 0x5A);
+	CheckFanOutputs(2, STOP, 0);
+	g_registers8[SHIM_OCR0] = (uint8_t)((Speeds[0] * 255) / 100);
+
+	/* Out of range fans and speeds */
+	FanArray_SetSpeed(NUM_OF_FANS, CW, 50);
+	FanArray_SetSpeed(3, CW, 150);
+	FanArray_UpdateAll();
+	CheckFanOutputs(3, CW, 100);
+
+	/* Control: one conversion per sensor channel, the curve of each fan on its own sensor */
+	g_adcCodes[ADC2] = LM35_TemperatureToCode(52);
+	g_adcCodes[ADC3] = LM35_TemperatureToCode(80);
+	g_adcCodes[ADC4] = LM35_TemperatureToCode(20);
+	std::memset(g_adcConversions, 0, sizeof(g_adcConversions));
+	FanArray_Control();
+
+	for (unsigned Channel : {ADC2, ADC3, ADC4})
+	{
+		Check(g_adcConversions[Channel] == 1, "fanarray", "conversions of a sensor channel", g_adcConversions[Channel], 1);
+	}
+	for (unsigned Fan = 0; Fan < NUM_OF_FANS; Fan++)
+	{
+		uint8 Temperature = LM35_ConvertToTemperature(g_adcCodes[g_fans[Fan].Sensor_Channel]);
+		uint8 Speed = FanCurve_GetSpeed(g_fans[Fan].Curve_Ptr, Temperature);
+
+		Check(FanArray_GetTemperature((uint8)Fan) == Temperature, "fanarray", "FanArray_GetTemperature", FanArray_GetTemperature((uint8)Fan), Temperature);
+		CheckFanOutputs(Fan, (Speed == 0) ? STOP : CW, Speed);
+	}
+
+	std::printf("%-10s %s\n", "fanarray", g_failures ? "errors" : "ok");
+}
+
+/*--------------------------------------------- softpwm -----------------------------------------------*/
+
+constexpr unsigned SOFT_PWM_CHECK_TOLERANCE = 6;
+constexpr uint64_t PERIOD_CYCLES = 256 * 8;
+
+/* Channels 0 and 1 on PB, 2 and 3 on PC, 4 on PB, 5 on PA; PB7 and PC7 are written by the main context */
+const SoftPWM_ChannelConfigType g_softChannels[] =
+{
+	{PORTB_ID, PIN0_ID}, {PORTB_ID, PIN1_ID}, {PORTC_ID, PIN4_ID}, {PORTC_ID, PIN5_ID}, {PORTB_ID, PIN2_ID}, {PORTA_ID, PIN2_ID}
+};
+constexpr unsigned NUM_OF_SOFT_CHANNELS = sizeof(g_softChannels) / sizeof(g_softChannels[0]);
+
+using DutySet = std::array<uint8_t, NUM_OF_SOFT_CHANNELS>;
+
+/* What a channel did in one period, from its overflow interrupt to the next one */
+struct ChannelPeriod
+{
+	unsigned Rises = 0;
+	unsigned Falls = 0;
+	unsigned Rise_Position = 0;
+	unsigned Fall_Position = 0;
+	uint64_t Fall_Cycle = 0;
+	bool Start_High = false;
+	bool End_High = false;
+};
+
+std::vector<std::array<ChannelPeriod, NUM_OF_SOFT_CHANNELS>> g_periods;
+bool g_levels[NUM_OF_SOFT_CHANNELS];
+uint64_t g_periodOverflows = 0;
+
+unsigned Level(unsigned Channel)
+{
+	return (PortLatch(g_softChannels[Channel].Port) >> g_softChannels[Channel].Pin) & 1;
+}
+
+/*
+ * A period of the engine starts when its overflow interrupt is taken (the edges of the period before, late
+ * or not, are written by then): the position of an edge is counted in Timer2 ticks from the overflow
+ */
+void WatchSoftPwm()
+{
+	unsigned Position = (unsigned)((g_timer2Overflows - g_periodOverflows) * 256 + g_registers8[SHIM_TCNT2]);
+
+	for (unsigned Channel = 0; Channel < NUM_OF_SOFT_CHANNELS; Channel++)
+	{
+		bool High = Level(Channel);
+		ChannelPeriod &Record = g_periods.back()[Channel];
+
+		if (High && !g_levels[Channel])
+		{
+			Record.Rises++;
+			Record.Rise_Position = Position;
+		}
+		else if (!High && g_levels[Channel])
+		{
+			Record.Falls++;
+			Record.Fall_Position = Position;
+			Record.Fall_Cycle = g_cycles;
+		}
+		g_levels[Channel] = High;
+	}
+}
+
+/* The overflow vector of the firmware, behind the start of a period */
+void SoftPwmPeriodStart()
+{
+	WatchSoftPwm();
+	for (unsigned Channel = 0; Channel < NUM_OF_SOFT_CHANNELS; Channel++)
+	{
+		g_periods.back()[Channel].End_High = g_levels[Channel];
+	}
+
+	g_periods.emplace_back();
+	g_periodOverflows = g_timer2Overflows;
+	for (unsigned Channel = 0; Channel < NUM_OF_SOFT_CHANNELS; Channel++)
+	{
+		g_periods.back()[Channel].Start_High = g_levels[Channel];
+	}
+}
+
+bool PeriodFollows(const std::array<ChannelPeriod, NUM_OF_SOFT_CHANNELS> &Period, const DutySet &Duties)
+{
+	for (unsigned Channel = 0; Channel < NUM_OF_SOFT_CHANNELS; Channel++)
+	{
+		const ChannelPeriod &Record = Period[Channel];
+		unsigned Duty = Duties[Channel];
+
+		if (Duty == 0)
+		{
+			if ((Record.Rises != 0) || Record.End_High)
+			{
+				return false;
+			}
+		}
+		else if (Duty == 0xFF)
+		{
+			if ((Record.Falls != 0) || !Record.End_High)
+			{
+				return false;
+			}
+		}
+		else
+		{
+			/* Already high at the start when the channel was at 255 */
+			if ((Record.Rises + (Record.Start_High ? 1u : 0u)) != 1)
+			{
+				return false;
+			}
+			if ((Record.Rises == 1) && (Record.Rise_Position > SOFT_PWM_CHECK_TOLERANCE))
+			{
+				return false;
+			}
+			if ((Record.Falls != 1) || (Record.Fall_Position < Duty) || (Record.Fall_Position > Duty + SOFT_PWM_CHECK_TOLERANCE))
+			{
+				return false;
+			}
+		}
+	}
+
+	/* The same duty cycle on the same port is one write */
+	for (unsigned First = 0; First < NUM_OF_SOFT_CHANNELS; First++)
+	{
+		for (unsigned Second = First + 1; Second < NUM_OF_SOFT_CHANNELS; Second++)
+		{
+			if ((g_softChannels[First].Port == g_softChannels[Second].Port) && (Duties[First] == Duties[Second]) &&
+				(Duties[First] != 0) && (Duties[First] != 0xFF) && (Period[First].Fall_Cycle != Period[Second].Fall_Cycle))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void RunSoftPwm()
+{
+	static const DutySet Fixed[] =
+	{
+		/* Merged edge on PB, the same time on two ports, an edge inside the margin, always high */
+		{10, 10, 200, 14, 200, 255},
+		/* 255 to 0, close edges, an edge near the end of the period */
+		{0, 90, 91, 160, 250, 30},
+		{255, 255, 1, 2, 3, 0},
+		/* 255 to 0 */
+		{0, 64, 32, 16, 8, 4}
+	};
+	struct Phase
+	{
+		DutySet Duties;
+		uint64_t Commit_Period;
+	};
+	std::vector<Phase> Phases;
+	uint32_t Random = 2463534242u;
+	uint8 Main_Level = 0;
+	unsigned Main_Errors = 0;
+	unsigned Wrong_Periods = 0;
+	unsigned Checked_Periods = 0;
+
+	ResetRegisters();
+	g_periods.assign(1, {});
+	std::memset(g_levels, 0, sizeof(g_levels));
+	g_periodOverflows = 0;
+	g_portWatcher = WatchSoftPwm;
+	g_overflowWatcher = SoftPwmPeriodStart;
+
+	SoftPWM_Init(g_softChannels, NUM_OF_SOFT_CHANNELS);
+	g_registers8[SHIM_SREG] |= SREG_I;
+
+	for (unsigned Count = 0; Count < 400; Count++)
+	{
+		Phase New_Phase;
+		uint64_t Run_Cycles;
+
+		if (Count < 4 * 2)
+		{
+			/* The fixed sets for 10 periods each, twice */
+			New_Phase.Duties = Fixed[Count % 4];
+			Run_Cycles = 10 * PERIOD_CYCLES;
+		}
+		else
+		{
+			for (uint8_t &Duty : New_Phase.Duties)
+			{
+				Random ^= Random << 13;
+				Random ^= Random >> 17;
+				Random ^= Random << 5;
+				Duty = (uint8_t)Random;
+			}
+			Run_Cycles = (Random >> 8) % (3 * PERIOD_CYCLES);
+		}
+
+		for (unsigned Channel = 0; Channel < NUM_OF_SOFT_CHANNELS; Channel++)
+		{
+			SoftPWM_SetDuty((uint8)Channel, New_Phase.Duties[Channel]);
+		}
+		SoftPWM_Commit();
+		New_Phase.Commit_Period = g_periods.size() - 1;
+		Phases.push_back(New_Phase);
+
+		/* The main context writes its own pins of the same ports meanwhile */
+		uint64_t End = g_cycles + Run_Cycles;
+		while (g_cycles < End)
+		{
+			Main_Level ^= 1;
+			GPIO_WritePin(PORTB_ID, PIN7_ID, Main_Level);
+			GPIO_WritePin(PORTC_ID, PIN7_ID, Main_Level ^ 1);
+			if ((((g_registers8[SHIM_PORTB] >> 7) & 1) != Main_Level) || (((g_registers8[SHIM_PORTC] >> 7) & 1) != (Main_Level ^ 1u)))
+			{
+				Main_Errors++;
+			}
+		}
+	}
+
+	/* Each phase owns the periods from the one after its commit to the one of the next commit */
+	for (size_t Index = 0; Index < Phases.size(); Index++)
+	{
+		uint64_t First = Phases[Index].Commit_Period + 1;
+		uint64_t Last = (Index + 1 < Phases.size()) ? Phases[Index + 1].Commit_Period : g_periods.size() - 2;
+
+		for (uint64_t Period = First; Period <= Last; Period++)
+		{
+			Checked_Periods++;
+			if (!PeriodFollows(g_periods[Period], Phases[Index].Duties))
+			{
+				if (Wrong_Periods < 5)
+				{
+					std::printf("%-10s FAIL period %llu of duty cycles", "softpwm", (unsigned long long)Period);
+					for (unsigned Channel = 0; Channel < NUM_OF_SOFT_CHANNELS; Channel++)
+					{
+						const ChannelPeriod &Record = g_periods[Period][Channel];
+						std::printf(" %u(r%u@%u f%u@%u%s)", Phases[Index].Duties[Channel], Record.Rises, Record.Rise_Position,
+							Record.Falls, Record.Fall_Position, Record.End_High ? " high" : "");
+					}
+					std::printf("\n");
+				}
+				Wrong_Periods++;
+			}
+		}
+	}
+
+	Check(Wrong_Periods == 0, "softpwm", "periods not following their duty cycle set", Wrong_Periods, 0);
+	Check(Main_Errors == 0, "softpwm", "pins of the main context lost", Main_Errors, 0);
+	std::printf("%-10s %u periods of %zu duty cycle sets: %s\n", "softpwm", Checked_Periods, Phases.size(), (Wrong_Periods || Main_Errors) ? "errors" : "ok");
+	g_portWatcher = nullptr;
+	g_overflowWatcher = nullptr;
+}
+
+/****************************************************************************************
+ *                                      Auto Ranging                                    *
+ ****************************************************************************************/
+
+/* The LM35 output (10mV/C) on a single ended channel */
+void SetSensor(unsigned Channel, double Celsius)
+{
+	g_adcVolts[Channel] = Celsius * 0.01;
+	g_adcCodes[Channel] = (uint16_t)std::min(1023L, std::lround(g_adcVolts[Channel] * 1024.0 / SHIM_VREF_V));
+}
+
+/* ADC_Init with the reference, the sensor channel and the ranges of LM35_InitAutoRange */
+void StartAutoRange(VoltageReference_Select Voltage_Ref, uint8 Channel)
+{
+	ADC_ConfigType Config = {Voltage_Ref, CLK_8, Free_Running};
+
+	ResetRegisters();
+	g_registers8[SHIM_SREG] = SREG_I;
+	g_adcGainOffset = 3;
+	ADC_Init(&Config);
+	LM35_SetChannel(Channel);
+	LM35_InitAutoRange();
+}
+
+/*
+ * One read at the temperature: the range, the gain channel conversions (the dropped one included) and a result
+ * within the step of the range (0.05C or 0.25C) plus the 1023/1024 scale of LM35_ConvertToTemperature
+ */
+void CheckPrecise(const char *Label, unsigned Channel, double Celsius, unsigned Range, unsigned Gain_Mux,
+		unsigned Gain_Conversions)
+{
+	const double Tolerance = ((Range == 0) && (Gain_Mux != 0)) ? 5.0 : 25.0;
+	unsigned Expected = (unsigned)std::lround(Celsius * LM35_PRECISE_DEGREE_FRACTION);
+	unsigned Before = (Gain_Mux != 0) ? g_muxConversions[Gain_Mux] : 0;
+	sint16 Temperature;
+
+	SetSensor(Channel, Celsius);
+	Temperature = LM35_GetPreciseTemperature();
+
+	std::printf("%-10s %-28s %6.2fC: range %u, %7.2fC\n", "autorange", Label, Celsius, (unsigned)AutoRange_GetRange(),
+			Temperature / (double)LM35_PRECISE_DEGREE_FRACTION);
+	Check(AutoRange_GetRange() == Range, "autorange", "range", AutoRange_GetRange(), Range);
+	Check(std::fabs(Temperature - (double)Expected) <= Tolerance + Expected * 0.001, "autorange",
+			"temperature (hundredths)", (unsigned)Temperature, Expected);
+	if (Gain_Mux != 0)
+	{
+		Check(g_muxConversions[Gain_Mux] - Before == Gain_Conversions, "autorange", "gain channel conversions",
+				g_muxConversions[Gain_Mux] - Before, Gain_Conversions);
+	}
+}
+
+void RunAutoRange()
+{
+	const unsigned Failures = g_failures;
+	const unsigned Fine_Limit = ADC_DIFF_MAX_VALUE - AUTO_RANGE_HYSTERESIS_CODES;
+
+	/* Sensor on ADC1, ground on ADC0: 20 codes of the 10x channel per C, the fine range ends at 25.55C */
+	StartAutoRange(Internal_VREF, ADC1);
+	Check(AutoRange_GetRange() == 1, "autorange", "range after the init", AutoRange_GetRange(), 1);
+	CheckPrecise("coarse to fine", ADC1, 20.0, 0, ADC1_ADC0_10X, 2);
+	CheckPrecise("fine, above the entry band", ADC1, 25.2, 0, ADC1_ADC0_10X, 2);
+	CheckPrecise("saturated, to coarse", ADC1, 26.0, 1, ADC1_ADC0_10X, 2);
+	CheckPrecise("coarse, in the entry band", ADC1, (Fine_Limit + 11) / 20.0, 1, ADC1_ADC0_10X, 0);
+	CheckPrecise("coarse to fine again", ADC1, (Fine_Limit - 9) / 20.0, 0, ADC1_ADC0_10X, 2);
+	CheckPrecise("hot", ADC1, 60.0, 1, ADC1_ADC0_10X, 2);
+	CheckPrecise("cold", ADC1, 0.5, 0, ADC1_ADC0_10X, 2);
+	Check(g_delayedUs == 0.0, "autorange", "reference settling waits (us)", (unsigned)g_delayedUs, 0);
+
+	/* The pair follows the sensor channel: ADC3-ADC2, then the single ended ADC2 of the default configuration */
+	StartAutoRange(Internal_VREF, ADC3);
+	CheckPrecise("ADC3, fine", ADC3, 20.0, 0, ADC3_ADC2_10X, 2);
+	Check(g_muxConversions[ADC1_ADC0_10X] == 0, "autorange", "ADC1-ADC0 conversions with the sensor on ADC3",
+			g_muxConversions[ADC1_ADC0_10X], 0);
+
+	StartAutoRange(Internal_VREF, ADC2);
+	CheckPrecise("ADC2, single ended", ADC2, 20.0, 0, 0, 0);
+	CheckPrecise("ADC2, single ended", ADC2, 60.0, 0, 0, 0);
+	Check(g_adcConversions[ADC2] != 0, "autorange", "ADC2 conversions", g_adcConversions[ADC2] != 0, 1);
+
+	/* The reference of ADC_Init is kept */
+	StartAutoRange(AVCC, ADC1);
+	SetSensor(ADC1, 20.0);
+	LM35_GetPreciseTemperature();
+	Check((g_registers8[SHIM_ADMUX] >> 6) == AVCC, "autorange", "reference after the reads", g_registers8[SHIM_ADMUX] >> 6, AVCC);
+	Check(g_delayedUs == 0.0, "autorange", "reference settling waits (us)", (unsigned)g_delayedUs, 0);
+
+	std::printf("%-10s %s\n", "autorange", (g_failures == Failures) ? "ok" : "errors");
+}
+
+} /* namespace */
+
+int main(int argc, char **argv)
+{
+	std::string Only;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ((std::strcmp(argv[i], "--only") == 0) && (i + 1 < argc))
+		{
+			Only = argv[++i];
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--only fanarray|softpwm|autorange]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	if (Only.empty() || (Only == "fanarray"))
+	{
+		RunFanArray();
+	}
+	if (Only.empty() || (Only == "softpwm"))
+	{
+		RunSoftPwm();
+	}
+	if (Only.empty() || (Only == "autorange"))
+	{
+		RunAutoRange();
+	}
+
+	return g_failures ? 1 : 0;
+}
@@ -0,0 +1,1044 @@
+/*******************************************************************************************************************
+ * File Name: sensor_bus.cpp
+ * Date: 19/10/2026
+ * Tool: Host-side checks of the digital temperature sensors on models of their buses (DS18B20.c on One_Wire.c,
+ *       TMP102.c on TWI.c)
+ * Author: Youssef Zaki
+ *
+ * The drivers are compiled for the host against the register shim of Thermal_Sim and driven through their sensor
+ * interface (Start/Poll/Read), polled every 100us as from the main loop. The time is counted in CPU cycles: every
+ * register access as SHIM_ACCESS_CYCLES, the interrupt entry as SHIM_ISR_ENTRY_CYCLES and the busy waits of
+ * <util/delay.h> exactly. The shim models:
+ *     - Timer1 counting at the CPU clock (prescaler 1) and its compare B interrupt, which can be delayed by a given
+ *       time (another interrupt running) to push a 1-Wire step past its window,
+ *     - a DS18B20 on PD7: the bus is low while DDRD7 is set or the device pulls it; the device answers a reset
+ *       with a presence pulse (its delay and length are options), decodes the written bits from the low time,
+ *       pulls the bus for the 0 bits of the read slots, runs Skip ROM, Write Scratchpad, Convert T (the
+ *       conversion time of its resolution) and Read Scratchpad (with its CRC-8, corrupted on request), and logs
+ *       the datasheet timing violations (reset, recovery, slot and low times, read sample time),
+ *     - the TWI master: a write of TWCR with TWINT starts a start condition, an address, a data byte or a stop,
+ *       finished 1 or 9 SCL periods later with the status code in TWSR and the TWI interrupt; TWSTO clears once
+ *       the stop condition is sent. TWINT reads 0 in the model, the driver never reads it,
+ *     - a TMP102 at its address: pointer register, one-shot conversions in the shutdown mode (OS reads 0 for 26ms),
+ *       the temperature register; it can be absent (address not acknowledged) or not acknowledge data bytes.
+ * Checks:
+ *     ds18b20   two conversions read the temperatures of the model, the resolution is written once, the read waits
+ *               the conversion time, no timing violation; the longest 1-Wire interrupt fits ONE_WIRE_ISR_CYCLES.
+ *     presence  the presence pulse at both ends of the datasheet (15us and 60us after the release, 60us long) is
+ *               seen; without a device the transfer ends with ONE_WIRE_NO_PRESENCE and the conversion fails.
+ *     crc       a scratchpad with a bad CRC and a shorted bus (all zeros, good CRC) fail the conversion.
+ *     late      the presence sample or the release of a 0 delayed past its window aborts the transfer
+ *               (ONE_WIRE_LATE), which is sent again: the conversion succeeds; delayed at every try, it fails after
+ *               DS18B20_LATE_RETRIES retries. An early step (the step before it delayed) is still in its window,
+ *               and its interrupt stays within ONE_WIRE_ISR_CYCLES.
+ *     tmp102    two one-shot conversions read the temperatures of the model, each transfer ends with a stop.
+ *     nack      the address and a data byte not acknowledged fail the conversion with a stop condition, the next
+ *               conversion succeeds once the sensor answers again.
+ * The tool returns 1 if a check fails.
+ * Build and run on the host, at 1MHz and at 8MHz (where a 1-Wire step which comes early is scheduled again):
+ *     for cpu in 1000000UL 8000000UL; do
+ *         for f in One_Wire DS18B20 TIMER1 GPIO TWI TMP102 Sys_Time CRC; do gcc -O2 -std=gnu99 -DF_CPU=$cpu \
+ *             -I../Thermal_Sim/shim -I../../Fan_Controller_Project -c ../../Fan_Controller_Project/$f.c -o $f.o; done
+ *         g++ -O2 -std=c++17 -DF_CPU=$cpu -I../Thermal_Sim/shim -I../../Fan_Controller_Project sensor_bus.cpp *.o \
+ *             -o sensor_bus && ./sensor_bus; done
+ * Options: --only NAME, --log (print the logged timing violations)
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+#include "Standard_Types.h"
+#include "Sys_Time.h"
+#include "TIMER1.h"
+#include "One_Wire.h"
+#include "DS18B20.h"
+#include "TWI.h"
+#include "TMP102.h"
+
+void Shim_Isr_TIMER1_COMPB(void);
+void Shim_Isr_TWI(void);
+}
+
+namespace
+{
+
+/****************************************************************************************
+ *                                      Register Shim                                   *
+ ****************************************************************************************/
+
+uint8_t g_registers8[SHIM_NUM_OF_REGISTERS8];
+uint16_t g_registers16[SHIM_NUM_OF_REGISTERS16];
+
+/* An lds/sts and the few instructions around it, and the interrupt response plus the vector jump */
+constexpr uint64_t SHIM_ACCESS_CYCLES = 4;
+constexpr uint64_t SHIM_ISR_ENTRY_CYCLES = 8;
+
+constexpr uint8_t SREG_I = 0x80;
+constexpr double CYCLES_PER_US = (double)F_CPU / 1000000.0;
+
+uint64_t Cycles(double Microseconds)
+{
+	return (uint64_t)(Microseconds * CYCLES_PER_US + 0.5);
+}
+
+double Microseconds(uint64_t Cycle_Count)
+{
+	return (double)Cycle_Count / CYCLES_PER_US;
+}
+
+bool g_log = false;
+
+/* CPU time, interrupt flags, time of the next system tick (1ms) */
+uint64_t g_cycles = 0;
+uint8_t g_tifr = 0;
+bool g_inIsr = false;
+uint64_t g_nextTick = 0;
+
+/* 1-Wire interrupts: count in the current transfer, the delay injected before one of them, the longest one */
+unsigned g_transferIsrs = 0;
+unsigned g_lateIsr = 0;
+double g_lateDelay_us = 0.0;
+unsigned g_lateTransfers = 0;
+uint64_t g_longestIsr = 0;
+double g_isrDelay_us = 0.0;
+double g_longestDelay_us = 0.0;
+
+void Violation(std::vector<std::string> *Log_Ptr, const char *Format, ...)
+{
+	char Text[128];
+	va_list Args;
+
+	va_start(Args, Format);
+	std::vsnprintf(Text, sizeof(Text), Format, Args);
+	va_end(Args);
+	Log_Ptr -> push_back(Text);
+}
+
+/* Dallas/Maxim CRC-8 (x^8 + x^5 + x^4 + 1, reflected), computed apart from CRC.c */
+uint8 Crc8Maxim(const uint8 *Data_Ptr, unsigned Length)
+{
+	uint8 Crc = 0;
+
+	for (unsigned Index = 0; Index < Length; Index++)
+	{
+		Crc ^= Data_Ptr[Index];
+		for (unsigned Bit = 0; Bit < 8; Bit++)
+		{
+			Crc = (Crc & 1) ? (uint8)((Crc >> 1) ^ 0x8C) : (uint8)(Crc >> 1);
+		}
+	}
+	return Crc;
+}
+
+/****************************************************************************************
+ *                                      DS18B20 Model                                   *
+ ****************************************************************************************/
+
+struct Ds18b20Model
+{
+	/* Options of the scenario */
+	bool Present = true;
+	bool Shorted = false;
+	bool Corrupt_Crc = false;
+	double Presence_Wait_us = 30.0;
+	double Presence_Low_us = 120.0;
+	sint16 Temperature = 0;
+
+	/* Power on scratchpad: 85C, TH/TL of the EEPROM, 12 bits */
+	uint8 Scratchpad[DS18B20_SCRATCHPAD_SIZE] = {0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10, 0x00};
+	bool Converting = false;
+	uint64_t Conversion_End = 0;
+
+	/* Counters and the timing violations */
+	unsigned Resets = 0;
+	unsigned Conversions = 0;
+	unsigned Config_Writes = 0;
+	unsigned Scratchpad_Reads = 0;
+	double First_Sample_us = 1e9;
+	double Last_Sample_us = 0.0;
+	std::vector<std::string> Violations;
+
+	/* Protocol: the byte being received, or the scratchpad being sent bit by bit */
+	enum class Step { Idle, Rom, Function, Write, Read } State = Step::Idle;
+	uint8 Byte = 0;
+	unsigned Bits = 0;
+	unsigned Index = 0;
+	uint8 Sent[DS18B20_SCRATCHPAD_SIZE] = {0};
+
+	/* Bus: master edges, the pull of the device, the read slot waiting for its sample */
+	bool Master_Low = false;
+	uint64_t Fall = 0;
+	uint64_t Previous_Fall = 0;
+	uint64_t Reset_Release = 0;
+	bool First_Slot = false;
+	bool Presence_Sample = false;
+	bool Read_Sample = false;
+	uint64_t Pull_From = 0;
+	uint64_t Pull_Until = 0;
+
+	bool Level(uint64_t Now) const
+	{
+		return !Master_Low && !Shorted && !((Now >= Pull_From) && (Now < Pull_Until));
+	}
+
+	void Update(uint64_t Now)
+	{
+		unsigned Resolution = ((Scratchpad[4] >> 5) & 0x03) + 9;
+
+		if (Converting && (Now >= Conversion_End))
+		{
+			/* The undefined low bits of the lower resolutions read 0 in the model */
+			uint16 Raw = (uint16)Temperature & (uint16)~((1u << (12 - Resolution)) - 1);
+
+			Scratchpad[0] = (uint8)Raw;
+			Scratchpad[1] = (uint8)(Raw >> 8);
+			Converting = false;
+		}
+	}
+
+	void Received(uint8 Value, uint64_t Now)
+	{
+		switch (State)
+		{
+		case Step::Rom:
+			if (Value != DS18B20_SKIP_ROM)
+			{
+				Violation(&Violations, "ROM command 0x%02X", Value);
+			}
+			State = (Value == DS18B20_SKIP_ROM) ? Step::Function : Step::Idle;
+			break;
+
+		case Step::Function:
+			State = Step::Idle;
+			if (Value == DS18B20_WRITE_SCRATCHPAD)
+			{
+				State = Step::Write;
+				Index = 2;
+			}
+			else if (Value == DS18B20_CONVERT_T)
+			{
+				/* 93.75ms at 9 bits, doubled per bit */
+				Conversions++;
+				Converting = true;
+				Conversion_End = Now + Cycles(93750.0 * (1 << ((Scratchpad[4] >> 5) & 0x03)));
+			}
+			else if (Value == DS18B20_READ_SCRATCHPAD)
+			{
+				Update(Now);
+				std::memcpy(Sent, Scratchpad, sizeof(Sent));
+				Sent[8] = Crc8Maxim(Sent, 8) ^ (Corrupt_Crc ? 0x01 : 0x00);
+				Scratchpad_Reads++;
+				State = Step::Read;
+				Index = 0;
+			}
+			else
+			{
+				Violation(&Violations, "function command 0x%02X", Value);
+			}
+			break;
+
+		case Step::Write:
+			/* TH, TL and the configuration register */
+			Scratchpad[Index++] = Value;
+			if (Index == 5)
+			{
+				Config_Writes++;
+				State = Step::Idle;
+			}
+			break;
+
+		default:
+			break;
+		}
+	}
+
+	void MasterEdge(bool Low, uint64_t Now)
+	{
+		double Low_us;
+
+		Master_Low = Low;
+		if (Low)
+		{
+			Previous_Fall = Fall;
+			Fall = Now;
+			Read_Sample = Present && (State == Step::Read);
+			if (Read_Sample && !((Sent[Index >> 3] >> (Index & 0x07)) & 1))
+			{
+				/* A 0 is held for 30us, the master samples it before 15us */
+				Pull_From = Now;
+				Pull_Until = Now + Cycles(30.0);
+			}
+			return;
+		}
+
+		Low_us = Microseconds(Now - Fall);
+		if (Low_us >= 480.0)
+		{
+			Resets++;
+			State = Present ? Step::Rom : Step::Idle;
+			Byte = 0;
+			Bits = 0;
+			Reset_Release = Now;
+			First_Slot = true;
+			Presence_Sample = true;
+			if (Present)
+			{
+				Pull_From = Now + Cycles(Presence_Wait_us);
+				Pull_Until = Pull_From + Cycles(Presence_Low_us);
+			}
+			return;
+		}
+		if (!Present)
+		{
+			return;
+		}
+
+		if (First_Slot && (Fall - Reset_Release < Cycles(480.0)))
+		{
+			Violation(&Violations, "first slot %.1fus after the reset release", Microseconds(Fall - Reset_Release));
+		}
+		else if (!First_Slot && (Fall - Previous_Fall < Cycles(61.0)))
+		{
+			Violation(&Violations, "slot of %.1fus", Microseconds(Fall - Previous_Fall));
+		}
+		First_Slot = false;
+		Presence_Sample = false;
+
+		if (Low_us > 120.0)
+		{
+			Violation(&Violations, "low time of %.1fus", Low_us);
+		}
+
+		if (State == Step::Read)
+		{
+			if (Low_us > 15.0)
+			{
+				Violation(&Violations, "read slot low for %.1fus", Low_us);
+			}
+			if (++Index == DS18B20_SCRATCHPAD_SIZE * 8)
+			{
+				State = Step::Idle;
+			}
+			return;
+		}
+
+		if ((Low_us >= 15.0) && (Low_us < 60.0))
+		{
+			Violation(&Violations, "write slot low for %.1fus", Low_us);
+		}
+		if ((State == Step::Rom) || (State == Step::Function) || (State == Step::Write))
+		{
+			Byte |= (uint8)((Low_us < 15.0) ? (1 << Bits) : 0);
+			if (++Bits == 8)
+			{
+				Received(Byte, Now);
+				Byte = 0;
+				Bits = 0;
+			}
+		}
+	}
+
+	/* The master reads the pin: the presence sample after a reset, the sample of a read slot */
+	void Sampled(uint64_t Now)
+	{
+		if (Presence_Sample)
+		{
+			double Sample_us = Microseconds(Now - Reset_Release);
+
+			First_Sample_us = std::min(First_Sample_us, Sample_us);
+			Last_Sample_us = std::max(Last_Sample_us, Sample_us);
+			Presence_Sample = false;
+		}
+		else if (Read_Sample)
+		{
+			if (Now - Fall > Cycles(15.0))
+			{
+				Violation(&Violations, "read slot sampled at %.1fus", Microseconds(Now - Fall));
+			}
+			Read_Sample = false;
+		}
+	}
+};
+
+Ds18b20Model g_ds18b20;
+
+/****************************************************************************************
+ *                                       TMP102 Model                                   *
+ ****************************************************************************************/
+
+struct Tmp102Model
+{
+	/* Options of the scenario */
+	bool Present = true;
+	bool Nack_Data = false;
+	sint16 Temperature = 0;
+
+	/* Registers, the one-shot conversion in progress */
+	uint8 Pointer = 0;
+	uint16 Temperature_Register = 0;
+	uint16 Config = 0x60A0;
+	bool Converting = false;
+	uint64_t Conversion_End = 0;
+
+	/* Transfer: direction and bytes since the address */
+	bool Reading = false;
+	unsigned Count = 0;
+	uint8 Received[2] = {0, 0};
+
+	unsigned Starts = 0;
+	unsigned Stops = 0;
+	unsigned One_Shots = 0;
+
+	void Update(uint64_t Now)
+	{
+		if (Converting && (Now >= Conversion_End))
+		{
+			Temperature_Register = (uint16)((uint16)Temperature << 4);
+			Converting = false;
+		}
+	}
+
+	bool Address(uint8 Address_Byte)
+	{
+		Reading = (Address_Byte & 1) != 0;
+		Count = 0;
+		return Present && ((Address_Byte >> 1) == TMP102_ADDRESS);
+	}
+
+	bool Write(uint8 Value, uint64_t Now)
+	{
+		if (Nack_Data)
+		{
+			return false;
+		}
+
+		if (Count == 0)
+		{
+			Pointer = Value & 0x03;
+		}
+		else if (Pointer == TMP102_CONFIG_REGISTER)
+		{
+			Received[Count - 1] = Value;
+			if (Count == 2)
+			{
+				/* OS with SD starts a one-shot conversion, R1:R0 are read only */
+				Config = (uint16)((((Received[0] & 0x7F) | 0x60) << 8) | Received[1]);
+				if ((Received[0] & 0x81) == 0x81)
+				{
+					One_Shots++;
+					Converting = true;
+					Conversion_End = Now + Cycles(26000.0);
+				}
+			}
+		}
+		Count++;
+		return true;
+	}
+
+	uint8 Read(uint64_t Now)
+	{
+		uint16 Value;
+
+		Update(Now);
+		Value = (Pointer == TMP102_CONFIG_REGISTER) ? (uint16)(Config | (Converting ? 0 : 0x8000)) : Temperature_Register;
+		return (Count++ == 0) ? (uint8)(Value >> 8) : (uint8)Value;
+	}
+};
+
+Tmp102Model g_tmp102;
+
+/* TWI: the operation in progress (its end and status code), the received byte, the stop condition */
+uint64_t g_twiDone = 0;
+uint8_t g_twiStatus = 0;
+uint8_t g_twiData = 0;
+bool g_twiReceive = false;
+bool g_twiFlag = false;
+bool g_twiOwner = false;
+uint64_t g_twiStopDone = 0;
+std::vector<std::string> g_twiViolations;
+
+/* A write of TWCR with TWINT: the next operation from the last status code */
+void TwiOperation(uint8_t Control)
+{
+	uint64_t Bit = 16 + 2 * (uint64_t)g_registers8[SHIM_TWBR];
+	uint8_t Last = g_registers8[SHIM_TWSR] & 0xF8;
+
+	g_registers8[SHIM_TWCR] = Control & (uint8_t)~(1 << TWINT);
+	if (!(Control & (1 << TWEN)))
+	{
+		return;
+	}
+
+	g_twiReceive = false;
+	if (Control & (1 << TWSTA))
+	{
+		g_tmp102.Starts++;
+		g_twiStatus = g_twiOwner ? 0x10 : 0x08;
+		g_twiOwner = true;
+		g_twiDone = g_cycles + Bit;
+	}
+	else if (Control & (1 << TWSTO))
+	{
+		g_tmp102.Stops++;
+		g_twiOwner = false;
+		g_twiStopDone = g_cycles + Bit;
+	}
+	else if (!g_twiOwner)
+	{
+		/* Released after a lost arbitration, nothing to send */
+	}
+	else if ((Last == 0x08) || (Last == 0x10))
+	{
+		bool Ack = g_tmp102.Address(g_registers8[SHIM_TWDR]);
+
+		g_twiStatus = (g_registers8[SHIM_TWDR] & 1) ? (Ack ? 0x40 : 0x48) : (Ack ? 0x18 : 0x20);
+		g_twiDone = g_cycles + 9 * Bit;
+	}
+	else if ((Last == 0x18) || (Last == 0x28))
+	{
+		g_twiStatus = g_tmp102.Write(g_registers8[SHIM_TWDR], g_cycles) ? 0x28 : 0x30;
+		g_twiDone = g_cycles + 9 * Bit;
+	}
+	else if ((Last == 0x40) || (Last == 0x50))
+	{
+		g_twiData = g_tmp102.Read(g_cycles);
+		g_twiReceive = true;
+		g_twiStatus = (Control & (1 << TWEA)) ? 0x50 : 0x58;
+		g_twiDone = g_cycles + 9 * Bit;
+	}
+	else
+	{
+		Violation(&g_twiViolations, "TWCR 0x%02X written after the status 0x%02X", Control, Last);
+	}
+}
+
+/****************************************************************************************
+ *                                        Hardware                                      *
+ ****************************************************************************************/
+
+void Advance(uint64_t Cycle_Count)
+{
+	for (uint64_t Cycle = 0; Cycle < Cycle_Count; Cycle++)
+	{
+		g_cycles++;
+		if ((g_registers8[SHIM_TCCR1B] & 0x07) == 1)
+		{
+			g_registers16[SHIM_TCNT1]++;
+			if (g_registers16[SHIM_TCNT1] == g_registers16[SHIM_OCR1B])
+			{
+				g_tifr |= (1 << OCF1B);
+			}
+		}
+	}
+}
+
+/* The master side of the 1-Wire bus after the last access, and the pin it reads */
+void WatchBus()
+{
+	bool Low = (g_registers8[SHIM_DDRD] & (1 << PD7)) != 0;
+
+	if (Low && (g_registers8[SHIM_PORTD] & (1 << PD7)))
+	{
+		Violation(&g_ds18b20.Violations, "bus driven high");
+	}
+	if (Low != g_ds18b20.Master_Low)
+	{
+		if (Low && !g_inIsr)
+		{
+			/* A reset pulse from OneWire_StartTransfer */
+			g_transferIsrs = 0;
+		}
+		g_ds18b20.MasterEdge(Low, g_cycles);
+	}
+
+	if (g_ds18b20.Level(g_cycles))
+	{
+		g_registers8[SHIM_PIND] |= (1 << PD7);
+	}
+	else
+	{
+		g_registers8[SHIM_PIND] &= (uint8_t)~(1 << PD7);
+	}
+}
+
+void RunIsr(void (*Vector)(void))
+{
+	g_inIsr = true;
+	g_registers8[SHIM_SREG] &= (uint8_t)~SREG_I;
+	Advance(SHIM_ISR_ENTRY_CYCLES);
+	Vector();
+	g_registers8[SHIM_SREG] |= SREG_I;
+	g_inIsr = false;
+}
+
+void CompareBInterrupt()
+{
+	uint64_t Start;
+
+	if ((g_transferIsrs == g_lateIsr) && (g_lateTransfers != 0))
+	{
+		/* Another interrupt runs first */
+		g_lateTransfers--;
+		Advance(Cycles(g_lateDelay_us));
+	}
+	g_transferIsrs++;
+
+	Start = g_cycles;
+	g_isrDelay_us = 0.0;
+	RunIsr(Shim_Isr_TIMER1_COMPB);
+	WatchBus();
+	g_longestIsr = std::max(g_longestIsr, g_cycles - Start);
+	g_longestDelay_us = std::max(g_longestDelay_us, g_isrDelay_us);
+}
+
+/*
+ * The effects of the previous access: a write of TWCR starts a TWI operation, the ones written to TIFR clear their
+ * flags, the bus is watched, then the time passes and an enabled interrupt is taken
+ */
+void Service()
+{
+	if (g_registers8[SHIM_TWCR] & (1 << TWINT))
+	{
+		TwiOperation(g_registers8[SHIM_TWCR]);
+	}
+	if ((g_twiDone != 0) && (g_cycles >= g_twiDone))
+	{
+		g_twiDone = 0;
+		g_registers8[SHIM_TWSR] = (uint8_t)((g_registers8[SHIM_TWSR] & 0x03) | g_twiStatus);
+		if (g_twiReceive)
+		{
+			g_registers8[SHIM_TWDR] = g_twiData;
+		}
+		g_twiFlag = true;
+	}
+	if ((g_twiStopDone != 0) && (g_cycles >= g_twiStopDone))
+	{
+		g_twiStopDone = 0;
+		g_registers8[SHIM_TWCR] &= (uint8_t)~(1 << TWSTO);
+	}
+
+	g_tifr &= (uint8_t)~g_registers8[SHIM_TIFR];
+	g_registers8[SHIM_TIFR] = 0;
+
+	WatchBus();
+	Advance(SHIM_ACCESS_CYCLES);
+
+	if (g_inIsr || !(g_registers8[SHIM_SREG] & SREG_I))
+	{
+		return;
+	}
+	if ((g_registers8[SHIM_TIMSK] & (1 << OCIE1B)) && (g_tifr & (1 << OCF1B)))
+	{
+		g_tifr &= (uint8_t)~(1 << OCF1B);
+		CompareBInterrupt();
+	}
+	else if ((g_registers8[SHIM_TWCR] & (1 << TWIE)) && g_twiFlag)
+	{
+		g_twiFlag = false;
+		RunIsr(Shim_Isr_TWI);
+	}
+}
+
+} /* namespace */
+
+extern "C" volatile uint8_t *Shim_Register8(Shim_Register8Id Id)
+{
+	if (Id == SHIM_PIND)
+	{
+		/* The pin is read at the start of the access */
+		WatchBus();
+		g_ds18b20.Sampled(g_cycles);
+	}
+	Service();
+	return &g_registers8[Id];
+}
+
+extern "C" volatile uint16_t *Shim_Register16(Shim_Register16Id Id)
+{
+	Service();
+	return &g_registers16[Id];
+}
+
+extern "C" void Shim_Sleep(void)
+{
+}
+
+extern "C" void Shim_Delay_us(double Microseconds)
+{
+	WatchBus();
+	if (g_inIsr)
+	{
+		g_isrDelay_us += Microseconds;
+	}
+	Advance(Cycles(Microseconds));
+}
+
+namespace
+{
+
+/****************************************************************************************
+ *                                        Checks                                        *
+ ****************************************************************************************/
+
+unsigned g_failures = 0;
+
+void Check(bool Condition, const char *Scenario, const char *Format, unsigned Value, unsigned Expected)
+{
+	if (!Condition)
+	{
+		g_failures++;
+		std::printf("%-10s FAIL %s: %u, expected %u\n", Scenario, Format, Value, Expected);
+	}
+}
+
+void CheckViolations(const char *Scenario, const std::vector<std::string> &Violations)
+{
+	Check(Violations.empty(), Scenario, "timing violations", (unsigned)Violations.size(), 0);
+	for (size_t Index = 0; Index < Violations.size(); Index++)
+	{
+		if (g_log || (Index == 0))
+		{
+			std::printf("%-10s %s\n", Scenario, Violations[Index].c_str());
+		}
+	}
+}
+
+/* Both buses reset, the drivers initialized, the system time at 0 with a 1ms tick */
+void ResetBuses()
+{
+	std::memset(g_registers8, 0, sizeof(g_registers8));
+	std::memset(g_registers16, 0, sizeof(g_registers16));
+	g_registers8[SHIM_SREG] = SREG_I;
+	g_cycles = 0;
+	g_tifr = 0;
+	g_nextTick = Cycles(1000.0);
+	g_transferIsrs = 0;
+	g_lateTransfers = 0;
+	g_longestIsr = 0;
+	g_longestDelay_us = 0.0;
+	g_twiDone = 0;
+	g_twiFlag = false;
+	g_twiOwner = false;
+	g_twiStopDone = 0;
+	g_twiViolations.clear();
+	g_ds18b20 = Ds18b20Model();
+	g_tmp102 = Tmp102Model();
+
+	SysTime_Init(1000);
+	DS18B20_Init();
+	TMP102_Init();
+}
+
+/* The main loop: the time passes, the Timer0 overflow ticks the system time every millisecond */
+void Run(double Duration_us)
+{
+	uint64_t End = g_cycles + Cycles(Duration_us);
+
+	while (g_cycles < End)
+	{
+		Service();
+		while (g_cycles >= g_nextTick)
+		{
+			g_nextTick += Cycles(1000.0);
+			SysTime_Tick();
+		}
+	}
+}
+
+struct Conversion
+{
+	TempSensor_StatusType Status;
+	sint16 Value;
+	double Duration_ms;
+};
+
+/* A conversion through the sensor interface, polled every 100us, 2s at most */
+Conversion Convert(const TempSensor_DriverType &Sensor)
+{
+	Conversion Result = {TEMP_SENSOR_BUSY, TEMP_SENSOR_INVALID, 0.0};
+	uint64_t Start = g_cycles;
+
+	while (!Sensor.Start() && (g_cycles - Start < Cycles(2e6)))
+	{
+		Run(100.0);
+	}
+	while (((Result.Status = Sensor.Poll()) == TEMP_SENSOR_BUSY) && (g_cycles - Start < Cycles(2e6)))
+	{
+		Run(100.0);
+	}
+	if (Result.Status == TEMP_SENSOR_READY)
+	{
+		Result.Value = Sensor.Read();
+	}
+	Result.Duration_ms = Microseconds(g_cycles - Start) / 1000.0;
+
+	/* The main loop goes on: the last writes of the interrupts are seen (the stop condition of the TWI) */
+	Run(1000.0);
+
+	return Result;
+}
+
+const char *StatusName(TempSensor_StatusType Status)
+{
+	return (Status == TEMP_SENSOR_READY) ? "ready" : ((Status == TEMP_SENSOR_ERROR) ? "error" : "busy");
+}
+
+/* The longest 1-Wire interrupt against the blocking budget of One_Wire.h */
+void CheckIsr(const char *Scenario)
+{
+	Check(g_longestIsr <= ONE_WIRE_ISR_CYCLES, Scenario, "longest 1-Wire interrupt in cycles", (unsigned)g_longestIsr,
+			(unsigned)ONE_WIRE_ISR_CYCLES);
+	Check(g_longestDelay_us <= ONE_WIRE_READ_LOW_US + ONE_WIRE_READ_SAMPLE_US, Scenario,
+			"longest _delay_us of a 1-Wire interrupt in us", (unsigned)g_longestDelay_us,
+			ONE_WIRE_READ_LOW_US + ONE_WIRE_READ_SAMPLE_US);
+}
+
+void RunDs18b20()
+{
+	const char *S = "ds18b20";
+	const unsigned Failures = g_failures;
+	const sint16 Temperatures[] = {0x0191, -162};
+
+	ResetBuses();
+	for (sint16 Temperature : Temperatures)
+	{
+		Conversion Result;
+
+		g_ds18b20.Temperature = Temperature;
+		Result = Convert(g_DS18B20Sensor);
+		Check(Result.Status == TEMP_SENSOR_READY, S, "conversion status", Result.Status, TEMP_SENSOR_READY);
+		Check(Result.Value == Temperature, S, "temperature in 1/16C", (uint16)Result.Value, (uint16)Temperature);
+		Check(Result.Duration_ms >= DS18B20_CONVERSION_MS - 1, S, "conversion time in ms", (unsigned)Result.Duration_ms,
+				DS18B20_CONVERSION_MS);
+		std::printf("%-10s %8.4fC in %.1fms (%s)\n", S, Result.Value / 16.0, Result.Duration_ms, StatusName(Result.Status));
+	}
+
+	Check(g_ds18b20.Config_Writes == 1, S, "writes of the configuration", g_ds18b20.Config_Writes, 1);
+	Check(g_ds18b20.Scratchpad[4] == (((DS18B20_RESOLUTION_BITS - 9) << 5) | 0x1F), S, "configuration register",
+			g_ds18b20.Scratchpad[4], ((DS18B20_RESOLUTION_BITS - 9) << 5) | 0x1F);
+	Check(g_ds18b20.Conversions == 2, S, "Convert T commands", g_ds18b20.Conversions, 2);
+	Check(g_ds18b20.Resets == 5, S, "transfers", g_ds18b20.Resets, 5);
+	CheckViolations(S, g_ds18b20.Violations);
+	CheckIsr(S);
+
+	std::printf("%-10s presence sampled %.1fus to %.1fus after the release, longest interrupt %u cycles "
+			"(ONE_WIRE_ISR_CYCLES %u), %zu violations: %s\n", S, g_ds18b20.First_Sample_us, g_ds18b20.Last_Sample_us,
+			(unsigned)g_longestIsr, (unsigned)ONE_WIRE_ISR_CYCLES, g_ds18b20.Violations.size(),
+			(g_failures != Failures) ? "errors" : "ok");
+}
+
+void RunPresence()
+{
+	const char *S = "presence";
+	const unsigned Failures = g_failures;
+	const double Pulses[][2] = {{15.0, 60.0}, {60.0, 60.0}, {30.0, 120.0}};
+	Conversion Result;
+
+	for (const auto &Pulse : Pulses)
+	{
+		ResetBuses();
+		g_ds18b20.Presence_Wait_us = Pulse[0];
+		g_ds18b20.Presence_Low_us = Pulse[1];
+		g_ds18b20.Temperature = 0x0191;
+		Result = Convert(g_DS18B20Sensor);
+		Check(Result.Status == TEMP_SENSOR_READY, S, "conversion status", Result.Status, TEMP_SENSOR_READY);
+		Check(Result.Value == 0x0191, S, "temperature in 1/16C", (uint16)Result.Value, 0x0191);
+		CheckViolations(S, g_ds18b20.Violations);
+		std::printf("%-10s pulse %2.0fus after the release for %3.0fus: %s\n", S, Pulse[0], Pulse[1],
+				StatusName(Result.Status));
+	}
+
+	/* Nothing answers: a single transfer, the bytes are not sent */
+	ResetBuses();
+	g_ds18b20.Present = false;
+	Result = Convert(g_DS18B20Sensor);
+	Check(Result.Status == TEMP_SENSOR_ERROR, S, "conversion status without a device", Result.Status, TEMP_SENSOR_ERROR);
+	Check(OneWire_GetStatus() == ONE_WIRE_NO_PRESENCE, S, "1-Wire status without a device", OneWire_GetStatus(),
+			ONE_WIRE_NO_PRESENCE);
+	Check(g_ds18b20.Resets == 1, S, "transfers without a device", g_ds18b20.Resets, 1);
+	std::printf("%-10s no device: %s after %u transfer\n", S, StatusName(Result.Status), g_ds18b20.Resets);
+
+	std::printf("%-10s %s\n", S, (g_failures != Failures) ? "errors" : "ok");
+}
+
+void RunCrc()
+{
+	const char *S = "crc";
+	const unsigned Failures = g_failures;
+	Conversion Result;
+
+	ResetBuses();
+	g_ds18b20.Corrupt_Crc = true;
+	g_ds18b20.Temperature = 0x0191;
+	Result = Convert(g_DS18B20Sensor);
+	Check(Result.Status == TEMP_SENSOR_ERROR, S, "conversion status with a bad CRC", Result.Status, TEMP_SENSOR_ERROR);
+	Check(g_ds18b20.Scratchpad_Reads == 1, S, "reads of the scratchpad", g_ds18b20.Scratchpad_Reads, 1);
+	std::printf("%-10s bad CRC: %s\n", S, StatusName(Result.Status));
+
+	ResetBuses();
+	g_ds18b20.Shorted = true;
+	Result = Convert(g_DS18B20Sensor);
+	Check(Result.Status == TEMP_SENSOR_ERROR, S, "conversion status on a shorted bus", Result.Status, TEMP_SENSOR_ERROR);
+	std::printf("%-10s shorted bus: %s\n", S, StatusName(Result.Status));
+
+	std::printf("%-10s %s\n", S, (g_failures != Failures) ? "errors" : "ok");
+}
+
+void RunLate()
+{
+	struct LateCase
+	{
+		const char *Name;
+		unsigned Isr;               /* compare B interrupt of the transfer: 0 reset release, 1 presence, 3 release of a 0 */
+		double Delay_us;
+		unsigned Transfers;         /* transfers with the delay */
+		TempSensor_StatusType Status;
+		unsigned Resets;
+	};
+	/* The transfers of a first conversion: configuration, Convert T, Read Scratchpad */
+	const LateCase Cases[] =
+	{
+		{"presence sample", 1, 20.0, 1, TEMP_SENSOR_READY, 4},
+		{"release of a 0", 3, 70.0, 1, TEMP_SENSOR_READY, 4},
+		{"every try", 1, 20.0, 1 + DS18B20_LATE_RETRIES, TEMP_SENSOR_ERROR, 1 + DS18B20_LATE_RETRIES},
+		{"early presence", 0, 40.0, 1, TEMP_SENSOR_READY, 3},
+		{"early release", 2, 50.0, 1, TEMP_SENSOR_READY, 3},
+	};
+	const char *S = "late";
+	const unsigned Failures = g_failures;
+
+	for (const LateCase &Case : Cases)
+	{
+		Conversion Result;
+
+		ResetBuses();
+		g_ds18b20.Temperature = 0x0191;
+		g_lateIsr = Case.Isr;
+		g_lateDelay_us = Case.Delay_us;
+		g_lateTransfers = Case.Transfers;
+		Result = Convert(g_DS18B20Sensor);
+
+		Check(Result.Status == Case.Status, S, Case.Name, Result.Status, Case.Status);
+		Check(g_ds18b20.Resets == Case.Resets, S, Case.Name, g_ds18b20.Resets, Case.Resets);
+		if (Case.Status == TEMP_SENSOR_READY)
+		{
+			Check(Result.Value == 0x0191, S, Case.Name, (uint16)Result.Value, 0x0191);
+		}
+		else
+		{
+			Check(OneWire_GetStatus() == ONE_WIRE_LATE, S, Case.Name, OneWire_GetStatus(), ONE_WIRE_LATE);
+		}
+		CheckIsr(S);
+		std::printf("%-10s %-16s delayed %2.0fus: %s after %u transfers, longest interrupt %u cycles\n", S, Case.Name,
+				Case.Delay_us, StatusName(Result.Status), g_ds18b20.Resets, (unsigned)g_longestIsr);
+	}
+
+	std::printf("%-10s %s\n", S, (g_failures != Failures) ? "errors" : "ok");
+}
+
+void RunTmp102()
+{
+	const char *S = "tmp102";
+	const unsigned Failures = g_failures;
+	const sint16 Temperatures[] = {0x0191, -162};
+
+	ResetBuses();
+	for (sint16 Temperature : Temperatures)
+	{
+		Conversion Result;
+
+		g_tmp102.Temperature = Temperature;
+		Result = Convert(g_TMP102Sensor);
+		Check(Result.Status == TEMP_SENSOR_READY, S, "conversion status", Result.Status, TEMP_SENSOR_READY);
+		Check(Result.Value == Temperature, S, "temperature in 1/16C", (uint16)Result.Value, (uint16)Temperature);
+		std::printf("%-10s %8.4fC in %.1fms (%s)\n", S, Result.Value / 16.0, Result.Duration_ms, StatusName(Result.Status));
+	}
+
+	Check(g_tmp102.One_Shots == 2, S, "one-shot conversions", g_tmp102.One_Shots, 2);
+	Check(g_tmp102.Stops == 6, S, "stop conditions", g_tmp102.Stops, 6);
+	CheckViolations(S, g_twiViolations);
+	std::printf("%-10s %u starts, %u stops: %s\n", S, g_tmp102.Starts, g_tmp102.Stops,
+			(g_failures != Failures) ? "errors" : "ok");
+}
+
+void RunNack()
+{
+	const char *S = "nack";
+	const unsigned Failures = g_failures;
+	Conversion Result;
+
+	for (int Data = 0; Data < 2; Data++)
+	{
+		ResetBuses();
+		g_tmp102.Present = (Data != 0);
+		g_tmp102.Nack_Data = (Data != 0);
+		g_tmp102.Temperature = 0x0191;
+		Result = Convert(g_TMP102Sensor);
+		Check(Result.Status == TEMP_SENSOR_ERROR, S, Data ? "status, data NACK" : "status, address NACK", Result.Status,
+				TEMP_SENSOR_ERROR);
+		Check(TWI_GetStatus() == TWI_ERROR, S, "TWI status", TWI_GetStatus(), TWI_ERROR);
+		Check(g_tmp102.Stops == 1, S, "stop conditions", g_tmp102.Stops, 1);
+		std::printf("%-10s %s not acknowledged: %s, %u stop\n", S, Data ? "data byte" : "address",
+				StatusName(Result.Status), g_tmp102.Stops);
+
+		/* The sensor answers again */
+		g_tmp102.Present = true;
+		g_tmp102.Nack_Data = false;
+		Result = Convert(g_TMP102Sensor);
+		Check(Result.Status == TEMP_SENSOR_READY, S, "status after the NACK", Result.Status, TEMP_SENSOR_READY);
+		Check(Result.Value == 0x0191, S, "temperature after the NACK", (uint16)Result.Value, 0x0191);
+	}
+	CheckViolations(S, g_twiViolations);
+
+	std::printf("%-10s %s\n", S, (g_failures != Failures) ? "errors" : "ok");
+}
+
+} /* namespace */
+
+int main(int argc, char **argv)
+{
+	static const struct
+	{
+		const char *Name;
+		void (*Run)(void);
+	} Scenarios[] =
+	{
+		{"ds18b20", RunDs18b20}, {"presence", RunPresence}, {"crc", RunCrc}, {"late", RunLate},
+		{"tmp102", RunTmp102}, {"nack", RunNack}
+	};
+	std::string Only;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ((std::strcmp(argv[i], "--only") == 0) && (i + 1 < argc))
+		{
+			Only = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--log") == 0)
+		{
+			g_log = true;
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--only ds18b20|presence|crc|late|tmp102|nack] [--log]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	std::printf("F_CPU %luHz\n", (unsigned long)F_CPU);
+	for (const auto &Scenario : Scenarios)
+	{
+		if (Only.empty() || (Only == Scenario.Name))
+		{
+			Scenario.Run();
+		}
+	}
+
+	return g_failures ? 1 : 0;
+}
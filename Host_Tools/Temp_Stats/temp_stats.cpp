@@ -0,0 +1,200 @@
+/*******************************************************************************************************************
+ * File Name: temp_stats.cpp
+ * Date: 19/10/2026
+ * Tool: Host-side check of the sliding window temperature statistics (Temp_Stats.c) against a brute force model
+ * Author: Youssef Zaki
+ *
+ * Temp_Stats.c is compiled for the host and fed with random sequences of samples, several times the longest
+ * window. After every sample the three windows of TempStats_GetWindow are compared with a brute force scan of
+ * all the samples kept by the tool: a window covers its last complete buckets (TEMP_STATS_BUCKETS_x buckets
+ * of its level at most) plus the samples of its bucket being filled, the mean is rounded. The sequences
+ * stress the monotonic deques of TempStats_PushBucket (rising and falling ramps, single spikes) and the
+ * running sums (full scale samples).
+ * Checks:
+ *     windows   minimum, maximum, mean and number of samples of every window after every sample,
+ *               TempStats_AddSample returns TRUE exactly at the end of each bucket of the 1 minute window,
+ *               no result before the first sample and for a window index out of range.
+ * The tool returns 1 if a check fails.
+ * Build and run on the host:
+ *     gcc -O2 -std=gnu99 -I../../Fan_Controller_Project -c ../../Fan_Controller_Project/Temp_Stats.c -o Temp_Stats.o
+ *     g++ -O2 -std=c++17 -I../../Fan_Controller_Project temp_stats.cpp Temp_Stats.o -o temp_stats
+ *     ./temp_stats
+ * Options: --seed N [1]
+ ******************************************************************************************************************/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+extern "C"
+{
+#include "Standard_Types.h"
+#include "Temp_Stats.h"
+}
+
+namespace
+{
+
+/* Samples in a bucket of each window, and the number of buckets of each window */
+constexpr unsigned BUCKET_SAMPLES[TEMP_STATS_NUM_OF_WINDOWS] =
+{
+	TEMP_STATS_SAMPLES_PER_BUCKET,
+	TEMP_STATS_SAMPLES_PER_BUCKET * TEMP_STATS_BUCKETS_1_MIN,
+	TEMP_STATS_SAMPLES_PER_BUCKET * TEMP_STATS_BUCKETS_1_MIN * TEMP_STATS_BUCKETS_10_MIN
+};
+constexpr unsigned NUM_OF_BUCKETS[TEMP_STATS_NUM_OF_WINDOWS] =
+{
+	TEMP_STATS_BUCKETS_1_MIN, TEMP_STATS_BUCKETS_10_MIN, TEMP_STATS_BUCKETS_60_MIN
+};
+
+/* Every sequence runs three longest windows and ends in the middle of a bucket of every window */
+constexpr unsigned SEQUENCE_SAMPLES = 3 * TEMP_STATS_MAX_WINDOW_SAMPLES + BUCKET_SAMPLES[2] / 2 + 7;
+
+/****************************************************************************************
+ *                                        Checks                                        *
+ ****************************************************************************************/
+
+unsigned g_failures = 0;
+
+void Check(bool Condition, const char *Scenario, const char *Format, unsigned Value, unsigned Expected)
+{
+	if (!Condition)
+	{
+		g_failures++;
+		std::printf("%-10s FAIL %s: %u, expected %u\n", Scenario, Format, Value, Expected);
+	}
+}
+
+/* The result of a window from all the samples */
+TempStats_ResultType BruteForce(const std::vector<uint8> &Samples, unsigned Window)
+{
+	size_t Complete = Samples.size() / BUCKET_SAMPLES[Window];
+	size_t Start = (Complete - std::min<size_t>(Complete, NUM_OF_BUCKETS[Window])) * BUCKET_SAMPLES[Window];
+	TempStats_ResultType Result = {0xFF, 0, 0, 0};
+	unsigned long Sum = 0;
+
+	for (size_t Index = Start; Index < Samples.size(); Index++)
+	{
+		Result.Minimum = std::min(Result.Minimum, Samples[Index]);
+		Result.Maximum = std::max(Result.Maximum, Samples[Index]);
+		Sum += Samples[Index];
+	}
+	Result.Num_Of_Samples = (uint16)(Samples.size() - Start);
+	Result.Mean = (uint8)((Sum + Result.Num_Of_Samples / 2) / Result.Num_Of_Samples);
+
+	return Result;
+}
+
+/* Sample of a sequence, the random walk keeps its level between the calls */
+uint8 NextSample(unsigned Sequence, unsigned Index, std::mt19937 &Generator, int *Level_Ptr)
+{
+	std::uniform_int_distribution<int> Byte(0, 255);
+	std::uniform_int_distribution<int> Step(-2, 2);
+
+	switch (Sequence)
+	{
+	case 0:
+		return (uint8)Byte(Generator);
+	case 1:
+		*Level_Ptr = std::min(120, std::max(20, *Level_Ptr + Step(Generator)));
+		return (uint8)*Level_Ptr;
+	case 2:
+		/* Rising ramps of random lengths: every new bucket maximum empties the maximum deque */
+		*Level_Ptr = ((Byte(Generator) == 0) || (*Level_Ptr >= 255)) ? Byte(Generator) / 4 : (*Level_Ptr + (Index & 1));
+		return (uint8)*Level_Ptr;
+	case 3:
+		*Level_Ptr = ((Byte(Generator) == 0) || (*Level_Ptr <= 0)) ? 192 + Byte(Generator) / 4 : (*Level_Ptr - (Index & 1));
+		return (uint8)*Level_Ptr;
+	default:
+		/* Constant with single spikes to both limits */
+		return (Byte(Generator) < 2) ? ((Index & 1) ? 255 : 0) : 40;
+	}
+}
+
+void RunWindows(unsigned Seed)
+{
+	static const char *const Sequence_Names[] = {"random", "walk", "rising", "falling", "spikes"};
+	const unsigned Failures = g_failures;
+	unsigned Compared = 0;
+
+	for (unsigned Sequence = 0; Sequence < sizeof(Sequence_Names) / sizeof(Sequence_Names[0]); Sequence++)
+	{
+		std::mt19937 Generator(Seed * 31u + Sequence);
+		std::vector<uint8> Samples;
+		TempStats_ResultType Result;
+		unsigned Mismatches[TEMP_STATS_NUM_OF_WINDOWS] = {0, 0, 0};
+		int Level = 60;
+
+		TempStats_Init();
+		for (unsigned Window = 0; Window < TEMP_STATS_NUM_OF_WINDOWS; Window++)
+		{
+			Check(!TempStats_GetWindow((uint8)Window, &Result), "windows", "result of an empty window", 1, 0);
+		}
+		Check(!TempStats_GetWindow(TEMP_STATS_NUM_OF_WINDOWS, &Result), "windows", "result of an unknown window", 1, 0);
+
+		for (unsigned Index = 0; Index < SEQUENCE_SAMPLES; Index++)
+		{
+			uint8 Sample = NextSample(Sequence, Index, Generator, &Level);
+			boolean Bucket_Done;
+
+			Samples.push_back(Sample);
+			Bucket_Done = TempStats_AddSample(Sample);
+			Check(Bucket_Done == ((Samples.size() % TEMP_STATS_SAMPLES_PER_BUCKET) == 0), "windows",
+					"TempStats_AddSample at the sample", Index, Index);
+
+			for (unsigned Window = 0; Window < TEMP_STATS_NUM_OF_WINDOWS; Window++)
+			{
+				TempStats_ResultType Expected = BruteForce(Samples, Window);
+				bool Valid = TempStats_GetWindow((uint8)Window, &Result);
+
+				Compared++;
+				if (Valid && (Result.Minimum == Expected.Minimum) && (Result.Maximum == Expected.Maximum) &&
+						(Result.Mean == Expected.Mean) && (Result.Num_Of_Samples == Expected.Num_Of_Samples))
+				{
+					continue;
+				}
+
+				if (Mismatches[Window]++ == 0)
+				{
+					std::printf("%-10s FAIL %s window %u after %zu samples: min %u max %u mean %u count %u, expected "
+							"min %u max %u mean %u count %u%s\n", "windows", Sequence_Names[Sequence], Window,
+							Samples.size(), Result.Minimum, Result.Maximum, Result.Mean, Result.Num_Of_Samples,
+							Expected.Minimum, Expected.Maximum, Expected.Mean, Expected.Num_Of_Samples,
+							Valid ? "" : " (no result)");
+				}
+				g_failures++;
+			}
+		}
+
+		std::printf("%-10s %-8s %u samples, mismatches %u/%u/%u (1/10/60 minutes)\n", "windows", Sequence_Names[Sequence],
+				SEQUENCE_SAMPLES, Mismatches[0], Mismatches[1], Mismatches[2]);
+	}
+
+	std::printf("%-10s %u results compared: %s\n", "windows", Compared, (g_failures == Failures) ? "ok" : "errors");
+}
+
+} /* namespace */
+
+int main(int argc, char **argv)
+{
+	unsigned Seed = 1;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ((std::strcmp(argv[i], "--seed") == 0) && (i + 1 < argc))
+		{
+			Seed = (unsigned)std::strtoul(argv[++i], nullptr, 0);
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--seed N]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	RunWindows(Seed);
+
+	return g_failures ? 1 : 0;
+}
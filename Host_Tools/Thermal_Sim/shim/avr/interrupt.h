@@ -0,0 +1,16 @@
+/*******************************************************************************************************************
+ * File Name: interrupt.h
+ * Date: 19/10/2026
+ * Tool: Host register shim of <avr/interrupt.h>, the global interrupt enable is the I bit of the shim SREG
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#ifndef HOST_AVR_INTERRUPT_H_
+#define HOST_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+#define ISR(vector)    void vector(void)
+#define sei()          (SREG |= 0x80)
+#define cli()          (SREG &= (uint8_t)~0x80)
+
+#endif /* HOST_AVR_INTERRUPT_H_ */
@@ -0,0 +1,308 @@
+/*******************************************************************************************************************
+ * File Name: io.h
+ * Date: 19/10/2026
+ * Tool: Host register shim of <avr/io.h> for the ATmega32, used by Thermal_Sim and Trace_Replay to link the firmware on the host
+ * Author: Youssef Zaki
+ *
+ * Every register is an lvalue returned by Shim_Register8/Shim_Register16, so the simulator sees each access:
+ * before returning the register, the pending effects of the previous writes are applied (a polled ADC
+ * conversion, an EEPROM read or write, the USART data register empty flag). The interrupt vectors are
+ * the functions Shim_Isr_<vector>, called by the simulator.
+ ******************************************************************************************************************/
+#ifndef HOST_AVR_IO_H_
+#define HOST_AVR_IO_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/****************************************************************************************
+ *                                      Registers                                       *
+ ****************************************************************************************/
+
+typedef enum
+{
+	SHIM_PORTA, SHIM_PORTB, SHIM_PORTC, SHIM_PORTD, SHIM_DDRA, SHIM_DDRB, SHIM_DDRC, SHIM_DDRD,
+	SHIM_PINA, SHIM_PINB, SHIM_PINC, SHIM_PIND, SHIM_ADMUX, SHIM_ADCSRA, SHIM_ADCL, SHIM_ADCH,
+	SHIM_SFIOR, SHIM_TCCR0, SHIM_TCNT0, SHIM_OCR0, SHIM_TIMSK, SHIM_TIFR, SHIM_TCCR1A, SHIM_TCCR1B,
+	SHIM_TCCR2, SHIM_TCNT2, SHIM_OCR2, SHIM_ASSR, SHIM_EECR, SHIM_EEDR, SHIM_SREG, SHIM_SPL,
+	SHIM_SPH, SHIM_UCSRA, SHIM_UCSRB, SHIM_UCSRC, SHIM_UBRRL, SHIM_UBRRH, SHIM_UDR, SHIM_TWBR,
+	SHIM_TWSR, SHIM_TWAR, SHIM_TWDR, SHIM_TWCR, SHIM_MCUCR, SHIM_MCUCSR, SHIM_GICR, SHIM_GIFR,
+	SHIM_WDTCR, SHIM_SPCR, SHIM_SPSR, SHIM_SPDR, SHIM_ACSR, SHIM_OSCCAL,
+	SHIM_NUM_OF_REGISTERS8
+}Shim_Register8Id;
+
+typedef enum
+{
+	SHIM_ADC, SHIM_TCNT1, SHIM_OCR1A, SHIM_OCR1B, SHIM_ICR1, SHIM_EEAR, SHIM_SP,
+	SHIM_NUM_OF_REGISTERS16
+}Shim_Register16Id;
+
+volatile uint8_t *Shim_Register8(Shim_Register8Id Id);
+volatile uint16_t *Shim_Register16(Shim_Register16Id Id);
+
+#define PORTA        (*Shim_Register8(SHIM_PORTA))
+#define PORTB        (*Shim_Register8(SHIM_PORTB))
+#define PORTC        (*Shim_Register8(SHIM_PORTC))
+#define PORTD        (*Shim_Register8(SHIM_PORTD))
+#define DDRA         (*Shim_Register8(SHIM_DDRA))
+#define DDRB         (*Shim_Register8(SHIM_DDRB))
+#define DDRC         (*Shim_Register8(SHIM_DDRC))
+#define DDRD         (*Shim_Register8(SHIM_DDRD))
+#define PINA         (*Shim_Register8(SHIM_PINA))
+#define PINB         (*Shim_Register8(SHIM_PINB))
+#define PINC         (*Shim_Register8(SHIM_PINC))
+#define PIND         (*Shim_Register8(SHIM_PIND))
+#define ADMUX        (*Shim_Register8(SHIM_ADMUX))
+#define ADCSRA       (*Shim_Register8(SHIM_ADCSRA))
+#define ADCL         (*Shim_Register8(SHIM_ADCL))
+#define ADCH         (*Shim_Register8(SHIM_ADCH))
+#define SFIOR        (*Shim_Register8(SHIM_SFIOR))
+#define TCCR0        (*Shim_Register8(SHIM_TCCR0))
+#define TCNT0        (*Shim_Register8(SHIM_TCNT0))
+#define OCR0         (*Shim_Register8(SHIM_OCR0))
+#define TIMSK        (*Shim_Register8(SHIM_TIMSK))
+#define TIFR         (*Shim_Register8(SHIM_TIFR))
+#define TCCR1A       (*Shim_Register8(SHIM_TCCR1A))
+#define TCCR1B       (*Shim_Register8(SHIM_TCCR1B))
+#define TCCR2        (*Shim_Register8(SHIM_TCCR2))
+#define TCNT2        (*Shim_Register8(SHIM_TCNT2))
+#define OCR2         (*Shim_Register8(SHIM_OCR2))
+#define ASSR         (*Shim_Register8(SHIM_ASSR))
+#define EECR         (*Shim_Register8(SHIM_EECR))
+#define EEDR         (*Shim_Register8(SHIM_EEDR))
+#define SREG         (*Shim_Register8(SHIM_SREG))
+#define SPL          (*Shim_Register8(SHIM_SPL))
+#define SPH          (*Shim_Register8(SHIM_SPH))
+#define UCSRA        (*Shim_Register8(SHIM_UCSRA))
+#define UCSRB        (*Shim_Register8(SHIM_UCSRB))
+#define UCSRC        (*Shim_Register8(SHIM_UCSRC))
+#define UBRRL        (*Shim_Register8(SHIM_UBRRL))
+#define UBRRH        (*Shim_Register8(SHIM_UBRRH))
+#define UDR          (*Shim_Register8(SHIM_UDR))
+#define TWBR         (*Shim_Register8(SHIM_TWBR))
+#define TWSR         (*Shim_Register8(SHIM_TWSR))
+#define TWAR         (*Shim_Register8(SHIM_TWAR))
+#define TWDR         (*Shim_Register8(SHIM_TWDR))
+#define TWCR         (*Shim_Register8(SHIM_TWCR))
+#define MCUCR        (*Shim_Register8(SHIM_MCUCR))
+#define MCUCSR       (*Shim_Register8(SHIM_MCUCSR))
+#define GICR         (*Shim_Register8(SHIM_GICR))
+#define GIFR         (*Shim_Register8(SHIM_GIFR))
+#define WDTCR        (*Shim_Register8(SHIM_WDTCR))
+#define SPCR         (*Shim_Register8(SHIM_SPCR))
+#define SPSR         (*Shim_Register8(SHIM_SPSR))
+#define SPDR         (*Shim_Register8(SHIM_SPDR))
+#define ACSR         (*Shim_Register8(SHIM_ACSR))
+#define OSCCAL       (*Shim_Register8(SHIM_OSCCAL))
+
+#define ADC          (*Shim_Register16(SHIM_ADC))
+#define TCNT1        (*Shim_Register16(SHIM_TCNT1))
+#define OCR1A        (*Shim_Register16(SHIM_OCR1A))
+#define OCR1B        (*Shim_Register16(SHIM_OCR1B))
+#define ICR1         (*Shim_Register16(SHIM_ICR1))
+#define EEAR         (*Shim_Register16(SHIM_EEAR))
+#define SP           (*Shim_Register16(SHIM_SP))
+
+/****************************************************************************************
+ *                                      Bit Numbers                                     *
+ ****************************************************************************************/
+
+#define PA0 0
+#define PA1 1
+#define PA2 2
+#define PA3 3
+#define PA4 4
+#define PA5 5
+#define PA6 6
+#define PA7 7
+
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define PB4 4
+#define PB5 5
+#define PB6 6
+#define PB7 7
+
+#define PC0 0
+#define PC1 1
+#define PC2 2
+#define PC3 3
+#define PC4 4
+#define PC5 5
+#define PC6 6
+#define PC7 7
+
+#define PD0 0
+#define PD1 1
+#define PD2 2
+#define PD3 3
+#define PD4 4
+#define PD5 5
+#define PD6 6
+#define PD7 7
+#define REFS1    7
+#define REFS0    6
+#define ADLAR    5
+#define MUX4     4
+#define MUX3     3
+#define MUX2     2
+#define MUX1     1
+#define MUX0     0
+#define ADEN     7
+#define ADSC     6
+#define ADATE    5
+#define ADIF     4
+#define ADIE     3
+#define ADPS2    2
+#define ADPS1    1
+#define ADPS0    0
+#define ADTS2    7
+#define ADTS1    6
+#define ADTS0    5
+#define ACME     3
+#define PUD      2
+#define PSR2     1
+#define PSR10    0
+#define FOC0     7
+#define WGM00    6
+#define COM01    5
+#define COM00    4
+#define WGM01    3
+#define CS02     2
+#define CS01     1
+#define CS00     0
+#define OCIE2    7
+#define TOIE2    6
+#define TICIE1   5
+#define OCIE1A   4
+#define OCIE1B   3
+#define TOIE1    2
+#define OCIE0    1
+#define TOIE0    0
+#define OCF2     7
+#define TOV2     6
+#define ICF1     5
+#define OCF1A    4
+#define OCF1B    3
+#define TOV1     2
+#define OCF0     1
+#define TOV0     0
+#define COM1A1   7
+#define COM1A0   6
+#define COM1B1   5
+#define COM1B0   4
+#define FOC1A    3
+#define FOC1B    2
+#define WGM11    1
+#define WGM10    0
+#define ICNC1    7
+#define ICES1    6
+#define WGM13    4
+#define WGM12    3
+#define CS12     2
+#define CS11     1
+#define CS10     0
+#define FOC2     7
+#define WGM20    6
+#define COM21    5
+#define COM20    4
+#define WGM21    3
+#define CS22     2
+#define CS21     1
+#define CS20     0
+#define AS2      3
+#define TCN2UB   2
+#define OCR2UB   1
+#define TCR2UB   0
+#define EERIE    3
+#define EEMWE    2
+#define EEWE     1
+#define EERE     0
+#define RXC      7
+#define TXC      6
+#define UDRE     5
+#define FE       4
+#define DOR      3
+#define PE       2
+#define U2X      1
+#define MPCM     0
+#define RXCIE    7
+#define TXCIE    6
+#define UDRIE    5
+#define RXEN     4
+#define TXEN     3
+#define UCSZ2    2
+#define RXB8     1
+#define TXB8     0
+#define URSEL    7
+#define UMSEL    6
+#define UPM1     5
+#define UPM0     4
+#define USBS     3
+#define UCSZ1    2
+#define UCSZ0    1
+#define UCPOL    0
+#define TWINT    7
+#define TWEA     6
+#define TWSTA    5
+#define TWSTO    4
+#define TWWC     3
+#define TWEN     2
+#define TWIE     0
+#define SE       7
+#define SM2      6
+#define SM1      5
+#define SM0      4
+#define ISC11    3
+#define ISC10    2
+#define ISC01    1
+#define ISC00    0
+#define INT1     7
+#define INT0     6
+#define INT2     5
+#define IVSEL    1
+#define IVCE     0
+#define WDTOE    4
+#define WDE      3
+#define WDP2     2
+#define WDP1     1
+#define WDP0     0
+
+#define RAMEND       0x85F
+#define E2END        0x3FF
+
+/****************************************************************************************
+ *                                   Interrupt Vectors                                  *
+ ****************************************************************************************/
+
+#define INT0_vect          Shim_Isr_INT0
+#define INT1_vect          Shim_Isr_INT1
+#define INT2_vect          Shim_Isr_INT2
+#define TIMER2_COMP_vect   Shim_Isr_TIMER2_COMP
+#define TIMER2_OVF_vect    Shim_Isr_TIMER2_OVF
+#define TIMER1_CAPT_vect   Shim_Isr_TIMER1_CAPT
+#define TIMER1_COMPA_vect  Shim_Isr_TIMER1_COMPA
+#define TIMER1_COMPB_vect  Shim_Isr_TIMER1_COMPB
+#define TIMER1_OVF_vect    Shim_Isr_TIMER1_OVF
+#define TIMER0_COMP_vect   Shim_Isr_TIMER0_COMP
+#define TIMER0_OVF_vect    Shim_Isr_TIMER0_OVF
+#define SPI_STC_vect       Shim_Isr_SPI_STC
+#define USART_RXC_vect     Shim_Isr_USART_RXC
+#define USART_UDRE_vect    Shim_Isr_USART_UDRE
+#define USART_TXC_vect     Shim_Isr_USART_TXC
+#define ADC_vect           Shim_Isr_ADC
+#define EE_RDY_vect        Shim_Isr_EE_RDY
+#define ANA_COMP_vect      Shim_Isr_ANA_COMP
+#define TWI_vect           Shim_Isr_TWI
+#define SPM_RDY_vect       Shim_Isr_SPM_RDY
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_AVR_IO_H_ */
@@ -0,0 +1,17 @@
+/*******************************************************************************************************************
+ * File Name: pgmspace.h
+ * Date: 19/10/2026
+ * Tool: Host register shim of <avr/pgmspace.h>, the flash is the host memory
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#ifndef HOST_AVR_PGMSPACE_H_
+#define HOST_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+
+#define PROGMEM
+#define PSTR(string)           (string)
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+
+#endif /* HOST_AVR_PGMSPACE_H_ */
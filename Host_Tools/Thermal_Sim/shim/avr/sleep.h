@@ -0,0 +1,33 @@
+/*******************************************************************************************************************
+ * File Name: sleep.h
+ * Date: 19/10/2026
+ * Tool: Host register shim of <avr/sleep.h>, sleeping runs the simulated hardware until the next interrupt
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#ifndef HOST_AVR_SLEEP_H_
+#define HOST_AVR_SLEEP_H_
+
+#include <avr/io.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void Shim_Sleep(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define SLEEP_MODE_IDLE        0
+#define SLEEP_MODE_ADC         (1 << SM0)
+#define SLEEP_MODE_PWR_DOWN    (1 << SM1)
+#define SLEEP_MODE_PWR_SAVE    ((1 << SM0) | (1 << SM1))
+
+#define set_sleep_mode(mode)   (MCUCR = (MCUCR & (uint8_t)~((1 << SM0) | (1 << SM1) | (1 << SM2))) | (mode))
+#define sleep_enable()         (MCUCR |= (1 << SE))
+#define sleep_disable()        (MCUCR &= (uint8_t)~(1 << SE))
+#define sleep_cpu()            Shim_Sleep()
+#define sleep_mode()           do { sleep_enable(); sleep_cpu(); sleep_disable(); } while (0)
+
+#endif /* HOST_AVR_SLEEP_H_ */
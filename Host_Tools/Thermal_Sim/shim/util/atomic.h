@@ -0,0 +1,14 @@
+/*******************************************************************************************************************
+ * File Name: atomic.h
+ * Date: 19/10/2026
+ * Tool: Host register shim of <util/atomic.h>, the simulated interrupts only run while the firmware sleeps
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#ifndef HOST_UTIL_ATOMIC_H_
+#define HOST_UTIL_ATOMIC_H_
+
+#define ATOMIC_RESTORESTATE
+#define ATOMIC_FORCEON
+#define ATOMIC_BLOCK(type)     for (int Atomic_Once = 1; Atomic_Once != 0; Atomic_Once = 0)
+
+#endif /* HOST_UTIL_ATOMIC_H_ */
@@ -0,0 +1,24 @@
+/*******************************************************************************************************************
+ * File Name: delay.h
+ * Date: 19/10/2026
+ * Tool: Host register shim of <util/delay.h>, the busy waits take no simulated time unless the tool defines
+ *       Shim_Delay_us (LCD_Model counts them as CPU cycles)
+ * Author: Youssef Zaki
+ ******************************************************************************************************************/
+#ifndef HOST_UTIL_DELAY_H_
+#define HOST_UTIL_DELAY_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void Shim_Delay_us(double Microseconds) __attribute__((weak));
+
+#ifdef __cplusplus
+}
+#endif
+
+#define _delay_us(us)          do { if (Shim_Delay_us) Shim_Delay_us((double)(us)); } while (0)
+#define _delay_ms(ms)          _delay_us((ms) * 1000.0)
+
+#endif /* HOST_UTIL_DELAY_H_ */
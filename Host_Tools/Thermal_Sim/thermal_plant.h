@@ -0,0 +1,64 @@
+/*******************************************************************************************************************
+ * File Name: thermal_plant.h
+ * Date: 19/10/2026
+ * Tool: Thermal plant model of Thermal_Sim, shared with Curve_Optimizer
+ * Author: Youssef Zaki
+ *
+ * One thermal mass heated by a power and cooled by natural convection plus the fan airflow:
+ *     C dT/dt = P - (G_natural + G_fan * fan speed) * (T - ambient)
+ * The fan speed (0..1) follows the drive duty cycle with a first order lag, 4 times faster while the windings
+ * are shorted (brake), and stops under the stall duty cycle.
+ ******************************************************************************************************************/
+#ifndef THERMAL_PLANT_H_
+#define THERMAL_PLANT_H_
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+struct ThermalPlantParams
+{
+	double Ambient_C = 25.0;
+	double Mass_J_per_K = 400.0;
+	double G_Natural = 0.5;
+	double G_Fan = 3.0;
+	double Fan_Tau_s = 2.0;
+	double Stall_Duty = 0.15;
+};
+
+struct ThermalPlantState
+{
+	double Temperature_C = 25.0;
+	double Fan_Speed = 0.0;
+};
+
+/* The options --ambient, --mass, --g-natural, --g-fan, --fan-tau and --stall, false for another option */
+inline bool ParseThermalPlantOption(const char *Name, const char *Value, ThermalPlantParams *Params_Ptr)
+{
+	if (!std::strcmp(Name, "--ambient")) Params_Ptr -> Ambient_C = std::atof(Value);
+	else if (!std::strcmp(Name, "--mass")) Params_Ptr -> Mass_J_per_K = std::atof(Value);
+	else if (!std::strcmp(Name, "--g-natural")) Params_Ptr -> G_Natural = std::atof(Value);
+	else if (!std::strcmp(Name, "--g-fan")) Params_Ptr -> G_Fan = std::atof(Value);
+	else if (!std::strcmp(Name, "--fan-tau")) Params_Ptr -> Fan_Tau_s = std::atof(Value);
+	else if (!std::strcmp(Name, "--stall")) Params_Ptr -> Stall_Duty = std::atof(Value);
+	else return false;
+
+	return true;
+}
+
+/* Advance the plant by Dt_s with the drive duty cycle (0..1) and the heat power */
+inline void StepThermalPlant(const ThermalPlantParams &Params, double Drive_Duty, bool Braking, double Watts,
+		double Dt_s, ThermalPlantState *State_Ptr)
+{
+	double Target = (Drive_Duty < Params.Stall_Duty) ? 0.0 : Drive_Duty;
+	double Tau_s = Braking ? (Params.Fan_Tau_s / 4.0) : Params.Fan_Tau_s;
+	double Conductance;
+
+	State_Ptr -> Fan_Speed += (Target - State_Ptr -> Fan_Speed) * std::min(1.0, Dt_s / Tau_s);
+
+	Conductance = Params.G_Natural + Params.G_Fan * State_Ptr -> Fan_Speed;
+	State_Ptr -> Temperature_C += (Watts - Conductance * (State_Ptr -> Temperature_C - Params.Ambient_C)) * Dt_s /
+			Params.Mass_J_per_K;
+}
+
+#endif /* THERMAL_PLANT_H_ */
@@ -0,0 +1,1015 @@
+/*******************************************************************************************************************
+ * File Name: thermal_sim.cpp
+ * Date: 19/10/2026
+ * Tool: Host-side closed loop simulation of the fan controller firmware against a thermal plant model
+ * Author: Youssef Zaki
+ *
+ * The firmware sources of Fan_Controller_Project are compiled for the host against the register shim in
+ * shim/ (main renamed Firmware_Main) and run unchanged:
+ *     - every register access goes through Shim_Register8/Shim_Register16, which completes the polled
+ *       ADC conversions, the EEPROM reads/writes and keeps the USART transmitter ready,
+ *     - sleep_cpu() runs the simulated hardware for one Timer0 period: the plant is advanced, then the
+ *       Timer0 overflow interrupt, the auto triggered ADC conversion and its interrupt, and the EEPROM
+ *       ready interrupt are called as the vectors Shim_Isr_<vector> of the firmware,
+ *     - the busy waits of <util/delay.h> take their time and run the simulated hardware of the Timer0 periods
+ *       passed meanwhile, so the boot sequence of the firmware is timed; the report gives the time from the
+ *       reset to the first drive of the motor and to the end of the LCD initialization,
+ *     - Timer2 and the interrupt driven USART are timed per timer tick and per character, the CPU is woken up
+ *       by their interrupts between two Timer0 overflows (Modbus slave, see --modbus-pty),
+ *     - the interrupts of a Timer0 period take their time: the entry (FAN_SAFETY_RESPONSE_CYCLES plus a prologue
+ *       of INTERRUPT_PROLOGUE_CYCLES) and --access-cycles per register access, the ADC interrupt starts at the
+ *       end of the conversion or of the Timer0 interrupt, plus --blocking-cycles, and TCNT0 follows this time.
+ *       When the over temperature fault trips (e.g. --initial 150) the report gives the reaction measured by
+ *       the firmware (FanSafety_GetReactionCycles) and the tool returns 1 when it is above
+ *       FAN_SAFETY_REACTION_BUDGET_CYCLES.
+ * The plant (thermal_plant.h, shared with Curve_Optimizer) is one thermal mass heated by a power profile and
+ * cooled by natural convection plus the fan airflow. The fan speed follows the drive duty cycle seen on the pins
+ * (OC0/PB3 and the bridge pins PB0/PB1) with a first order lag, and stalls under a minimum duty cycle. The LM35 and the current shunt are seen
+ * by the ADC as synthetic voltages.
+ * Build and run on the host:
+ *     for f in $(ls ../../Fan_Controller_Project | grep "\.c$"); do
+ *         gcc -O2 -std=gnu99 -DF_CPU=1000000UL -Dmain=Firmware_Main -Ishim -I../../Fan_Controller_Project \
+ *             -c ../../Fan_Controller_Project/$f -o ${f%.c}.o; done
+ *     g++ -O2 -std=c++17 -Ishim -I../../Fan_Controller_Project thermal_sim.cpp *.o -o thermal_sim
+ *     ./thermal_sim --hours 6 --heat 0:0,0.25:20,2:45,4:10 --csv trace.csv
+ * Options (defaults in brackets):
+ *     --hours H             simulated time [6]
+ *     --heat h:W,h:W,...    heat source steps, start hour and power in watts [0:0,0.25:20,2:45,4:10]
+ *     --ambient C           ambient temperature [25]
+ *     --initial C           temperature at reset [ambient], above the first threshold of the fan curve for a
+ *                           boot with the fan needed at once
+ *     --mass J/K            thermal mass [400]
+ *     --g-natural W/K       natural convection conductance [0.5]
+ *     --g-fan W/K           conductance added at full fan speed [3]
+ *     --fan-tau s           time constant of the fan speed [2]
+ *     --stall duty          minimum duty cycle which turns the fan [0.15]
+ *     --noise C             noise of the sensor reading, standard deviation [0.2]
+ *     --settle-band C       band of the settling time around the final temperature [1]
+ *     --csv file            write a trace of the run [none], --csv-period s between rows [10]
+ *     --access-cycles N     CPU cycles per register access in an interrupt, the code around it [10]
+ *     --blocking-cycles N   section with the interrupts disabled at the end of each conversion [0]
+ *     --modbus-pty link     firmware built with -DMODBUS_SLAVE_ENABLED=1 -DLCD_RS_PIN=PIN3_ID: open a pseudo
+ *                           terminal as the USART line (symbolic link to it, "-" for none) and run in real
+ *                           time, Ctrl+C ends the run with the report (Host_Tools/Modbus_Master talks to it)
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "thermal_plant.h"
+
+extern "C"
+{
+#include "Standard_Types.h"
+#include "ADC.h"
+#include "DC_Motor.h"
+#include "LM35.h"
+#include "Current_Sense.h"
+#include "Fan_Safety.h"
+#include "LCD.h"
+#include "Modbus_Slave.h"
+
+int Firmware_Main(void);
+
+/* Interrupt vectors of the firmware, missing ones are not called */
+void Shim_Isr_TIMER0_OVF(void) __attribute__((weak));
+void Shim_Isr_TIMER0_COMP(void) __attribute__((weak));
+void Shim_Isr_ADC(void) __attribute__((weak));
+void Shim_Isr_EE_RDY(void) __attribute__((weak));
+void Shim_Isr_TIMER2_COMP(void) __attribute__((weak));
+void Shim_Isr_USART_RXC(void) __attribute__((weak));
+void Shim_Isr_USART_UDRE(void) __attribute__((weak));
+void Shim_Isr_USART_TXC(void) __attribute__((weak));
+
+/* Symbols of the avr-libc run time used by Stack_Monitor.c */
+uint8 __heap_start;
+char *__brkval = nullptr;
+
+char *itoa(int Value, char *Buffer, int Radix);
+}
+
+namespace
+{
+
+constexpr double F_CPU_HZ = 1000000.0;
+constexpr double SENSOR_VOLTS_PER_DEGREE = 0.010;
+constexpr double RUN_CURRENT_A = 0.25;
+constexpr double STALL_CURRENT_A = 1.0;
+
+/****************************************************************************************
+ *                                   Plant and Options                                  *
+ ****************************************************************************************/
+
+struct HeatStep
+{
+	double Start_s;
+	double Watts;
+};
+
+struct Options
+{
+	double Hours = 6.0;
+	std::vector<HeatStep> Heat = {{0.0, 0.0}, {0.25 * 3600.0, 20.0}, {2.0 * 3600.0, 45.0}, {4.0 * 3600.0, 10.0}};
+	ThermalPlantParams Plant;
+	double Initial_C = NAN;
+	double Noise_C = 0.2;
+	double Settle_Band_C = 1.0;
+	std::string Csv;
+	double Csv_Period_s = 10.0;
+	std::string Modbus_Pty;
+	uint32_t Access_Cycles = 10;
+	uint32_t Blocking_Cycles = 0;
+};
+
+struct Plant : ThermalPlantState
+{
+	double Drive_Duty = 0.0;
+	bool Braking = false;
+	double Sampled_Current_A = 0.0;
+};
+
+/* Statistics of one heat step */
+struct StepStats
+{
+	double Start_s = 0.0;
+	double End_s = 0.0;
+	double Watts = 0.0;
+	double Initial_C = 0.0;
+	std::vector<float> Trace;
+};
+
+Options g_options;
+Plant g_plant;
+std::mt19937 g_generator(1);
+std::normal_distribution<double> g_noise(0.0, 1.0);
+
+/****************************************************************************************
+ *                                      Register Shim                                   *
+ ****************************************************************************************/
+
+uint8_t g_registers8[SHIM_NUM_OF_REGISTERS8];
+uint16_t g_registers16[SHIM_NUM_OF_REGISTERS16];
+uint8_t g_eeprom[E2END + 1];
+
+uint64_t g_cycles = 0;
+uint64_t g_endCycles = 0;
+uint64_t g_lastOverflow = 0;
+uint64_t g_nextOverflow = 0;
+
+double Seconds()
+{
+	return (double)g_cycles / F_CPU_HZ;
+}
+
+double HeatPower(double Time_s)
+{
+	double Watts = 0.0;
+
+	for (const HeatStep &Step : g_options.Heat)
+	{
+		if (Time_s >= Step.Start_s)
+		{
+			Watts = Step.Watts;
+		}
+	}
+	return Watts;
+}
+
+/* ADC code of a channel (MUX4:0) with the reference of REFS1:0, only the single ended inputs are modeled */
+uint16_t Convert(uint8_t Admux)
+{
+	uint8_t Channel = Admux & 0x1F;
+	double Reference_V = ((Admux >> 6) == 1) ? 5.0 : 2.56;
+	double Volts = 0.0;
+
+	if (Channel == LM35_SENSOR_READ_CHANNEL)
+	{
+		Volts = (g_plant.Temperature_C + g_options.Noise_C * g_noise(g_generator)) * SENSOR_VOLTS_PER_DEGREE;
+	}
+	else if (Channel == CURRENT_SENSE_CHANNEL)
+	{
+		Volts = g_plant.Sampled_Current_A * CURRENT_SENSE_MV_PER_AMP / 1000.0;
+	}
+	else if (Channel == ADC_VBG)
+	{
+		Volts = 1.22;
+	}
+
+	long Code = std::lround(Volts / Reference_V * 1024.0);
+	return (uint16_t)std::min(1023L, std::max(0L, Code));
+}
+
+/*
+ * Timer2 runs from the count Base_Count at the cycle Base_Cycles. The firmware writes are seen as a TCNT2,
+ * TCCR2 or OCR2 value different from the last one seen (a write of the same value changes nothing but the
+ * prescaler phase), then the counter starts again from the written value.
+ */
+const uint16_t TIMER2_DIVISIONS[8] = {0, 1, 8, 32, 64, 128, 256, 1024};
+constexpr uint64_t NEVER = UINT64_MAX;
+
+uint64_t g_timer2BaseCycles = 0;
+uint8_t g_timer2BaseCount = 0;
+uint8_t g_timer2SeenCount = 0;
+uint8_t g_timer2SeenControl = 0;
+uint8_t g_timer2SeenCompare = 0;
+uint64_t g_timer2NextCompare = NEVER;
+
+/* Counting steps of Timer2 before it goes back to 0: OCR2 + 1 in the CTC mode, else 256 */
+uint32_t Timer2Steps()
+{
+	uint8_t Tccr2 = g_registers8[SHIM_TCCR2];
+
+	return ((Tccr2 & (1 << WGM21)) && !(Tccr2 & (1 << WGM20))) ? (uint32_t)g_registers8[SHIM_OCR2] + 1 : 256;
+}
+
+uint8_t Timer2Count()
+{
+	uint32_t Division = TIMER2_DIVISIONS[g_registers8[SHIM_TCCR2] & 0x07];
+	uint32_t Steps = Timer2Steps();
+	uint64_t Ticks;
+
+	if (Division == 0)
+	{
+		return g_timer2BaseCount;
+	}
+
+	Ticks = (g_cycles - g_timer2BaseCycles) / Division;
+
+	/* A count above the top first runs to 255 */
+	if (g_timer2BaseCount >= Steps)
+	{
+		if (Ticks < 256u - g_timer2BaseCount)
+		{
+			return (uint8_t)(g_timer2BaseCount + Ticks);
+		}
+		return (uint8_t)((Ticks - (256u - g_timer2BaseCount)) % Steps);
+	}
+	return (uint8_t)((g_timer2BaseCount + Ticks) % Steps);
+}
+
+/* The compare flag is set on the timer clock after the count equals OCR2 */
+void Timer2Rebase(uint8_t Count)
+{
+	uint32_t Division = TIMER2_DIVISIONS[g_registers8[SHIM_TCCR2] & 0x07];
+	uint8_t Compare = g_registers8[SHIM_OCR2];
+
+	g_timer2BaseCycles = g_cycles;
+	g_timer2BaseCount = Count;
+	g_timer2NextCompare = (Division == 0) ? NEVER :
+			g_cycles + ((uint64_t)(uint8_t)(Compare - Count) + 1) * Division;
+}
+
+void ServiceTimer2()
+{
+	uint8_t &Tcnt2 = g_registers8[SHIM_TCNT2];
+	uint8_t Control = g_registers8[SHIM_TCCR2] & ~(1 << FOC2);
+
+	if ((Tcnt2 != g_timer2SeenCount) || (Control != g_timer2SeenControl) || (g_registers8[SHIM_OCR2] != g_timer2SeenCompare))
+	{
+		g_timer2SeenControl = Control;
+		g_timer2SeenCompare = g_registers8[SHIM_OCR2];
+		Timer2Rebase(Tcnt2);
+	}
+	Tcnt2 = Timer2Count();
+	g_timer2SeenCount = Tcnt2;
+}
+
+/* Entry of an interrupt after its response: SREG and the registers used by the handler are pushed */
+constexpr uint32_t INTERRUPT_PROLOGUE_CYCLES = 40;
+
+/* Cycles since the Timer0 overflow while the interrupts of the period run, TCNT0 follows them */
+uint32_t g_isrClock = 0;
+bool g_isrClockRunning = false;
+
+/* Timer0 prescaler division from TCCR0, 0 when it is stopped */
+uint32_t Timer0Division()
+{
+	static const uint32_t Prescalars[8] = {0, 1, 8, 64, 256, 1024, 0, 0};
+
+	return Prescalars[g_registers8[SHIM_TCCR0] & 0x07];
+}
+
+/* The clock of the interrupts: one register access more, or the start of the next interrupt */
+void AdvanceIsrClock(uint32_t Cycles)
+{
+	uint32_t Division = Timer0Division();
+
+	g_isrClock += Cycles;
+	if (Division != 0)
+	{
+		g_registers8[SHIM_TCNT0] = (uint8_t)std::min<uint32_t>(g_isrClock / Division, 255);
+	}
+}
+
+/* Effects of the previous register writes, applied before each register access */
+void Service()
+{
+	uint8_t &Adcsra = g_registers8[SHIM_ADCSRA];
+	uint8_t &Eecr = g_registers8[SHIM_EECR];
+
+	if ((Adcsra & (1 << ADSC)) && (Adcsra & (1 << ADEN)))
+	{
+		g_registers16[SHIM_ADC] = Convert(g_registers8[SHIM_ADMUX]);
+		Adcsra = (Adcsra & ~(1 << ADSC)) | (1 << ADIF);
+	}
+
+	if (Eecr & (1 << EERE))
+	{
+		g_registers8[SHIM_EEDR] = g_eeprom[g_registers16[SHIM_EEAR] & E2END];
+		Eecr &= ~(1 << EERE);
+	}
+	if (Eecr & (1 << EEWE))
+	{
+		g_eeprom[g_registers16[SHIM_EEAR] & E2END] = g_registers8[SHIM_EEDR];
+		Eecr &= ~((1 << EEWE) | (1 << EEMWE));
+	}
+
+	/* The polled transmitter (profiler dump) never waits, the interrupt driven one is timed (SerialEvent) */
+	g_registers8[SHIM_UCSRA] |= (1 << UDRE) | (1 << TXC);
+	ServiceTimer2();
+
+	g_registers8[SHIM_PINA] = g_registers8[SHIM_PORTA];
+	g_registers8[SHIM_PINB] = g_registers8[SHIM_PORTB];
+	g_registers8[SHIM_PINC] = g_registers8[SHIM_PORTC];
+	g_registers8[SHIM_PIND] = g_registers8[SHIM_PORTD];
+
+	if (g_isrClockRunning)
+	{
+		AdvanceIsrClock(g_options.Access_Cycles);
+	}
+}
+
+/****************************************************************************************
+ *                                       Metrics                                        *
+ ****************************************************************************************/
+
+std::vector<StepStats> g_steps;
+double g_dutySum = 0.0;
+double g_maxTemperature = 0.0;
+uint64_t g_periods = 0;
+unsigned long g_speedChanges = 0;
+uint16 g_lastCompare = 0xFFFF;
+double g_firstActuation_s = -1.0;
+double g_lcdReady_s = -1.0;
+unsigned long g_modbusResponses = 0;
+double g_modbusLatencySum_s = 0.0;
+double g_modbusLatencyMax_s = 0.0;
+FILE *g_csv = nullptr;
+double g_nextCsv_s = 0.0;
+
+/* Timer0 period in CPU cycles from the mode and the prescaler of TCCR0 */
+uint32_t Timer0PeriodCycles()
+{
+	uint8_t Tccr0 = g_registers8[SHIM_TCCR0];
+	uint32_t Division = Timer0Division();
+	uint32_t Steps = 256;
+
+	if ((Tccr0 & (1 << WGM00)) && !(Tccr0 & (1 << WGM01)))
+	{
+		Steps = 510;
+	}
+	else if (!(Tccr0 & (1 << WGM00)) && (Tccr0 & (1 << WGM01)))
+	{
+		Steps = (uint32_t)g_registers8[SHIM_OCR0] + 1;
+	}
+
+	/* A stopped timer never wakes the CPU, the time still moves so the run ends */
+	return (Division == 0) ? 2048 : Steps * Division;
+}
+
+/* Motor drive seen on the pins: PB0/PB1 bridge inputs, OC0 (PB3) PWM or forced level */
+void ReadMotorPins()
+{
+	uint8_t Portb = g_registers8[SHIM_PORTB];
+	uint8_t Direction = Portb & 0x03;
+	double Duty;
+
+	if (g_registers8[SHIM_TCCR0] & (1 << COM01))
+	{
+		Duty = (g_registers8[SHIM_OCR0] == 0) ? 0.0 : (g_registers8[SHIM_OCR0] + 1) / 256.0;
+	}
+	else
+	{
+		Duty = (Portb & (1 << PB3)) ? 1.0 : 0.0;
+	}
+
+	g_plant.Drive_Duty = ((Direction == 0x01) || (Direction == 0x02)) ? Duty : 0.0;
+	g_plant.Braking = (Direction == 0x03) && (Duty > 0.0);
+}
+
+void StepPlant(double Dt_s)
+{
+	StepThermalPlant(g_options.Plant, g_plant.Drive_Duty, g_plant.Braking, HeatPower(Seconds()), Dt_s, &g_plant);
+
+	/* The shunt is sampled at the start of the Fast PWM high time */
+	g_plant.Sampled_Current_A = (g_plant.Drive_Duty > 0.0) ?
+			(RUN_CURRENT_A + (STALL_CURRENT_A - RUN_CURRENT_A) * (1.0 - g_plant.Fan_Speed)) : 0.0;
+}
+
+void Record()
+{
+	double Time_s = Seconds();
+	uint16 Compare = DcMotor_GetOutputCompare();
+
+	g_periods++;
+	g_dutySum += g_plant.Drive_Duty;
+
+	/* Boot latencies from the reset (Firmware_Main starts at time 0) */
+	if ((g_firstActuation_s < 0.0) && ((g_plant.Drive_Duty > 0.0) || g_plant.Braking))
+	{
+		g_firstActuation_s = Time_s;
+	}
+	if ((g_lcdReady_s < 0.0) && LCD_IsReady())
+	{
+		g_lcdReady_s = Time_s;
+	}
+	g_maxTemperature = std::max(g_maxTemperature, g_plant.Temperature_C);
+
+	if (Compare != g_lastCompare)
+	{
+		if (g_lastCompare != 0xFFFF)
+		{
+			g_speedChanges++;
+		}
+		g_lastCompare = Compare;
+	}
+
+	if ((g_steps.empty() || (Time_s >= g_steps.back().End_s)) && (g_steps.size() < g_options.Heat.size()))
+	{
+		StepStats Step;
+		size_t Index = g_steps.size();
+
+		Step.Start_s = g_options.Heat[Index].Start_s;
+		Step.End_s = (Index + 1 < g_options.Heat.size()) ? g_options.Heat[Index + 1].Start_s : g_endCycles / F_CPU_HZ;
+		Step.End_s = std::min(Step.End_s, g_endCycles / F_CPU_HZ);
+		Step.Watts = g_options.Heat[Index].Watts;
+		Step.Initial_C = g_plant.Temperature_C;
+		g_steps.push_back(Step);
+	}
+
+	/* One point every 100ms is enough for the step response */
+	if ((g_periods % 50) == 0)
+	{
+		g_steps.back().Trace.push_back((float)g_plant.Temperature_C);
+	}
+
+	if (g_csv && (Time_s >= g_nextCsv_s))
+	{
+		g_nextCsv_s += g_options.Csv_Period_s;
+		std::fprintf(g_csv, "%.1f,%.3f,%.1f,%.4f,%.4f,%u\n", Time_s, g_plant.Temperature_C, HeatPower(Time_s),
+				g_plant.Drive_Duty, g_plant.Fan_Speed, (unsigned)Compare);
+	}
+}
+
+void Report()
+{
+	double Hours = Seconds() / 3600.0;
+
+	std::printf("step  start    power   from      final     overshoot  settling   ripple p-p\n");
+	for (const StepStats &Step : g_steps)
+	{
+		const std::vector<float> &Trace = Step.Trace;
+		size_t Tail = Trace.size() - Trace.size() / 5;
+		double Final = 0.0;
+		double Tail_Min = 1e9;
+		double Tail_Max = -1e9;
+		double Overshoot = 0.0;
+		double Settling_s = 0.0;
+
+		if (Trace.size() < 10)
+		{
+			continue;
+		}
+
+		for (size_t Index = Tail; Index < Trace.size(); Index++)
+		{
+			Final += Trace[Index];
+			Tail_Min = std::min(Tail_Min, (double)Trace[Index]);
+			Tail_Max = std::max(Tail_Max, (double)Trace[Index]);
+		}
+		Final /= (double)(Trace.size() - Tail);
+
+		for (size_t Index = 0; Index < Trace.size(); Index++)
+		{
+			double Excess = (Final >= Step.Initial_C) ? (Trace[Index] - Final) : (Final - Trace[Index]);
+
+			Overshoot = std::max(Overshoot, Excess);
+			if (std::fabs(Trace[Index] - Final) > g_options.Settle_Band_C)
+			{
+				Settling_s = (Index + 1) * 0.1;
+			}
+		}
+
+		std::printf("%4zu  %5.2fh  %5.1fW  %6.2fC   %6.2fC   %6.2fC    ", (size_t)(&Step - &g_steps[0]),
+				Step.Start_s / 3600.0, Step.Watts, Step.Initial_C, Final, Overshoot);
+		if (Tail_Max - Tail_Min > 2.0 * g_options.Settle_Band_C)
+		{
+			std::printf(" limit cycle");
+		}
+		else
+		{
+			std::printf("%8.0fs  ", Settling_s);
+		}
+		std::printf("  %6.2fC\n", Tail_Max - Tail_Min);
+	}
+
+	std::printf("boot: ");
+	if (g_firstActuation_s >= 0.0)
+	{
+		std::printf("fan first driven %.1fms", g_firstActuation_s * 1e3);
+	}
+	else
+	{
+		std::printf("fan not driven (below the fan curve, see --initial)");
+	}
+	std::printf(", LCD ready %.1fms after reset\n", g_lcdReady_s * 1e3);
+
+	std::printf("max temperature %.2fC, average duty %.1f%%, speed changes %.1f/h, safety fault %s, current trips %u\n",
+			g_maxTemperature, 100.0 * g_dutySum / (double)g_periods, g_speedChanges / Hours,
+			FanSafety_IsFaulted() ? "yes" : "no", (unsigned)CurrentSense_GetTripCount());
+
+	if (FanSafety_IsFaulted())
+	{
+		std::printf("safety fault reaction %lu cycles (budget %lu: conversion %lu, blocking %lu, response %lu, fast path %lu)%s\n",
+				(unsigned long)FanSafety_GetReactionCycles(), FAN_SAFETY_REACTION_BUDGET_CYCLES, FAN_SAFETY_CONVERSION_CYCLES,
+				FAN_SAFETY_BLOCKING_CYCLES, FAN_SAFETY_RESPONSE_CYCLES, FAN_SAFETY_FAST_PATH_CYCLES,
+				(FanSafety_GetReactionCycles() > FAN_SAFETY_REACTION_BUDGET_CYCLES) ? " FAIL" : "");
+	}
+
+	if (!g_options.Modbus_Pty.empty())
+	{
+		std::printf("modbus: %lu responses, latency from the last request byte to the first response byte "
+				"average %.2fms max %.2fms\n", g_modbusResponses,
+				g_modbusResponses ? 1e3 * g_modbusLatencySum_s / g_modbusResponses : 0.0, 1e3 * g_modbusLatencyMax_s);
+	}
+}
+
+/****************************************************************************************
+ *                                    Option Parsing                                    *
+ ****************************************************************************************/
+
+std::vector<HeatStep> ParseHeat(const char *Text)
+{
+	std::vector<HeatStep> Steps;
+	std::string Remaining(Text);
+
+	while (!Remaining.empty())
+	{
+		size_t Comma = Remaining.find(',');
+		std::string Item = Remaining.substr(0, Comma);
+		double Hours = 0.0;
+		double Watts = 0.0;
+
+		if (std::sscanf(Item.c_str(), "%lf:%lf", &Hours, &Watts) != 2)
+		{
+			std::fprintf(stderr, "bad heat step \"%s\", expected hours:watts\n", Item.c_str());
+			std::exit(1);
+		}
+		Steps.push_back({Hours * 3600.0, Watts});
+		Remaining = (Comma == std::string::npos) ? "" : Remaining.substr(Comma + 1);
+	}
+
+	if (Steps.empty() || (Steps[0].Start_s != 0.0))
+	{
+		Steps.insert(Steps.begin(), {0.0, 0.0});
+	}
+	return Steps;
+}
+
+void ParseOptions(int Argc, char **Argv)
+{
+	for (int Index = 1; Index + 1 < Argc; Index += 2)
+	{
+		const char *Name = Argv[Index];
+		const char *Value = Argv[Index + 1];
+
+		if (!std::strcmp(Name, "--hours")) g_options.Hours = std::atof(Value);
+		else if (!std::strcmp(Name, "--heat")) g_options.Heat = ParseHeat(Value);
+		else if (ParseThermalPlantOption(Name, Value, &g_options.Plant)) continue;
+		else if (!std::strcmp(Name, "--initial")) g_options.Initial_C = std::atof(Value);
+		else if (!std::strcmp(Name, "--noise")) g_options.Noise_C = std::atof(Value);
+		else if (!std::strcmp(Name, "--settle-band")) g_options.Settle_Band_C = std::atof(Value);
+		else if (!std::strcmp(Name, "--csv")) g_options.Csv = Value;
+		else if (!std::strcmp(Name, "--csv-period")) g_options.Csv_Period_s = std::atof(Value);
+		else if (!std::strcmp(Name, "--modbus-pty")) g_options.Modbus_Pty = Value;
+		else if (!std::strcmp(Name, "--access-cycles")) g_options.Access_Cycles = (uint32_t)std::atoi(Value);
+		else if (!std::strcmp(Name, "--blocking-cycles")) g_options.Blocking_Cycles = (uint32_t)std::atoi(Value);
+		else
+		{
+			std::fprintf(stderr, "unknown option %s\n", Name);
+			std::exit(1);
+		}
+	}
+}
+
+std::chrono::steady_clock::time_point g_wallStart;
+volatile std::sig_atomic_t g_stop = 0;
+
+/****************************************************************************************
+ *                                Serial Line (Modbus Slave)                            *
+ ****************************************************************************************/
+
+/*
+ * The USART is timed per character from UBRR, U2X and the frame format of UCSRC: the received bytes are
+ * spaced by one character at least, the Data Register Empty interrupt is called when the transmit buffer is
+ * free and writes one byte (read from UDR after the interrupt), the Transmit Complete interrupt comes at the
+ * end of the last character. A byte reaches the other side at the end of its character. The line is a pseudo terminal, and the simulation runs in real time with it.
+ */
+int g_ptyFd = -1;
+int g_ptySlaveFd = -1;
+
+/* Received bytes with the cycle of the end of their stop bit */
+std::deque<std::pair<uint64_t, uint8_t>> g_rxBytes;
+uint64_t g_rxLastCycles = 0;
+bool g_rxRequestPending = false;
+
+/* The byte in the transmit shift register ends at g_txShiftEnd, the buffer is free from g_txBufferFree */
+uint64_t g_txShiftEnd = 0;
+uint64_t g_txBufferFree = 0;
+bool g_txCompletePending = false;
+
+/* Transmitted bytes, written to the pseudo terminal at the end of their stop bit */
+std::deque<std::pair<uint64_t, uint8_t>> g_txBytes;
+
+uint64_t CharacterCycles()
+{
+	uint8_t Ucsrc = g_registers8[SHIM_UCSRC];
+	uint32_t Ubrr = ((uint32_t)(g_registers8[SHIM_UBRRH] & 0x0F) << 8) | g_registers8[SHIM_UBRRL];
+	uint32_t Bit_Cycles = ((g_registers8[SHIM_UCSRA] & (1 << U2X)) ? 8 : 16) * (Ubrr + 1);
+	uint32_t Bits = 1 + 8 + ((Ucsrc & (1 << UPM1)) ? 1 : 0) + ((Ucsrc & (1 << USBS)) ? 2 : 1);
+
+	return (uint64_t)Bits * Bit_Cycles;
+}
+
+uint64_t WallCycles()
+{
+	return (uint64_t)(std::chrono::duration<double>(std::chrono::steady_clock::now() - g_wallStart).count() * F_CPU_HZ);
+}
+
+void OpenPty()
+{
+	struct termios Settings;
+
+	g_ptyFd = posix_openpt(O_RDWR | O_NOCTTY);
+	if ((g_ptyFd < 0) || grantpt(g_ptyFd) || unlockpt(g_ptyFd))
+	{
+		std::perror("pseudo terminal");
+		std::exit(1);
+	}
+
+	/* The slave side stays open (no hang up between two masters) and raw (8-bit bytes, no echo) */
+	g_ptySlaveFd = open(ptsname(g_ptyFd), O_RDWR | O_NOCTTY);
+	tcgetattr(g_ptySlaveFd, &Settings);
+	cfmakeraw(&Settings);
+	tcsetattr(g_ptySlaveFd, TCSANOW, &Settings);
+	fcntl(g_ptyFd, F_SETFL, O_NONBLOCK);
+
+	if (g_options.Modbus_Pty != "-")
+	{
+		unlink(g_options.Modbus_Pty.c_str());
+		if (symlink(ptsname(g_ptyFd), g_options.Modbus_Pty.c_str()))
+		{
+			std::perror(g_options.Modbus_Pty.c_str());
+			std::exit(1);
+		}
+	}
+	std::printf("modbus slave %d on %s\n", MODBUS_SLAVE_ADDRESS, ptsname(g_ptyFd));
+	std::fflush(stdout);
+}
+
+/* Bytes written by the master, received one character after the wall clock time or after the previous byte */
+void ReadPty()
+{
+	uint8_t Buffer[256];
+	ssize_t Length = read(g_ptyFd, Buffer, sizeof(Buffer));
+
+	for (ssize_t Index = 0; Index < Length; Index++)
+	{
+		g_rxLastCycles = std::max({WallCycles(), g_cycles, g_rxLastCycles}) + CharacterCycles();
+		g_rxBytes.push_back({g_rxLastCycles, Buffer[Index]});
+	}
+}
+
+/* Cycle of the next Timer2 or USART interrupt, NEVER if none is enabled */
+uint64_t NextSerialEvent()
+{
+	uint8_t Ucsrb = g_registers8[SHIM_UCSRB];
+	uint64_t Next = NEVER;
+
+	if (g_registers8[SHIM_TIMSK] & (1 << OCIE2))
+	{
+		Next = g_timer2NextCompare;
+	}
+	if (!g_rxBytes.empty() && (Ucsrb & (1 << RXCIE)))
+	{
+		Next = std::min(Next, std::max(g_cycles, g_rxBytes.front().first));
+	}
+	if ((Ucsrb & (1 << UDRIE)) && (Ucsrb & (1 << TXEN)))
+	{
+		Next = std::min(Next, std::max(g_cycles, g_txBufferFree));
+	}
+	if ((Ucsrb & (1 << TXCIE)) && g_txCompletePending)
+	{
+		Next = std::min(Next, std::max(g_cycles, g_txShiftEnd));
+	}
+	return Next;
+}
+
+/* Run the interrupt due at the cycle Next (given by NextSerialEvent) */
+void SerialEvent(uint64_t Next)
+{
+	uint8_t Ucsrb = g_registers8[SHIM_UCSRB];
+
+	g_cycles = Next;
+	Service();
+
+	if ((g_registers8[SHIM_TIMSK] & (1 << OCIE2)) && (g_timer2NextCompare == Next))
+	{
+		g_timer2NextCompare += (uint64_t)Timer2Steps() * TIMER2_DIVISIONS[g_registers8[SHIM_TCCR2] & 0x07];
+		if (Shim_Isr_TIMER2_COMP)
+		{
+			Shim_Isr_TIMER2_COMP();
+		}
+	}
+	else if ((Ucsrb & (1 << TXCIE)) && g_txCompletePending && (g_txShiftEnd <= Next))
+	{
+		/* Before a byte received at the same time: the line is free when the master starts to send */
+		g_txCompletePending = false;
+		if (Shim_Isr_USART_TXC)
+		{
+			Shim_Isr_USART_TXC();
+		}
+	}
+	else if (!g_rxBytes.empty() && (Ucsrb & (1 << RXCIE)) && (g_rxBytes.front().first <= Next))
+	{
+		g_registers8[SHIM_UDR] = g_rxBytes.front().second;
+		g_rxBytes.pop_front();
+		g_rxRequestPending = true;
+		if (Shim_Isr_USART_RXC)
+		{
+			Shim_Isr_USART_RXC();
+		}
+	}
+	else if ((Ucsrb & (1 << UDRIE)) && (g_txBufferFree <= Next))
+	{
+		uint64_t Start;
+		uint8_t Data;
+
+		if (Shim_Isr_USART_UDRE)
+		{
+			Shim_Isr_USART_UDRE();
+		}
+		Data = g_registers8[SHIM_UDR];
+
+		/* The byte goes to the shift register at once or when the previous one ends */
+		Start = std::max(Next, g_txShiftEnd);
+		g_txShiftEnd = Start + CharacterCycles();
+		g_txBufferFree = Start;
+		g_txCompletePending = true;
+
+		if (g_rxRequestPending)
+		{
+			double Latency_s = (Start - g_rxLastCycles) / F_CPU_HZ;
+
+			g_rxRequestPending = false;
+			g_modbusResponses++;
+			g_modbusLatencySum_s += Latency_s;
+			g_modbusLatencyMax_s = std::max(g_modbusLatencyMax_s, Latency_s);
+		}
+		if (g_ptyFd >= 0)
+		{
+			g_txBytes.push_back({g_txShiftEnd, Data});
+		}
+	}
+
+	/* The writes of the interrupt (Timer2 restarted or stopped) are seen at the cycle of the interrupt */
+	Service();
+}
+
+/* With a pseudo terminal, wait for the wall clock to reach the next event, reading the master meanwhile */
+void WaitRealTime()
+{
+	if (g_ptyFd < 0)
+	{
+		return;
+	}
+
+	while (!g_stop)
+	{
+		uint64_t Next = std::min(NextSerialEvent(), g_nextOverflow);
+		uint64_t Now = WallCycles();
+		struct pollfd Poll = {g_ptyFd, POLLIN, 0};
+		struct timespec Timeout;
+
+		while (!g_txBytes.empty() && (g_txBytes.front().first <= Now))
+		{
+			if (write(g_ptyFd, &g_txBytes.front().second, 1) != 1)
+			{
+				std::perror("pseudo terminal");
+			}
+			g_txBytes.pop_front();
+		}
+		if (!g_txBytes.empty())
+		{
+			Next = std::min(Next, g_txBytes.front().first);
+		}
+
+		if (Now >= Next)
+		{
+			ReadPty();
+			return;
+		}
+		Timeout.tv_sec = (time_t)((Next - Now) / 1000000u);
+		Timeout.tv_nsec = (long)((Next - Now) % 1000000u) * 1000L;
+		if ((ppoll(&Poll, 1, &Timeout, nullptr) > 0) && (Poll.revents & POLLIN))
+		{
+			ReadPty();
+		}
+	}
+}
+
+/*
+ * One Timer0 period of simulated hardware: the ADC trigger is taken at the overflow edge, then the Timer0
+ * interrupt runs, then the interrupt of the conversion (13.5 ADC clocks later).
+ * The interrupts are only called with the I bit of SREG set: the overflows during a busy wait with the
+ * interrupts disabled (before sei at boot) are lost, the auto triggered conversions still update the ADC.
+ */
+void HardwarePeriod()
+{
+	uint32_t Period_Cycles = Timer0PeriodCycles();
+	uint8_t Adcsra = g_registers8[SHIM_ADCSRA];
+	bool Adc_Triggered = (Adcsra & (1 << ADEN)) && (Adcsra & (1 << ADATE));
+	uint8_t Admux = g_registers8[SHIM_ADMUX];
+	bool Interrupts = (g_registers8[SHIM_SREG] & 0x80) != 0;
+
+	ReadMotorPins();
+	StepPlant((g_nextOverflow - g_lastOverflow) / F_CPU_HZ);
+	g_cycles = g_nextOverflow;
+	g_lastOverflow = g_nextOverflow;
+	g_nextOverflow += Period_Cycles;
+
+	/* The interrupts of the period are timed from the overflow (TCNT0 = 0) */
+	g_isrClock = 0;
+	g_isrClockRunning = true;
+	g_registers8[SHIM_TCNT0] = 0;
+
+	if (Interrupts && (g_registers8[SHIM_TIMSK] & (1 << TOIE0)) && Shim_Isr_TIMER0_OVF)
+	{
+		AdvanceIsrClock(FAN_SAFETY_RESPONSE_CYCLES + INTERRUPT_PROLOGUE_CYCLES);
+		Shim_Isr_TIMER0_OVF();
+	}
+	if (Interrupts && (g_registers8[SHIM_TIMSK] & (1 << OCIE0)) && Shim_Isr_TIMER0_COMP)
+	{
+		AdvanceIsrClock(FAN_SAFETY_RESPONSE_CYCLES + INTERRUPT_PROLOGUE_CYCLES);
+		Shim_Isr_TIMER0_COMP();
+	}
+
+	if (Adc_Triggered)
+	{
+		/* 13.5 ADC clocks after the trigger, the interrupt waits for the Timer0 interrupt and the blocking section */
+		uint32_t Conversion_End = (27 * CLOCK_SOLVER_ADC_DIVISION_OF(Adcsra & 0x07)) / 2;
+
+		g_registers16[SHIM_ADC] = Convert(Admux);
+		g_isrClock = std::max(g_isrClock, Conversion_End);
+		AdvanceIsrClock(g_options.Blocking_Cycles);
+		if (Interrupts && (g_registers8[SHIM_ADCSRA] & (1 << ADIE)) && Shim_Isr_ADC)
+		{
+			AdvanceIsrClock(FAN_SAFETY_RESPONSE_CYCLES + INTERRUPT_PROLOGUE_CYCLES);
+			Shim_Isr_ADC();
+		}
+	}
+	g_isrClockRunning = false;
+
+	if (Interrupts && (g_registers8[SHIM_EECR] & (1 << EERIE)) && Shim_Isr_EE_RDY)
+	{
+		Shim_Isr_EE_RDY();
+	}
+
+	Record();
+
+	if ((g_cycles >= g_endCycles) || g_stop)
+	{
+		double Wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - g_wallStart).count();
+
+		Report();
+		std::printf("simulated %.2fh in %.2fs (%.0fx real time)\n", Seconds() / 3600.0, Wall_s, Seconds() / Wall_s);
+		if (g_csv)
+		{
+			std::fclose(g_csv);
+		}
+		std::exit((FanSafety_GetReactionCycles() > FAN_SAFETY_REACTION_BUDGET_CYCLES) ? 1 : 0);
+	}
+}
+
+} /* namespace */
+
+/****************************************************************************************
+ *                                 Shim Entry Points (C)                                *
+ ****************************************************************************************/
+
+extern "C" volatile uint8_t *Shim_Register8(Shim_Register8Id Id)
+{
+	Service();
+	return &g_registers8[Id];
+}
+
+extern "C" volatile uint16_t *Shim_Register16(Shim_Register16Id Id)
+{
+	Service();
+	return &g_registers16[Id];
+}
+
+/* The CPU wakes up at the next Timer0 overflow, or before at a Timer2 or USART interrupt */
+extern "C" void Shim_Sleep(void)
+{
+	uint64_t Serial;
+
+	WaitRealTime();
+	Serial = NextSerialEvent();
+	if (Serial < g_nextOverflow)
+	{
+		SerialEvent(Serial);
+	}
+	else
+	{
+		HardwarePeriod();
+	}
+}
+
+/*
+ * The busy waits of <util/delay.h> take their time, the overflows passed meanwhile run the hardware and the
+ * Timer2 and USART interrupts run if they are enabled (they wait for sei otherwise)
+ */
+extern "C" void Shim_Delay_us(double Microseconds)
+{
+	uint64_t End = g_cycles + (uint64_t)(Microseconds * F_CPU_HZ / 1e6 + 0.5);
+
+	while (true)
+	{
+		uint64_t Serial = (g_registers8[SHIM_SREG] & 0x80) ? NextSerialEvent() : NEVER;
+
+		if ((Serial < g_nextOverflow) && (Serial <= End))
+		{
+			SerialEvent(Serial);
+		}
+		else if (g_nextOverflow <= End)
+		{
+			HardwarePeriod();
+		}
+		else
+		{
+			break;
+		}
+	}
+	g_cycles = End;
+}
+
+extern "C" char *itoa(int Value, char *Buffer, int Radix)
+{
+	std::snprintf(Buffer, 12, (Radix == 16) ? "%x" : "%d", Value);
+	return Buffer;
+}
+
+int main(int Argc, char **Argv)
+{
+	ParseOptions(Argc, Argv);
+
+	std::memset(g_eeprom, 0xFF, sizeof(g_eeprom));
+	g_plant.Temperature_C = std::isnan(g_options.Initial_C) ? g_options.Plant.Ambient_C : g_options.Initial_C;
+	g_nextOverflow = Timer0PeriodCycles();
+	g_endCycles = (uint64_t)(g_options.Hours * 3600.0 * F_CPU_HZ);
+
+	if (!g_options.Csv.empty())
+	{
+		g_csv = std::fopen(g_options.Csv.c_str(), "w");
+		if (g_csv)
+		{
+			std::fprintf(g_csv, "time_s,temperature_c,heat_w,drive_duty,fan_speed,compare\n");
+		}
+	}
+
+	if (!g_options.Modbus_Pty.empty())
+	{
+		OpenPty();
+		std::signal(SIGINT, [](int) { g_stop = 1; });
+	}
+
+	g_wallStart = std::chrono::steady_clock::now();
+
+	/* The firmware never returns, the run ends in Shim_Sleep */
+	Firmware_Main();
+	return 1;
+}
@@ -0,0 +1,251 @@
+/*******************************************************************************************************************
+ * File Name: trace_file.h
+ * Date: 19/10/2026
+ * Tool: Sensor trace file format of Trace_Replay (writer and memory mapped streaming reader)
+ * Author: Youssef Zaki
+ *
+ * Trace file (little endian):
+ *     header  "FTRC", uint16 version (1), uint8 ADC channel, uint8 REFS1:0 of the recorded codes,
+ *             uint32 sample period in us, uint64 number of samples, 8 reserved bytes (32 bytes)
+ *     samples one byte per sample, the signed difference with the previous code (-127..127), or the escape
+ *             0x80 followed by the 16-bit code (first sample and jumps)
+ * The file is memory mapped and read sequentially (MADV_SEQUENTIAL); the pages behind the read position are
+ * released every TRACE_RELEASE_BYTES, so a multi-gigabyte trace streams in a few megabytes of memory.
+ ******************************************************************************************************************/
+#ifndef TRACE_FILE_H_
+#define TRACE_FILE_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+constexpr uint16_t TRACE_VERSION = 1;
+constexpr uint8_t TRACE_ESCAPE = 0x80;
+constexpr size_t TRACE_RELEASE_BYTES = 64u << 20;
+
+struct TraceHeader
+{
+	char Magic[4];
+	uint16_t Version;
+	uint8_t Channel;
+	uint8_t Refs;
+	uint32_t Period_us;
+	uint64_t Num_Of_Samples;
+	uint8_t Reserved[8];
+};
+static_assert(sizeof(TraceHeader) == 32, "the trace header is 32 bytes on disk");
+
+/****************************************************************************************
+ *                                      Trace Writer                                    *
+ ****************************************************************************************/
+
+class TraceWriter
+{
+public:
+	TraceWriter(const char *Path, uint8_t Channel, uint8_t Refs, uint32_t Period_us)
+	{
+		m_file = std::fopen(Path, "wb");
+		if (!m_file)
+		{
+			std::perror(Path);
+			std::exit(1);
+		}
+		std::setvbuf(m_file, nullptr, _IOFBF, 1 << 20);
+
+		std::memset(&m_header, 0, sizeof(m_header));
+		std::memcpy(m_header.Magic, "FTRC", 4);
+		m_header.Version = TRACE_VERSION;
+		m_header.Channel = Channel;
+		m_header.Refs = Refs;
+		m_header.Period_us = Period_us;
+		std::fwrite(&m_header, sizeof(m_header), 1, m_file);
+	}
+
+	void Add(uint16_t Code)
+	{
+		int Delta = (int)Code - (int)m_last;
+
+		if ((m_header.Num_Of_Samples != 0) && (Delta >= -127) && (Delta <= 127))
+		{
+			std::fputc((uint8_t)(int8_t)Delta, m_file);
+		}
+		else
+		{
+			std::fputc(TRACE_ESCAPE, m_file);
+			std::fputc(Code & 0xFF, m_file);
+			std::fputc(Code >> 8, m_file);
+		}
+		m_last = Code;
+		m_header.Num_Of_Samples++;
+	}
+
+	/* The number of samples is only known at the end, the header is written again */
+	uint64_t Close()
+	{
+		uint64_t Bytes = (uint64_t)std::ftell(m_file);
+
+		std::fseek(m_file, 0, SEEK_SET);
+		std::fwrite(&m_header, sizeof(m_header), 1, m_file);
+		if (std::fclose(m_file) != 0)
+		{
+			std::perror("trace");
+			std::exit(1);
+		}
+		return Bytes;
+	}
+
+	uint64_t Count() const
+	{
+		return m_header.Num_Of_Samples;
+	}
+
+private:
+	FILE *m_file;
+	TraceHeader m_header;
+	uint16_t m_last = 0;
+};
+
+/****************************************************************************************
+ *                                      Trace Reader                                    *
+ ****************************************************************************************/
+
+class TraceReader
+{
+public:
+	~TraceReader()
+	{
+		if (m_base)
+		{
+			munmap((void *)m_base, m_size);
+		}
+	}
+
+	void Open(const char *Path)
+	{
+		struct stat Status;
+		int Descriptor = open(Path, O_RDONLY);
+
+		if ((Descriptor < 0) || (fstat(Descriptor, &Status) != 0))
+		{
+			std::perror(Path);
+			std::exit(1);
+		}
+		if ((size_t)Status.st_size < sizeof(TraceHeader))
+		{
+			std::fprintf(stderr, "%s: too short for a trace header\n", Path);
+			std::exit(1);
+		}
+
+		m_size = (size_t)Status.st_size;
+		m_base = (const uint8_t *)mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, Descriptor, 0);
+		close(Descriptor);
+		if (m_base == MAP_FAILED)
+		{
+			std::perror("mmap");
+			std::exit(1);
+		}
+		madvise((void *)m_base, m_size, MADV_SEQUENTIAL);
+
+		std::memcpy(&m_header, m_base, sizeof(m_header));
+		if (std::memcmp(m_header.Magic, "FTRC", 4) || (m_header.Version != TRACE_VERSION) || (m_header.Period_us == 0))
+		{
+			std::fprintf(stderr, "%s: not a version %u trace file\n", Path, (unsigned)TRACE_VERSION);
+			std::exit(1);
+		}
+
+		m_position = sizeof(TraceHeader);
+		m_released = 0;
+		m_index = 0;
+		Next();
+	}
+
+	/* Move to the sample covering the simulated time, return false once the trace is over */
+	bool Seek(uint64_t Cycles)
+	{
+		uint64_t Index = Cycles / m_header.Period_us;
+
+		while ((m_index < Index) && (m_index < m_header.Num_Of_Samples))
+		{
+			Next();
+		}
+		return m_index < m_header.Num_Of_Samples;
+	}
+
+	uint16_t Code() const
+	{
+		return m_code;
+	}
+
+	uint64_t Index() const
+	{
+		return m_index;
+	}
+
+	const TraceHeader &Header() const
+	{
+		return m_header;
+	}
+
+	size_t Size() const
+	{
+		return m_size;
+	}
+
+private:
+	/* Decode the sample at the read position, m_index counts the samples decoded before it */
+	void Next()
+	{
+		if (m_decoded)
+		{
+			m_index++;
+		}
+		m_decoded = true;
+
+		if (m_position >= m_size)
+		{
+			return;
+		}
+		if (m_base[m_position] == TRACE_ESCAPE)
+		{
+			if (m_position + 3 > m_size)
+			{
+				m_position = m_size;
+				return;
+			}
+			m_code = (uint16_t)(m_base[m_position + 1] | (m_base[m_position + 2] << 8));
+			m_position += 3;
+		}
+		else
+		{
+			m_code = (uint16_t)(m_code + (int8_t)m_base[m_position]);
+			m_position++;
+		}
+
+		/* Drop the pages already read, they are not needed again */
+		if (m_position - m_released >= TRACE_RELEASE_BYTES)
+		{
+			size_t Page = (size_t)sysconf(_SC_PAGESIZE);
+			size_t End = (m_position / Page) * Page;
+
+			madvise((void *)(m_base + m_released), End - m_released, MADV_DONTNEED);
+			m_released = End;
+		}
+	}
+
+	const uint8_t *m_base = nullptr;
+	size_t m_size = 0;
+	size_t m_position = 0;
+	size_t m_released = 0;
+	uint64_t m_index = 0;
+	bool m_decoded = false;
+	uint16_t m_code = 0;
+	TraceHeader m_header;
+};
+
+#endif /* TRACE_FILE_H_ */
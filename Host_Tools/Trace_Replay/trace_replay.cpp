@@ -0,0 +1,557 @@
+/*******************************************************************************************************************
+ * File Name: trace_replay.cpp
+ * Date: 19/10/2026
+ * Tool: Host-side replay of recorded sensor ADC traces through the unchanged fan controller firmware
+ * Author: Youssef Zaki
+ *
+ * The firmware sources of Fan_Controller_Project are compiled for the host against the register shim of
+ * Thermal_Sim (main renamed Firmware_Main) exactly like Thermal_Sim, but the sensor input is not a plant model:
+ * every conversion of the trace channel (auto triggered or polled through ADC_ReadChannel/LM35_GetTemperature)
+ * returns the recorded code of the current simulated time. There is no wall clock, the firmware runs the trace
+ * as fast as the host allows.
+ * The decisions of the firmware are written to a text trace, one line each time they change, so the outputs
+ * of two firmware versions for the same input can be compared with diff:
+ *     <time ms>  duty <OC0 duty %> <bridge state>  "<LCD row 0>" "<LCD row 1>"
+ * The duty is the one seen on the pins; a value is only written once it has been held for DECISION_HOLD_PERIODS
+ * Timer0 periods, so the deceleration ramps of DC_Motor.c give one line (--ramps writes every period).
+ * The LCD rows are decoded from the RS/E/data pins of LCD.c (HD44780 DDRAM writes latched on the E falling edge).
+ *
+ * The trace files (trace_file.h, about 1 byte per sample) are made by the record and synth commands; they are
+ * memory mapped and streamed, a multi-gigabyte trace is replayed in a few megabytes of memory.
+ *
+ * Build on the host (same objects as Thermal_Sim):
+ *     for f in $(ls ../../Fan_Controller_Project | grep "\.c$"); do
+ *         gcc -O2 -std=gnu99 -DF_CPU=1000000UL -Dmain=Firmware_Main -I../Thermal_Sim/shim \
+ *             -I../../Fan_Controller_Project -c ../../Fan_Controller_Project/$f -o ${f%.c}.o; done
+ *     g++ -O2 -std=c++17 -I../Thermal_Sim/shim -I../../Fan_Controller_Project trace_replay.cpp *.o -o trace_replay
+ * Commands:
+ *     ./trace_replay record <codes.txt|-> <trace.trc> [--period-us 2048] [--channel 2] [--refs 3]
+ *         encode a capture, one decimal ADC code per line (the first field of a CSV line, other lines skipped)
+ *     ./trace_replay synth <trace.trc> [--hours 24] [--period-us 2048] [--seed 1]
+ *         write a synthetic random walk trace (room temperature drifts and heat steps) for benchmarking
+ *     ./trace_replay replay <trace.trc> [--out decisions.txt] [--ramps]
+ *         run the firmware over the trace, write the decisions (stdout by default) and report the speed
+ ******************************************************************************************************************/
+#include <avr/io.h>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include "trace_file.h"
+
+extern "C"
+{
+#include "Standard_Types.h"
+#include "ADC.h"
+#include "LM35.h"
+#include "Current_Sense.h"
+
+int Firmware_Main(void);
+
+/* Interrupt vectors of the firmware, missing ones are not called */
+void Shim_Isr_TIMER0_OVF(void) __attribute__((weak));
+void Shim_Isr_TIMER0_COMP(void) __attribute__((weak));
+void Shim_Isr_ADC(void) __attribute__((weak));
+void Shim_Isr_EE_RDY(void) __attribute__((weak));
+
+/* Symbols of the avr-libc run time used by Stack_Monitor.c */
+uint8 __heap_start;
+char *__brkval = nullptr;
+
+char *itoa(int Value, char *Buffer, int Radix);
+}
+
+namespace
+{
+
+constexpr double F_CPU_HZ = 1000000.0;
+constexpr double RUN_CURRENT_A = 0.25;
+
+constexpr uint32_t DECISION_HOLD_PERIODS = 8;
+
+/* LCD.c wiring in the 8-bit mode: RS = PD0, E = PD2, D0:D7 = PORTC */
+constexpr uint8_t LCD_RS_BIT = 0;
+constexpr uint8_t LCD_E_BIT = 2;
+constexpr uint8_t LCD_COLUMNS = 16;
+
+/* Volts of the reference selected by REFS1:0, AVCC is 5V and the external AREF is taken as 2.56V */
+double ReferenceVolts(uint8_t Refs)
+{
+	return (Refs == 1) ? 5.0 : 2.56;
+}
+
+/****************************************************************************************
+ *                                      Register Shim                                   *
+ ****************************************************************************************/
+
+uint8_t g_registers8[SHIM_NUM_OF_REGISTERS8];
+uint16_t g_registers16[SHIM_NUM_OF_REGISTERS16];
+uint8_t g_eeprom[E2END + 1];
+
+uint64_t g_cycles = 0;
+TraceReader g_trace;
+
+/* DDRAM of the HD44780 as written through the pins, rows at 0x00 and 0x40 */
+char g_ddram[0x80];
+uint8_t g_lcdAddress = 0;
+bool g_lcdEnable = false;
+
+/* Drive of the motor seen on the pins, DC_Motor.c: CW = PB1, A_CW = PB0, both for the brake */
+struct MotorPins
+{
+	double Duty;
+	const char *State;
+};
+
+MotorPins ReadMotorPins()
+{
+	uint8_t Portb = g_registers8[SHIM_PORTB];
+	uint8_t Direction = Portb & 0x03;
+	double Duty;
+
+	if (g_registers8[SHIM_TCCR0] & (1 << COM01))
+	{
+		Duty = (g_registers8[SHIM_OCR0] == 0) ? 0.0 : (g_registers8[SHIM_OCR0] + 1) / 256.0;
+	}
+	else
+	{
+		Duty = (Portb & (1 << PB3)) ? 1.0 : 0.0;
+	}
+
+	if ((Direction == 0x00) || (Duty == 0.0))
+	{
+		return {0.0, "stop "};
+	}
+	if (Direction == 0x03)
+	{
+		return {Duty, "brake"};
+	}
+	return {Duty, (Direction == 0x02) ? "cw   " : "a_cw "};
+}
+
+/* ADC code of a channel (MUX4:0) with the reference of REFS1:0, the trace feeds its own channel */
+uint16_t Convert(uint8_t Admux)
+{
+	uint8_t Channel = Admux & 0x1F;
+	uint8_t Refs = Admux >> 6;
+	double Reference_V = ReferenceVolts(Refs);
+	double Volts = 0.0;
+
+	if (Channel == g_trace.Header().Channel)
+	{
+		if (Refs == g_trace.Header().Refs)
+		{
+			return g_trace.Code();
+		}
+		Volts = g_trace.Code() * ReferenceVolts(g_trace.Header().Refs) / 1024.0;
+	}
+	else if (Channel == CURRENT_SENSE_CHANNEL)
+	{
+		Volts = (ReadMotorPins().Duty > 0.0) ? (RUN_CURRENT_A * CURRENT_SENSE_MV_PER_AMP / 1000.0) : 0.0;
+	}
+	else if (Channel == ADC_VBG)
+	{
+		Volts = 1.22;
+	}
+
+	long Code = std::lround(Volts / Reference_V * 1024.0);
+	return (uint16_t)std::min(1023L, std::max(0L, Code));
+}
+
+/* The HD44780 latches RS and the data bus on the falling edge of E */
+void LatchLcd()
+{
+	uint8_t Portd = g_registers8[SHIM_PORTD];
+	bool Enable = (Portd >> LCD_E_BIT) & 1;
+
+	if (g_lcdEnable && !Enable)
+	{
+		uint8_t Data = g_registers8[SHIM_PORTC];
+
+		if (Portd & (1 << LCD_RS_BIT))
+		{
+			g_ddram[g_lcdAddress] = ((Data >= 0x20) && (Data < 0x7F)) ? (char)Data : '?';
+			g_lcdAddress = (g_lcdAddress + 1) & 0x7F;
+		}
+		else if (Data & 0x80)
+		{
+			g_lcdAddress = Data & 0x7F;
+		}
+		else if (Data == 0x01)
+		{
+			std::memset(g_ddram, ' ', sizeof(g_ddram));
+			g_lcdAddress = 0;
+		}
+		else if (Data == 0x02)
+		{
+			g_lcdAddress = 0;
+		}
+	}
+	g_lcdEnable = Enable;
+}
+
+/* Effects of the previous register writes, applied before each register access */
+void Service()
+{
+	uint8_t &Adcsra = g_registers8[SHIM_ADCSRA];
+	uint8_t &Eecr = g_registers8[SHIM_EECR];
+
+	if ((Adcsra & (1 << ADSC)) && (Adcsra & (1 << ADEN)))
+	{
+		g_registers16[SHIM_ADC] = Convert(g_registers8[SHIM_ADMUX]);
+		Adcsra = (Adcsra & ~(1 << ADSC)) | (1 << ADIF);
+	}
+
+	if (Eecr & (1 << EERE))
+	{
+		g_registers8[SHIM_EEDR] = g_eeprom[g_registers16[SHIM_EEAR] & E2END];
+		Eecr &= ~(1 << EERE);
+	}
+	if (Eecr & (1 << EEWE))
+	{
+		g_eeprom[g_registers16[SHIM_EEAR] & E2END] = g_registers8[SHIM_EEDR];
+		Eecr &= ~((1 << EEWE) | (1 << EEMWE));
+	}
+
+	g_registers8[SHIM_UCSRA] |= (1 << UDRE) | (1 << TXC);
+
+	LatchLcd();
+
+	g_registers8[SHIM_PINA] = g_registers8[SHIM_PORTA];
+	g_registers8[SHIM_PINB] = g_registers8[SHIM_PORTB];
+	g_registers8[SHIM_PINC] = g_registers8[SHIM_PORTC];
+	g_registers8[SHIM_PIND] = g_registers8[SHIM_PORTD];
+}
+
+/* Timer0 period in CPU cycles from the mode and the prescaler of TCCR0 */
+uint32_t Timer0PeriodCycles()
+{
+	static const uint32_t Prescalars[8] = {0, 1, 8, 64, 256, 1024, 0, 0};
+	uint8_t Tccr0 = g_registers8[SHIM_TCCR0];
+	uint32_t Division = Prescalars[Tccr0 & 0x07];
+	uint32_t Steps = 256;
+
+	if ((Tccr0 & (1 << WGM00)) && !(Tccr0 & (1 << WGM01)))
+	{
+		Steps = 510;
+	}
+	else if (!(Tccr0 & (1 << WGM00)) && (Tccr0 & (1 << WGM01)))
+	{
+		Steps = (uint32_t)g_registers8[SHIM_OCR0] + 1;
+	}
+
+	/* A stopped timer never wakes the CPU, the time still moves so the run ends */
+	return (Division == 0) ? 2048 : Steps * Division;
+}
+
+/****************************************************************************************
+ *                                    Decision Trace                                    *
+ ****************************************************************************************/
+
+FILE *g_out = stdout;
+bool g_ramps = false;
+std::chrono::steady_clock::time_point g_wallStart;
+
+/* Last written decision, and the candidate duty waiting for DECISION_HOLD_PERIODS */
+uint64_t g_lastCycles = 0;
+double g_lastDuty = 0.0;
+const char *g_lastState = "stop ";
+char g_lastLcd[2][LCD_COLUMNS];
+double g_pendingDuty = 0.0;
+const char *g_pendingState = "stop ";
+uint64_t g_pendingCycles = 0;
+uint32_t g_pendingPeriods = 0;
+unsigned long g_lines = 0;
+
+void WriteDecision(uint64_t Cycles)
+{
+	/* A duty held since before the last LCD line is written at the time of that line */
+	Cycles = std::max(Cycles, g_lastCycles);
+	g_lastCycles = Cycles;
+
+	std::fprintf(g_out, "%12.3f  duty %5.1f%% %s  \"%.*s\" \"%.*s\"\n", Cycles / 1000.0, 100.0 * g_lastDuty, g_lastState,
+			(int)LCD_COLUMNS, g_lastLcd[0], (int)LCD_COLUMNS, g_lastLcd[1]);
+	g_lines++;
+}
+
+void RecordDecisions()
+{
+	MotorPins Pins = ReadMotorPins();
+	bool Duty_Changed = false;
+	bool Lcd_Changed = false;
+
+	if ((Pins.Duty != g_pendingDuty) || std::strcmp(Pins.State, g_pendingState))
+	{
+		g_pendingDuty = Pins.Duty;
+		g_pendingState = Pins.State;
+		g_pendingCycles = g_cycles;
+		g_pendingPeriods = 0;
+	}
+	g_pendingPeriods++;
+
+	if (((g_pendingPeriods >= DECISION_HOLD_PERIODS) || g_ramps) &&
+			((g_pendingDuty != g_lastDuty) || std::strcmp(g_pendingState, g_lastState)))
+	{
+		g_lastDuty = g_pendingDuty;
+		g_lastState = g_pendingState;
+		Duty_Changed = true;
+	}
+
+	if (std::memcmp(g_lastLcd[0], g_ddram, LCD_COLUMNS) || std::memcmp(g_lastLcd[1], g_ddram + 0x40, LCD_COLUMNS))
+	{
+		std::memcpy(g_lastLcd[0], g_ddram, LCD_COLUMNS);
+		std::memcpy(g_lastLcd[1], g_ddram + 0x40, LCD_COLUMNS);
+		Lcd_Changed = true;
+	}
+
+	/* The duty is written with the time it started to be held */
+	if (Lcd_Changed)
+	{
+		WriteDecision(g_cycles);
+	}
+	else if (Duty_Changed)
+	{
+		WriteDecision(g_pendingCycles);
+	}
+}
+
+void Finish()
+{
+	double Wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - g_wallStart).count();
+	double Simulated_s = g_cycles / F_CPU_HZ;
+	uint64_t Samples = g_trace.Index();
+
+	std::fflush(g_out);
+	if (g_out != stdout)
+	{
+		std::fclose(g_out);
+	}
+
+	std::fprintf(stderr, "replayed %llu samples (%.2fh, %.1f MB) in %.2fs: %.2f M samples/s, %.0fx real time, %lu decision lines\n",
+			(unsigned long long)Samples, Simulated_s / 3600.0, g_trace.Size() / 1e6, Wall_s, Samples / Wall_s / 1e6,
+			Simulated_s / Wall_s, g_lines);
+	std::fprintf(stderr, "current trips %u\n", (unsigned)CurrentSense_GetTripCount());
+	std::exit(0);
+}
+
+/****************************************************************************************
+ *                                       Commands                                       *
+ ****************************************************************************************/
+
+const char *Option(int Argc, char **Argv, const char *Name, const char *Default)
+{
+	for (int Index = 1; Index + 1 < Argc; Index++)
+	{
+		if (!std::strcmp(Argv[Index], Name))
+		{
+			return Argv[Index + 1];
+		}
+	}
+	return Default;
+}
+
+bool Flag(int Argc, char **Argv, const char *Name)
+{
+	for (int Index = 1; Index < Argc; Index++)
+	{
+		if (!std::strcmp(Argv[Index], Name))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+int Command_Record(const char *Input, const char *Output, int Argc, char **Argv)
+{
+	FILE *In = std::strcmp(Input, "-") ? std::fopen(Input, "r") : stdin;
+	TraceWriter Writer(Output, (uint8_t)std::atoi(Option(Argc, Argv, "--channel", "2")),
+			(uint8_t)std::atoi(Option(Argc, Argv, "--refs", "3")), (uint32_t)std::atol(Option(Argc, Argv, "--period-us", "2048")));
+	char Line[256];
+	uint64_t Bytes;
+
+	if (!In)
+	{
+		std::perror(Input);
+		return 1;
+	}
+
+	while (std::fgets(Line, sizeof(Line), In))
+	{
+		char *End;
+		long Code = std::strtol(Line, &End, 10);
+
+		/* Header lines and comments have no number in the first field */
+		if ((End == Line) || (Code < 0) || (Code > 1023))
+		{
+			continue;
+		}
+		Writer.Add((uint16_t)Code);
+	}
+
+	Bytes = Writer.Close();
+	std::printf("%llu samples, %llu bytes (%.2f bytes/sample)\n", (unsigned long long)Writer.Count(),
+			(unsigned long long)Bytes, (double)Bytes / std::max<uint64_t>(1, Writer.Count()));
+	return 0;
+}
+
+/*
+ * Room temperature drifting around 25C, a heat source switched every 20 to 90 minutes and the sensor noise,
+ * with a first order lag, as codes of the LM35 with the 2.56V reference (4 codes per C).
+ */
+int Command_Synth(const char *Output, int Argc, char **Argv)
+{
+	double Hours = std::atof(Option(Argc, Argv, "--hours", "24"));
+	uint32_t Period_us = (uint32_t)std::atol(Option(Argc, Argv, "--period-us", "2048"));
+	std::mt19937_64 Generator((uint64_t)std::atoll(Option(Argc, Argv, "--seed", "1")));
+	std::normal_distribution<double> Noise(0.0, 0.5);
+	std::uniform_real_distribution<double> Uniform(0.0, 1.0);
+	TraceWriter Writer(Output, LM35_SENSOR_READ_CHANNEL, 3, Period_us);
+	uint64_t Count = (uint64_t)(Hours * 3600e6 / Period_us);
+	double Dt_s = Period_us / 1e6;
+	double Ambient_C = 25.0;
+	double Target_C = 25.0;
+	double Temperature_C = 25.0;
+	double Next_Step_s = 0.0;
+	uint64_t Bytes;
+
+	for (uint64_t Index = 0; Index < Count; Index++)
+	{
+		double Time_s = Index * Dt_s;
+
+		if (Time_s >= Next_Step_s)
+		{
+			Next_Step_s = Time_s + 1200.0 + 4200.0 * Uniform(Generator);
+			Target_C = Ambient_C + 100.0 * Uniform(Generator);
+		}
+		Ambient_C += 0.002 * Noise(Generator) * std::sqrt(Dt_s);
+		Temperature_C += (Target_C - Temperature_C) * Dt_s / 300.0;
+
+		Writer.Add((uint16_t)std::min(1023L, std::max(0L, std::lround((Temperature_C + 0.1 * Noise(Generator)) * 4.0))));
+	}
+
+	Bytes = Writer.Close();
+	std::printf("%llu samples, %llu bytes (%.2f bytes/sample)\n", (unsigned long long)Writer.Count(),
+			(unsigned long long)Bytes, (double)Bytes / std::max<uint64_t>(1, Writer.Count()));
+	return 0;
+}
+
+int Command_Replay(const char *Input, int Argc, char **Argv)
+{
+	const char *Output = Option(Argc, Argv, "--out", nullptr);
+
+	g_trace.Open(Input);
+	g_ramps = Flag(Argc, Argv, "--ramps");
+
+	if (Output)
+	{
+		g_out = std::fopen(Output, "w");
+		if (!g_out)
+		{
+			std::perror(Output);
+			return 1;
+		}
+	}
+	std::setvbuf(g_out, nullptr, _IOFBF, 1 << 20);
+	std::fprintf(g_out, "# trace channel %u, %u us per sample, %llu samples\n", (unsigned)g_trace.Header().Channel,
+			(unsigned)g_trace.Header().Period_us, (unsigned long long)g_trace.Header().Num_Of_Samples);
+
+	std::memset(g_eeprom, 0xFF, sizeof(g_eeprom));
+	std::memset(g_ddram, ' ', sizeof(g_ddram));
+	std::memset(g_lastLcd, ' ', sizeof(g_lastLcd));
+	g_wallStart = std::chrono::steady_clock::now();
+
+	/* The firmware never returns, the run ends in Shim_Sleep */
+	Firmware_Main();
+	return 1;
+}
+
+} /* namespace */
+
+/****************************************************************************************
+ *                                 Shim Entry Points (C)                                *
+ ****************************************************************************************/
+
+extern "C" volatile uint8_t *Shim_Register8(Shim_Register8Id Id)
+{
+	Service();
+	return &g_registers8[Id];
+}
+
+extern "C" volatile uint16_t *Shim_Register16(Shim_Register16Id Id)
+{
+	Service();
+	return &g_registers16[Id];
+}
+
+/* One Timer0 period of simulated hardware, the same sequence as Thermal_Sim without the plant */
+extern "C" void Shim_Sleep(void)
+{
+	uint32_t Period_Cycles = Timer0PeriodCycles();
+	uint8_t Adcsra = g_registers8[SHIM_ADCSRA];
+	bool Adc_Triggered = (Adcsra & (1 << ADEN)) && (Adcsra & (1 << ADATE));
+	uint8_t Admux = g_registers8[SHIM_ADMUX];
+
+	g_cycles += Period_Cycles;
+	if (!g_trace.Seek(g_cycles))
+	{
+		Finish();
+	}
+
+	if ((g_registers8[SHIM_TIMSK] & (1 << TOIE0)) && Shim_Isr_TIMER0_OVF)
+	{
+		Shim_Isr_TIMER0_OVF();
+	}
+	if ((g_registers8[SHIM_TIMSK] & (1 << OCIE0)) && Shim_Isr_TIMER0_COMP)
+	{
+		Shim_Isr_TIMER0_COMP();
+	}
+
+	if (Adc_Triggered)
+	{
+		g_registers16[SHIM_ADC] = Convert(Admux);
+		g_registers8[SHIM_TCNT0] = 14;
+		if ((g_registers8[SHIM_ADCSRA] & (1 << ADIE)) && Shim_Isr_ADC)
+		{
+			Shim_Isr_ADC();
+		}
+	}
+
+	if ((g_registers8[SHIM_EECR] & (1 << EERIE)) && Shim_Isr_EE_RDY)
+	{
+		Shim_Isr_EE_RDY();
+	}
+
+	RecordDecisions();
+}
+
+extern "C" char *itoa(int Value, char *Buffer, int Radix)
+{
+	std::snprintf(Buffer, 12, (Radix == 16) ? "%x" : "%d", Value);
+	return Buffer;
+}
+
+int main(int Argc, char **Argv)
+{
+	if ((Argc >= 4) && !std::strcmp(Argv[1], "record"))
+	{
+		return Command_Record(Argv[2], Argv[3], Argc, Argv);
+	}
+	if ((Argc >= 3) && !std::strcmp(Argv[1], "synth"))
+	{
+		return Command_Synth(Argv[2], Argc, Argv);
+	}
+	if ((Argc >= 3) && !std::strcmp(Argv[1], "replay"))
+	{
+		return Command_Replay(Argv[2], Argc, Argv);
+	}
+
+	std::fprintf(stderr, "usage: %s record <codes.txt|-> <trace.trc> [--period-us N] [--channel N] [--refs N]\n"
+			"       %s synth <trace.trc> [--hours H] [--period-us N] [--seed N]\n"
+			"       %s replay <trace.trc> [--out decisions.txt] [--ramps]\n", Argv[0], Argv[0], Argv[0]);
+	return 1;
+}